@@ -14,9 +14,34 @@
 
 #include "benchmark_runner.hpp"
 
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <thread>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/utsname.h>
+#include <unistd.h>
+#endif
+
+#include <bsoncxx/builder/basic/array.hpp>
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
 #include <bsoncxx/stdx/make_unique.hpp>
+#include <bsoncxx/string/to_string.hpp>
+#include <bsoncxx/types.hpp>
+#include <mongocxx/config/version.hpp>
 
+#include "bson/bson_decoding.hpp"
+#include "bson/bson_element_access.hpp"
 #include "bson/bson_encoding.hpp"
+#include "bson/bson_iteration.hpp"
+#include "bson/bson_key_lookup.hpp"
+#include "bson/bson_match.hpp"
+#include "bson/bson_to_json.hpp"
 #include "multi_doc/bulk_insert.hpp"
 #include "multi_doc/find_many.hpp"
 #include "multi_doc/gridfs_download.hpp"
@@ -25,12 +50,100 @@
 #include "parallel/gridfs_multi_import.hpp"
 #include "parallel/json_multi_export.hpp"
 #include "parallel/json_multi_import.hpp"
+#include "report.hpp"
 #include "single_doc/find_one_by_id.hpp"
 #include "single_doc/insert_one.hpp"
 #include "single_doc/run_command.hpp"
 
 namespace benchmark {
 
+namespace {
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_document;
+
+// A slowdown is only reported as a regression if Welch's t statistic for the difference in mean
+// runtimes exceeds this. It corresponds to a one-sided p-value of about 0.001 for the sample
+// counts that the benchmarks run.
+const double regression_t_statistic = 3.1;
+
+std::string compiler_description() {
+#if defined(__clang__)
+    return "clang " __clang_version__;
+#elif defined(__GNUC__)
+    return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+    return "msvc " + std::to_string(_MSC_FULL_VER);
+#else
+    return "unknown";
+#endif
+}
+
+bsoncxx::document::value environment() {
+    std::time_t now = std::time(nullptr);
+    char timestamp[32];
+    std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+    std::string hostname = "unknown";
+    std::string os = "unknown";
+#if defined(_WIN32)
+    char name[MAX_COMPUTERNAME_LENGTH + 1];
+    DWORD name_len = sizeof(name);
+    if (::GetComputerNameA(name, &name_len)) {
+        hostname.assign(name, name_len);
+    }
+    os = "Windows";
+#else
+    char name[256];
+    if (::gethostname(name, sizeof(name)) == 0) {
+        name[sizeof(name) - 1] = '\0';
+        hostname = name;
+    }
+
+    struct utsname uts;
+    if (::uname(&uts) == 0) {
+        os = std::string{uts.sysname} + " " + uts.release + " " + uts.machine;
+    }
+#endif
+
+#if defined(NDEBUG)
+    const char* build_type = "release";
+#else
+    const char* build_type = "debug";
+#endif
+
+    return make_document(
+        kvp("timestamp", timestamp),
+        kvp("driver_version", MONGOCXX_VERSION_STRING),
+        kvp("compiler", compiler_description()),
+        kvp("build_type", build_type),
+        kvp("os", os),
+        kvp("hostname", hostname),
+        kvp("hardware_concurrency",
+            static_cast<std::int32_t>(std::thread::hardware_concurrency())));
+}
+
+double get_number(bsoncxx::document::view doc, const char* key) {
+    auto element = doc[key];
+    if (!element) {
+        throw std::runtime_error(std::string{"baseline result is missing \""} + key + "\"");
+    }
+
+    switch (element.type()) {
+        case bsoncxx::type::k_double:
+            return element.get_double().value;
+        case bsoncxx::type::k_int32:
+            return element.get_int32().value;
+        case bsoncxx::type::k_int64:
+            return static_cast<double>(element.get_int64().value);
+        default:
+            throw std::runtime_error(std::string{"baseline result has non-numeric \""} + key +
+                                     "\"");
+    }
+}
+
+}  // namespace
+
 // The task sizes and iteration numbers come from the Driver Perfomance Benchmarking Reference Doc.
 benchmark_runner::benchmark_runner(std::set<benchmark_type> types) : _types{types} {
     using bsoncxx::stdx::make_unique;
@@ -42,7 +155,45 @@ benchmark_runner::benchmark_runner(std::set<benchmark_type> types) : _types{type
         make_unique<bson_encoding>("TestDeepEncoding", 19.64, "extended_bson/deep_bson.json"));
     _microbenches.push_back(
         make_unique<bson_encoding>("TestFullEncoding", 57.34, "extended_bson/full_bson.json"));
-    // TODO CXX-1241: Add bson_decoding equivalents.
+    _microbenches.push_back(
+        make_unique<bson_decoding>("TestFlatDecoding", 75.31, "extended_bson/flat_bson.json"));
+    _microbenches.push_back(
+        make_unique<bson_decoding>("TestDeepDecoding", 19.64, "extended_bson/deep_bson.json"));
+    _microbenches.push_back(
+        make_unique<bson_decoding>("TestFullDecoding", 57.34, "extended_bson/full_bson.json"));
+
+    // Bson access microbenchmarks, which are not part of the spec. Their task sizes are those of
+    // the spec's BSON benchmarks over the same documents, since each also handles the document
+    // 10000 times.
+    struct bson_file {
+        std::string name;
+        double task_size;
+        std::string path;
+    };
+    const bson_file bson_files[] = {{"Flat", 75.31, "extended_bson/flat_bson.json"},
+                                    {"Deep", 19.64, "extended_bson/deep_bson.json"},
+                                    {"Full", 57.34, "extended_bson/full_bson.json"}};
+    for (auto&& file : bson_files) {
+        const std::string& name = file.name;
+        const std::string& path = file.path;
+
+        _microbenches.push_back(
+            make_unique<bson_iteration>("Test" + name + "Iteration", file.task_size, path));
+        _microbenches.push_back(make_unique<bson_element_access>(
+            "Test" + name + "ElementAccess", file.task_size, path));
+        _microbenches.push_back(
+            make_unique<bson_key_lookup>("Test" + name + "KeyLookup", file.task_size, path));
+        _microbenches.push_back(
+            make_unique<bson_match>("Test" + name + "Match", file.task_size, path));
+        _microbenches.push_back(make_unique<bson_to_json>("Test" + name + "ToJson",
+                                                          file.task_size,
+                                                          path,
+                                                          bsoncxx::ExtendedJsonMode::k_legacy));
+        _microbenches.push_back(make_unique<bson_to_json>("Test" + name + "ToRelaxedJson",
+                                                          file.task_size,
+                                                          path,
+                                                          bsoncxx::ExtendedJsonMode::k_relaxed));
+    }
 
     // Single doc microbenchmarks
     _microbenches.push_back(make_unique<run_command>());
@@ -60,6 +211,8 @@ benchmark_runner::benchmark_runner(std::set<benchmark_type> types) : _types{type
         "TestLargeDocBulkInsert", 27.31, 10, "single_and_multi_document/large_doc.json"));
     _microbenches.push_back(
         make_unique<gridfs_upload>("single_and_multi_document/gridfs_large.bin"));
+    _microbenches.push_back(
+        make_unique<gridfs_upload>("single_and_multi_document/gridfs_large.bin", 4));
     _microbenches.push_back(
         make_unique<gridfs_download>("single_and_multi_document/gridfs_large.bin"));
 
@@ -100,7 +253,7 @@ void benchmark_runner::run_microbenches() {
         auto score = bench->get_results();
 
         std::cout << bench->get_name() << ": "
-                  << static_cast<double>(score.get_percentile(50).count()) / 1000.0
+                  << static_cast<double>(score.get_percentile(50).count()) / 1000000.0
                   << " second(s) | " << score.get_score() << " MB/s" << std::endl
                   << std::endl;
     }
@@ -155,7 +308,7 @@ void benchmark_runner::print_scores() {
         auto& score = bench->get_results();
 
         std::cout << bench->get_name() << ": "
-                  << static_cast<double>(score.get_percentile(50).count()) / 1000.0
+                  << static_cast<double>(score.get_percentile(50).count()) / 1000000.0
                   << " second(s) | " << score.get_score() << " MB/s" << std::endl;
     }
 
@@ -187,4 +340,116 @@ void benchmark_runner::print_scores() {
         std::cout << "DriverBench: " << (read + write) / 2.0 << " MB/s" << std::endl;
     }
 }
-}  // namespace benchmark
\ No newline at end of file
+
+bsoncxx::document::value benchmark_runner::results() {
+    bsoncxx::builder::basic::array benchmarks;
+
+    for (auto&& bench : _microbenches) {
+        auto& score = bench->get_results();
+
+        bsoncxx::builder::basic::array tags;
+        for (auto&& tag : bench->get_tags()) {
+            tags.append(type_names[tag]);
+        }
+
+        bsoncxx::builder::basic::document percentiles;
+        for (auto&& n : reported_percentiles) {
+            percentiles.append(kvp("p" + std::to_string(n),
+                                   static_cast<std::int64_t>(score.get_percentile(n).count())));
+        }
+        percentiles.append(
+            kvp("max", static_cast<std::int64_t>(score.get_percentile(100).count())));
+
+        benchmarks.append(make_document(
+            kvp("name", bench->get_name()),
+            kvp("tags", tags.extract()),
+            kvp("task_size_mb", score.get_task_size()),
+            kvp("iterations", static_cast<std::int64_t>(score.get_sample_count())),
+            kvp("execution_time_us", static_cast<std::int64_t>(score.get_execution_time().count())),
+            kvp("mean_us", score.get_mean()),
+            kvp("stddev_us", score.get_standard_deviation()),
+            kvp("percentiles_us", percentiles.extract()),
+            kvp("score_mb_per_s", score.get_score())));
+    }
+
+    return make_document(kvp("environment", environment()),
+                         kvp("benchmarks", benchmarks.extract()));
+}
+
+void benchmark_runner::write_csv(std::ostream& out) {
+    out << "name,iterations,mean_us,stddev_us";
+    for (auto&& n : reported_percentiles) {
+        out << ",p" << n << "_us";
+    }
+    out << ",max_us,score_mb_per_s" << std::endl;
+
+    for (auto&& bench : _microbenches) {
+        auto& score = bench->get_results();
+
+        out << bench->get_name() << "," << score.get_sample_count() << "," << score.get_mean()
+            << "," << score.get_standard_deviation();
+        for (auto&& n : reported_percentiles) {
+            out << "," << score.get_percentile(n).count();
+        }
+        out << "," << score.get_percentile(100).count() << "," << score.get_score() << std::endl;
+    }
+}
+
+std::size_t benchmark_runner::compare(bsoncxx::document::view baseline, double threshold) {
+    std::size_t regressions = 0;
+
+    std::cout << std::endl
+              << "Comparison with baseline (regression threshold " << threshold * 100.0
+              << "%):" << std::endl
+              << "===========" << std::endl;
+
+    for (auto&& bench : _microbenches) {
+        auto& score = bench->get_results();
+        const std::string name = bench->get_name();
+
+        bsoncxx::stdx::optional<bsoncxx::document::view> base;
+        for (auto&& result : baseline["benchmarks"].get_array().value) {
+            auto doc = result.get_document().value;
+            if (bsoncxx::string::to_string(doc["name"].get_string().value) == name) {
+                base = doc;
+                break;
+            }
+        }
+
+        if (!base) {
+            std::cout << name << ": not in baseline" << std::endl;
+            continue;
+        }
+
+        const double base_median =
+            get_number((*base)["percentiles_us"].get_document().value, "p50");
+        const double base_mean = get_number(*base, "mean_us");
+        const double base_stddev = get_number(*base, "stddev_us");
+        const double base_count = get_number(*base, "iterations");
+
+        const double median = static_cast<double>(score.get_percentile(50).count());
+        const double mean = score.get_mean();
+        const double stddev = score.get_standard_deviation();
+        const double count = static_cast<double>(score.get_sample_count());
+
+        // Welch's t-test, which does not assume that both runs have the same variance.
+        const double standard_error =
+            std::sqrt(base_stddev * base_stddev / base_count + stddev * stddev / count);
+        const double t = standard_error > 0.0 ? (mean - base_mean) / standard_error
+                                              : (mean > base_mean ? HUGE_VAL : 0.0);
+
+        const double change = base_median > 0.0 ? (median - base_median) / base_median : 0.0;
+        const bool regression = change > threshold && t > regression_t_statistic;
+
+        std::cout << name << ": median " << base_median / 1000000.0 << " -> " << median / 1000000.0
+                  << " second(s) (" << (change >= 0 ? "+" : "") << change * 100.0 << "%, t = " << t
+                  << ")" << (regression ? " REGRESSION" : "") << std::endl;
+
+        if (regression) {
+            ++regressions;
+        }
+    }
+
+    return regressions;
+}
+}  // namespace benchmark
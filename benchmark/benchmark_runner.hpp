@@ -14,6 +14,11 @@
 
 #pragma once
 
+#include <cstddef>
+#include <ostream>
+
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/document/view.hpp>
 #include <bsoncxx/stdx/optional.hpp>
 #include <mongocxx/instance.hpp>
 
@@ -43,6 +48,30 @@ class benchmark_runner {
 
     double calculate_driver_bench_score();
 
+    //
+    // Returns the results of the microbenchmarks that were run, with their sample runtime
+    // distributions, and a description of the environment they were run in.
+    //
+    bsoncxx::document::value results();
+
+    //
+    // Writes one line of comma-separated values per microbenchmark that was run.
+    //
+    void write_csv(std::ostream& out);
+
+    //
+    // Compares the microbenchmarks that were run with a baseline produced by results(), printing
+    // the change in each median runtime.
+    //
+    // @param threshold
+    //   The relative slowdown of the median runtime, e.g. 0.05 for 5%, above which a
+    //   statistically significant slowdown is a regression.
+    //
+    // @return
+    //   The number of regressions.
+    //
+    std::size_t compare(bsoncxx::document::view baseline, double threshold);
+
    private:
     double calculate_average(benchmark_type);
 
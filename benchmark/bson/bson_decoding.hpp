@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <bsoncxx/json.hpp>
+
 #include "../microbench.hpp"
 
 namespace benchmark {
@@ -34,16 +36,17 @@ class bson_decoding : public microbench {
 
    private:
     std::string _file_name;
-    std::string _json;
+    bsoncxx::stdx::optional<bsoncxx::document::value> _doc;
 };
 
 void bson_decoding::setup() {
-    _json = parse_json_file_to_strings(_file_name)[0];
+    _doc = parse_json_file_to_documents(_file_name)[0];
 }
 
+// Mirroring mongo-c-driver's interpretation of the spec, which decodes to canonical extended JSON.
 void bson_decoding::task() {
     for (std::uint32_t i = 0; i < 10000; i++) {
-        // TODO CXX-1241: call bson_as_extended json on _json.
+        bsoncxx::to_json(_doc->view(), bsoncxx::ExtendedJsonMode::k_canonical);
     }
 }
 }  // namespace benchmark
\ No newline at end of file
@@ -0,0 +1,101 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <bsoncxx/array/view.hpp>
+#include <bsoncxx/document/view.hpp>
+#include <bsoncxx/types.hpp>
+#include <bsoncxx/types/bson_value/view.hpp>
+
+#include "../microbench.hpp"
+
+namespace benchmark {
+
+// Walks every element of a document, descending into subdocuments and arrays, and reads the value
+// of each through the typed accessors. This measures element value decoding on top of iteration.
+class bson_element_access : public microbench {
+   public:
+    bson_element_access() = delete;
+
+    bson_element_access(std::string name, double task_size, std::string json_file)
+        : microbench{std::move(name),
+                     task_size,
+                     std::set<benchmark_type>{benchmark_type::bson_access_bench}},
+          _json_file{std::move(json_file)},
+          _sink{0} {}
+
+   protected:
+    void setup();
+    void task();
+
+   private:
+    void access(bsoncxx::types::bson_value::view value);
+
+    std::string _json_file;
+    bsoncxx::stdx::optional<bsoncxx::document::value> _doc;
+
+    // Accumulates the values read, so that the reads cannot be optimized away.
+    std::uint64_t _sink;
+};
+
+void bson_element_access::setup() {
+    _doc = parse_json_file_to_documents(_json_file)[0];
+}
+
+void bson_element_access::access(bsoncxx::types::bson_value::view value) {
+    switch (value.type()) {
+        case bsoncxx::type::k_document:
+            for (auto&& element : value.get_document().value) {
+                access(element.get_value());
+            }
+            break;
+        case bsoncxx::type::k_array:
+            for (auto&& element : value.get_array().value) {
+                access(element.get_value());
+            }
+            break;
+        case bsoncxx::type::k_utf8:
+            _sink += value.get_string().value.size();
+            break;
+        case bsoncxx::type::k_int32:
+            _sink += static_cast<std::uint64_t>(value.get_int32().value);
+            break;
+        case bsoncxx::type::k_int64:
+            _sink += static_cast<std::uint64_t>(value.get_int64().value);
+            break;
+        case bsoncxx::type::k_double:
+            _sink += static_cast<std::uint64_t>(value.get_double().value);
+            break;
+        case bsoncxx::type::k_bool:
+            _sink += value.get_bool().value ? 1 : 0;
+            break;
+        case bsoncxx::type::k_binary:
+            _sink += value.get_binary().size;
+            break;
+        case bsoncxx::type::k_oid:
+            _sink += static_cast<std::uint8_t>(value.get_oid().value.bytes()[0]);
+            break;
+        default:
+            _sink += static_cast<std::uint64_t>(value.type());
+            break;
+    }
+}
+
+void bson_element_access::task() {
+    for (std::uint32_t i = 0; i < 10000; i++) {
+        access(bsoncxx::types::bson_value::view{bsoncxx::types::b_document{_doc->view()}});
+    }
+}
+}  // namespace benchmark
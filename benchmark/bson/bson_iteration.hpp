@@ -0,0 +1,82 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <bsoncxx/array/view.hpp>
+#include <bsoncxx/document/view.hpp>
+#include <bsoncxx/types.hpp>
+
+#include "../microbench.hpp"
+
+namespace benchmark {
+
+// Walks every element of a document, descending into subdocuments and arrays, and reads only the
+// key and type of each. This measures the cost of document::view and array::view iteration.
+class bson_iteration : public microbench {
+   public:
+    bson_iteration() = delete;
+
+    bson_iteration(std::string name, double task_size, std::string json_file)
+        : microbench{std::move(name),
+                     task_size,
+                     std::set<benchmark_type>{benchmark_type::bson_access_bench}},
+          _json_file{std::move(json_file)},
+          _key_bytes{0} {}
+
+   protected:
+    void setup();
+    void task();
+
+   private:
+    void iterate(bsoncxx::document::view doc);
+    void iterate(bsoncxx::array::view array);
+
+    std::string _json_file;
+    bsoncxx::stdx::optional<bsoncxx::document::value> _doc;
+    std::size_t _key_bytes;
+};
+
+void bson_iteration::setup() {
+    _doc = parse_json_file_to_documents(_json_file)[0];
+}
+
+void bson_iteration::iterate(bsoncxx::document::view doc) {
+    for (auto&& element : doc) {
+        _key_bytes += element.key().size();
+        if (element.type() == bsoncxx::type::k_document) {
+            iterate(element.get_document().value);
+        } else if (element.type() == bsoncxx::type::k_array) {
+            iterate(element.get_array().value);
+        }
+    }
+}
+
+void bson_iteration::iterate(bsoncxx::array::view array) {
+    for (auto&& element : array) {
+        _key_bytes += element.key().size();
+        if (element.type() == bsoncxx::type::k_document) {
+            iterate(element.get_document().value);
+        } else if (element.type() == bsoncxx::type::k_array) {
+            iterate(element.get_array().value);
+        }
+    }
+}
+
+void bson_iteration::task() {
+    for (std::uint32_t i = 0; i < 10000; i++) {
+        iterate(_doc->view());
+    }
+}
+}  // namespace benchmark
@@ -0,0 +1,82 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include <bsoncxx/document/view.hpp>
+#include <bsoncxx/string/to_string.hpp>
+#include <bsoncxx/types.hpp>
+
+#include "../microbench.hpp"
+
+namespace benchmark {
+
+// Looks up every key of a document and of each of its subdocuments by name, plus one key that is
+// not present in each. This measures document::view::operator[], which scans the document.
+class bson_key_lookup : public microbench {
+   public:
+    bson_key_lookup() = delete;
+
+    bson_key_lookup(std::string name, double task_size, std::string json_file)
+        : microbench{std::move(name),
+                     task_size,
+                     std::set<benchmark_type>{benchmark_type::bson_access_bench}},
+          _json_file{std::move(json_file)},
+          _found{0} {}
+
+   protected:
+    void setup();
+    void task();
+
+   private:
+    void collect_keys(bsoncxx::document::view doc);
+
+    std::string _json_file;
+    bsoncxx::stdx::optional<bsoncxx::document::value> _doc;
+
+    // Each (sub)document of `_doc` paired with a key to look up in it.
+    std::vector<std::pair<bsoncxx::document::view, std::string>> _lookups;
+
+    std::size_t _found;
+};
+
+void bson_key_lookup::setup() {
+    _doc = parse_json_file_to_documents(_json_file)[0];
+    _lookups.clear();
+    collect_keys(_doc->view());
+}
+
+void bson_key_lookup::collect_keys(bsoncxx::document::view doc) {
+    for (auto&& element : doc) {
+        _lookups.emplace_back(doc, bsoncxx::string::to_string(element.key()));
+        if (element.type() == bsoncxx::type::k_document) {
+            collect_keys(element.get_document().value);
+        }
+    }
+    _lookups.emplace_back(doc, "not a key of the document");
+}
+
+void bson_key_lookup::task() {
+    for (std::uint32_t i = 0; i < 10000; i++) {
+        for (auto&& lookup : _lookups) {
+            if (lookup.first[lookup.second]) {
+                ++_found;
+            }
+        }
+    }
+}
+}  // namespace benchmark
@@ -0,0 +1,100 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <string>
+
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/document/view.hpp>
+#include <bsoncxx/matcher.hpp>
+#include <bsoncxx/string/to_string.hpp>
+#include <bsoncxx/types.hpp>
+#include <bsoncxx/types/bson_value/view.hpp>
+
+#include "../microbench.hpp"
+
+namespace benchmark {
+
+// Matches a document against a filter with an equality predicate on the dotted path of each of its
+// scalar fields, including those of subdocuments, plus an $exists on a missing field. Arrays and
+// the types the matcher does not compare are skipped. Every predicate matches, so each evaluation
+// walks every path.
+class bson_match : public microbench {
+   public:
+    bson_match() = delete;
+
+    bson_match(std::string name, double task_size, std::string json_file)
+        : microbench{std::move(name),
+                     task_size,
+                     std::set<benchmark_type>{benchmark_type::bson_access_bench}},
+          _json_file{std::move(json_file)},
+          _matched{0} {}
+
+   protected:
+    void setup();
+    void task();
+
+   private:
+    void collect_paths(bsoncxx::document::view doc,
+                       const std::string& prefix,
+                       bsoncxx::builder::basic::document* filter);
+
+    std::string _json_file;
+    bsoncxx::stdx::optional<bsoncxx::document::value> _doc;
+    bsoncxx::stdx::optional<bsoncxx::matcher> _matcher;
+    std::size_t _matched;
+};
+
+void bson_match::setup() {
+    using bsoncxx::builder::basic::kvp;
+    using bsoncxx::builder::basic::make_document;
+
+    _doc = parse_json_file_to_documents(_json_file)[0];
+
+    bsoncxx::builder::basic::document filter;
+    collect_paths(_doc->view(), "", &filter);
+    filter.append(kvp("not a key of the document", make_document(kvp("$exists", false))));
+
+    _matcher.emplace(filter.view());
+}
+
+void bson_match::collect_paths(bsoncxx::document::view doc,
+                               const std::string& prefix,
+                               bsoncxx::builder::basic::document* filter) {
+    using bsoncxx::builder::basic::kvp;
+    using bsoncxx::builder::basic::make_document;
+
+    for (auto&& element : doc) {
+        const std::string path = prefix + bsoncxx::string::to_string(element.key());
+        if (element.type() == bsoncxx::type::k_document) {
+            collect_paths(element.get_document().value, path + ".", filter);
+        } else if (element.type() != bsoncxx::type::k_array &&
+                   element.type() != bsoncxx::type::k_regex &&
+                   element.type() != bsoncxx::type::k_codewscope &&
+                   element.type() != bsoncxx::type::k_dbpointer) {
+            filter->append(kvp(path, make_document(kvp("$eq", element.get_value()))));
+        }
+    }
+}
+
+void bson_match::task() {
+    for (std::uint32_t i = 0; i < 10000; i++) {
+        if (_matcher->matches(_doc->view())) {
+            ++_matched;
+        }
+    }
+}
+}  // namespace benchmark
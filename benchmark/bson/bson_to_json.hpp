@@ -0,0 +1,58 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <bsoncxx/json.hpp>
+
+#include "../microbench.hpp"
+
+namespace benchmark {
+
+// Converts a document to extended JSON in the given mode. The canonical mode is covered by
+// bson_decoding, which the spec defines.
+class bson_to_json : public microbench {
+   public:
+    bson_to_json() = delete;
+
+    bson_to_json(std::string name,
+                 double task_size,
+                 std::string json_file,
+                 bsoncxx::ExtendedJsonMode mode)
+        : microbench{std::move(name),
+                     task_size,
+                     std::set<benchmark_type>{benchmark_type::bson_access_bench}},
+          _json_file{std::move(json_file)},
+          _mode{mode} {}
+
+   protected:
+    void setup();
+    void task();
+
+   private:
+    std::string _json_file;
+    bsoncxx::ExtendedJsonMode _mode;
+    bsoncxx::stdx::optional<bsoncxx::document::value> _doc;
+};
+
+void bson_to_json::setup() {
+    _doc = parse_json_file_to_documents(_json_file)[0];
+}
+
+void bson_to_json::task() {
+    for (std::uint32_t i = 0; i < 10000; i++) {
+        bsoncxx::to_json(_doc->view(), _mode);
+    }
+}
+}  // namespace benchmark
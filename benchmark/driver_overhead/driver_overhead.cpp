@@ -0,0 +1,406 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// Benchmarks of the driver's own overhead. Every libmongoc call that would reach the network is
+// interposed through the MONGOCXX_TESTING mock layer, so no server is needed and the measured time
+// is spent building BSON, converting options and wrapping results in this library.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <bsoncxx/builder/basic/array.hpp>
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
+#include <bsoncxx/json.hpp>
+#include <bsoncxx/types.hpp>
+#include <bsoncxx/types/bson_value/view.hpp>
+#include <mongocxx/bulk_write.hpp>
+#include <mongocxx/client.hpp>
+#include <mongocxx/column_projection.hpp>
+#include <mongocxx/instance.hpp>
+#include <mongocxx/model/delete_one.hpp>
+#include <mongocxx/model/insert_one.hpp>
+#include <mongocxx/model/update_one.hpp>
+#include <mongocxx/options/bulk_write.hpp>
+#include <mongocxx/options/find.hpp>
+#include <mongocxx/prepared_find.hpp>
+#include <mongocxx/private/libmongoc.hh>
+#include <mongocxx/uri.hpp>
+
+#include <third_party/catch/include/helpers.hpp>
+
+#include "../report.hpp"
+
+namespace {
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_array;
+using bsoncxx::builder::basic::make_document;
+
+using namespace mongocxx;
+
+// The number of timed samples taken of each benchmark, unless --samples is given.
+const std::size_t default_sample_count = 200;
+
+// The number of documents returned by each mocked cursor.
+const std::size_t cursor_batch_size = 1000;
+
+// The number of models appended to each bulk write.
+const std::size_t bulk_write_size = 100;
+
+// The number of update models appended to the single bulk write of TestBulkAppendUpdates.
+const std::size_t bulk_append_size = 1000000;
+
+struct overhead_benchmark {
+    std::string name;
+
+    // The number of operations timed together as one sample.
+    std::size_t ops_per_sample;
+
+    // Runs the given number of operations.
+    std::function<void(std::size_t)> run;
+};
+
+struct overhead_result {
+    std::string name;
+    std::size_t ops_per_sample;
+
+    // The sample runtimes in nanoseconds per operation, in ascending order.
+    std::vector<double> ns_per_op;
+};
+
+overhead_result run_overhead_benchmark(const overhead_benchmark& bench, std::size_t sample_count) {
+    using clock = std::chrono::steady_clock;
+
+    // One untimed sample warms up the caches and the allocator.
+    bench.run(bench.ops_per_sample);
+
+    std::vector<double> ns_per_op;
+    ns_per_op.reserve(sample_count);
+
+    for (std::size_t i = 0; i < sample_count; ++i) {
+        auto start = clock::now();
+        bench.run(bench.ops_per_sample);
+        auto elapsed = std::chrono::duration<double, std::nano>(clock::now() - start);
+        ns_per_op.push_back(elapsed.count() / static_cast<double>(bench.ops_per_sample));
+    }
+
+    std::sort(ns_per_op.begin(), ns_per_op.end());
+    return overhead_result{bench.name, bench.ops_per_sample, std::move(ns_per_op)};
+}
+
+// The same per-benchmark figures as the microbenchmarks' --json report, in nanoseconds per
+// operation.
+void write_overhead_json(const std::vector<overhead_result>& results, std::ostream& out) {
+    bsoncxx::builder::basic::array benchmarks;
+
+    for (const auto& result : results) {
+        double total = 0;
+        for (double sample : result.ns_per_op) {
+            total += sample;
+        }
+
+        bsoncxx::builder::basic::document percentiles;
+        for (auto&& n : benchmark::reported_percentiles) {
+            percentiles.append(kvp("p" + std::to_string(n),
+                                   benchmark::nearest_rank_percentile(result.ns_per_op, n)));
+        }
+        percentiles.append(kvp("max", result.ns_per_op.back()));
+
+        benchmarks.append(make_document(
+            kvp("name", result.name),
+            kvp("iterations", static_cast<std::int64_t>(result.ns_per_op.size())),
+            kvp("ops_per_sample", static_cast<std::int64_t>(result.ops_per_sample)),
+            kvp("mean_ns_per_op", total / static_cast<double>(result.ns_per_op.size())),
+            kvp("percentiles_ns_per_op", percentiles.extract())));
+    }
+
+    out << bsoncxx::to_json(make_document(kvp("benchmarks", benchmarks.extract())),
+                            bsoncxx::ExtendedJsonMode::k_relaxed)
+        << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    std::set<std::string> requested;
+    std::string json_path;
+    std::size_t sample_count = default_sample_count;
+
+    for (int x = 1; x < argc; ++x) {
+        std::string arg{argv[x]};
+
+        if (arg == "--json" || arg == "--samples") {
+            std::string value;
+            if (!benchmark::read_option_value(argc, argv, &x, &value)) {
+                return 1;
+            }
+
+            if (arg == "--json") {
+                json_path = value;
+            } else {
+                sample_count = std::strtoul(value.c_str(), nullptr, 10);
+                if (sample_count == 0) {
+                    std::cerr << "Invalid sample count: " << value << std::endl;
+                    return 1;
+                }
+            }
+            continue;
+        }
+
+        requested.insert(arg);
+    }
+
+    instance inst{};
+
+    // Creating a client, database or collection handle does not contact the server, so these are
+    // the real libmongoc objects. Only the operations below are mocked.
+    client conn{uri{}};
+    collection coll = conn["perftest"]["corpus"];
+
+    // Mocks are active on the thread that creates them, so every benchmark runs on this thread.
+    auto collection_create_bulk_operation_with_opts =
+        libmongoc::collection_create_bulk_operation_with_opts.create_instance();
+    auto bulk_operation_insert_with_opts =
+        libmongoc::bulk_operation_insert_with_opts.create_instance();
+    auto bulk_operation_update_one_with_opts =
+        libmongoc::bulk_operation_update_one_with_opts.create_instance();
+    auto bulk_operation_remove_one_with_opts =
+        libmongoc::bulk_operation_remove_one_with_opts.create_instance();
+    auto bulk_operation_set_bypass_document_validation =
+        libmongoc::bulk_operation_set_bypass_document_validation.create_instance();
+    auto bulk_operation_execute = libmongoc::bulk_operation_execute.create_instance();
+    auto bulk_operation_destroy = libmongoc::bulk_operation_destroy.create_instance();
+    auto collection_find_with_opts = libmongoc::collection_find_with_opts.create_instance();
+    auto cursor_destroy = libmongoc::cursor_destroy.create_instance();
+
+    collection_create_bulk_operation_with_opts
+        ->interpose([](mongoc_collection_t*, const bson_t*) -> mongoc_bulk_operation_t* {
+            return nullptr;
+        })
+        .forever();
+    bulk_operation_insert_with_opts
+        ->interpose([](mongoc_bulk_operation_t*, const bson_t*, const bson_t*, bson_error_t*) {
+            return true;
+        })
+        .forever();
+    bulk_operation_update_one_with_opts
+        ->interpose([](mongoc_bulk_operation_t*,
+                       const bson_t*,
+                       const bson_t*,
+                       const bson_t*,
+                       bson_error_t*) { return true; })
+        .forever();
+    bulk_operation_remove_one_with_opts
+        ->interpose([](mongoc_bulk_operation_t*, const bson_t*, const bson_t*, bson_error_t*) {
+            return true;
+        })
+        .forever();
+    bulk_operation_set_bypass_document_validation
+        ->interpose([](mongoc_bulk_operation_t*, bool) {})
+        .forever();
+    bulk_operation_execute
+        ->interpose([](mongoc_bulk_operation_t*, bson_t* reply, bson_error_t*) {
+            // An empty reply means an unacknowledged write, which would skip building the result.
+            bson_init(reply);
+            bson_append_int32(reply, "nInserted", -1, 1);
+            return 1u;
+        })
+        .forever();
+    bulk_operation_destroy->interpose([](mongoc_bulk_operation_t*) {}).forever();
+
+    // Every find returns a batch of cursor_batch_size copies of the same document.
+    auto returned = make_document(kvp("_id", 1),
+                                  kvp("name", "overhead"),
+                                  kvp("count", 42),
+                                  kvp("tags", make_array("a", "b", "c")));
+    std::vector<bson_t> returned_bsons(cursor_batch_size);
+    for (auto&& returned_bson : returned_bsons) {
+        bson_init_static(&returned_bson, returned.view().data(), returned.view().length());
+    }
+
+    MOCK_CURSOR_DOCUMENTS(returned_bsons)
+
+    auto without_id = make_document(kvp("name", "overhead"), kvp("count", 42));
+    auto with_id = make_document(kvp("_id", 1), kvp("name", "overhead"), kvp("count", 42));
+    auto filter = make_document(kvp("count", make_document(kvp("$gt", 10))));
+    auto update = make_document(kvp("$inc", make_document(kvp("count", 1))));
+
+    // The same query shape as TestFindWithOptions, with the options and filter serialized once.
+    options::find prepared_options;
+    prepared_options.limit(10)
+        .batch_size(100)
+        .projection(make_document(kvp("name", 1), kvp("count", 1)))
+        .sort(make_document(kvp("count", -1)));
+    auto prepared = coll.prepare_find(filter.view(), {"count.$gt"}, prepared_options);
+
+    std::vector<overhead_benchmark> benchmarks{
+        // The cost of one call through the mock layer, which every other benchmark pays for each
+        // libmongoc function it calls. It bounds how much of their time is not the driver's own.
+        {"TestMockDispatch",
+         10000,
+         [&](std::size_t ops) {
+             bson_error_t error;
+             const bson_t* error_document;
+             for (std::size_t i = 0; i < ops; ++i) {
+                 libmongoc::cursor_error_document(
+                     reinterpret_cast<mongoc_cursor_t*>(&dummy_cursor), &error, &error_document);
+             }
+         }},
+        {"TestInsertOne",
+         1000,
+         [&](std::size_t ops) {
+             for (std::size_t i = 0; i < ops; ++i) {
+                 coll.insert_one(without_id.view());
+             }
+         }},
+        {"TestInsertOneWithId",
+         1000,
+         [&](std::size_t ops) {
+             for (std::size_t i = 0; i < ops; ++i) {
+                 coll.insert_one(with_id.view());
+             }
+         }},
+        {"TestFindWithOptions",
+         1000,
+         [&](std::size_t ops) {
+             for (std::size_t i = 0; i < ops; ++i) {
+                 options::find opts;
+                 opts.limit(10)
+                     .batch_size(100)
+                     .projection(make_document(kvp("name", 1), kvp("count", 1)))
+                     .sort(make_document(kvp("count", -1)));
+                 coll.find(filter.view(), opts);
+             }
+         }},
+        {"TestPreparedFind",
+         1000,
+         [&](std::size_t ops) {
+             for (std::size_t i = 0; i < ops; ++i) {
+                 prepared.bind(0, bsoncxx::types::bson_value::view{bsoncxx::types::b_int32{
+                                      static_cast<std::int32_t>(i)}});
+                 prepared.execute();
+             }
+         }},
+        // One operation is one model appended to the bulk write, including its share of option
+        // building and execution.
+        {"TestBulkWrite",
+         bulk_write_size * 10,
+         [&](std::size_t ops) {
+             for (std::size_t i = 0; i < ops / bulk_write_size; ++i) {
+                 options::bulk_write opts;
+                 opts.ordered(false).bypass_document_validation(true);
+
+                 auto bulk = coll.create_bulk_write(opts);
+                 for (std::size_t j = 0; j < bulk_write_size; j += 4) {
+                     bulk.append(model::insert_one{with_id.view()});
+                     bulk.append(model::insert_one{without_id.view()});
+                     bulk.append(model::update_one{filter.view(), update.view()}.upsert(true));
+                     bulk.append(model::delete_one{filter.view()});
+                 }
+                 bulk.execute();
+             }
+         }},
+        // One operation is one update model appended to a bulk write holding a million of them,
+        // half of which are upserts. Nothing is executed, so this isolates the cost of append.
+        {"TestBulkAppendUpdates",
+         bulk_append_size,
+         [&](std::size_t ops) {
+             auto bulk = coll.create_bulk_write();
+             for (std::size_t i = 0; i < ops; i += 2) {
+                 bulk.append(model::update_one{filter.view(), update.view()});
+                 bulk.append(model::update_one{filter.view(), update.view()}.upsert(true));
+             }
+         }},
+        // One operation is one document read from a cursor.
+        {"TestCursorIteration",
+         cursor_batch_size * 10,
+         [&](std::size_t ops) {
+             std::int64_t total = 0;
+             for (std::size_t i = 0; i < ops / cursor_batch_size; ++i) {
+                 for (auto&& doc : coll.find({})) {
+                     total += doc["count"].get_int32().value;
+                 }
+             }
+             if (total != static_cast<std::int64_t>(ops) * 42) {
+                 std::cerr << "Unexpected cursor contents" << std::endl;
+                 std::exit(1);
+             }
+         }},
+        // The same cursor as TestCursorIteration, with its fields extracted into columns in one
+        // pass per document instead of being looked up one at a time.
+        {"TestColumnProjection",
+         cursor_batch_size * 10,
+         [&](std::size_t ops) {
+             column_projection projection;
+             projection.add_field("count", bsoncxx::type::k_int64)
+                 .add_field("name", bsoncxx::type::k_utf8);
+
+             for (std::size_t i = 0; i < ops / cursor_batch_size; ++i) {
+                 auto cursor = coll.find({});
+                 projection.append(cursor);
+             }
+
+             std::int64_t total = 0;
+             for (auto count : projection.columns()[0].int64s()) {
+                 total += count;
+             }
+             if (total != static_cast<std::int64_t>(ops) * 42) {
+                 std::cerr << "Unexpected cursor contents" << std::endl;
+                 std::exit(1);
+             }
+         }},
+    };
+
+    std::vector<overhead_result> results;
+
+    for (const auto& bench : benchmarks) {
+        if (!requested.empty() && requested.count(bench.name) == 0) {
+            continue;
+        }
+
+        std::cerr << "Running " << bench.name << "..." << std::endl;
+        results.push_back(run_overhead_benchmark(bench, sample_count));
+    }
+
+    std::cout << std::fixed << std::setprecision(1);
+    for (const auto& result : results) {
+        std::cout << result.name << ":";
+        for (auto&& n : benchmark::reported_percentiles) {
+            std::cout << " " << benchmark::nearest_rank_percentile(result.ns_per_op, n)
+                      << " ns/op p" << n;
+        }
+        std::cout << std::endl;
+    }
+
+    if (!json_path.empty()) {
+        bool written = benchmark::write_report(
+            json_path, [&](std::ostream& out) { write_overhead_json(results, out); });
+        if (!written) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
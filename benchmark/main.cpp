@@ -12,34 +12,114 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <fstream>
 #include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+#include <bsoncxx/json.hpp>
 
 #include "benchmark_runner.hpp"
+#include "report.hpp"
 
 using namespace benchmark;
 
+namespace {
+
+// The relative slowdown of a median runtime above which --compare reports a statistically
+// significant slowdown as a regression, unless --threshold is given.
+const double default_regression_threshold = 0.05;
+
+// The exit status when --compare finds a regression.
+const int regression_exit_status = 2;
+
+}  // namespace
+
 int main(int argc, char* argv[]) {
     std::set<benchmark_type> types;
+    bool types_requested = false;
+    std::string json_path;
+    std::string csv_path;
+    std::string baseline_path;
+    double threshold = default_regression_threshold;
+
+    for (int x = 1; x < argc; ++x) {
+        std::string arg{argv[x]};
 
-    if (argc > 1) {
-        for (int x = 1; x < argc; ++x) {
-            std::string type{argv[x]};
-            auto it = names_types.find(type);
+        if (arg == "--json" || arg == "--csv" || arg == "--compare" || arg == "--threshold") {
+            std::string value;
+            if (!read_option_value(argc, argv, &x, &value)) {
+                return 1;
+            }
 
-            if (it != names_types.end()) {
-                types.insert(it->second);
+            if (arg == "--json") {
+                json_path = value;
+            } else if (arg == "--csv") {
+                csv_path = value;
+            } else if (arg == "--compare") {
+                baseline_path = value;
             } else {
-                std::cerr << "Invalid benchmark: " << type << std::endl;
+                try {
+                    threshold = std::stod(value) / 100.0;
+                } catch (const std::logic_error&) {
+                    std::cerr << "Invalid threshold percentage: " << value << std::endl;
+                    return 1;
+                }
             }
+            continue;
+        }
+
+        types_requested = true;
+        auto it = names_types.find(arg);
+
+        if (it != names_types.end()) {
+            types.insert(it->second);
+        } else {
+            std::cerr << "Invalid benchmark: " << arg << std::endl;
         }
+    }
+
+    if (types_requested && types.empty()) {
+        std::cerr << "No valid benchmarks specified. Exiting." << std::endl;
+        return 1;
+    }
 
-        if (types.empty()) {
-            std::cerr << "No valid benchmarks specified. Exiting." << std::endl;
+    // The baseline is read first, so that a bad path fails before the benchmarks run.
+    bsoncxx::stdx::optional<bsoncxx::document::value> baseline;
+    if (!baseline_path.empty()) {
+        std::ifstream stream{baseline_path};
+        if (!stream) {
+            std::cerr << "Failed to open baseline " << baseline_path << std::endl;
             return 1;
         }
+
+        std::string json{std::istreambuf_iterator<char>{stream}, std::istreambuf_iterator<char>{}};
+        baseline = bsoncxx::from_json(json);
     }
 
     benchmark_runner runner{types};
     runner.run_microbenches();
     runner.print_scores();
+
+    if (!json_path.empty()) {
+        bool written = write_report(json_path, [&](std::ostream& out) {
+            out << bsoncxx::to_json(runner.results(), bsoncxx::ExtendedJsonMode::k_relaxed)
+                << std::endl;
+        });
+        if (!written) {
+            return 1;
+        }
+    }
+
+    if (!csv_path.empty()) {
+        bool written = write_report(csv_path, [&](std::ostream& out) { runner.write_csv(out); });
+        if (!written) {
+            return 1;
+        }
+    }
+
+    if (baseline && runner.compare(baseline->view(), threshold) > 0) {
+        return regression_exit_status;
+    }
 }
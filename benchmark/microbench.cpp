@@ -21,8 +21,7 @@
 
 namespace benchmark {
 
-bool finished_running(const std::chrono::duration<std::uint32_t, std::milli>& curr_time,
-                      std::uint32_t iter) {
+bool finished_running(const std::chrono::microseconds& curr_time, std::uint32_t iter) {
     return (curr_time > maxtime || (curr_time > mintime && iter > MAX_ITER));
 }
 
@@ -35,6 +35,7 @@ enum benchmark_type {
     read_bench,
     write_bench,
     run_command_bench,
+    bson_access_bench,
 };
 
 const std::string type_names[] = {"BSONBench",
@@ -43,7 +44,8 @@ const std::string type_names[] = {"BSONBench",
                                   "ParallelBench",
                                   "ReadBench",
                                   "WriteBench",
-                                  "RunCommandBench"};
+                                  "RunCommandBench",
+                                  "BSONAccessBench"};
 
 const std::unordered_map<std::string, benchmark_type> names_types = {
     {"BSONBench", bson_bench},
@@ -52,7 +54,8 @@ const std::unordered_map<std::string, benchmark_type> names_types = {
     {"ParallelBench", parallel_bench},
     {"ReadBench", read_bench},
     {"WriteBench", write_bench},
-    {"RunCommandBench", run_command_bench}};
+    {"RunCommandBench", run_command_bench},
+    {"BSONAccessBench", bson_access_bench}};
 
 const std::chrono::milliseconds mintime{60000};
 const std::chrono::milliseconds maxtime{300000};
@@ -16,29 +16,38 @@
 
 #include "../microbench.hpp"
 
+#include <memory>
 #include <vector>
 
+#include <bsoncxx/stdx/make_unique.hpp>
 #include <bsoncxx/string/to_string.hpp>
 #include <mongocxx/client.hpp>
 #include <mongocxx/gridfs/bucket.hpp>
 #include <mongocxx/instance.hpp>
+#include <mongocxx/options/gridfs/upload.hpp>
+#include <mongocxx/pool.hpp>
 #include <mongocxx/uri.hpp>
 
 namespace benchmark {
 
 using bsoncxx::builder::basic::kvp;
 using bsoncxx::builder::basic::make_document;
+using bsoncxx::stdx::make_unique;
 
 class gridfs_upload : public microbench {
    public:
     // The task size comes from the Driver Perfomance Benchmarking Reference Doc.
-    gridfs_upload(std::string file_name)
-        : microbench{"TestGridFsUpload",
+    //
+    // With a concurrency greater than 1, chunk batches are inserted through a pool with up to that
+    // many batches in flight at once.
+    gridfs_upload(std::string file_name, std::int32_t concurrency = 1)
+        : microbench{concurrency > 1 ? "TestGridFsUploadConcurrent" : "TestGridFsUpload",
                      52.43,
                      std::set<benchmark_type>{benchmark_type::multi_bench,
                                               benchmark_type::write_bench}},
           _conn{mongocxx::uri{}},
-          _file_name{file_name} {}
+          _file_name{file_name},
+          _concurrency{concurrency} {}
 
     void setup();
 
@@ -54,6 +63,8 @@ class gridfs_upload : public microbench {
     mongocxx::gridfs::bucket _bucket;
     std::vector<std::uint8_t> _gridfs_file;
     std::string _file_name;
+    std::int32_t _concurrency;
+    std::unique_ptr<mongocxx::pool> _pool;
 };
 
 void gridfs_upload::setup() {
@@ -64,6 +75,10 @@ void gridfs_upload::setup() {
 
     mongocxx::database db = _conn["perftest"];
     db.drop();
+
+    if (_concurrency > 1) {
+        _pool = make_unique<mongocxx::pool>(mongocxx::uri{});
+    }
 }
 
 void gridfs_upload::before_task() {
@@ -82,7 +97,12 @@ void gridfs_upload::teardown() {
 }
 
 void gridfs_upload::task() {
-    auto uploader = _bucket.open_upload_stream("actual_file");
+    mongocxx::options::gridfs::upload options;
+    if (_pool) {
+        options.pool(_pool.get()).concurrency(_concurrency);
+    }
+
+    auto uploader = _bucket.open_upload_stream("actual_file", options);
     uploader.write(_gridfs_file.data(), _gridfs_file.size());
     uploader.close();
 }
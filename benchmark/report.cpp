@@ -0,0 +1,49 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "report.hpp"
+
+#include <fstream>
+#include <iostream>
+
+namespace benchmark {
+
+bool read_option_value(int argc, char* argv[], int* x, std::string* value) {
+    if (*x + 1 == argc) {
+        std::cerr << "Missing value for " << argv[*x] << std::endl;
+        return false;
+    }
+
+    *value = argv[++*x];
+    return true;
+}
+
+bool write_report(const std::string& path, const std::function<void(std::ostream&)>& write) {
+    std::ofstream out{path};
+    if (!out.is_open()) {
+        std::cerr << "Could not open " << path << " for writing" << std::endl;
+        return false;
+    }
+
+    write(out);
+    out.close();
+
+    if (!out) {
+        std::cerr << "Could not write " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+}  // namespace benchmark
@@ -0,0 +1,67 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace benchmark {
+
+// The percentiles of the sample runtimes that are reported, besides the maximum.
+const unsigned long reported_percentiles[] = {50, 90, 99};
+
+//
+// Gets the nth percentile of samples sorted in ascending order, using the nearest-rank method.
+//
+// @return
+//   The smallest sample that is at least n percent of the samples.
+//
+// @exception
+//   A runtime error is thrown if there are no samples.
+//
+template <typename T>
+const T& nearest_rank_percentile(const std::vector<T>& sorted_samples, unsigned long n) {
+    if (sorted_samples.empty()) {
+        throw std::runtime_error("No samples recorded yet");
+    }
+
+    std::size_t rank = (sorted_samples.size() * n + 99) / 100;
+    return sorted_samples[std::min(std::max<std::size_t>(rank, 1), sorted_samples.size()) - 1];
+}
+
+//
+// Reads the value that follows the command line option at argv[*x], and advances *x to it.
+//
+// @return
+//   true if the option has a value. Otherwise, an error naming the option has been printed to
+//   std::cerr.
+//
+bool read_option_value(int argc, char* argv[], int* x, std::string* value);
+
+//
+// Writes a report to the file at the given path, replacing its contents.
+//
+// @return
+//   true if the report was written. Otherwise, an error naming the file has been printed to
+//   std::cerr.
+//
+bool write_report(const std::string& path, const std::function<void(std::ostream&)>& write);
+
+}  // namespace benchmark
@@ -0,0 +1,292 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// Benchmarks of how the driver scales with the number of threads sharing it. Each operation is run
+// on 1, 2, 4, ... threads at once, and the throughput and tail latency at each thread count expose
+// contention on state that the threads share.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <bsoncxx/builder/basic/array.hpp>
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
+#include <bsoncxx/json.hpp>
+#include <bsoncxx/oid.hpp>
+#include <mongocxx/client.hpp>
+#include <mongocxx/instance.hpp>
+#include <mongocxx/options/find.hpp>
+#include <mongocxx/pool.hpp>
+#include <mongocxx/uri.hpp>
+
+#include "../report.hpp"
+
+namespace {
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_document;
+
+// How long each thread count runs, unless --duration is given.
+const std::chrono::milliseconds default_duration{2000};
+
+struct scaling_benchmark {
+    std::string name;
+
+    // The number of operations timed together as one latency sample. Operations much cheaper than
+    // reading the clock are batched, and their latency is the mean over the batch.
+    std::size_t ops_per_sample;
+
+    // Whether the operation talks to the server given with --uri.
+    bool needs_server;
+
+    // Runs one operation.
+    std::function<void()> op;
+};
+
+struct scaling_result {
+    std::size_t threads;
+    double ops_per_sec;
+    double p50_us;
+    double p99_us;
+};
+
+// Runs the benchmark on the given number of threads for the given duration.
+scaling_result run_at_thread_count(const scaling_benchmark& bench,
+                                   std::size_t thread_count,
+                                   std::chrono::milliseconds duration) {
+    using clock = std::chrono::steady_clock;
+
+    std::mutex lock;
+    std::condition_variable started;
+    bool go = false;
+    std::atomic<bool> stop{false};
+
+    std::vector<std::vector<double>> latencies(thread_count);
+    std::vector<std::uint64_t> op_counts(thread_count);
+    std::vector<std::thread> threads;
+
+    for (std::size_t t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&, t] {
+            {
+                std::unique_lock<std::mutex> guard{lock};
+                started.wait(guard, [&] { return go; });
+            }
+
+            auto& samples = latencies[t];
+            while (!stop.load(std::memory_order_relaxed)) {
+                auto start = clock::now();
+                for (std::size_t i = 0; i < bench.ops_per_sample; ++i) {
+                    bench.op();
+                }
+                auto elapsed = std::chrono::duration<double, std::micro>(clock::now() - start);
+                samples.push_back(elapsed.count() / static_cast<double>(bench.ops_per_sample));
+            }
+            op_counts[t] = samples.size() * bench.ops_per_sample;
+        });
+    }
+
+    auto start = clock::now();
+    {
+        std::lock_guard<std::mutex> guard{lock};
+        go = true;
+    }
+    started.notify_all();
+
+    std::this_thread::sleep_for(duration);
+    stop = true;
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    auto elapsed = std::chrono::duration<double>(clock::now() - start);
+
+    std::vector<double> all;
+    std::uint64_t total_ops = 0;
+    for (std::size_t t = 0; t < thread_count; ++t) {
+        all.insert(all.end(), latencies[t].begin(), latencies[t].end());
+        total_ops += op_counts[t];
+    }
+    std::sort(all.begin(), all.end());
+
+    // Nothing is recorded if no thread got to run before the duration ended.
+    auto percentile = [&](unsigned long n) {
+        return all.empty() ? 0.0 : benchmark::nearest_rank_percentile(all, n);
+    };
+
+    return scaling_result{thread_count,
+                          static_cast<double>(total_ops) / elapsed.count(),
+                          percentile(50),
+                          percentile(99)};
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    std::set<std::string> requested;
+    std::string uri_string;
+    std::string json_path;
+    std::size_t max_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    std::chrono::milliseconds duration = default_duration;
+
+    for (int x = 1; x < argc; ++x) {
+        std::string arg{argv[x]};
+
+        if (arg == "--uri" || arg == "--json" || arg == "--max-threads" || arg == "--duration") {
+            std::string value;
+            if (!benchmark::read_option_value(argc, argv, &x, &value)) {
+                return 1;
+            }
+
+            if (arg == "--uri") {
+                uri_string = value;
+            } else if (arg == "--json") {
+                json_path = value;
+            } else if (arg == "--max-threads") {
+                max_threads = std::strtoul(value.c_str(), nullptr, 10);
+                if (max_threads == 0) {
+                    std::cerr << "Invalid thread count: " << value << std::endl;
+                    return 1;
+                }
+            } else {
+                duration = std::chrono::milliseconds{std::strtoul(value.c_str(), nullptr, 10)};
+                if (duration.count() == 0) {
+                    std::cerr << "Invalid duration: " << value << std::endl;
+                    return 1;
+                }
+            }
+            continue;
+        }
+
+        requested.insert(arg);
+    }
+
+    mongocxx::instance inst{};
+
+    // Without --uri, no operation below contacts a server, so the default URI is only parsed.
+    const bool have_server = !uri_string.empty();
+    mongocxx::uri shared_uri{have_server ? uri_string : mongocxx::uri::k_default_uri};
+    mongocxx::pool shared_pool{mongocxx::uri{shared_uri.to_string()}};
+
+    mongocxx::options::find shared_find_options;
+    shared_find_options.limit(10)
+        .projection(make_document(kvp("name", 1), kvp("count", 1)))
+        .sort(make_document(kvp("count", -1)));
+
+    auto seeded_id = bsoncxx::oid{};
+    auto seeded_filter = make_document(kvp("_id", seeded_id));
+    auto inserted = make_document(kvp("name", "scaling"), kvp("count", 42));
+
+    if (have_server) {
+        auto entry = shared_pool.acquire();
+        auto coll = (*entry)["perftest"]["scaling"];
+        coll.drop();
+        coll.insert_one(make_document(kvp("_id", seeded_id), kvp("name", "scaling")));
+    }
+
+    std::vector<scaling_benchmark> benchmarks{
+        {"TestOidGeneration", 100, false, [] { bsoncxx::oid{}; }},
+        {"TestInstanceCurrent", 100, false, [] { mongocxx::instance::current(); }},
+        {"TestSharedUriRead",
+         10,
+         false,
+         [&] {
+             shared_uri.hosts();
+             shared_uri.read_preference();
+         }},
+        {"TestSharedOptionsCopy",
+         10,
+         false,
+         [&] { mongocxx::options::find copy{shared_find_options}; }},
+        {"TestPoolAcquire", 1, false, [&] { shared_pool.acquire(); }},
+        {"TestPooledFindOne",
+         1,
+         true,
+         [&] {
+             auto entry = shared_pool.acquire();
+             (*entry)["perftest"]["scaling"].find_one(seeded_filter.view());
+         }},
+        {"TestPooledInsertOne",
+         1,
+         true,
+         [&] {
+             auto entry = shared_pool.acquire();
+             (*entry)["perftest"]["scaling"].insert_one(inserted.view());
+         }},
+    };
+
+    bsoncxx::builder::basic::array json_results;
+
+    std::cout << std::fixed << std::setprecision(2);
+    for (const auto& bench : benchmarks) {
+        if (!requested.empty() && requested.count(bench.name) == 0) {
+            continue;
+        }
+        if (bench.needs_server && !have_server) {
+            std::cerr << "Skipping " << bench.name << ", which needs --uri" << std::endl;
+            continue;
+        }
+
+        std::cout << bench.name << std::endl;
+        bsoncxx::builder::basic::array thread_counts;
+
+        for (std::size_t threads = 1;; threads = std::min(threads * 2, max_threads)) {
+            auto result = run_at_thread_count(bench, threads, duration);
+
+            std::cout << "  " << std::setw(4) << result.threads << " threads: " << std::setw(14)
+                      << result.ops_per_sec << " ops/sec, p50 " << result.p50_us << " us, p99 "
+                      << result.p99_us << " us" << std::endl;
+
+            thread_counts.append(
+                make_document(kvp("threads", static_cast<std::int64_t>(result.threads)),
+                              kvp("ops_per_sec", result.ops_per_sec),
+                              kvp("p50_us", result.p50_us),
+                              kvp("p99_us", result.p99_us)));
+
+            if (threads == max_threads) {
+                break;
+            }
+        }
+
+        json_results.append(
+            make_document(kvp("name", bench.name),
+                          kvp("ops_per_sample", static_cast<std::int64_t>(bench.ops_per_sample)),
+                          kvp("results", thread_counts.extract())));
+    }
+
+    if (!json_path.empty()) {
+        bool written = benchmark::write_report(json_path, [&](std::ostream& out) {
+            out << bsoncxx::to_json(make_document(kvp("benchmarks", json_results.extract())),
+                                    bsoncxx::ExtendedJsonMode::k_relaxed)
+                << std::endl;
+        });
+        if (!written) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -15,17 +15,28 @@
 #include "score_recorder.hpp"
 
 #include <algorithm>
+#include <cmath>
 #include <stdexcept>
 
+#include "report.hpp"
+
 namespace benchmark {
 
 score_recorder::score_recorder(double task_size)
     : _execution_time{0}, _sorted{false}, _task_size{task_size} {}
 
-const std::chrono::milliseconds& score_recorder::get_execution_time() const {
+const std::chrono::microseconds& score_recorder::get_execution_time() const {
     return _execution_time;
 }
 
+std::size_t score_recorder::get_sample_count() const {
+    return _samples.size();
+}
+
+double score_recorder::get_task_size() const {
+    return _task_size;
+}
+
 void benchmark::score_recorder::start_sample() {
     _last_start = std::chrono::high_resolution_clock::now();
 }
@@ -33,32 +44,48 @@ void benchmark::score_recorder::start_sample() {
 void score_recorder::end_sample() {
     std::chrono::time_point<std::chrono::high_resolution_clock> end =
         std::chrono::high_resolution_clock::now();
-    std::chrono::milliseconds duration =
-        std::chrono::duration_cast<std::chrono::milliseconds>(end - _last_start);
+    std::chrono::microseconds duration =
+        std::chrono::duration_cast<std::chrono::microseconds>(end - _last_start);
 
     _samples.push_back(duration);
     _sorted = false;
     _execution_time += duration;
 }
 
-const std::chrono::milliseconds& score_recorder::get_percentile(unsigned long n) {
+const std::chrono::microseconds& score_recorder::get_percentile(unsigned long n) {
+    if (!_sorted) {
+        std::sort(_samples.begin(), _samples.end());
+        _sorted = true;
+    }
+
+    return nearest_rank_percentile(_samples, n);
+}
+
+double score_recorder::get_mean() const {
     if (_samples.empty()) {
         throw std::runtime_error("No samples recorded yet");
     }
 
-    if (!_sorted) {
-        std::sort(_samples.begin(), _samples.end());
-        _sorted = true;
+    return static_cast<double>(_execution_time.count()) / static_cast<double>(_samples.size());
+}
+
+double score_recorder::get_standard_deviation() const {
+    const double mean = get_mean();
+
+    if (_samples.size() < 2) {
+        return 0.0;
     }
 
-    if (_samples.size() == 1) {
-        return _samples[0];
+    double sum_of_squares = 0.0;
+    for (auto&& sample : _samples) {
+        const double deviation = static_cast<double>(sample.count()) - mean;
+        sum_of_squares += deviation * deviation;
     }
 
-    return _samples[(_samples.size() * n / 100) - 1];
+    return std::sqrt(sum_of_squares / static_cast<double>(_samples.size() - 1));
 }
 
 double score_recorder::get_score() {
-    return _task_size / (static_cast<double>(get_percentile(50).count()) * .001);
+    return _task_size / (static_cast<double>(get_percentile(50).count()) * .000001);
 }
 }  // namespace benchmark
@@ -15,6 +15,7 @@
 #pragma once
 
 #include <chrono>
+#include <cstddef>
 #include <ctime>
 #include <vector>
 
@@ -44,10 +45,26 @@ class score_recorder {
     // @return
     //  The cumulative execution time.
     //
-    const std::chrono::milliseconds& get_execution_time() const;
+    const std::chrono::microseconds& get_execution_time() const;
 
     //
-    // Gets the nth percentile sample runtime.
+    // Returns the number of samples that have been run.
+    //
+    // @return
+    //  The number of samples.
+    //
+    std::size_t get_sample_count() const;
+
+    //
+    // Returns the amount of data, in MB, that a single sample processes.
+    //
+    // @return
+    //  The task size in MB.
+    //
+    double get_task_size() const;
+
+    //
+    // Gets the nth percentile sample runtime, using the nearest-rank method.
     //
     // @return
     //   The "nth" percentile recorded sample time.
@@ -58,7 +75,24 @@ class score_recorder {
     // @note
     //   This method should only be called after all samples are completed.
     //
-    const std::chrono::milliseconds& get_percentile(unsigned long n);
+    const std::chrono::microseconds& get_percentile(unsigned long n);
+
+    //
+    // Gets the mean sample runtime in microseconds.
+    //
+    // @exception
+    //   A runtime error is thrown if this method is called before any samples have been recorded.
+    //
+    double get_mean() const;
+
+    //
+    // Gets the sample standard deviation of the sample runtimes in microseconds, or 0 if fewer
+    // than two samples have been recorded.
+    //
+    // @exception
+    //   A runtime error is thrown if this method is called before any samples have been recorded.
+    //
+    double get_standard_deviation() const;
 
     //
     // Gets the score for this benchmark.
@@ -77,12 +111,12 @@ class score_recorder {
    private:
     std::chrono::time_point<std::chrono::high_resolution_clock> _last_start;
 
-    std::chrono::milliseconds _execution_time;
+    std::chrono::microseconds _execution_time;
 
     bool _sorted;
 
     double _task_size;
 
-    std::vector<std::chrono::milliseconds> _samples;
+    std::vector<std::chrono::microseconds> _samples;
 };
 }  // namespace benchmark
\ No newline at end of file
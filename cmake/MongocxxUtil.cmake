@@ -28,7 +28,10 @@ function(mongocxx_add_library TARGET OUTPUT_NAME LINK_TYPE)
         target_compile_definitions(${TARGET} PUBLIC MONGOCXX_STATIC)
     endif()
 
-    target_link_libraries(${TARGET} PRIVATE ${libmongoc_target})
+    target_link_libraries(${TARGET} PRIVATE ${libmongoc_target} Threads::Threads)
+    if(MONGOCXX_ENABLE_ZLIB_CHUNK_CODEC)
+        target_link_libraries(${TARGET} PRIVATE ZLIB::ZLIB)
+    endif()
     target_include_directories(${TARGET} PRIVATE ${libmongoc_include_directories})
     target_include_directories(
         ${TARGET}
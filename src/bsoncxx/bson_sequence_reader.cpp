@@ -0,0 +1,293 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <bsoncxx/bson_sequence_reader.hpp>
+
+#include <cerrno>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <bsoncxx/exception/error_code.hpp>
+#include <bsoncxx/exception/exception.hpp>
+#include <bsoncxx/private/bson_sequence.hh>
+#include <bsoncxx/stdx/make_unique.hpp>
+#include <bsoncxx/string/to_string.hpp>
+#include <bsoncxx/validate.hpp>
+
+#include <bsoncxx/config/private/prelude.hh>
+
+namespace bsoncxx {
+BSONCXX_INLINE_NAMESPACE_BEGIN
+
+namespace {
+
+[[noreturn]] void throw_invalid(std::size_t offset) {
+    throw exception{error_code::k_invalid_bson_sequence,
+                    "invalid document at offset " + std::to_string(offset)};
+}
+
+#if defined(_WIN32)
+[[noreturn]] void throw_last_error(const std::string& what) {
+    throw exception{std::error_code{static_cast<int>(::GetLastError()), std::system_category()},
+                    what};
+}
+#else
+[[noreturn]] void throw_errno(const std::string& what) {
+    throw exception{std::error_code{errno, std::system_category()}, what};
+}
+#endif
+
+}  // namespace
+
+class bson_sequence_reader::impl {
+   public:
+    impl(const std::uint8_t* data, std::size_t length) : data{data}, length{length} {}
+
+    explicit impl(const std::string& path) {
+#if defined(_WIN32)
+        HANDLE file = ::CreateFileA(path.c_str(),
+                                    GENERIC_READ,
+                                    FILE_SHARE_READ,
+                                    nullptr,
+                                    OPEN_EXISTING,
+                                    FILE_FLAG_SEQUENTIAL_SCAN,
+                                    nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            throw_last_error("could not open BSON sequence file " + path);
+        }
+
+        LARGE_INTEGER size;
+        if (!::GetFileSizeEx(file, &size)) {
+            ::CloseHandle(file);
+            throw_last_error("could not read the size of BSON sequence file " + path);
+        }
+        length = static_cast<std::size_t>(size.QuadPart);
+
+        // A zero-length file cannot be mapped, and holds no documents anyway.
+        if (length > 0) {
+            HANDLE file_mapping =
+                ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (!file_mapping) {
+                ::CloseHandle(file);
+                throw_last_error("could not map BSON sequence file " + path);
+            }
+
+            // The view keeps the mapping and the file open once their handles are closed.
+            mapping = ::MapViewOfFile(file_mapping, FILE_MAP_READ, 0, 0, 0);
+            ::CloseHandle(file_mapping);
+            if (!mapping) {
+                ::CloseHandle(file);
+                throw_last_error("could not map BSON sequence file " + path);
+            }
+            data = static_cast<const std::uint8_t*>(mapping);
+        }
+        ::CloseHandle(file);
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw_errno("could not open BSON sequence file " + path);
+        }
+
+        struct stat status;
+        if (::fstat(fd, &status) != 0) {
+            int err = errno;
+            ::close(fd);
+            errno = err;
+            throw_errno("could not read the size of BSON sequence file " + path);
+        }
+        length = static_cast<std::size_t>(status.st_size);
+
+        // A zero-length file cannot be mapped, and holds no documents anyway.
+        if (length > 0) {
+            mapping = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping == MAP_FAILED) {
+                mapping = nullptr;
+                int err = errno;
+                ::close(fd);
+                errno = err;
+                throw_errno("could not map BSON sequence file " + path);
+            }
+            data = static_cast<const std::uint8_t*>(mapping);
+
+            // Sequences are mostly read front to back, so ask for aggressive read-ahead.
+            ::madvise(mapping, length, MADV_SEQUENTIAL);
+        }
+        ::close(fd);
+#endif
+    }
+
+    ~impl() {
+        if (!mapping) {
+            return;
+        }
+#if defined(_WIN32)
+        ::UnmapViewOfFile(mapping);
+#else
+        ::munmap(mapping, length);
+#endif
+    }
+
+    impl(const impl&) = delete;
+    impl& operator=(const impl&) = delete;
+
+    const std::uint8_t* data = nullptr;
+    std::size_t length = 0;
+    void* mapping = nullptr;
+
+    bool indexed = false;
+    std::vector<std::size_t> index;
+};
+
+bson_sequence_reader::bson_sequence_reader(stdx::string_view path)
+    : _impl{stdx::make_unique<impl>(string::to_string(path))} {}
+
+bson_sequence_reader::bson_sequence_reader(const std::uint8_t* data, std::size_t length)
+    : _impl{stdx::make_unique<impl>(data, length)} {}
+
+bson_sequence_reader::bson_sequence_reader(bson_sequence_reader&&) noexcept = default;
+bson_sequence_reader& bson_sequence_reader::operator=(bson_sequence_reader&&) noexcept = default;
+bson_sequence_reader::~bson_sequence_reader() = default;
+
+bson_sequence_reader::const_iterator bson_sequence_reader::begin() const {
+    return const_iterator{_impl->data, _impl->data, _impl->data + _impl->length};
+}
+
+bson_sequence_reader::const_iterator bson_sequence_reader::end() const {
+    const std::uint8_t* end = _impl->data + _impl->length;
+    return const_iterator{_impl->data, end, end};
+}
+
+const std::uint8_t* bson_sequence_reader::data() const {
+    return _impl->data;
+}
+
+std::size_t bson_sequence_reader::length() const {
+    return _impl->length;
+}
+
+void bson_sequence_reader::validate() const {
+    validate(validator{});
+}
+
+void bson_sequence_reader::validate(const validator& validator) const {
+    for (auto it = begin(); it != end(); ++it) {
+        if (!bsoncxx::validate(it->data(), it->length(), validator)) {
+            throw_invalid(it.offset());
+        }
+    }
+}
+
+void bson_sequence_reader::build_index() {
+    std::vector<std::size_t> index;
+    for (auto it = begin(); it != end(); ++it) {
+        index.push_back(it.offset());
+    }
+
+    _impl->index = std::move(index);
+    _impl->indexed = true;
+}
+
+std::size_t bson_sequence_reader::size() const {
+    if (!_impl->indexed) {
+        throw exception{error_code::k_bson_sequence_not_indexed};
+    }
+    return _impl->index.size();
+}
+
+document::view bson_sequence_reader::operator[](std::size_t index) const {
+    if (index >= size()) {
+        throw exception{error_code::k_invalid_bson_sequence,
+                        "no document at position " + std::to_string(index)};
+    }
+
+    // The length was checked when the index was built.
+    const std::size_t offset = _impl->index[index];
+    return document::view{_impl->data + offset,
+                          bson_sequence::length_prefix(_impl->data + offset)};
+}
+
+bson_sequence_reader::const_iterator::const_iterator()
+    : _begin{nullptr}, _current{nullptr}, _end{nullptr} {}
+
+bson_sequence_reader::const_iterator::const_iterator(const std::uint8_t* begin,
+                                                     const std::uint8_t* current,
+                                                     const std::uint8_t* end)
+    : _begin{begin}, _current{current}, _end{end} {
+    read();
+}
+
+void bson_sequence_reader::const_iterator::read() {
+    if (_current == _end) {
+        _document = document::view{};
+        return;
+    }
+
+    const std::size_t length =
+        bson_sequence::document_length(_current, static_cast<std::size_t>(_end - _current));
+    if (length == 0) {
+        throw_invalid(offset());
+    }
+
+    _document = document::view{_current, length};
+}
+
+bson_sequence_reader::const_iterator::reference bson_sequence_reader::const_iterator::operator*()
+    const {
+    return _document;
+}
+
+bson_sequence_reader::const_iterator::pointer bson_sequence_reader::const_iterator::operator->()
+    const {
+    return &_document;
+}
+
+bson_sequence_reader::const_iterator& bson_sequence_reader::const_iterator::operator++() {
+    _current += _document.length();
+    read();
+    return *this;
+}
+
+bson_sequence_reader::const_iterator bson_sequence_reader::const_iterator::operator++(int) {
+    const_iterator before{*this};
+    ++(*this);
+    return before;
+}
+
+std::size_t bson_sequence_reader::const_iterator::offset() const {
+    return static_cast<std::size_t>(_current - _begin);
+}
+
+bool BSONCXX_CALL operator==(const bson_sequence_reader::const_iterator& lhs,
+                             const bson_sequence_reader::const_iterator& rhs) {
+    return lhs._current == rhs._current;
+}
+
+bool BSONCXX_CALL operator!=(const bson_sequence_reader::const_iterator& lhs,
+                             const bson_sequence_reader::const_iterator& rhs) {
+    return !(lhs == rhs);
+}
+
+BSONCXX_INLINE_NAMESPACE_END
+}  // namespace bsoncxx
@@ -0,0 +1,194 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+
+#include <bsoncxx/document/view.hpp>
+#include <bsoncxx/stdx/string_view.hpp>
+
+#include <bsoncxx/config/prelude.hpp>
+
+namespace bsoncxx {
+BSONCXX_INLINE_NAMESPACE_BEGIN
+
+class validator;
+
+///
+/// Reads a BSON sequence: concatenated BSON documents with nothing between them, the format of
+/// mongodump's .bson files. The documents are read in place from a memory-mapped file or from a
+/// caller's buffer, so iterating them copies nothing.
+///
+/// Iteration only checks that each document's length prefix stays within the sequence. Call
+/// validate() first to check the contents of every document, and build_index() to access the
+/// documents by position.
+///
+class BSONCXX_API bson_sequence_reader {
+   public:
+    class const_iterator;
+
+    ///
+    /// Memory-maps a file for reading.
+    ///
+    /// @param path
+    ///   The path of the file.
+    ///
+    /// @throws bsoncxx::exception if the file cannot be opened or mapped.
+    ///
+    explicit bson_sequence_reader(stdx::string_view path);
+
+    ///
+    /// Reads a sequence held in memory. The memory must outlive the reader.
+    ///
+    /// @param data
+    ///   The first byte of the first document.
+    /// @param length
+    ///   The total length of the sequence in bytes.
+    ///
+    bson_sequence_reader(const std::uint8_t* data, std::size_t length);
+
+    bson_sequence_reader(bson_sequence_reader&&) noexcept;
+    bson_sequence_reader& operator=(bson_sequence_reader&&) noexcept;
+
+    ///
+    /// Unmaps the file, if the reader mapped one. Views obtained from the reader become invalid.
+    ///
+    ~bson_sequence_reader();
+
+    ///
+    /// @return An iterator to the first document of the sequence.
+    ///
+    /// @throws bsoncxx::exception if the first document is truncated.
+    ///
+    const_iterator begin() const;
+
+    ///
+    /// @return An iterator past the last document of the sequence.
+    ///
+    const_iterator end() const;
+
+    ///
+    /// @return The first byte of the sequence, for passing the whole sequence on, e.g. to
+    /// mongocxx::collection::insert_many.
+    ///
+    const std::uint8_t* data() const;
+
+    ///
+    /// @return The total length of the sequence in bytes.
+    ///
+    std::size_t length() const;
+
+    ///
+    /// Checks the structure of every document of the sequence.
+    ///
+    /// @throws bsoncxx::exception with error_code::k_invalid_bson_sequence, naming the offset of
+    /// the invalid document, if any document is invalid.
+    ///
+    void validate() const;
+
+    ///
+    /// Validates every document of the sequence.
+    ///
+    /// @param validator
+    ///   The checks to perform on each document.
+    ///
+    /// @throws bsoncxx::exception with error_code::k_invalid_bson_sequence, naming the offset of
+    /// the invalid document, if any document fails validation.
+    ///
+    void validate(const validator& validator) const;
+
+    ///
+    /// Records the offset of every document so that they can be accessed by position. An index
+    /// takes eight bytes per document.
+    ///
+    /// @throws bsoncxx::exception if a document is truncated.
+    ///
+    void build_index();
+
+    ///
+    /// @return The number of documents in the sequence.
+    ///
+    /// @throws bsoncxx::exception if build_index() has not been called.
+    ///
+    std::size_t size() const;
+
+    ///
+    /// @return The document at the given position.
+    ///
+    /// @throws bsoncxx::exception if build_index() has not been called or the position is out of
+    /// range.
+    ///
+    document::view operator[](std::size_t index) const;
+
+   private:
+    class BSONCXX_PRIVATE impl;
+    std::unique_ptr<impl> _impl;
+};
+
+///
+/// A forward iterator over the documents of a bson_sequence_reader.
+///
+class BSONCXX_API bson_sequence_reader::const_iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = document::view;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const document::view*;
+    using reference = const document::view&;
+
+    const_iterator();
+
+    reference operator*() const;
+    pointer operator->() const;
+
+    ///
+    /// Advances to the next document.
+    ///
+    /// @throws bsoncxx::exception if the next document is truncated.
+    ///
+    const_iterator& operator++();
+    const_iterator operator++(int);
+
+    ///
+    /// @return The offset of the current document from the start of the sequence.
+    ///
+    std::size_t offset() const;
+
+    friend BSONCXX_API bool BSONCXX_CALL operator==(const const_iterator&, const const_iterator&);
+    friend BSONCXX_API bool BSONCXX_CALL operator!=(const const_iterator&, const const_iterator&);
+
+   private:
+    friend class bson_sequence_reader;
+
+    BSONCXX_PRIVATE const_iterator(const std::uint8_t* begin,
+                                   const std::uint8_t* current,
+                                   const std::uint8_t* end);
+
+    BSONCXX_PRIVATE void read();
+
+    const std::uint8_t* _begin;
+    const std::uint8_t* _current;
+    const std::uint8_t* _end;
+    document::view _document;
+};
+
+BSONCXX_INLINE_NAMESPACE_END
+}  // namespace bsoncxx
+
+#include <bsoncxx/config/postlude.hpp>
@@ -0,0 +1,208 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <bsoncxx/bson_sequence_writer.hpp>
+
+#include <cerrno>
+#include <cstdint>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <bsoncxx/exception/error_code.hpp>
+#include <bsoncxx/exception/exception.hpp>
+#include <bsoncxx/stdx/make_unique.hpp>
+#include <bsoncxx/string/to_string.hpp>
+
+#include <bsoncxx/config/private/prelude.hh>
+
+namespace bsoncxx {
+BSONCXX_INLINE_NAMESPACE_BEGIN
+
+namespace {
+
+[[noreturn]] void throw_errno(const std::string& what) {
+    throw exception{std::error_code{errno, std::system_category()}, what};
+}
+
+#if defined(_WIN32)
+int open_for_writing(const std::string& path) {
+    return ::_open(
+        path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+}
+
+int write_some(int fd, const std::uint8_t* data, std::size_t length) {
+    return ::_write(fd, data, static_cast<unsigned int>(length));
+}
+
+int sync_file(int fd) {
+    return ::_commit(fd);
+}
+
+int close_file(int fd) {
+    return ::_close(fd);
+}
+#else
+int open_for_writing(const std::string& path) {
+    return ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+}
+
+ssize_t write_some(int fd, const std::uint8_t* data, std::size_t length) {
+    return ::write(fd, data, length);
+}
+
+int sync_file(int fd) {
+    return ::fsync(fd);
+}
+
+int close_file(int fd) {
+    return ::close(fd);
+}
+#endif
+
+}  // namespace
+
+class bson_sequence_writer::impl {
+   public:
+    impl(std::string path, std::size_t buffer_size)
+        : path{std::move(path)}, buffer_size{buffer_size} {
+        fd = open_for_writing(this->path);
+        if (fd < 0) {
+            throw_errno("could not create BSON sequence file " + this->path);
+        }
+        buffer.reserve(buffer_size);
+    }
+
+    ~impl() {
+        if (fd < 0) {
+            return;
+        }
+        try {
+            flush();
+        } catch (...) {
+        }
+        close_file(fd);
+    }
+
+    impl(const impl&) = delete;
+    impl& operator=(const impl&) = delete;
+
+    void check_open() const {
+        if (fd < 0) {
+            throw exception{error_code::k_bson_sequence_closed};
+        }
+    }
+
+    void write(const std::uint8_t* data, std::size_t length) {
+        while (length > 0) {
+            auto written = write_some(fd, data, length);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw_errno("could not write BSON sequence file " + path);
+            }
+            data += written;
+            length -= static_cast<std::size_t>(written);
+        }
+    }
+
+    void flush() {
+        if (buffer.empty()) {
+            return;
+        }
+
+        write(buffer.data(), buffer.size());
+        buffer.clear();
+    }
+
+    std::string path;
+    std::size_t buffer_size;
+    int fd = -1;
+    std::vector<std::uint8_t> buffer;
+    std::size_t length = 0;
+};
+
+constexpr std::size_t bson_sequence_writer::k_default_buffer_size;
+
+bson_sequence_writer::bson_sequence_writer(stdx::string_view path, std::size_t buffer_size)
+    : _impl{stdx::make_unique<impl>(string::to_string(path), buffer_size)} {}
+
+bson_sequence_writer::bson_sequence_writer(bson_sequence_writer&&) noexcept = default;
+bson_sequence_writer& bson_sequence_writer::operator=(bson_sequence_writer&&) noexcept = default;
+bson_sequence_writer::~bson_sequence_writer() = default;
+
+void bson_sequence_writer::append(document::view document) {
+    _impl->check_open();
+
+    const std::uint8_t* data = document.data();
+    const std::size_t length = document.length();
+
+    if (_impl->buffer.size() + length > _impl->buffer_size) {
+        _impl->flush();
+    }
+
+    // A document larger than the whole buffer is written straight from the caller's memory
+    // instead of being copied through it.
+    if (length > _impl->buffer_size) {
+        _impl->write(data, length);
+    } else {
+        _impl->buffer.insert(_impl->buffer.end(), data, data + length);
+    }
+
+    _impl->length += length;
+}
+
+void bson_sequence_writer::flush() {
+    _impl->check_open();
+    _impl->flush();
+}
+
+void bson_sequence_writer::sync() {
+    flush();
+    if (sync_file(_impl->fd) != 0) {
+        throw_errno("could not sync BSON sequence file " + _impl->path);
+    }
+}
+
+void bson_sequence_writer::close() {
+    if (_impl->fd < 0) {
+        return;
+    }
+
+    _impl->flush();
+
+    const int fd = _impl->fd;
+    _impl->fd = -1;
+    if (close_file(fd) != 0) {
+        throw_errno("could not close BSON sequence file " + _impl->path);
+    }
+}
+
+std::size_t bson_sequence_writer::length() const {
+    return _impl->length;
+}
+
+BSONCXX_INLINE_NAMESPACE_END
+}  // namespace bsoncxx
@@ -0,0 +1,113 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+#include <bsoncxx/document/view.hpp>
+#include <bsoncxx/stdx/string_view.hpp>
+
+#include <bsoncxx/config/prelude.hpp>
+
+namespace bsoncxx {
+BSONCXX_INLINE_NAMESPACE_BEGIN
+
+///
+/// Writes a BSON sequence: concatenated BSON documents with nothing between them, the format of
+/// mongodump's .bson files and of what bson_sequence_reader reads.
+///
+/// Documents are collected in a buffer and written to the file once it fills. A document that
+/// does not fit in the buffer, or every document when the buffer size is zero, is written to the
+/// file directly from the caller's memory.
+///
+class BSONCXX_API bson_sequence_writer {
+   public:
+    ///
+    /// The buffer size used unless another is given: 1 MiB.
+    ///
+    static constexpr std::size_t k_default_buffer_size = 1024 * 1024;
+
+    ///
+    /// Creates a file, or truncates an existing one, for writing.
+    ///
+    /// @param path
+    ///   The path of the file.
+    /// @param buffer_size
+    ///   The number of bytes collected before they are written to the file. Zero writes each
+    ///   document as it is appended.
+    ///
+    /// @throws bsoncxx::exception if the file cannot be created.
+    ///
+    explicit bson_sequence_writer(stdx::string_view path,
+                                  std::size_t buffer_size = k_default_buffer_size);
+
+    bson_sequence_writer(bson_sequence_writer&&) noexcept;
+    bson_sequence_writer& operator=(bson_sequence_writer&&) noexcept;
+
+    ///
+    /// Writes any buffered documents and closes the file. Errors are ignored; call close() to
+    /// observe them.
+    ///
+    ~bson_sequence_writer();
+
+    ///
+    /// Appends a document to the sequence.
+    ///
+    /// @param document
+    ///   The document to append.
+    ///
+    /// @throws bsoncxx::exception if the document cannot be written or the writer is closed.
+    ///
+    void append(document::view document);
+
+    ///
+    /// Writes any buffered documents to the file.
+    ///
+    /// @throws bsoncxx::exception if the documents cannot be written or the writer is closed.
+    ///
+    void flush();
+
+    ///
+    /// Writes any buffered documents to the file and waits for the file to reach the disk.
+    ///
+    /// @throws bsoncxx::exception if the documents cannot be written or synced, or the writer is
+    /// closed.
+    ///
+    void sync();
+
+    ///
+    /// Writes any buffered documents and closes the file. Calling close() on a closed writer has
+    /// no effect.
+    ///
+    /// @throws bsoncxx::exception if the documents cannot be written or the file cannot be closed.
+    ///
+    void close();
+
+    ///
+    /// @return The total length in bytes of the documents appended so far, buffered or not.
+    ///
+    std::size_t length() const;
+
+   private:
+    class BSONCXX_PRIVATE impl;
+    std::unique_ptr<impl> _impl;
+};
+
+BSONCXX_INLINE_NAMESPACE_END
+}  // namespace bsoncxx
+
+#include <bsoncxx/config/postlude.hpp>
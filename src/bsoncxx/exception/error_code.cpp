@@ -77,6 +77,14 @@ class error_category_impl final : public std::error_category {
         return {"unable to append " #name};
 #include <bsoncxx/enums/type.hpp>
 #undef BSONCXX_ENUM
+            case error_code::k_invalid_bson_sequence:
+                return "BSON sequence contains a truncated or malformed document";
+            case error_code::k_bson_sequence_not_indexed:
+                return "BSON sequence must be indexed before documents are accessed by position";
+            case error_code::k_bson_sequence_closed:
+                return "BSON sequence writer has been closed";
+            case error_code::k_invalid_query_filter:
+                return "query filter is invalid or uses an unsupported operator";
             default:
                 return "unknown bsoncxx error code";
         }
@@ -92,6 +92,18 @@ enum class error_code : std::int32_t {
 #define BSONCXX_ENUM(name, value) k_cannot_append_##name,
 #include <bsoncxx/enums/type.hpp>
 #undef BSONCXX_ENUM
+
+    /// A BSON sequence contains a truncated or malformed document.
+    k_invalid_bson_sequence,
+
+    /// A document was requested by index from a BSON sequence that has no index.
+    k_bson_sequence_not_indexed,
+
+    /// A BSON sequence was written to after it was closed.
+    k_bson_sequence_closed,
+
+    /// A query filter uses an unsupported operator or gives an operator an invalid operand.
+    k_invalid_query_filter,
     // Add new constant string message to error_code.cpp as well!
 };
 
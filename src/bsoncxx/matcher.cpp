@@ -0,0 +1,757 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <bsoncxx/matcher.hpp>
+
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/exception/error_code.hpp>
+#include <bsoncxx/exception/exception.hpp>
+#include <bsoncxx/private/libbson.hh>
+#include <bsoncxx/stdx/make_unique.hpp>
+
+#include <bsoncxx/config/private/prelude.hh>
+
+namespace bsoncxx {
+BSONCXX_INLINE_NAMESPACE_BEGIN
+
+namespace {
+
+// Returned by compare() for values that have no order relative to each other, such as Decimal128
+// and double values, which then match no comparison.
+constexpr int k_unordered = 2;
+
+[[noreturn]] void throw_invalid(const std::string& what) {
+    throw exception{error_code::k_invalid_query_filter, what};
+}
+
+// The server's canonical type order. Values only compare with values of the same bracket.
+int bracket(bson_type_t type) {
+    switch (type) {
+        case BSON_TYPE_MINKEY:
+            return 1;
+        case BSON_TYPE_UNDEFINED:
+        case BSON_TYPE_NULL:
+            return 2;
+        case BSON_TYPE_DOUBLE:
+        case BSON_TYPE_INT32:
+        case BSON_TYPE_INT64:
+        case BSON_TYPE_DECIMAL128:
+            return 3;
+        case BSON_TYPE_UTF8:
+        case BSON_TYPE_SYMBOL:
+            return 4;
+        case BSON_TYPE_DOCUMENT:
+            return 5;
+        case BSON_TYPE_ARRAY:
+            return 6;
+        case BSON_TYPE_BINARY:
+            return 7;
+        case BSON_TYPE_OID:
+            return 8;
+        case BSON_TYPE_BOOL:
+            return 9;
+        case BSON_TYPE_DATE_TIME:
+            return 10;
+        case BSON_TYPE_TIMESTAMP:
+            return 11;
+        case BSON_TYPE_REGEX:
+            return 12;
+        case BSON_TYPE_DBPOINTER:
+            return 13;
+        case BSON_TYPE_CODE:
+            return 14;
+        case BSON_TYPE_CODEWSCOPE:
+            return 15;
+        case BSON_TYPE_MAXKEY:
+            return 16;
+        default:
+            return 0;
+    }
+}
+
+template <typename T>
+int order(const T& a, const T& b) {
+    return a < b ? -1 : (b < a ? 1 : 0);
+}
+
+int order_bytes(const void* a, std::size_t a_length, const void* b, std::size_t b_length) {
+    const int result = std::memcmp(a, b, a_length < b_length ? a_length : b_length);
+    if (result != 0) {
+        return result < 0 ? -1 : 1;
+    }
+    return order(a_length, b_length);
+}
+
+// NaN equals NaN and orders before every other number, as on the server.
+int order_doubles(double a, double b) {
+    if (std::isnan(a) || std::isnan(b)) {
+        return order(!std::isnan(a), !std::isnan(b));
+    }
+    return order(a, b);
+}
+
+// Orders an integer and a double exactly, without converting the integer to a double.
+int order_int_double(std::int64_t i, double d) {
+    if (std::isnan(d)) {
+        return 1;
+    }
+    if (d >= 9223372036854775808.0) {
+        return -1;
+    }
+    if (d < -9223372036854775808.0) {
+        return 1;
+    }
+
+    const auto truncated = static_cast<std::int64_t>(d);
+    if (i != truncated) {
+        return order(i, truncated);
+    }
+
+    const double fraction = d - static_cast<double>(truncated);
+    return fraction > 0 ? -1 : (fraction < 0 ? 1 : 0);
+}
+
+bool is_integer(bson_type_t type) {
+    return type == BSON_TYPE_INT32 || type == BSON_TYPE_INT64;
+}
+
+int order_numbers(const bson_iter_t* a, const bson_iter_t* b) {
+    const bson_type_t a_type = bson_iter_type(a);
+    const bson_type_t b_type = bson_iter_type(b);
+
+    if (a_type == BSON_TYPE_DECIMAL128 || b_type == BSON_TYPE_DECIMAL128) {
+        bson_decimal128_t a_value;
+        bson_decimal128_t b_value;
+        if (a_type != b_type || !bson_iter_decimal128(a, &a_value) ||
+            !bson_iter_decimal128(b, &b_value)) {
+            return k_unordered;
+        }
+        return a_value.high == b_value.high && a_value.low == b_value.low ? 0 : k_unordered;
+    }
+
+    if (is_integer(a_type) && is_integer(b_type)) {
+        return order(bson_iter_as_int64(a), bson_iter_as_int64(b));
+    }
+    if (is_integer(a_type)) {
+        return order_int_double(bson_iter_as_int64(a), bson_iter_double(b));
+    }
+    if (is_integer(b_type)) {
+        return -order_int_double(bson_iter_as_int64(b), bson_iter_double(a));
+    }
+    return order_doubles(bson_iter_double(a), bson_iter_double(b));
+}
+
+const char* string_value(const bson_iter_t* iter, std::uint32_t* length) {
+    if (bson_iter_type(iter) == BSON_TYPE_SYMBOL) {
+        return bson_iter_symbol(iter, length);
+    }
+    return bson_iter_utf8(iter, length);
+}
+
+int order_values(const bson_iter_t* a, const bson_iter_t* b);
+
+int order_containers(const bson_iter_t* a, const bson_iter_t* b) {
+    bson_iter_t a_fields;
+    bson_iter_t b_fields;
+    if (!bson_iter_recurse(a, &a_fields) || !bson_iter_recurse(b, &b_fields)) {
+        return k_unordered;
+    }
+
+    for (;;) {
+        const bool a_next = bson_iter_next(&a_fields);
+        const bool b_next = bson_iter_next(&b_fields);
+        if (!a_next || !b_next) {
+            return order(a_next, b_next);
+        }
+
+        int result = order(bracket(bson_iter_type(&a_fields)), bracket(bson_iter_type(&b_fields)));
+        if (result == 0) {
+            result = order(std::strcmp(bson_iter_key(&a_fields), bson_iter_key(&b_fields)), 0);
+        }
+        if (result == 0) {
+            result = order_values(&a_fields, &b_fields);
+        }
+        if (result != 0) {
+            return result;
+        }
+    }
+}
+
+// Orders two values of the same type bracket, returning -1, 0, 1 or k_unordered.
+int order_values(const bson_iter_t* a, const bson_iter_t* b) {
+    switch (bson_iter_type(a)) {
+        case BSON_TYPE_MINKEY:
+        case BSON_TYPE_UNDEFINED:
+        case BSON_TYPE_NULL:
+        case BSON_TYPE_MAXKEY:
+            return 0;
+        case BSON_TYPE_DOUBLE:
+        case BSON_TYPE_INT32:
+        case BSON_TYPE_INT64:
+        case BSON_TYPE_DECIMAL128:
+            return order_numbers(a, b);
+        case BSON_TYPE_UTF8:
+        case BSON_TYPE_SYMBOL: {
+            std::uint32_t a_length;
+            std::uint32_t b_length;
+            const char* a_value = string_value(a, &a_length);
+            const char* b_value = string_value(b, &b_length);
+            return order_bytes(a_value, a_length, b_value, b_length);
+        }
+        case BSON_TYPE_DOCUMENT:
+        case BSON_TYPE_ARRAY:
+            return order_containers(a, b);
+        case BSON_TYPE_BINARY: {
+            bson_subtype_t a_subtype;
+            bson_subtype_t b_subtype;
+            std::uint32_t a_length;
+            std::uint32_t b_length;
+            const std::uint8_t* a_value;
+            const std::uint8_t* b_value;
+            bson_iter_binary(a, &a_subtype, &a_length, &a_value);
+            bson_iter_binary(b, &b_subtype, &b_length, &b_value);
+            if (a_length != b_length) {
+                return order(a_length, b_length);
+            }
+            if (a_subtype != b_subtype) {
+                return order(static_cast<int>(a_subtype), static_cast<int>(b_subtype));
+            }
+            return order_bytes(a_value, a_length, b_value, b_length);
+        }
+        case BSON_TYPE_OID:
+            return order_bytes(bson_iter_oid(a), 12, bson_iter_oid(b), 12);
+        case BSON_TYPE_BOOL:
+            return order(bson_iter_bool(a), bson_iter_bool(b));
+        case BSON_TYPE_DATE_TIME:
+            return order(bson_iter_date_time(a), bson_iter_date_time(b));
+        case BSON_TYPE_TIMESTAMP: {
+            std::uint32_t a_time, a_increment, b_time, b_increment;
+            bson_iter_timestamp(a, &a_time, &a_increment);
+            bson_iter_timestamp(b, &b_time, &b_increment);
+            return a_time != b_time ? order(a_time, b_time) : order(a_increment, b_increment);
+        }
+        case BSON_TYPE_REGEX: {
+            const char* a_options;
+            const char* b_options;
+            const char* a_pattern = bson_iter_regex(a, &a_options);
+            const char* b_pattern = bson_iter_regex(b, &b_options);
+            const int result = order(std::strcmp(a_pattern, b_pattern), 0);
+            return result != 0 ? result : order(std::strcmp(a_options, b_options), 0);
+        }
+        case BSON_TYPE_CODE: {
+            std::uint32_t a_length;
+            std::uint32_t b_length;
+            const char* a_value = bson_iter_code(a, &a_length);
+            const char* b_value = bson_iter_code(b, &b_length);
+            return order_bytes(a_value, a_length, b_value, b_length);
+        }
+        default:
+            return k_unordered;
+    }
+}
+
+bool is_null(const bson_iter_t* iter) {
+    return BSON_ITER_HOLDS_NULL(iter) || BSON_ITER_HOLDS_UNDEFINED(iter);
+}
+
+bool is_operator(const char* key) {
+    return key[0] == '$';
+}
+
+bool is_logical_operator(const char* key) {
+    return std::strcmp(key, "$and") == 0 || std::strcmp(key, "$or") == 0 ||
+           std::strcmp(key, "$nor") == 0;
+}
+
+// Whether the value is a document whose first field is an operator, like {"$gt": 1}.
+bool holds_operators(const bson_iter_t* iter) {
+    bson_iter_t fields;
+    return BSON_ITER_HOLDS_DOCUMENT(iter) && bson_iter_recurse(iter, &fields) &&
+           bson_iter_next(&fields) && is_operator(bson_iter_key(&fields));
+}
+
+}  // namespace
+
+class matcher::impl {
+   public:
+    explicit impl(document::view filter) : filter{filter} {
+        bson_iter_t fields;
+        if (!bson_iter_init_from_data(&fields, this->filter.view().data(), filter.length())) {
+            throw_invalid("query filter is not a valid BSON document");
+        }
+        root = compile_document(fields);
+    }
+
+    bool matches(document::view document) const {
+        bson_iter_t fields;
+        if (!bson_iter_init_from_data(&fields, document.data(), document.length())) {
+            return false;
+        }
+        return evaluate(root, &fields, nullptr);
+    }
+
+    // The owned copy of the filter, which the operands point into.
+    document::value filter;
+
+   private:
+    enum class op {
+        k_and,
+        k_or,
+        k_nor,
+        k_eq,
+        k_gt,
+        k_gte,
+        k_lt,
+        k_lte,
+        k_in,
+        k_exists,
+        k_elem_match,
+    };
+
+    struct path_segment {
+        std::string name;
+        bool is_index;
+    };
+
+    // The plan is a tree of nodes held in flat vectors and linked by index. $and, $or and $nor
+    // nodes list their clauses in `children`; predicates list their operands in `operands` and
+    // their field path in `segments`. An empty path applies the predicate to the value itself,
+    // which is how the clauses of {"$elemMatch": {"$gt": 1}} are evaluated.
+    struct node {
+        op kind;
+        bool negate;
+        std::size_t first;
+        std::size_t count;
+        std::size_t path_first;
+        std::size_t path_count;
+        bool elements_are_values;
+    };
+
+    std::size_t add_node(op kind,
+                         bool negate,
+                         std::size_t first,
+                         std::size_t count,
+                         std::size_t path_first,
+                         std::size_t path_count) {
+        nodes.push_back(node{kind, negate, first, count, path_first, path_count, false});
+        return nodes.size() - 1;
+    }
+
+    std::size_t add_clauses(op kind, const std::vector<std::size_t>& clauses) {
+        const std::size_t first = children.size();
+        children.insert(children.end(), clauses.begin(), clauses.end());
+        return add_node(kind, false, first, clauses.size(), 0, 0);
+    }
+
+    std::size_t add_path(const char* key, std::size_t* count) {
+        const std::size_t first = segments.size();
+        const std::string path{key};
+
+        std::size_t start = 0;
+        for (;;) {
+            const std::size_t dot = path.find('.', start);
+            std::string name = path.substr(start, dot == std::string::npos ? dot : dot - start);
+            if (name.empty()) {
+                throw_invalid("empty component in field path " + path);
+            }
+
+            bool is_index = true;
+            for (char c : name) {
+                is_index = is_index && c >= '0' && c <= '9';
+            }
+            segments.push_back(path_segment{std::move(name), is_index});
+
+            if (dot == std::string::npos) {
+                break;
+            }
+            start = dot + 1;
+        }
+
+        *count = segments.size() - first;
+        return first;
+    }
+
+    std::size_t compile_document(bson_iter_t fields) {
+        std::vector<std::size_t> clauses;
+
+        while (bson_iter_next(&fields)) {
+            const char* key = bson_iter_key(&fields);
+
+            if (is_logical_operator(key)) {
+                clauses.push_back(compile_logical(key, &fields));
+                continue;
+            }
+            if (is_operator(key)) {
+                throw_invalid(std::string{"unsupported query operator "} + key);
+            }
+
+            std::size_t path_count;
+            const std::size_t path_first = add_path(key, &path_count);
+
+            if (holds_operators(&fields)) {
+                compile_operators(&fields, path_first, path_count, &clauses);
+            } else if (BSON_ITER_HOLDS_REGEX(&fields)) {
+                throw_invalid(std::string{"regular expression match on field "} + key +
+                              " is not supported");
+            } else {
+                clauses.push_back(add_operand(op::k_eq, false, &fields, path_first, path_count));
+            }
+        }
+
+        return add_clauses(op::k_and, clauses);
+    }
+
+    std::size_t compile_logical(const char* key, const bson_iter_t* value) {
+        const op kind = std::strcmp(key, "$and") == 0
+                            ? op::k_and
+                            : (std::strcmp(key, "$or") == 0 ? op::k_or : op::k_nor);
+
+        bson_iter_t branches;
+        if (!BSON_ITER_HOLDS_ARRAY(value) || !bson_iter_recurse(value, &branches)) {
+            throw_invalid(std::string{key} + " requires an array of documents");
+        }
+
+        std::vector<std::size_t> clauses;
+        while (bson_iter_next(&branches)) {
+            bson_iter_t fields;
+            if (!BSON_ITER_HOLDS_DOCUMENT(&branches) || !bson_iter_recurse(&branches, &fields)) {
+                throw_invalid(std::string{key} + " requires an array of documents");
+            }
+            clauses.push_back(compile_document(fields));
+        }
+
+        if (clauses.empty()) {
+            throw_invalid(std::string{key} + " requires a nonempty array");
+        }
+
+        return add_clauses(kind, clauses);
+    }
+
+    void compile_operators(const bson_iter_t* value,
+                           std::size_t path_first,
+                           std::size_t path_count,
+                           std::vector<std::size_t>* clauses) {
+        bson_iter_t operators;
+        bson_iter_recurse(value, &operators);
+
+        while (bson_iter_next(&operators)) {
+            const char* name = bson_iter_key(&operators);
+
+            if (std::strcmp(name, "$eq") == 0) {
+                clauses->push_back(
+                    add_operand(op::k_eq, false, &operators, path_first, path_count));
+            } else if (std::strcmp(name, "$ne") == 0) {
+                clauses->push_back(add_operand(op::k_eq, true, &operators, path_first, path_count));
+            } else if (std::strcmp(name, "$gt") == 0) {
+                clauses->push_back(
+                    add_operand(op::k_gt, false, &operators, path_first, path_count));
+            } else if (std::strcmp(name, "$gte") == 0) {
+                clauses->push_back(
+                    add_operand(op::k_gte, false, &operators, path_first, path_count));
+            } else if (std::strcmp(name, "$lt") == 0) {
+                clauses->push_back(
+                    add_operand(op::k_lt, false, &operators, path_first, path_count));
+            } else if (std::strcmp(name, "$lte") == 0) {
+                clauses->push_back(
+                    add_operand(op::k_lte, false, &operators, path_first, path_count));
+            } else if (std::strcmp(name, "$in") == 0) {
+                clauses->push_back(compile_in(false, &operators, path_first, path_count));
+            } else if (std::strcmp(name, "$nin") == 0) {
+                clauses->push_back(compile_in(true, &operators, path_first, path_count));
+            } else if (std::strcmp(name, "$exists") == 0) {
+                clauses->push_back(add_node(op::k_exists,
+                                            !bson_iter_as_bool(&operators),
+                                            0,
+                                            0,
+                                            path_first,
+                                            path_count));
+            } else if (std::strcmp(name, "$elemMatch") == 0) {
+                clauses->push_back(compile_elem_match(&operators, path_first, path_count));
+            } else if (is_operator(name)) {
+                throw_invalid(std::string{"unsupported query operator "} + name);
+            } else {
+                throw_invalid(std::string{"field "} + name +
+                              " cannot follow an operator in an operator expression");
+            }
+        }
+    }
+
+    std::size_t add_operand(op kind,
+                            bool negate,
+                            const bson_iter_t* operand,
+                            std::size_t path_first,
+                            std::size_t path_count) {
+        operands.push_back(*operand);
+        return add_node(kind, negate, operands.size() - 1, 1, path_first, path_count);
+    }
+
+    std::size_t compile_in(bool negate,
+                           const bson_iter_t* operand,
+                           std::size_t path_first,
+                           std::size_t path_count) {
+        const char* name = negate ? "$nin" : "$in";
+
+        bson_iter_t values;
+        if (!BSON_ITER_HOLDS_ARRAY(operand) || !bson_iter_recurse(operand, &values)) {
+            throw_invalid(std::string{name} + " requires an array");
+        }
+
+        const std::size_t first = operands.size();
+        while (bson_iter_next(&values)) {
+            if (BSON_ITER_HOLDS_REGEX(&values)) {
+                throw_invalid(std::string{"regular expressions in "} + name +
+                              " are not supported");
+            }
+            operands.push_back(values);
+        }
+
+        return add_node(op::k_in, negate, first, operands.size() - first, path_first, path_count);
+    }
+
+    std::size_t compile_elem_match(const bson_iter_t* operand,
+                                   std::size_t path_first,
+                                   std::size_t path_count) {
+        bson_iter_t fields;
+        if (!BSON_ITER_HOLDS_DOCUMENT(operand) || !bson_iter_recurse(operand, &fields)) {
+            throw_invalid("$elemMatch requires a document");
+        }
+
+        // {"$elemMatch": {"$gt": 1}} applies operators to each element, while
+        // {"$elemMatch": {"a": 1}} and {"$elemMatch": {"$or": [...]}} match each element as a
+        // document.
+        bson_iter_t first_field = fields;
+        const bool elements_are_values = bson_iter_next(&first_field) &&
+                                         is_operator(bson_iter_key(&first_field)) &&
+                                         !is_logical_operator(bson_iter_key(&first_field));
+
+        std::size_t plan;
+        if (elements_are_values) {
+            std::vector<std::size_t> clauses;
+            compile_operators(operand, 0, 0, &clauses);
+            plan = add_clauses(op::k_and, clauses);
+        } else {
+            plan = compile_document(fields);
+        }
+
+        const std::size_t index =
+            add_node(op::k_elem_match, false, plan, 1, path_first, path_count);
+        nodes[index].elements_are_values = elements_are_values;
+        return index;
+    }
+
+    // Evaluates a node against the fields of a document, or against a single value for the
+    // clauses of an $elemMatch on values.
+    bool evaluate(std::size_t index, const bson_iter_t* fields, const bson_iter_t* value) const {
+        const node& n = nodes[index];
+
+        switch (n.kind) {
+            case op::k_and:
+                for (std::size_t i = 0; i < n.count; ++i) {
+                    if (!evaluate(children[n.first + i], fields, value)) {
+                        return false;
+                    }
+                }
+                return true;
+            case op::k_or:
+            case op::k_nor:
+                for (std::size_t i = 0; i < n.count; ++i) {
+                    if (evaluate(children[n.first + i], fields, value)) {
+                        return n.kind == op::k_or;
+                    }
+                }
+                return n.kind == op::k_nor;
+            default:
+                break;
+        }
+
+        if (n.path_count == 0) {
+            return test(n, value, false) != n.negate;
+        }
+
+        const path_segment* path = &segments[n.path_first];
+        auto visitor = [&](const bson_iter_t* reached) { return test(n, reached, true); };
+        return visit(*fields, path, path + n.path_count, visitor) != n.negate;
+    }
+
+    // Calls the visitor with each value that the path reaches in the fields, or with nullptr
+    // where the path ends at a missing field, and returns true as soon as the visitor does.
+    template <typename Visitor>
+    static bool visit(bson_iter_t fields,
+                      const path_segment* segment,
+                      const path_segment* end,
+                      Visitor& visitor) {
+        if (!bson_iter_find(&fields, segment->name.c_str())) {
+            return visitor(nullptr);
+        }
+        if (segment + 1 == end) {
+            return visitor(&fields);
+        }
+
+        const path_segment* next = segment + 1;
+        bson_iter_t children;
+
+        if (BSON_ITER_HOLDS_DOCUMENT(&fields) && bson_iter_recurse(&fields, &children)) {
+            return visit(children, next, end, visitor);
+        }
+
+        if (BSON_ITER_HOLDS_ARRAY(&fields) && bson_iter_recurse(&fields, &children)) {
+            // A numeric component selects an element by position, and the rest of the path is
+            // also applied to every element that is a document.
+            if (next->is_index && visit(children, next, end, visitor)) {
+                return true;
+            }
+
+            bool reached = next->is_index;
+            while (bson_iter_next(&children)) {
+                bson_iter_t element;
+                if (BSON_ITER_HOLDS_DOCUMENT(&children) &&
+                    bson_iter_recurse(&children, &element)) {
+                    reached = true;
+                    if (visit(element, next, end, visitor)) {
+                        return true;
+                    }
+                }
+            }
+            if (reached) {
+                return false;
+            }
+        }
+
+        return visitor(nullptr);
+    }
+
+    // Tests one value reached by a predicate's path, with nullptr for a missing field. When
+    // `expand` is set, an array value also matches if one of its elements does.
+    bool test(const node& n, const bson_iter_t* value, bool expand) const {
+        if (n.kind == op::k_exists) {
+            return value != nullptr;
+        }
+
+        if (n.kind == op::k_elem_match) {
+            bson_iter_t elements;
+            if (!value || !BSON_ITER_HOLDS_ARRAY(value) || !bson_iter_recurse(value, &elements)) {
+                return false;
+            }
+            while (bson_iter_next(&elements)) {
+                if (n.elements_are_values) {
+                    if (evaluate(n.first, nullptr, &elements)) {
+                        return true;
+                    }
+                    continue;
+                }
+                bson_iter_t fields;
+                if (BSON_ITER_HOLDS_DOCUMENT(&elements) && bson_iter_recurse(&elements, &fields) &&
+                    evaluate(n.first, &fields, nullptr)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        if (!value) {
+            return test_missing(n);
+        }
+        if (compare(n, value)) {
+            return true;
+        }
+
+        bson_iter_t elements;
+        if (expand && BSON_ITER_HOLDS_ARRAY(value) && bson_iter_recurse(value, &elements)) {
+            while (bson_iter_next(&elements)) {
+                if (compare(n, &elements)) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // A missing field compares as null.
+    bool test_missing(const node& n) const {
+        if (n.kind == op::k_gt || n.kind == op::k_lt) {
+            return false;
+        }
+        for (std::size_t i = 0; i < n.count; ++i) {
+            if (is_null(&operands[n.first + i])) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool compare(const node& n, const bson_iter_t* value) const {
+        const int value_bracket = bracket(bson_iter_type(value));
+
+        for (std::size_t i = 0; i < n.count; ++i) {
+            const bson_iter_t* operand = &operands[n.first + i];
+            if (bracket(bson_iter_type(operand)) != value_bracket) {
+                continue;
+            }
+
+            const int result = order_values(value, operand);
+            if (result == k_unordered) {
+                continue;
+            }
+
+            switch (n.kind) {
+                case op::k_eq:
+                case op::k_in:
+                    if (result == 0) {
+                        return true;
+                    }
+                    break;
+                case op::k_gt:
+                    return result > 0;
+                case op::k_gte:
+                    return result >= 0;
+                case op::k_lt:
+                    return result < 0;
+                case op::k_lte:
+                    return result <= 0;
+                default:
+                    break;
+            }
+        }
+        return false;
+    }
+
+    std::vector<node> nodes;
+    std::vector<std::size_t> children;
+    std::vector<bson_iter_t> operands;
+    std::vector<path_segment> segments;
+    std::size_t root;
+};
+
+matcher::matcher(document::view filter) : _impl{stdx::make_unique<impl>(filter)} {}
+
+matcher::matcher(matcher&&) noexcept = default;
+matcher& matcher::operator=(matcher&&) noexcept = default;
+matcher::~matcher() = default;
+
+bool matcher::matches(document::view document) const {
+    return _impl->matches(document);
+}
+
+document::view matcher::filter() const {
+    return _impl->filter.view();
+}
+
+BSONCXX_INLINE_NAMESPACE_END
+}  // namespace bsoncxx
@@ -0,0 +1,86 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <memory>
+
+#include <bsoncxx/document/view.hpp>
+
+#include <bsoncxx/config/prelude.hpp>
+
+namespace bsoncxx {
+BSONCXX_INLINE_NAMESPACE_BEGIN
+
+///
+/// Evaluates a query filter against documents on the client, the way the server evaluates a find
+/// filter.
+///
+/// The filter is compiled once when the matcher is constructed; matches() then walks the
+/// document with no allocations. The supported operators are $eq, $ne, $gt, $gte, $lt, $lte, $in,
+/// $nin, $exists, $elemMatch, $and, $or and $nor, on top-level or dotted field paths. As on the
+/// server, a path that reaches an array matches if any of its elements match, a numeric path
+/// component also selects an array element by position, and comparisons only match values of the
+/// same type bracket, with int32, int64 and double values compared numerically.
+///
+/// Strings compare by their bytes, as they do on the server without a collation. Decimal128
+/// values only equal Decimal128 values with the same encoding, and do not compare with other
+/// numbers.
+///
+/// A matcher holds no state that matches() modifies, so one matcher may be used by several
+/// threads at once.
+///
+class BSONCXX_API matcher {
+   public:
+    ///
+    /// Compiles a filter. The filter is copied, so it need not outlive the matcher.
+    ///
+    /// @param filter
+    ///   The query filter, e.g. {"a.b": {"$gt": 1}, "$or": [{"c": "x"}, {"d": {"$exists": true}}]}.
+    ///
+    /// @throws bsoncxx::exception if the filter uses an unsupported operator or an operator is
+    ///   given an operand of the wrong type.
+    ///
+    explicit matcher(document::view filter);
+
+    matcher(matcher&&) noexcept;
+    matcher& operator=(matcher&&) noexcept;
+
+    ~matcher();
+
+    ///
+    /// Evaluates the filter.
+    ///
+    /// @param document
+    ///   The document to evaluate the filter against.
+    ///
+    /// @return Whether the document matches the filter.
+    ///
+    bool matches(document::view document) const;
+
+    ///
+    /// @return The filter the matcher was compiled from.
+    ///
+    document::view filter() const;
+
+   private:
+    class BSONCXX_PRIVATE impl;
+    std::unique_ptr<impl> _impl;
+};
+
+BSONCXX_INLINE_NAMESPACE_END
+}  // namespace bsoncxx
+
+#include <bsoncxx/config/postlude.hpp>
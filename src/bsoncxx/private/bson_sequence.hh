@@ -0,0 +1,57 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include <bsoncxx/config/private/prelude.hh>
+
+namespace bsoncxx {
+BSONCXX_INLINE_NAMESPACE_BEGIN
+
+namespace bson_sequence {
+
+// Reads the little-endian int32 length prefix of the document at data.
+inline std::size_t length_prefix(const std::uint8_t* data) {
+    return static_cast<std::size_t>(data[0]) | (static_cast<std::size_t>(data[1]) << 8) |
+           (static_cast<std::size_t>(data[2]) << 16) | (static_cast<std::size_t>(data[3]) << 24);
+}
+
+// Returns the length of the document at data, which includes the length prefix and the trailing
+// NUL byte, or zero if the document does not fit in the available bytes or is malformed.
+inline std::size_t document_length(const std::uint8_t* data, std::size_t available) {
+    if (available < 5) {
+        return 0;
+    }
+
+    const std::size_t length = length_prefix(data);
+    if (length < 5 ||
+        length > static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max()) ||
+        length > available || data[length - 1] != 0) {
+        return 0;
+    }
+
+    return length;
+}
+
+}  // namespace bson_sequence
+
+BSONCXX_INLINE_NAMESPACE_END
+}  // namespace bsoncxx
+
+#include <bsoncxx/config/private/postlude.hh>
@@ -0,0 +1,143 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <bsoncxx/bson_sequence_reader.hpp>
+#include <bsoncxx/bson_sequence_writer.hpp>
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/exception/error_code.hpp>
+#include <bsoncxx/exception/exception.hpp>
+#include <bsoncxx/test_util/catch.hh>
+#include <bsoncxx/validate.hpp>
+
+namespace {
+
+using namespace bsoncxx;
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_document;
+
+std::vector<document::value> make_documents(int count) {
+    std::vector<document::value> docs;
+    for (int i = 0; i < count; ++i) {
+        docs.push_back(make_document(kvp("_id", i), kvp("name", std::string(i * 10, 'x'))));
+    }
+    return docs;
+}
+
+void write_and_read_back(std::size_t buffer_size) {
+    const std::string path = "test_bson_sequence.bson";
+    auto docs = make_documents(50);
+
+    {
+        bson_sequence_writer writer{path, buffer_size};
+        for (const auto& doc : docs) {
+            writer.append(doc.view());
+        }
+        writer.close();
+        REQUIRE_THROWS_AS(writer.append(docs[0].view()), bsoncxx::exception);
+    }
+
+    bson_sequence_reader reader{path};
+
+    std::size_t expected_length = 0;
+    for (const auto& doc : docs) {
+        expected_length += doc.view().length();
+    }
+    REQUIRE(reader.length() == expected_length);
+
+    std::size_t i = 0;
+    for (auto&& doc : reader) {
+        REQUIRE(doc == docs[i].view());
+        ++i;
+    }
+    REQUIRE(i == docs.size());
+
+    REQUIRE_NOTHROW(reader.validate());
+
+    REQUIRE_THROWS_AS(reader.size(), bsoncxx::exception);
+    reader.build_index();
+    REQUIRE(reader.size() == docs.size());
+    REQUIRE(reader[17] == docs[17].view());
+    REQUIRE_THROWS_AS(reader[docs.size()], bsoncxx::exception);
+
+    std::remove(path.c_str());
+}
+
+TEST_CASE("a written BSON sequence is read back", "[bson_sequence]") {
+    SECTION("with the default buffer") {
+        write_and_read_back(bson_sequence_writer::k_default_buffer_size);
+    }
+
+    // Some of the documents are larger than this buffer and are written directly.
+    SECTION("with a small buffer") {
+        write_and_read_back(64);
+    }
+
+    SECTION("without a buffer") {
+        write_and_read_back(0);
+    }
+}
+
+TEST_CASE("an empty BSON sequence file has no documents", "[bson_sequence]") {
+    const std::string path = "test_bson_sequence_empty.bson";
+    { bson_sequence_writer writer{path}; }
+
+    bson_sequence_reader reader{path};
+    REQUIRE(reader.length() == 0);
+    REQUIRE(reader.begin() == reader.end());
+
+    std::remove(path.c_str());
+}
+
+TEST_CASE("a malformed BSON sequence is reported", "[bson_sequence]") {
+    auto docs = make_documents(3);
+
+    std::vector<std::uint8_t> bytes;
+    for (const auto& doc : docs) {
+        bytes.insert(bytes.end(), doc.view().data(), doc.view().data() + doc.view().length());
+    }
+
+    SECTION("a truncated document") {
+        bson_sequence_reader reader{bytes.data(), bytes.size() - 1};
+
+        auto it = reader.begin();
+        ++it;
+        REQUIRE(it.offset() == docs[0].view().length());
+        try {
+            ++it;
+            FAIL("expected a truncated document to throw");
+        } catch (const bsoncxx::exception& e) {
+            REQUIRE(e.code() == error_code::k_invalid_bson_sequence);
+        }
+    }
+
+    SECTION("a document that fails validation") {
+        auto dollar = make_document(kvp("$bad", 1));
+        bytes.insert(
+            bytes.end(), dollar.view().data(), dollar.view().data() + dollar.view().length());
+
+        bson_sequence_reader reader{bytes.data(), bytes.size()};
+        REQUIRE_NOTHROW(reader.validate());
+
+        validator checks;
+        checks.check_dollar_keys(true);
+        REQUIRE_THROWS_AS(reader.validate(checks), bsoncxx::exception);
+    }
+}
+
+}  // namespace
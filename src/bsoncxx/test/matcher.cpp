@@ -0,0 +1,193 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <bsoncxx/exception/error_code.hpp>
+#include <bsoncxx/exception/exception.hpp>
+#include <bsoncxx/json.hpp>
+#include <bsoncxx/matcher.hpp>
+#include <bsoncxx/test_util/catch.hh>
+
+namespace {
+
+using namespace bsoncxx;
+
+bool match(const char* filter, const char* document) {
+    return matcher{from_json(filter).view()}.matches(from_json(document).view());
+}
+
+TEST_CASE("matcher evaluates equality", "[bsoncxx::matcher]") {
+    REQUIRE(match(R"({})", R"({"a": 1})"));
+    REQUIRE(match(R"({"a": 1})", R"({"a": 1})"));
+    REQUIRE(!match(R"({"a": 1})", R"({"a": 2})"));
+    REQUIRE(!match(R"({"a": 1})", R"({"a": "1"})"));
+    REQUIRE(match(R"({"a": 1, "b": "x"})", R"({"b": "x", "a": 1})"));
+    REQUIRE(!match(R"({"a": 1, "b": "x"})", R"({"a": 1})"));
+
+    SECTION("numbers of different types compare by value") {
+        REQUIRE(match(R"({"a": {"$eq": 2}})", R"({"a": 2.0})"));
+        REQUIRE(match(R"({"a": {"$numberLong": "2"}})", R"({"a": 2})"));
+        REQUIRE(!match(R"({"a": 2})", R"({"a": 2.5})"));
+        REQUIRE(match(R"({"a": {"x": 1}})", R"({"a": {"x": 1.0}})"));
+        REQUIRE(!match(R"({"a": {"x": 1}})", R"({"a": {"x": 1, "y": 2}})"));
+    }
+
+    SECTION("arrays match as a whole or by element") {
+        REQUIRE(match(R"({"a": 2})", R"({"a": [1, 2, 3]})"));
+        REQUIRE(match(R"({"a": [1, 2]})", R"({"a": [1, 2]})"));
+        REQUIRE(match(R"({"a": [1, 2]})", R"({"a": [[1, 2], 3]})"));
+        REQUIRE(!match(R"({"a": [1, 2]})", R"({"a": [2, 1]})"));
+    }
+
+    SECTION("null matches missing fields") {
+        REQUIRE(match(R"({"a": null})", R"({"b": 1})"));
+        REQUIRE(match(R"({"a": null})", R"({"a": null})"));
+        REQUIRE(!match(R"({"a": null})", R"({"a": 0})"));
+        REQUIRE(match(R"({"a": {"$ne": null}})", R"({"a": 0})"));
+    }
+}
+
+TEST_CASE("matcher evaluates comparisons", "[bsoncxx::matcher]") {
+    REQUIRE(match(R"({"a": {"$gt": 1}})", R"({"a": 1.5})"));
+    REQUIRE(!match(R"({"a": {"$gt": 1}})", R"({"a": 1})"));
+    REQUIRE(match(R"({"a": {"$gte": 1}})", R"({"a": 1})"));
+    REQUIRE(match(R"({"a": {"$lt": 1}})", R"({"a": -3})"));
+    REQUIRE(match(R"({"a": {"$lte": 1}})", R"({"a": 1.0})"));
+    REQUIRE(match(R"({"a": {"$gt": 1, "$lt": 3}})", R"({"a": 2})"));
+    REQUIRE(!match(R"({"a": {"$gt": 1, "$lt": 3}})", R"({"a": 3})"));
+    REQUIRE(match(R"({"a": {"$gt": "abc"}})", R"({"a": "abd"})"));
+    REQUIRE(match(R"({"a": {"$lt": "abc"}})", R"({"a": "ab"})"));
+
+    SECTION("values of different types do not compare") {
+        REQUIRE(!match(R"({"a": {"$gt": 1}})", R"({"a": "2"})"));
+        REQUIRE(!match(R"({"a": {"$lt": "2"}})", R"({"a": 1})"));
+        REQUIRE(!match(R"({"a": {"$gt": 1}})", R"({"b": 2})"));
+    }
+
+    SECTION("large integers compare exactly with doubles") {
+        REQUIRE(match(R"({"a": {"$gt": 9007199254740992.0}})",
+                      R"({"a": {"$numberLong": "9007199254740993"}})"));
+        REQUIRE(!match(R"({"a": 9007199254740992.0})",
+                       R"({"a": {"$numberLong": "9007199254740993"}})"));
+    }
+
+    SECTION("an array matches if any element does") {
+        REQUIRE(match(R"({"a": {"$gt": 5}})", R"({"a": [1, 7]})"));
+        REQUIRE(!match(R"({"a": {"$gt": 5}})", R"({"a": [1, 2]})"));
+    }
+
+    SECTION("dates compare by time") {
+        const char* filter = R"({"a": {"$gte": {"$date": {"$numberLong": "1000"}}}})";
+        REQUIRE(match(filter, R"({"a": {"$date": {"$numberLong": "2000"}}})"));
+        REQUIRE(!match(filter, R"({"a": 2000})"));
+    }
+}
+
+TEST_CASE("matcher evaluates $in, $nin and $exists", "[bsoncxx::matcher]") {
+    REQUIRE(match(R"({"a": {"$in": [1, "x"]}})", R"({"a": "x"})"));
+    REQUIRE(match(R"({"a": {"$in": [1, "x"]}})", R"({"a": [3, 1]})"));
+    REQUIRE(!match(R"({"a": {"$in": [1, "x"]}})", R"({"a": 2})"));
+    REQUIRE(!match(R"({"a": {"$in": []}})", R"({"a": 2})"));
+    REQUIRE(match(R"({"a": {"$in": [null]}})", R"({})"));
+    REQUIRE(match(R"({"a": {"$nin": [1, 2]}})", R"({"a": 3})"));
+    REQUIRE(match(R"({"a": {"$nin": [1, 2]}})", R"({})"));
+    REQUIRE(!match(R"({"a": {"$nin": [1, 2]}})", R"({"a": [2, 3]})"));
+
+    REQUIRE(match(R"({"a": {"$exists": true}})", R"({"a": null})"));
+    REQUIRE(!match(R"({"a": {"$exists": true}})", R"({"b": 1})"));
+    REQUIRE(match(R"({"a": {"$exists": false}})", R"({"b": 1})"));
+    REQUIRE(!match(R"({"a": {"$exists": 0}})", R"({"a": 1})"));
+}
+
+TEST_CASE("matcher evaluates logical operators", "[bsoncxx::matcher]") {
+    const char* filter = R"({"$or": [{"a": 1}, {"b": {"$gt": 5}}], "c": {"$exists": false}})";
+    REQUIRE(match(filter, R"({"a": 1})"));
+    REQUIRE(match(filter, R"({"a": 2, "b": 6})"));
+    REQUIRE(!match(filter, R"({"a": 2, "b": 5})"));
+    REQUIRE(!match(filter, R"({"a": 1, "c": 0})"));
+
+    REQUIRE(match(R"({"$and": [{"a": {"$gt": 1}}, {"a": {"$lt": 5}}]})", R"({"a": 3})"));
+    REQUIRE(!match(R"({"$and": [{"a": {"$gt": 1}}, {"a": {"$lt": 5}}]})", R"({"a": 5})"));
+    REQUIRE(match(R"({"$nor": [{"a": 1}, {"b": 1}]})", R"({"a": 2})"));
+    REQUIRE(!match(R"({"$nor": [{"a": 1}, {"b": 1}]})", R"({"b": 1})"));
+}
+
+TEST_CASE("matcher follows dotted paths", "[bsoncxx::matcher]") {
+    REQUIRE(match(R"({"a.b.c": 1})", R"({"a": {"b": {"c": 1}}})"));
+    REQUIRE(!match(R"({"a.b.c": 1})", R"({"a": {"b": 1}})"));
+    REQUIRE(match(R"({"a.b": {"$exists": false}})", R"({"a": 1})"));
+
+    SECTION("paths descend into arrays of documents") {
+        REQUIRE(match(R"({"a.b": 2})", R"({"a": [{"b": 1}, {"b": 2}]})"));
+        REQUIRE(match(R"({"a.b": {"$gt": 1}})", R"({"a": [{"b": [0, 3]}]})"));
+        REQUIRE(!match(R"({"a.b": 3})", R"({"a": [{"b": 1}, {"c": 3}]})"));
+        REQUIRE(match(R"({"a.b": null})", R"({"a": [{"b": 1}, {"c": 3}]})"));
+        REQUIRE(!match(R"({"a.b": {"$exists": false}})", R"({"a": [{"b": 1}, {"c": 3}]})"));
+    }
+
+    SECTION("numeric components select array elements") {
+        REQUIRE(match(R"({"a.1": 5})", R"({"a": [4, 5]})"));
+        REQUIRE(!match(R"({"a.0": 5})", R"({"a": [4, 5]})"));
+        REQUIRE(match(R"({"a.0.b": "x"})", R"({"a": [{"b": "x"}]})"));
+        REQUIRE(match(R"({"a.0": 5})", R"({"a": {"0": 5}})"));
+    }
+}
+
+TEST_CASE("matcher evaluates $elemMatch", "[bsoncxx::matcher]") {
+    const char* values = R"({"a": {"$elemMatch": {"$gt": 1, "$lt": 3}}})";
+    REQUIRE(match(values, R"({"a": [0, 2, 5]})"));
+    REQUIRE(!match(values, R"({"a": [0, 5]})"));
+    REQUIRE(!match(values, R"({"a": 2})"));
+
+    const char* documents = R"({"a": {"$elemMatch": {"b": 1, "c": {"$gt": 1}}}})";
+    REQUIRE(match(documents, R"({"a": [{"b": 1, "c": 2}]})"));
+    REQUIRE(!match(documents, R"({"a": [{"b": 1, "c": 0}, {"b": 2, "c": 2}]})"));
+
+    REQUIRE(match(R"({"a": {"$elemMatch": {"$or": [{"b": 1}, {"c": 1}]}}})",
+                  R"({"a": [{"c": 1}]})"));
+}
+
+TEST_CASE("matcher rejects unsupported filters", "[bsoncxx::matcher]") {
+    auto rejects = [](const char* filter) {
+        try {
+            matcher{from_json(filter).view()};
+        } catch (const bsoncxx::exception& e) {
+            return e.code() == error_code::k_invalid_query_filter;
+        }
+        return false;
+    };
+
+    REQUIRE(rejects(R"({"$where": "true"})"));
+    REQUIRE(rejects(R"({"a": {"$not": {"$gt": 1}}})"));
+    REQUIRE(rejects(R"({"a": {"$regularExpression": {"pattern": "x", "options": ""}}})"));
+    REQUIRE(rejects(R"({"a": {"$in": 1}})"));
+    REQUIRE(rejects(R"({"a": {"$elemMatch": 1}})"));
+    REQUIRE(rejects(R"({"$or": []})"));
+    REQUIRE(rejects(R"({"$and": [1]})"));
+    REQUIRE(rejects(R"({"a..b": 1})"));
+    REQUIRE(rejects(R"({"a": {"$gt": 1, "b": 1}})"));
+}
+
+TEST_CASE("matcher owns a copy of its filter", "[bsoncxx::matcher]") {
+    auto make = [] { return matcher{from_json(R"({"a": {"$in": [1, 2]}})").view()}; };
+
+    matcher m = make();
+    REQUIRE(m.filter() == from_json(R"({"a": {"$in": [1, 2]}})").view());
+    REQUIRE(m.matches(from_json(R"({"a": 2})").view()));
+
+    matcher moved{std::move(m)};
+    REQUIRE(moved.matches(from_json(R"({"a": 1})").view()));
+}
+
+}  // namespace
@@ -0,0 +1,723 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <mongocxx/arrow_export.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+#include <bsoncxx/stdx/make_unique.hpp>
+#include <mongocxx/exception/error_code.hpp>
+#include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/private/field_decoder.hh>
+#include <mongocxx/private/libbson.hh>
+
+#include <mongocxx/config/private/prelude.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+namespace {
+
+constexpr std::int32_t k_default_batch_size = 65536;
+
+void push_bit(std::vector<std::uint8_t>& bits, std::int64_t index, bool value) {
+    if (index % 8 == 0) {
+        bits.push_back(0);
+    }
+    if (value) {
+        bits.back() |= static_cast<std::uint8_t>(1u << (index % 8));
+    }
+}
+
+std::int32_t checked_offset(std::size_t offset, const std::string& name) {
+    if (offset > static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max())) {
+        throw logic_error{error_code::k_invalid_parameter,
+                          "Arrow column " + name + " exceeds 2^31 elements or bytes in a batch"};
+    }
+    return static_cast<std::int32_t>(offset);
+}
+
+// Accumulates the values of one field of a batch in the buffers of its Arrow array.
+struct column_builder {
+    explicit column_builder(const arrow_field& field) : name{field.name()}, type{field.type()} {
+        for (const auto& child : field.children()) {
+            children.emplace_back(child);
+        }
+        reset();
+    }
+
+    void reset() {
+        length = 0;
+        null_count = 0;
+        validity.clear();
+        values.clear();
+        data.clear();
+        offsets.clear();
+        if (type == bsoncxx::type::k_utf8 || type == bsoncxx::type::k_array) {
+            offsets.push_back(0);
+        }
+        decoder.reset(children.size());
+        for (auto& child : children) {
+            child.reset();
+        }
+    }
+
+    template <typename T>
+    void push_fixed(T value) {
+        const auto* bytes = reinterpret_cast<const std::uint8_t*>(&value);
+        values.insert(values.end(), bytes, bytes + sizeof(T));
+    }
+
+    void push_validity(bool valid) {
+        push_bit(validity, length, valid);
+        if (!valid) {
+            ++null_count;
+        }
+        ++length;
+    }
+
+    void append_null() {
+        switch (type) {
+            case bsoncxx::type::k_double:
+                push_fixed(0.0);
+                break;
+            case bsoncxx::type::k_int64:
+            case bsoncxx::type::k_date:
+                push_fixed(std::int64_t{0});
+                break;
+            case bsoncxx::type::k_int32:
+                push_fixed(std::int32_t{0});
+                break;
+            case bsoncxx::type::k_bool:
+                push_bit(values, length, false);
+                break;
+            case bsoncxx::type::k_utf8:
+                offsets.push_back(offsets.back());
+                break;
+            case bsoncxx::type::k_document:
+                // The children of a struct have as many rows as the struct itself.
+                for (auto& child : children) {
+                    child.append_null();
+                }
+                break;
+            case bsoncxx::type::k_array:
+                offsets.push_back(offsets.back());
+                break;
+            default:
+                break;
+        }
+        push_validity(false);
+    }
+
+    // Appends the value at iter, or a null if it does not have a type this column accepts.
+    void append(const bson_iter_t* iter) {
+        if (!try_append(iter)) {
+            append_null();
+        }
+    }
+
+    // Appends the value at iter, returning false without appending anything if it does not have
+    // a type this column accepts.
+    bool try_append(const bson_iter_t* iter) {
+        const bson_type_t value_type = bson_iter_type(iter);
+
+        switch (type) {
+            case bsoncxx::type::k_document: {
+                bson_iter_t child;
+                if (value_type != BSON_TYPE_DOCUMENT || !bson_iter_recurse(iter, &child)) {
+                    return false;
+                }
+                append_fields(&child);
+                break;
+            }
+            case bsoncxx::type::k_array: {
+                bson_iter_t element;
+                if (value_type != BSON_TYPE_ARRAY || !bson_iter_recurse(iter, &element)) {
+                    return false;
+                }
+                auto& items = children.front();
+                while (bson_iter_next(&element)) {
+                    items.append(&element);
+                }
+                offsets.push_back(checked_offset(static_cast<std::size_t>(items.length), name));
+                break;
+            }
+            default: {
+                field_decoder::scalar value;
+                if (!field_decoder::read_scalar(type, iter, &value)) {
+                    return false;
+                }
+                push_scalar(value);
+                break;
+            }
+        }
+
+        push_validity(true);
+        return true;
+    }
+
+    void push_scalar(const field_decoder::scalar& value) {
+        switch (type) {
+            case bsoncxx::type::k_double:
+                push_fixed(value.f64);
+                break;
+            case bsoncxx::type::k_int64:
+            case bsoncxx::type::k_date:
+                push_fixed(value.i64);
+                break;
+            case bsoncxx::type::k_int32:
+                push_fixed(value.i32);
+                break;
+            case bsoncxx::type::k_bool:
+                push_bit(values, length, value.b);
+                break;
+            case bsoncxx::type::k_utf8:
+                data.append(value.str.data(), value.str.size());
+                offsets.push_back(checked_offset(data.size(), name));
+                break;
+            default:
+                break;
+        }
+    }
+
+    // Appends one row to each child of a struct from the elements of a document, walking the
+    // document once. Children whose field is missing get a null.
+    void append_fields(bson_iter_t* iter) {
+        decoder.start_document();
+        decoder.walk(
+            iter,
+            [&](const char* key, bson_iter_t*) -> std::size_t {
+                for (std::size_t i = 0; i < children.size(); ++i) {
+                    if (std::strcmp(children[i].name.c_str(), key) == 0) {
+                        return i;
+                    }
+                }
+                return field_decoder::k_no_field;
+            },
+            [&](std::size_t i, bson_iter_t* value) { return children[i].try_append(value); });
+
+        if (decoder.unfilled() > 0) {
+            for (std::size_t i = 0; i < children.size(); ++i) {
+                if (!decoder.filled(i)) {
+                    children[i].append_null();
+                }
+            }
+        }
+    }
+
+    std::string name;
+    bsoncxx::type type;
+
+    std::int64_t length;
+    std::int64_t null_count;
+    std::vector<std::uint8_t> validity;
+
+    // Fixed-width values, or the bitmap of a boolean column.
+    std::vector<std::uint8_t> values;
+
+    // The offsets of a utf8 or list column, and the bytes of a utf8 column.
+    std::vector<std::int32_t> offsets;
+    std::string data;
+
+    // The fields of a struct column, or the single element column of a list column.
+    std::vector<column_builder> children;
+
+    // Tracks the children of a struct column filled in the row being appended.
+    field_decoder decoder;
+};
+
+// Owns the buffers and children of an exported array until the consumer releases it.
+struct exported_array {
+    std::vector<std::uint8_t> validity;
+    std::vector<std::uint8_t> values;
+    std::vector<std::int32_t> offsets;
+    std::string data;
+    std::vector<const void*> buffers;
+    std::vector<ArrowArray> children;
+    std::vector<ArrowArray*> child_pointers;
+};
+
+void release_array(ArrowArray* array) {
+    auto* exported = static_cast<exported_array*>(array->private_data);
+
+    // A consumer may have moved a child out, marking it released.
+    for (auto& child : exported->children) {
+        if (child.release) {
+            child.release(&child);
+        }
+    }
+
+    delete exported;
+    array->release = nullptr;
+}
+
+// Moves the buffers of a column into an exported array, leaving the column empty.
+void export_column(column_builder& column, ArrowArray* out) {
+    auto exported = stdx::make_unique<exported_array>();
+    exported->validity = std::move(column.validity);
+    exported->values = std::move(column.values);
+    exported->offsets = std::move(column.offsets);
+    exported->data = std::move(column.data);
+
+    // The validity buffer may be omitted when there are no nulls.
+    exported->buffers.push_back(column.null_count > 0 ? exported->validity.data() : nullptr);
+
+    switch (column.type) {
+        case bsoncxx::type::k_utf8:
+            exported->buffers.push_back(exported->offsets.data());
+            exported->buffers.push_back(exported->data.data());
+            break;
+        case bsoncxx::type::k_array:
+            exported->buffers.push_back(exported->offsets.data());
+            break;
+        case bsoncxx::type::k_document:
+            break;
+        default:
+            exported->buffers.push_back(exported->values.data());
+            break;
+    }
+
+    exported->children.resize(column.children.size());
+    for (std::size_t i = 0; i < column.children.size(); ++i) {
+        export_column(column.children[i], &exported->children[i]);
+        exported->child_pointers.push_back(&exported->children[i]);
+    }
+
+    out->length = column.length;
+    out->null_count = column.null_count;
+    out->offset = 0;
+    out->n_buffers = static_cast<std::int64_t>(exported->buffers.size());
+    out->n_children = static_cast<std::int64_t>(exported->children.size());
+    out->buffers = exported->buffers.data();
+    out->children = exported->child_pointers.empty() ? nullptr : exported->child_pointers.data();
+    out->dictionary = nullptr;
+    out->release = release_array;
+    out->private_data = exported.release();
+
+    column.reset();
+}
+
+// Owns the strings and children of an exported schema until the consumer releases it.
+struct exported_schema {
+    std::string format;
+    std::string name;
+    std::vector<ArrowSchema> children;
+    std::vector<ArrowSchema*> child_pointers;
+};
+
+void release_schema(ArrowSchema* schema) {
+    auto* exported = static_cast<exported_schema*>(schema->private_data);
+
+    for (auto& child : exported->children) {
+        if (child.release) {
+            child.release(&child);
+        }
+    }
+
+    delete exported;
+    schema->release = nullptr;
+}
+
+const char* format_of(bsoncxx::type type) {
+    switch (type) {
+        case bsoncxx::type::k_double:
+            return "g";
+        case bsoncxx::type::k_int64:
+            return "l";
+        case bsoncxx::type::k_int32:
+            return "i";
+        case bsoncxx::type::k_bool:
+            return "b";
+        case bsoncxx::type::k_date:
+            return "tsm:UTC";
+        case bsoncxx::type::k_utf8:
+            return "u";
+        case bsoncxx::type::k_array:
+            return "+l";
+        default:
+            return "+s";
+    }
+}
+
+void export_field(const std::string& name,
+                  bsoncxx::type type,
+                  const std::vector<arrow_field>& children,
+                  std::int64_t flags,
+                  ArrowSchema* out) {
+    auto exported = stdx::make_unique<exported_schema>();
+    exported->format = format_of(type);
+    exported->name = name;
+
+    exported->children.resize(children.size());
+    for (std::size_t i = 0; i < children.size(); ++i) {
+        const auto& child = children[i];
+        export_field(child.name(),
+                     child.type(),
+                     child.children(),
+                     ARROW_FLAG_NULLABLE,
+                     &exported->children[i]);
+        exported->child_pointers.push_back(&exported->children[i]);
+    }
+
+    out->format = exported->format.c_str();
+    out->name = exported->name.c_str();
+    out->metadata = nullptr;
+    out->flags = flags;
+    out->n_children = static_cast<std::int64_t>(exported->children.size());
+    out->children = exported->child_pointers.empty() ? nullptr : exported->child_pointers.data();
+    out->dictionary = nullptr;
+    out->release = release_schema;
+    out->private_data = exported.release();
+}
+
+bool is_scalar_type(bsoncxx::type type) {
+    switch (type) {
+        case bsoncxx::type::k_double:
+        case bsoncxx::type::k_int64:
+        case bsoncxx::type::k_int32:
+        case bsoncxx::type::k_bool:
+        case bsoncxx::type::k_date:
+        case bsoncxx::type::k_utf8:
+            return true;
+        default:
+            return false;
+    }
+}
+
+}  // namespace
+
+arrow_field::arrow_field(std::string name, bsoncxx::type type, std::vector<arrow_field> children)
+    : _name{std::move(name)}, _type{type}, _children{std::move(children)} {
+    if (type == bsoncxx::type::k_document) {
+        if (_children.empty()) {
+            throw logic_error{error_code::k_invalid_parameter,
+                              "Arrow struct field " + _name + " requires at least one child"};
+        }
+    } else if (type == bsoncxx::type::k_array) {
+        if (_children.size() != 1) {
+            throw logic_error{error_code::k_invalid_parameter,
+                              "Arrow list field " + _name + " requires exactly one child"};
+        }
+    } else if (!is_scalar_type(type)) {
+        throw logic_error{error_code::k_invalid_parameter,
+                          "unsupported type for Arrow field " + _name};
+    } else if (!_children.empty()) {
+        throw logic_error{error_code::k_invalid_parameter,
+                          "Arrow field " + _name + " of a scalar type cannot have children"};
+    }
+}
+
+const std::string& arrow_field::name() const {
+    return _name;
+}
+
+bsoncxx::type arrow_field::type() const {
+    return _type;
+}
+
+const std::vector<arrow_field>& arrow_field::children() const {
+    return _children;
+}
+
+class arrow_exporter::impl {
+   public:
+    impl(class cursor cursor,
+         std::vector<arrow_field> schema,
+         std::int32_t batch_size,
+         std::int32_t threads)
+        : cursor{std::move(cursor)},
+          schema{std::move(schema)},
+          batch_size{batch_size},
+          threads{threads},
+          root{arrow_field{"", bsoncxx::type::k_document, this->schema}} {}
+
+    ~impl() {
+        {
+            std::lock_guard<std::mutex> lock{workers_mutex};
+            stopping = true;
+        }
+        batch_ready.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    // Fills the columns from the documents of the batch, one top-level column per thread at a
+    // time. Each thread looks its columns up in every document rather than walking it once. The
+    // calling thread fills its share alongside workers that are started with the first batch and
+    // kept until the exporter is destroyed, so small batches do not pay for starting threads.
+    void fill_in_parallel() {
+        if (workers.empty()) {
+            start_workers();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock{workers_mutex};
+            stride = workers.size() + 1;
+            errors.assign(stride, nullptr);
+            pending = workers.size();
+            ++generation;
+        }
+        batch_ready.notify_all();
+
+        fill_columns(0);
+
+        {
+            std::unique_lock<std::mutex> lock{workers_mutex};
+            batch_done.wait(lock, [this] { return pending == 0; });
+        }
+
+        for (const auto& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+
+        for (std::size_t d = 0; d < document_offsets.size(); ++d) {
+            root.push_validity(true);
+        }
+    }
+
+    void start_workers() {
+        const std::size_t thread_count =
+            std::min(static_cast<std::size_t>(threads), root.children.size());
+
+        workers.reserve(thread_count - 1);
+        for (std::size_t t = 1; t < thread_count; ++t) {
+            workers.emplace_back([this, t] {
+                std::uint64_t filled = 0;
+                for (;;) {
+                    {
+                        std::unique_lock<std::mutex> lock{workers_mutex};
+                        batch_ready.wait(lock, [this, filled] {
+                            return stopping || generation != filled;
+                        });
+                        if (stopping) {
+                            return;
+                        }
+                        filled = generation;
+                    }
+
+                    fill_columns(t);
+
+                    std::lock_guard<std::mutex> lock{workers_mutex};
+                    if (--pending == 0) {
+                        batch_done.notify_one();
+                    }
+                }
+            });
+        }
+    }
+
+    // Fills every stride-th top-level column, starting from the t-th, and records any error for
+    // the calling thread to rethrow.
+    void fill_columns(std::size_t t) {
+        try {
+            for (std::size_t d = 0; d < document_offsets.size(); ++d) {
+                const std::uint8_t* data = arena.data() + document_offsets[d];
+                const std::size_t length = document_lengths[d];
+
+                for (std::size_t c = t; c < root.children.size(); c += stride) {
+                    auto& column = root.children[c];
+                    bson_iter_t iter;
+                    const bool found =
+                        bson_iter_init_from_data(&iter, data, length) &&
+                        field_decoder::find_field(
+                            &iter, column.name.c_str(), [&](bson_iter_t* value) {
+                                return column.try_append(value);
+                            });
+                    if (!found) {
+                        column.append_null();
+                    }
+                }
+            }
+        } catch (...) {
+            errors[t] = std::current_exception();
+        }
+    }
+
+    void fill() {
+        for (std::size_t d = 0; d < document_offsets.size(); ++d) {
+            bson_iter_t iter;
+            if (bson_iter_init_from_data(
+                    &iter, arena.data() + document_offsets[d], document_lengths[d])) {
+                root.append_fields(&iter);
+            } else {
+                for (auto& column : root.children) {
+                    column.append_null();
+                }
+            }
+            root.push_validity(true);
+        }
+    }
+
+    class cursor cursor;
+    std::vector<arrow_field> schema;
+    std::int32_t batch_size;
+    std::int32_t threads;
+    column_builder root;
+
+    // The documents of the batch being exported. The cursor reuses the memory of each document it
+    // returns, so they are copied here until the batch has been decoded.
+    std::vector<std::uint8_t> arena;
+    std::vector<std::size_t> document_offsets;
+    std::vector<std::size_t> document_lengths;
+
+    // The workers of fill_in_parallel. Each batch bumps `generation` to wake them, and the last
+    // one to finish its columns wakes the calling thread.
+    std::vector<std::thread> workers;
+    std::mutex workers_mutex;
+    std::condition_variable batch_ready;
+    std::condition_variable batch_done;
+    std::uint64_t generation = 0;
+    std::size_t pending = 0;
+    std::size_t stride = 1;
+    bool stopping = false;
+    std::vector<std::exception_ptr> errors;
+};
+
+arrow_exporter::arrow_exporter(cursor cursor,
+                               std::vector<arrow_field> schema,
+                               const options::arrow_export& options) {
+    if (schema.empty()) {
+        throw logic_error{error_code::k_invalid_parameter,
+                          "an arrow_exporter schema requires at least one field"};
+    }
+
+    std::int32_t batch_size = k_default_batch_size;
+    if (auto size = options.batch_size()) {
+        if (*size <= 0) {
+            throw logic_error{error_code::k_invalid_parameter,
+                              "positive value required for options::arrow_export::batch_size()"};
+        }
+        batch_size = *size;
+    }
+
+    std::int32_t threads = 1;
+    if (auto count = options.threads()) {
+        if (*count <= 0) {
+            throw logic_error{error_code::k_invalid_parameter,
+                              "positive value required for options::arrow_export::threads()"};
+        }
+        threads = *count;
+    }
+
+    _impl = stdx::make_unique<impl>(std::move(cursor), std::move(schema), batch_size, threads);
+}
+
+arrow_exporter::arrow_exporter(arrow_exporter&&) noexcept = default;
+arrow_exporter& arrow_exporter::operator=(arrow_exporter&&) noexcept = default;
+arrow_exporter::~arrow_exporter() = default;
+
+void arrow_exporter::export_schema(ArrowSchema* out) const {
+    export_field("", bsoncxx::type::k_document, _impl->schema, 0, out);
+}
+
+bool arrow_exporter::next_batch(ArrowArray* out) {
+    _impl->arena.clear();
+    _impl->document_offsets.clear();
+    _impl->document_lengths.clear();
+
+    const auto batch_size = static_cast<std::size_t>(_impl->batch_size);
+    for (auto it = _impl->cursor.begin();
+         it != _impl->cursor.end() && _impl->document_offsets.size() < batch_size;
+         ++it) {
+        _impl->document_offsets.push_back(_impl->arena.size());
+        _impl->document_lengths.push_back(it->length());
+        _impl->arena.insert(_impl->arena.end(), it->data(), it->data() + it->length());
+    }
+
+    if (_impl->document_offsets.empty()) {
+        return false;
+    }
+
+    try {
+        if (_impl->threads > 1 && _impl->root.children.size() > 1) {
+            _impl->fill_in_parallel();
+        } else {
+            _impl->fill();
+        }
+    } catch (...) {
+        _impl->root.reset();
+        throw;
+    }
+
+    export_column(_impl->root, out);
+    return true;
+}
+
+namespace {
+
+struct stream_state {
+    explicit stream_state(arrow_exporter exporter) : exporter{std::move(exporter)} {}
+
+    arrow_exporter exporter;
+    std::string last_error;
+};
+
+int stream_get_schema(ArrowArrayStream* stream, ArrowSchema* out) {
+    auto* state = static_cast<stream_state*>(stream->private_data);
+    try {
+        state->exporter.export_schema(out);
+        return 0;
+    } catch (const std::exception& e) {
+        state->last_error = e.what();
+        return EIO;
+    }
+}
+
+int stream_get_next(ArrowArrayStream* stream, ArrowArray* out) {
+    auto* state = static_cast<stream_state*>(stream->private_data);
+    try {
+        // The end of the stream is signalled by a released array.
+        if (!state->exporter.next_batch(out)) {
+            out->release = nullptr;
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        state->last_error = e.what();
+        return EIO;
+    }
+}
+
+const char* stream_get_last_error(ArrowArrayStream* stream) {
+    auto* state = static_cast<stream_state*>(stream->private_data);
+    return state->last_error.empty() ? nullptr : state->last_error.c_str();
+}
+
+void stream_release(ArrowArrayStream* stream) {
+    delete static_cast<stream_state*>(stream->private_data);
+    stream->release = nullptr;
+}
+
+}  // namespace
+
+void arrow_exporter::export_stream(arrow_exporter exporter, ArrowArrayStream* out) {
+    out->get_schema = stream_get_schema;
+    out->get_next = stream_get_next;
+    out->get_last_error = stream_get_last_error;
+    out->release = stream_release;
+    out->private_data = new stream_state{std::move(exporter)};
+}
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
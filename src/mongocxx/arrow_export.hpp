@@ -0,0 +1,226 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <bsoncxx/types.hpp>
+#include <mongocxx/cursor.hpp>
+#include <mongocxx/options/arrow_export.hpp>
+
+// The structs of the Apache Arrow C data interface and C stream interface, as published in the
+// Arrow specification. The guards let them coexist with Arrow's own copy of the definitions.
+extern "C" {
+
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+    // Array type description
+    const char* format;
+    const char* name;
+    const char* metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema** children;
+    struct ArrowSchema* dictionary;
+
+    // Release callback
+    void (*release)(struct ArrowSchema*);
+    // Opaque producer-specific data
+    void* private_data;
+};
+
+struct ArrowArray {
+    // Array data description
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void** buffers;
+    struct ArrowArray** children;
+    struct ArrowArray* dictionary;
+
+    // Release callback
+    void (*release)(struct ArrowArray*);
+    // Opaque producer-specific data
+    void* private_data;
+};
+
+#endif  // ARROW_C_DATA_INTERFACE
+
+#ifndef ARROW_C_STREAM_INTERFACE
+#define ARROW_C_STREAM_INTERFACE
+
+struct ArrowArrayStream {
+    // Callbacks providing stream functionality
+    int (*get_schema)(struct ArrowArrayStream*, struct ArrowSchema* out);
+    int (*get_next)(struct ArrowArrayStream*, struct ArrowArray* out);
+    const char* (*get_last_error)(struct ArrowArrayStream*);
+
+    // Release callback
+    void (*release)(struct ArrowArrayStream*);
+
+    // Opaque producer-specific data
+    void* private_data;
+};
+
+#endif  // ARROW_C_STREAM_INTERFACE
+}
+
+#include <mongocxx/config/prelude.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+///
+/// A field of the schema of an arrow_exporter: the name of a document field and the Arrow type
+/// its values are exported as. Every field is nullable; a missing value, or one whose BSON type
+/// the field does not accept, is exported as null. When a document repeats a key, the first
+/// occurrence whose BSON type the field accepts is exported.
+///
+/// The types and the BSON values they accept are:
+///
+///  - bsoncxx::type::k_double: float64, from double, int32 and int64 values.
+///  - bsoncxx::type::k_int64: int64, from int32 and int64 values.
+///  - bsoncxx::type::k_int32: int32, from int32 values.
+///  - bsoncxx::type::k_bool: boolean, from boolean values.
+///  - bsoncxx::type::k_date: timestamp in milliseconds, UTC, from date values.
+///  - bsoncxx::type::k_utf8: utf8, from string values.
+///  - bsoncxx::type::k_document: struct, from subdocuments. The children are its fields.
+///  - bsoncxx::type::k_array: list, from arrays. The single child is the type of its elements,
+///    and its name is only used as the name of the list's child field.
+///
+class MONGOCXX_API arrow_field {
+   public:
+    ///
+    /// Creates a field.
+    ///
+    /// @param name
+    ///   The name of the document field.
+    /// @param type
+    ///   The type the values are exported as.
+    /// @param children
+    ///   The fields of a k_document field, or the single element field of a k_array field.
+    ///
+    /// @throws mongocxx::logic_error if the type is not supported, or if the children do not
+    /// match the type.
+    ///
+    arrow_field(std::string name, bsoncxx::type type, std::vector<arrow_field> children = {});
+
+    ///
+    /// @return The name of the document field.
+    ///
+    const std::string& name() const;
+
+    ///
+    /// @return The type the values are exported as.
+    ///
+    bsoncxx::type type() const;
+
+    ///
+    /// @return The child fields of a k_document or k_array field.
+    ///
+    const std::vector<arrow_field>& children() const;
+
+   private:
+    std::string _name;
+    bsoncxx::type _type;
+    std::vector<arrow_field> _children;
+};
+
+///
+/// Exports the documents of a cursor as Apache Arrow record batches, through the Arrow C data
+/// interface, without depending on an Arrow library.
+///
+/// Each batch is a struct array whose children are the columns of the schema's fields. The
+/// documents of a batch are read from the cursor and decoded into the columns, which the exported
+/// arrays then own; consumers read the columns in place until they release the arrays.
+///
+class MONGOCXX_API arrow_exporter {
+   public:
+    ///
+    /// Creates an exporter, taking ownership of a cursor.
+    ///
+    /// @param cursor
+    ///   The cursor whose documents are exported.
+    /// @param schema
+    ///   The top-level fields to export.
+    /// @param options
+    ///   Optional arguments, see options::arrow_export.
+    ///
+    /// @throws mongocxx::logic_error if the schema is empty or an option is not positive.
+    ///
+    arrow_exporter(cursor cursor,
+                   std::vector<arrow_field> schema,
+                   const options::arrow_export& options = {});
+
+    arrow_exporter(arrow_exporter&&) noexcept;
+    arrow_exporter& operator=(arrow_exporter&&) noexcept;
+
+    ~arrow_exporter();
+
+    ///
+    /// Exports the schema of the record batches, a struct with one child per top-level field.
+    ///
+    /// @param out
+    ///   The struct to fill. The caller must release it.
+    ///
+    void export_schema(ArrowSchema* out) const;
+
+    ///
+    /// Reads the next batch of documents from the cursor and exports them.
+    ///
+    /// @param out
+    ///   The struct to fill. The caller must release it. It is left unchanged if the cursor has
+    ///   no more documents.
+    ///
+    /// @return Whether a batch was exported.
+    ///
+    /// @throws mongocxx::query_exception if the cursor fails.
+    ///
+    bool next_batch(ArrowArray* out);
+
+    ///
+    /// Exports an exporter as an Arrow C stream, which then owns it.
+    ///
+    /// Errors raised while reading the cursor are reported through the stream's get_last_error
+    /// callback, with get_next returning EIO.
+    ///
+    /// @param exporter
+    ///   The exporter to export.
+    /// @param out
+    ///   The stream to fill. The caller must release it.
+    ///
+    static void export_stream(arrow_exporter exporter, ArrowArrayStream* out);
+
+   private:
+    class MONGOCXX_PRIVATE impl;
+    std::unique_ptr<impl> _impl;
+};
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/postlude.hpp>
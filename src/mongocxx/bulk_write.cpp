@@ -34,15 +34,66 @@ MONGOCXX_INLINE_NAMESPACE_BEGIN
 using namespace libbson;
 using bsoncxx::builder::basic::kvp;
 
+namespace {
+
+void append_document(bson_t* options, const char* key, bsoncxx::document::view value) {
+    bson_t child;
+    bson_init_static(&child, value.data(), value.length());
+    bson_append_document(options, key, -1, &child);
+}
+
+// Writes a model's options into the scratch document and returns it, or returns nullptr without
+// building anything when the model sets no options.
+bson_t* write_options(bson_t* scratch,
+                      const stdx::optional<bsoncxx::document::view_or_value>& collation,
+                      const stdx::optional<hint>& index_hint,
+                      const stdx::optional<bool>& upsert = stdx::nullopt,
+                      const stdx::optional<bsoncxx::array::view_or_value>& array_filters =
+                          stdx::nullopt) {
+    if (!collation && !index_hint && !upsert && !array_filters) {
+        return nullptr;
+    }
+
+    bson_reinit(scratch);
+
+    if (collation) {
+        append_document(scratch, "collation", collation->view());
+    }
+    if (index_hint) {
+        auto value = index_hint->to_value();
+        if (value.type() == bsoncxx::type::k_utf8) {
+            auto name = value.get_string().value;
+            bson_append_utf8(scratch, "hint", -1, name.data(), static_cast<int>(name.size()));
+        } else {
+            append_document(scratch, "hint", value.get_document().value);
+        }
+    }
+    if (upsert) {
+        bson_append_bool(scratch, "upsert", -1, *upsert);
+    }
+    if (array_filters) {
+        auto filters = array_filters->view();
+        bson_t child;
+        bson_init_static(&child, filters.data(), filters.length());
+        bson_append_array(scratch, "arrayFilters", -1, &child);
+    }
+
+    return scratch;
+}
+
+}  // namespace
+
 bulk_write::bulk_write(bulk_write&&) noexcept = default;
 bulk_write& bulk_write::operator=(bulk_write&&) noexcept = default;
 
 bulk_write::~bulk_write() = default;
 
 bulk_write& bulk_write::append(const model::write& operation) {
+    // The filter, update and replacement documents are wrapped by view so that models owning their
+    // documents are not copied; libmongoc copies what it needs into the bulk operation.
     switch (operation.type()) {
         case write_type::k_insert_one: {
-            scoped_bson_t doc(operation.get_insert_one().document());
+            scoped_bson_t doc(operation.get_insert_one().document().view());
             bson_error_t error;
             auto result = libmongoc::bulk_operation_insert_with_opts(
                 _impl->operation_t, doc.bson(), nullptr, &error);
@@ -52,120 +103,77 @@ bulk_write& bulk_write::append(const model::write& operation) {
             break;
         }
         case write_type::k_update_one: {
-            scoped_bson_t filter(operation.get_update_one().filter());
-            scoped_bson_t update(operation.get_update_one().update());
-
-            bsoncxx::builder::basic::document options_builder;
-            if (operation.get_update_one().collation()) {
-                options_builder.append(kvp("collation", *operation.get_update_one().collation()));
-            }
-            if (operation.get_update_one().hint()) {
-                options_builder.append(kvp("hint", *operation.get_update_one().hint()));
-            }
-            if (operation.get_update_one().upsert()) {
-                options_builder.append(kvp("upsert", *operation.get_update_one().upsert()));
-            }
-            if (operation.get_update_one().array_filters()) {
-                options_builder.append(
-                    kvp("arrayFilters", *operation.get_update_one().array_filters()));
-            }
-            scoped_bson_t options(options_builder.extract());
+            const auto& model = operation.get_update_one();
+            scoped_bson_t filter(model.filter().view());
+            scoped_bson_t update(model.update().view());
+            bson_t* options = write_options(&_impl->options,
+                                            model.collation(),
+                                            model.hint(),
+                                            model.upsert(),
+                                            model.array_filters());
 
             bson_error_t error;
             auto result = libmongoc::bulk_operation_update_one_with_opts(
-                _impl->operation_t, filter.bson(), update.bson(), options.bson(), &error);
+                _impl->operation_t, filter.bson(), update.bson(), options, &error);
             if (!result) {
                 throw_exception<logic_error>(error);
             }
             break;
         }
         case write_type::k_update_many: {
-            scoped_bson_t filter(operation.get_update_many().filter());
-            scoped_bson_t update(operation.get_update_many().update());
-
-            bsoncxx::builder::basic::document options_builder;
-            if (operation.get_update_many().collation()) {
-                options_builder.append(kvp("collation", *operation.get_update_many().collation()));
-            }
-            if (operation.get_update_many().hint()) {
-                options_builder.append(kvp("hint", *operation.get_update_many().hint()));
-            }
-            if (operation.get_update_many().upsert()) {
-                options_builder.append(kvp("upsert", *operation.get_update_many().upsert()));
-            }
-            if (operation.get_update_many().array_filters()) {
-                options_builder.append(
-                    kvp("arrayFilters", *operation.get_update_many().array_filters()));
-            }
-            scoped_bson_t options(options_builder.extract());
+            const auto& model = operation.get_update_many();
+            scoped_bson_t filter(model.filter().view());
+            scoped_bson_t update(model.update().view());
+            bson_t* options = write_options(&_impl->options,
+                                            model.collation(),
+                                            model.hint(),
+                                            model.upsert(),
+                                            model.array_filters());
 
             bson_error_t error;
             auto result = libmongoc::bulk_operation_update_many_with_opts(
-                _impl->operation_t, filter.bson(), update.bson(), options.bson(), &error);
+                _impl->operation_t, filter.bson(), update.bson(), options, &error);
             if (!result) {
                 throw_exception<logic_error>(error);
             }
             break;
         }
         case write_type::k_delete_one: {
-            scoped_bson_t filter(operation.get_delete_one().filter());
-
-            bsoncxx::builder::basic::document options_builder;
-            if (operation.get_delete_one().collation()) {
-                options_builder.append(kvp("collation", *operation.get_delete_one().collation()));
-            }
-            if (operation.get_delete_one().hint()) {
-                options_builder.append(kvp("hint", *operation.get_delete_one().hint()));
-            }
-            scoped_bson_t options(options_builder.extract());
+            const auto& model = operation.get_delete_one();
+            scoped_bson_t filter(model.filter().view());
+            bson_t* options = write_options(&_impl->options, model.collation(), model.hint());
 
             bson_error_t error;
             auto result = libmongoc::bulk_operation_remove_one_with_opts(
-                _impl->operation_t, filter.bson(), options.bson(), &error);
+                _impl->operation_t, filter.bson(), options, &error);
             if (!result) {
                 throw_exception<logic_error>(error);
             }
             break;
         }
         case write_type::k_delete_many: {
-            scoped_bson_t filter(operation.get_delete_many().filter());
-
-            bsoncxx::builder::basic::document options_builder;
-            if (operation.get_delete_many().collation()) {
-                options_builder.append(kvp("collation", *operation.get_delete_many().collation()));
-            }
-            if (operation.get_delete_many().hint()) {
-                options_builder.append(kvp("hint", *operation.get_delete_many().hint()));
-            }
-            scoped_bson_t options(options_builder.extract());
+            const auto& model = operation.get_delete_many();
+            scoped_bson_t filter(model.filter().view());
+            bson_t* options = write_options(&_impl->options, model.collation(), model.hint());
 
             bson_error_t error;
             auto result = libmongoc::bulk_operation_remove_many_with_opts(
-                _impl->operation_t, filter.bson(), options.bson(), &error);
+                _impl->operation_t, filter.bson(), options, &error);
             if (!result) {
                 throw_exception<logic_error>(error);
             }
             break;
         }
         case write_type::k_replace_one: {
-            scoped_bson_t filter(operation.get_replace_one().filter());
-            scoped_bson_t replace(operation.get_replace_one().replacement());
-
-            bsoncxx::builder::basic::document options_builder;
-            if (operation.get_replace_one().collation()) {
-                options_builder.append(kvp("collation", *operation.get_replace_one().collation()));
-            }
-            if (operation.get_replace_one().hint()) {
-                options_builder.append(kvp("hint", *operation.get_replace_one().hint()));
-            }
-            if (operation.get_replace_one().upsert()) {
-                options_builder.append(kvp("upsert", *operation.get_replace_one().upsert()));
-            }
-            scoped_bson_t options(options_builder.extract());
+            const auto& model = operation.get_replace_one();
+            scoped_bson_t filter(model.filter().view());
+            scoped_bson_t replace(model.replacement().view());
+            bson_t* options =
+                write_options(&_impl->options, model.collation(), model.hint(), model.upsert());
 
             bson_error_t error;
             auto result = libmongoc::bulk_operation_replace_one_with_opts(
-                _impl->operation_t, filter.bson(), replace.bson(), options.bson(), &error);
+                _impl->operation_t, filter.bson(), replace.bson(), options, &error);
             if (!result) {
                 throw_exception<logic_error>(error);
             }
@@ -195,6 +203,25 @@ stdx::optional<result::bulk_write> bulk_write::execute() const {
     return stdx::optional<result::bulk_write>(std::move(result));
 }
 
+stdx::optional<result::bulk_write> bulk_write::execute(std::error_code& ec) const {
+    mongoc_bulk_operation_t* b = _impl->operation_t;
+    scoped_bson_t reply;
+    bson_error_t error;
+
+    if (!libmongoc::bulk_operation_execute(b, reply.bson_for_init(), &error)) {
+        ec = make_error_code(error);
+        return stdx::nullopt;
+    }
+
+    ec.clear();
+
+    if (reply.view().empty()) {
+        return stdx::nullopt;
+    }
+
+    return stdx::optional<result::bulk_write>(result::bulk_write(reply.steal()));
+}
+
 bulk_write::bulk_write(const collection& coll,
                        const options::bulk_write& options,
                        const client_session* session)
@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <system_error>
+
 #include <mongocxx/client_session.hpp>
 #include <mongocxx/model/write.hpp>
 #include <mongocxx/options/bulk_write.hpp>
@@ -92,6 +94,23 @@ class MONGOCXX_API bulk_write {
     ///
     stdx::optional<result::bulk_write> execute() const;
 
+    ///
+    /// Executes a bulk write, reporting a failure through an error code instead of throwing.
+    ///
+    /// The server's reply to a failed bulk write, including its writeErrors, is discarded rather
+    /// than copied into an exception; use execute() where it is needed.
+    ///
+    /// @param ec
+    ///   Set to the error if the writes could not be processed, otherwise cleared. The code is the
+    ///   one that mongocxx::bulk_write_exception::code() would have returned.
+    ///
+    /// @return The optional result of the bulk operation execution, a result::bulk_write. It is
+    ///   disengaged if the writes failed or if the write concern is unacknowledged.
+    ///
+    /// @see https://docs.mongodb.com/master/core/bulk-write-operations/
+    ///
+    stdx::optional<result::bulk_write> execute(std::error_code& ec) const;
+
    private:
     friend class collection;
 
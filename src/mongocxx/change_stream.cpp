@@ -59,9 +59,39 @@ stdx::optional<bsoncxx::document::view> change_stream::get_resume_token() const
     return _impl->get_resume_token();
 }
 
+change_stream::batch change_stream::next_batch() {
+    const auto& events = _impl->advance_batch();
+    return batch{&events, _impl->get_resume_token()};
+}
+
 // void* since we don't leak C driver defs into C++ driver
-change_stream::change_stream(void* change_stream_ptr)
-    : _impl(stdx::make_unique<impl>(static_cast<mongoc_change_stream_t*>(change_stream_ptr))) {}
+change_stream::change_stream(void* change_stream_ptr, stdx::optional<std::int32_t> batch_size)
+    : _impl(stdx::make_unique<impl>(static_cast<mongoc_change_stream_t*>(change_stream_ptr),
+                                    batch_size)) {}
+
+change_stream::batch::batch(const std::vector<bsoncxx::document::view>* events,
+                            stdx::optional<bsoncxx::document::view> resume_token)
+    : _events{events}, _resume_token{std::move(resume_token)} {}
+
+change_stream::batch::const_iterator change_stream::batch::begin() const {
+    return _events->begin();
+}
+
+change_stream::batch::const_iterator change_stream::batch::end() const {
+    return _events->end();
+}
+
+std::size_t change_stream::batch::size() const {
+    return _events->size();
+}
+
+bool change_stream::batch::empty() const {
+    return _events->empty();
+}
+
+const stdx::optional<bsoncxx::document::view>& change_stream::batch::resume_token() const {
+    return _resume_token;
+}
 
 change_stream::iterator::iterator()
     : change_stream::iterator::iterator{iter_type::k_default_constructed, nullptr} {}
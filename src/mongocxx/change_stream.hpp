@@ -14,7 +14,9 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 #include <bsoncxx/document/view.hpp>
 #include <bsoncxx/stdx/optional.hpp>
@@ -32,6 +34,8 @@ class MONGOCXX_API change_stream {
    public:
     class MONGOCXX_API iterator;
 
+    class MONGOCXX_API batch;
+
     ///
     /// Move constructs a change_stream.
     ///
@@ -103,13 +107,50 @@ class MONGOCXX_API change_stream {
     ///
     bsoncxx::stdx::optional<bsoncxx::document::view> get_resume_token() const;
 
+    ///
+    /// Returns every notification remaining in the current server batch at once, together with
+    /// the resume token to use after the last of them.
+    ///
+    /// This lets consumers apply a whole batch in one step, such as a single bulk_write
+    /// downstream, and checkpoint once per batch instead of once per notification.
+    ///
+    /// libmongoc does not report where a server batch ends, so a batch returned here ends at
+    /// whichever comes first:
+    ///
+    ///   - a postBatchResumeToken that differs from the last notification's _id;
+    ///   - batch_size (from the options::change_stream) notifications;
+    ///   - 16 MiB of notifications, the most a single server reply can carry;
+    ///   - a getMore that returns no notifications, which may take up to max_await_time (from the
+    ///     options::change_stream) milliseconds.
+    ///
+    /// A returned batch may therefore span several server batches, but its size stays bounded.
+    ///
+    /// If an error occurs after some notifications of a batch have already been read, those
+    /// notifications are returned and the error is reported by the next call.
+    ///
+    /// Any iterators over this change_stream compare equal to end() after this call. Iteration
+    /// and next_batch() may be mixed freely.
+    ///
+    /// @return
+    ///   The change_stream::batch. It may be empty, in which case its resume token still reflects
+    ///   the latest position reported by the server. The batch refers to memory owned by this
+    ///   change_stream and is invalidated by the next call to next_batch() or begin(), or by
+    ///   incrementing an iterator.
+    ///
+    /// @exception
+    ///   Throws mongocxx::query_exception if the query failed.
+    ///
+    batch next_batch();
+
    private:
     friend class client;
     friend class collection;
     friend class database;
     friend class change_stream::iterator;
 
-    MONGOCXX_PRIVATE change_stream(void* change_stream_ptr);
+    MONGOCXX_PRIVATE change_stream(
+        void* change_stream_ptr,
+        bsoncxx::stdx::optional<std::int32_t> batch_size = bsoncxx::stdx::nullopt);
 
     class MONGOCXX_PRIVATE impl;
     std::unique_ptr<impl> _impl;
@@ -195,6 +236,61 @@ class MONGOCXX_API change_stream::iterator {
     const change_stream* _change_stream;
 };
 
+///
+/// A read-only range over the notifications of one server batch, as returned by
+/// change_stream::next_batch().
+///
+/// The notifications are views into a buffer owned by the change_stream; no per-notification
+/// allocation is made while consuming the batch.
+///
+class MONGOCXX_API change_stream::batch {
+   public:
+    using const_iterator = std::vector<bsoncxx::document::view>::const_iterator;
+
+    ///
+    /// @return
+    ///   An iterator to the first notification of the batch.
+    ///
+    const_iterator begin() const;
+
+    ///
+    /// @return
+    ///   An iterator past the last notification of the batch.
+    ///
+    const_iterator end() const;
+
+    ///
+    /// @return
+    ///   The number of notifications in the batch.
+    ///
+    std::size_t size() const;
+
+    ///
+    /// @return
+    ///   Whether the batch contains no notifications.
+    ///
+    bool empty() const;
+
+    ///
+    /// Returns the token to resume after this batch. This is the server's postBatchResumeToken
+    /// if one was reported, and otherwise the resume token of the last notification.
+    ///
+    /// @return
+    ///   The token, or no token if the stream has neither been iterated nor given a starting
+    ///   point. Like the notifications, it is invalidated by further use of the change_stream.
+    ///
+    const bsoncxx::stdx::optional<bsoncxx::document::view>& resume_token() const;
+
+   private:
+    friend class change_stream;
+
+    MONGOCXX_PRIVATE batch(const std::vector<bsoncxx::document::view>* events,
+                           bsoncxx::stdx::optional<bsoncxx::document::view> resume_token);
+
+    const std::vector<bsoncxx::document::view>* _events;
+    bsoncxx::stdx::optional<bsoncxx::document::view> _resume_token;
+};
+
 MONGOCXX_INLINE_NAMESPACE_END
 }  // namespace mongocxx
 
@@ -0,0 +1,294 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <mongocxx/change_stream_dispatcher.hpp>
+
+#include <limits>
+
+#include <bsoncxx/private/libbson.hh>
+#include <bsoncxx/stdx/make_unique.hpp>
+#include <bsoncxx/types.hpp>
+#include <mongocxx/exception/error_code.hpp>
+#include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/private/change_stream_dispatcher.hh>
+
+#include <mongocxx/config/private/prelude.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+namespace {
+
+constexpr std::int32_t k_default_max_pending_events = 1024;
+
+// FNV-1a over the type byte and value bytes of an element. The key is skipped so that equal values
+// stored under different field names still land on the same worker.
+std::uint64_t hash_element(const bsoncxx::document::element& element) {
+    bson_iter_t iter;
+    if (!bson_iter_init_from_data_at_offset(
+            &iter, element.raw(), element.length(), element.offset(), element.keylen())) {
+        return 0;
+    }
+
+    std::uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](std::uint8_t byte) {
+        hash ^= byte;
+        hash *= 1099511628211ULL;
+    };
+
+    mix(element.raw()[element.offset()]);
+    for (std::uint32_t i = element.offset() + element.keylen() + 2; i < iter.next_off; ++i) {
+        mix(element.raw()[i]);
+    }
+
+    return hash;
+}
+
+}  // namespace
+
+change_stream_dispatcher::impl::impl(
+    change_stream* stream,
+    handler_type handler,
+    options::change_stream_dispatcher::key_extractor_type key_extractor,
+    std::size_t worker_count,
+    std::size_t max_pending)
+    : stream{stream},
+      handler{std::move(handler)},
+      key_extractor{std::move(key_extractor)},
+      max_pending{max_pending},
+      first_seq{0},
+      next_seq{0},
+      first_unhandled_seq{std::numeric_limits<std::uint64_t>::max()},
+      stopping{false} {
+    workers.reserve(worker_count);
+    for (std::size_t i = 0; i < worker_count; ++i) {
+        workers.push_back(stdx::make_unique<worker>());
+    }
+
+    try {
+        for (auto&& w : workers) {
+            worker* raw = w.get();
+            w->thread = std::thread{[this, raw] { run(*raw); }};
+        }
+    } catch (...) {
+        shutdown();
+        throw;
+    }
+}
+
+change_stream_dispatcher::impl::~impl() {
+    shutdown();
+}
+
+void change_stream_dispatcher::impl::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        stopping = true;
+    }
+
+    for (auto&& w : workers) {
+        w->cv.notify_all();
+    }
+
+    for (auto&& w : workers) {
+        if (w->thread.joinable()) {
+            w->thread.join();
+        }
+    }
+}
+
+change_stream_dispatcher::impl::worker& change_stream_dispatcher::impl::worker_for(
+    const bsoncxx::document::view& event) {
+    auto key = key_extractor ? key_extractor(event) : event["documentKey"];
+    if (!key) {
+        return *workers.front();
+    }
+
+    return *workers[static_cast<std::size_t>(hash_element(key) % workers.size())];
+}
+
+std::size_t change_stream_dispatcher::impl::dispatch() {
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        rethrow_if_failed();
+    }
+
+    std::size_t count = 0;
+
+    for (auto&& view : *stream) {
+        worker& w = worker_for(view);
+
+        bsoncxx::document::value doc{view};
+        stdx::optional<bsoncxx::document::value> token;
+        auto id = view["_id"];
+        if (id && id.type() == bsoncxx::type::k_document) {
+            token = bsoncxx::document::value{id.get_document().value};
+        }
+
+        std::unique_lock<std::mutex> lock{mutex};
+        progress_cv.wait(lock, [&] { return error || in_flight.size() < max_pending; });
+        rethrow_if_failed();
+
+        in_flight.push_back(slot{false, std::move(token)});
+        w.queue.push_back(event{next_seq++, std::move(doc)});
+        w.cv.notify_one();
+        ++count;
+    }
+
+    // Once the current batch is exhausted the stream may report a postBatchResumeToken that is
+    // newer than the last event. It becomes safe as soon as everything read so far is handled.
+    if (auto token = stream->get_resume_token()) {
+        std::lock_guard<std::mutex> lock{mutex};
+        if (in_flight.empty()) {
+            safe_token = bsoncxx::document::value{*token};
+        } else {
+            in_flight.back().token = bsoncxx::document::value{*token};
+        }
+    }
+
+    return count;
+}
+
+void change_stream_dispatcher::impl::wait() {
+    std::unique_lock<std::mutex> lock{mutex};
+    progress_cv.wait(lock, [&] { return in_flight.empty(); });
+    rethrow_if_failed();
+}
+
+stdx::optional<bsoncxx::document::value> change_stream_dispatcher::impl::safe_resume_token()
+    const {
+    std::lock_guard<std::mutex> lock{mutex};
+    return safe_token;
+}
+
+void change_stream_dispatcher::impl::run(worker& w) {
+    std::unique_lock<std::mutex> lock{mutex};
+
+    for (;;) {
+        w.cv.wait(lock, [&] { return stopping || !w.queue.empty(); });
+
+        // Only exit once the queue is drained so that dispatched events are never dropped.
+        if (w.queue.empty()) {
+            return;
+        }
+
+        event ev = std::move(w.queue.front());
+        w.queue.pop_front();
+
+        // After a handler failure the remaining events are retired without being handled, so that
+        // the safe resume token never advances past the failed event.
+        const bool failed = static_cast<bool>(error);
+
+        lock.unlock();
+        bool handled = false;
+        std::exception_ptr handler_error;
+        if (!failed) {
+            try {
+                handler(ev.doc.view());
+                handled = true;
+            } catch (...) {
+                handler_error = std::current_exception();
+            }
+        }
+        lock.lock();
+
+        if (handler_error && !error) {
+            error = handler_error;
+        }
+
+        mark_done(ev.seq, handled);
+        progress_cv.notify_all();
+    }
+}
+
+void change_stream_dispatcher::impl::mark_done(std::uint64_t seq, bool handled) {
+    if (!handled && seq < first_unhandled_seq) {
+        first_unhandled_seq = seq;
+    }
+
+    in_flight[static_cast<std::size_t>(seq - first_seq)].done = true;
+
+    while (!in_flight.empty() && in_flight.front().done) {
+        if (first_seq < first_unhandled_seq && in_flight.front().token) {
+            safe_token = std::move(in_flight.front().token);
+        }
+        in_flight.pop_front();
+        ++first_seq;
+    }
+}
+
+void change_stream_dispatcher::impl::rethrow_if_failed() const {
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+change_stream_dispatcher::change_stream_dispatcher(
+    change_stream* stream,
+    handler_type handler,
+    const options::change_stream_dispatcher& options) {
+    std::int32_t worker_count = static_cast<std::int32_t>(std::thread::hardware_concurrency());
+    if (auto count = options.worker_count()) {
+        if (*count <= 0) {
+            throw logic_error{
+                error_code::k_invalid_parameter,
+                "positive value required for options::change_stream_dispatcher::worker_count()"};
+        }
+        worker_count = *count;
+    }
+
+    if (worker_count <= 0) {
+        worker_count = 1;
+    }
+
+    std::int32_t max_pending = k_default_max_pending_events;
+    if (auto pending = options.max_pending_events()) {
+        if (*pending <= 0) {
+            throw logic_error{error_code::k_invalid_parameter,
+                              "positive value required for "
+                              "options::change_stream_dispatcher::max_pending_events()"};
+        }
+        max_pending = *pending;
+    }
+
+    _impl = stdx::make_unique<impl>(stream,
+                                    std::move(handler),
+                                    options.key_extractor(),
+                                    static_cast<std::size_t>(worker_count),
+                                    static_cast<std::size_t>(max_pending));
+}
+
+change_stream_dispatcher::change_stream_dispatcher(change_stream_dispatcher&&) noexcept = default;
+change_stream_dispatcher& change_stream_dispatcher::operator=(change_stream_dispatcher&&) noexcept =
+    default;
+change_stream_dispatcher::~change_stream_dispatcher() = default;
+
+std::size_t change_stream_dispatcher::dispatch() {
+    return _impl->dispatch();
+}
+
+void change_stream_dispatcher::wait() {
+    _impl->wait();
+}
+
+stdx::optional<bsoncxx::document::value> change_stream_dispatcher::safe_resume_token() const {
+    return _impl->safe_resume_token();
+}
+
+std::int32_t change_stream_dispatcher::worker_count() const {
+    return static_cast<std::int32_t>(_impl->worker_count());
+}
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
@@ -0,0 +1,147 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/document/view.hpp>
+#include <bsoncxx/stdx/optional.hpp>
+#include <mongocxx/change_stream.hpp>
+#include <mongocxx/options/change_stream_dispatcher.hpp>
+
+#include <mongocxx/config/prelude.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+///
+/// Class that reads events from a change_stream and hands them to a pool of worker threads.
+///
+/// Events are partitioned by a key (the "documentKey" field by default) so that all events for the
+/// same key are handled by the same worker in the order they were read from the stream. Events for
+/// different keys may be handled concurrently.
+///
+/// A change_stream_dispatcher tracks which events have been fully handled and exposes the most
+/// recent resume token that is safe to persist: every event at or before that token has been
+/// handled.
+///
+/// The dispatcher does not take ownership of the change_stream, which must outlive it. The
+/// change_stream is only ever advanced from the thread calling dispatch().
+///
+class MONGOCXX_API change_stream_dispatcher {
+   public:
+    ///
+    /// The type of the function invoked on a worker thread for each event. The view passed to the
+    /// handler is valid only for the duration of the call.
+    ///
+    using handler_type = std::function<void(const bsoncxx::document::view&)>;
+
+    ///
+    /// Constructs a dispatcher and starts its worker threads.
+    ///
+    /// @param stream
+    ///   The change stream to read events from.
+    ///
+    /// @param handler
+    ///   The function to invoke for each event.
+    ///
+    /// @param options
+    ///   Optional arguments; see mongocxx::options::change_stream_dispatcher.
+    ///
+    /// @throws mongocxx::logic_error if the worker count or the maximum number of pending events
+    ///   is not positive.
+    ///
+    change_stream_dispatcher(change_stream* stream,
+                             handler_type handler,
+                             const options::change_stream_dispatcher& options = {});
+
+    ///
+    /// Move constructs a change_stream_dispatcher.
+    ///
+    change_stream_dispatcher(change_stream_dispatcher&&) noexcept;
+
+    ///
+    /// Move assigns a change_stream_dispatcher.
+    ///
+    change_stream_dispatcher& operator=(change_stream_dispatcher&&) noexcept;
+
+    change_stream_dispatcher(const change_stream_dispatcher&) = delete;
+
+    change_stream_dispatcher& operator=(const change_stream_dispatcher&) = delete;
+
+    ///
+    /// Destroys a change_stream_dispatcher. Events that have already been dispatched are handled
+    /// before the worker threads are joined.
+    ///
+    ~change_stream_dispatcher();
+
+    ///
+    /// Reads every currently available event from the change stream and queues it on the worker
+    /// responsible for its key.
+    ///
+    /// Like change_stream::begin(), this is a blocking operation bounded by the max_await_time of
+    /// the change stream. It also blocks while the maximum number of pending events is reached.
+    ///
+    /// @return
+    ///   The number of events read from the change stream.
+    ///
+    /// @throws mongocxx::query_exception if reading from the change stream failed.
+    ///
+    /// @throws
+    ///   The first exception thrown by the handler, if any. No further events are dispatched once
+    ///   the handler has thrown.
+    ///
+    std::size_t dispatch();
+
+    ///
+    /// Blocks until every event read so far has been handled.
+    ///
+    /// @throws
+    ///   The first exception thrown by the handler, if any.
+    ///
+    void wait();
+
+    ///
+    /// Returns the most recent resume token such that every event read before it has been
+    /// handled. Passing this token to options::change_stream::resume_after never skips an
+    /// unhandled event.
+    ///
+    /// @return
+    ///   A copy of the token, or no token if no event has been handled yet and the change stream
+    ///   has not reported a resume token.
+    ///
+    stdx::optional<bsoncxx::document::value> safe_resume_token() const;
+
+    ///
+    /// Gets the number of worker threads.
+    ///
+    /// @return
+    ///   The number of worker threads.
+    ///
+    std::int32_t worker_count() const;
+
+   private:
+    class MONGOCXX_PRIVATE impl;
+    std::unique_ptr<impl> _impl;
+};
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/postlude.hpp>
@@ -0,0 +1,152 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <mongocxx/checkpointed_change_stream.hpp>
+
+#include <bsoncxx/stdx/make_unique.hpp>
+#include <mongocxx/client.hpp>
+#include <mongocxx/collection.hpp>
+#include <mongocxx/database.hpp>
+#include <mongocxx/exception/error_code.hpp>
+#include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/private/checkpointed_change_stream.hh>
+
+#include <mongocxx/config/private/prelude.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+namespace {
+
+constexpr std::int32_t k_default_event_interval = 1000;
+constexpr std::chrono::milliseconds k_default_time_interval{1000};
+
+}  // namespace
+
+checkpointed_change_stream::checkpointed_change_stream(
+    collection& coll,
+    std::shared_ptr<resume_token_store> store,
+    const options::checkpoint& checkpoint_options,
+    const pipeline& pipe,
+    const options::change_stream& options) {
+    auto stream_options = resume_options(*store, options);
+    init(coll.watch(pipe, stream_options), std::move(store), checkpoint_options);
+}
+
+checkpointed_change_stream::checkpointed_change_stream(
+    database& db,
+    std::shared_ptr<resume_token_store> store,
+    const options::checkpoint& checkpoint_options,
+    const pipeline& pipe,
+    const options::change_stream& options) {
+    auto stream_options = resume_options(*store, options);
+    init(db.watch(pipe, stream_options), std::move(store), checkpoint_options);
+}
+
+checkpointed_change_stream::checkpointed_change_stream(
+    client& client,
+    std::shared_ptr<resume_token_store> store,
+    const options::checkpoint& checkpoint_options,
+    const pipeline& pipe,
+    const options::change_stream& options) {
+    auto stream_options = resume_options(*store, options);
+    init(client.watch(pipe, stream_options), std::move(store), checkpoint_options);
+}
+
+checkpointed_change_stream::checkpointed_change_stream(checkpointed_change_stream&&) noexcept =
+    default;
+checkpointed_change_stream& checkpointed_change_stream::operator=(
+    checkpointed_change_stream&&) noexcept = default;
+checkpointed_change_stream::~checkpointed_change_stream() = default;
+
+options::change_stream checkpointed_change_stream::resume_options(
+    resume_token_store& store, const options::change_stream& options) {
+    options::change_stream result{options};
+
+    if (auto token = store.load()) {
+        result.resume_after(std::move(*token));
+        result._start_after = stdx::nullopt;
+        result._start_at_operation_time_set = false;
+    }
+
+    return result;
+}
+
+void checkpointed_change_stream::init(change_stream stream,
+                                      std::shared_ptr<resume_token_store> store,
+                                      const options::checkpoint& checkpoint_options) {
+    std::int32_t event_interval = k_default_event_interval;
+    if (auto interval = checkpoint_options.event_interval()) {
+        if (*interval <= 0) {
+            throw logic_error{error_code::k_invalid_parameter,
+                              "positive value required for options::checkpoint::event_interval()"};
+        }
+        event_interval = *interval;
+    }
+
+    std::chrono::milliseconds time_interval = k_default_time_interval;
+    if (auto interval = checkpoint_options.time_interval()) {
+        if (interval->count() <= 0) {
+            throw logic_error{error_code::k_invalid_parameter,
+                              "positive value required for options::checkpoint::time_interval()"};
+        }
+        time_interval = *interval;
+    }
+
+    _impl = stdx::make_unique<impl>(
+        std::move(stream), std::move(store), event_interval, time_interval);
+}
+
+change_stream::iterator checkpointed_change_stream::begin() const {
+    return _impl->stream.begin();
+}
+
+change_stream::iterator checkpointed_change_stream::end() const {
+    return _impl->stream.end();
+}
+
+bool checkpointed_change_stream::acknowledge(bsoncxx::document::view event) {
+    auto id = event["_id"];
+    if (!id || id.type() != bsoncxx::type::k_document) {
+        throw logic_error{error_code::k_invalid_parameter,
+                          "acknowledged change stream event has no document _id"};
+    }
+
+    _impl->acknowledged_token = bsoncxx::document::value{id.get_document().value};
+    ++_impl->unpersisted_events;
+
+    if (_impl->unpersisted_events < _impl->event_interval &&
+        std::chrono::steady_clock::now() - _impl->last_checkpoint < _impl->time_interval) {
+        return false;
+    }
+
+    checkpoint();
+    return true;
+}
+
+void checkpointed_change_stream::checkpoint() {
+    if (_impl->acknowledged_token) {
+        _impl->store->store(_impl->acknowledged_token->view());
+    }
+
+    _impl->unpersisted_events = 0;
+    _impl->last_checkpoint = std::chrono::steady_clock::now();
+}
+
+stdx::optional<bsoncxx::document::view> checkpointed_change_stream::get_resume_token() const {
+    return _impl->stream.get_resume_token();
+}
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
@@ -0,0 +1,177 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+
+#include <bsoncxx/document/view.hpp>
+#include <bsoncxx/stdx/optional.hpp>
+#include <mongocxx/change_stream.hpp>
+#include <mongocxx/options/change_stream.hpp>
+#include <mongocxx/options/checkpoint.hpp>
+#include <mongocxx/pipeline.hpp>
+#include <mongocxx/resume_token_store.hpp>
+
+#include <mongocxx/config/prelude.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+class client;
+class collection;
+class database;
+
+///
+/// Class representing a change stream whose resume token is periodically persisted to a
+/// resume_token_store.
+///
+/// Events are consumed through begin() and end() exactly as with a change_stream. After an event
+/// has been fully processed, the consumer passes it to acknowledge(). Every options::checkpoint
+/// interval, acknowledge() stores the resume token of the last acknowledged event, so the
+/// durability cost is paid once per interval instead of once per event.
+///
+/// On construction, a previously stored token is loaded and used to resume the stream. After a
+/// crash, at most one checkpoint interval of events is delivered again.
+///
+class MONGOCXX_API checkpointed_change_stream {
+   public:
+    ///
+    /// Opens a change stream on a collection, resuming after the stored checkpoint if there is one.
+    ///
+    /// If a checkpoint is found, it is passed as resume_after and any start_after or
+    /// start_at_operation_time in the options is ignored; those only apply to the first run.
+    ///
+    /// @param coll
+    ///   The collection to watch.
+    ///
+    /// @param store
+    ///   The store holding the checkpoint.
+    ///
+    /// @param checkpoint_options
+    ///   How often to write a checkpoint.
+    ///
+    /// @param pipe
+    ///   The aggregation pipeline to apply to the change stream.
+    ///
+    /// @param options
+    ///   The options for the change stream.
+    ///
+    /// @throws mongocxx::logic_error if a checkpoint interval is not positive.
+    ///
+    checkpointed_change_stream(collection& coll,
+                               std::shared_ptr<resume_token_store> store,
+                               const options::checkpoint& checkpoint_options = {},
+                               const pipeline& pipe = {},
+                               const options::change_stream& options = {});
+
+    ///
+    /// Opens a change stream on a database, resuming after the stored checkpoint if there is one.
+    ///
+    /// @see checkpointed_change_stream(collection&, std::shared_ptr<resume_token_store>,
+    ///   const options::checkpoint&, const pipeline&, const options::change_stream&)
+    ///
+    checkpointed_change_stream(database& db,
+                               std::shared_ptr<resume_token_store> store,
+                               const options::checkpoint& checkpoint_options = {},
+                               const pipeline& pipe = {},
+                               const options::change_stream& options = {});
+
+    ///
+    /// Opens a change stream on a deployment, resuming after the stored checkpoint if there is
+    /// one.
+    ///
+    /// @see checkpointed_change_stream(collection&, std::shared_ptr<resume_token_store>,
+    ///   const options::checkpoint&, const pipeline&, const options::change_stream&)
+    ///
+    checkpointed_change_stream(client& client,
+                               std::shared_ptr<resume_token_store> store,
+                               const options::checkpoint& checkpoint_options = {},
+                               const pipeline& pipe = {},
+                               const options::change_stream& options = {});
+
+    ///
+    /// Move constructs a checkpointed_change_stream.
+    ///
+    checkpointed_change_stream(checkpointed_change_stream&&) noexcept;
+
+    ///
+    /// Move assigns a checkpointed_change_stream.
+    ///
+    checkpointed_change_stream& operator=(checkpointed_change_stream&&) noexcept;
+
+    ///
+    /// Destroys a checkpointed_change_stream. Acknowledged events that have not been checkpointed
+    /// yet are not persisted; call checkpoint() first to keep them.
+    ///
+    ~checkpointed_change_stream();
+
+    ///
+    /// @see change_stream::begin()
+    ///
+    change_stream::iterator begin() const;
+
+    ///
+    /// @see change_stream::end()
+    ///
+    change_stream::iterator end() const;
+
+    ///
+    /// Records that an event has been processed, and writes a checkpoint if a checkpoint interval
+    /// has elapsed.
+    ///
+    /// The checkpoint holds the event's _id, which is its resume token, rather than the stream's
+    /// current resume token, so events read ahead of the acknowledged one are delivered again
+    /// after a restart.
+    ///
+    /// @param event
+    ///   The event that has been processed.
+    ///
+    /// @return
+    ///   true if a checkpoint was written.
+    ///
+    /// @throws mongocxx::logic_error if the event has no document _id.
+    /// @throws mongocxx::exception if the store fails to persist the token.
+    ///
+    bool acknowledge(bsoncxx::document::view event);
+
+    ///
+    /// Writes a checkpoint immediately with the token of the last acknowledged event. Nothing is
+    /// written if no event has been acknowledged.
+    ///
+    /// @throws mongocxx::exception if the store fails to persist the token.
+    ///
+    void checkpoint();
+
+    ///
+    /// @see change_stream::get_resume_token()
+    ///
+    stdx::optional<bsoncxx::document::view> get_resume_token() const;
+
+   private:
+    MONGOCXX_PRIVATE static options::change_stream resume_options(
+        resume_token_store& store, const options::change_stream& options);
+
+    MONGOCXX_PRIVATE void init(change_stream stream,
+                               std::shared_ptr<resume_token_store> store,
+                               const options::checkpoint& checkpoint_options);
+
+    class MONGOCXX_PRIVATE impl;
+    std::unique_ptr<impl> _impl;
+};
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/postlude.hpp>
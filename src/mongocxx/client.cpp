@@ -268,7 +268,8 @@ class change_stream client::_watch(const client_session* session,
     scoped_bson_t options_bson{options_builder.extract()};
 
     return change_stream{
-        libmongoc::client_watch(_get_impl().client_t, pipeline_bson.bson(), options_bson.bson())};
+        libmongoc::client_watch(_get_impl().client_t, pipeline_bson.bson(), options_bson.bson()),
+        options.batch_size()};
 }
 
 const client::impl& client::_get_impl() const {
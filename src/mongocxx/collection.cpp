@@ -18,6 +18,7 @@
 #include <cstdint>
 #include <limits>
 #include <utility>
+#include <vector>
 
 #include <bsoncxx/builder/basic/document.hpp>
 #include <bsoncxx/builder/basic/kvp.hpp>
@@ -26,6 +27,7 @@
 #include <bsoncxx/builder/concatenate.hpp>
 #include <bsoncxx/exception/error_code.hpp>
 #include <bsoncxx/exception/exception.hpp>
+#include <bsoncxx/private/bson_sequence.hh>
 #include <bsoncxx/private/helpers.hh>
 #include <bsoncxx/private/libbson.hh>
 #include <bsoncxx/stdx/make_unique.hpp>
@@ -41,13 +43,17 @@
 #include <mongocxx/exception/write_exception.hpp>
 #include <mongocxx/hint.hpp>
 #include <mongocxx/model/write.hpp>
+#include <mongocxx/private/bson_template.hh>
 #include <mongocxx/private/bulk_write.hh>
 #include <mongocxx/private/client_session.hh>
 #include <mongocxx/private/collection.hh>
+#include <mongocxx/private/compiled_pipeline.hh>
 #include <mongocxx/private/cursor.hh>
 #include <mongocxx/private/libbson.hh>
 #include <mongocxx/private/libmongoc.hh>
 #include <mongocxx/private/pipeline.hh>
+#include <mongocxx/private/prepared_aggregate.hh>
+#include <mongocxx/private/prepared_find.hh>
 #include <mongocxx/private/read_concern.hh>
 #include <mongocxx/private/read_preference.hh>
 #include <mongocxx/private/write_concern.hh>
@@ -430,12 +436,13 @@ cursor collection::find(const client_session& session,
 
 stdx::optional<bsoncxx::document::value> collection::_find_one(const client_session* session,
                                                                view_or_value filter,
-                                                               const options::find& options) {
+                                                               const options::find& options,
+                                                               std::error_code* ec) {
     options::find copy(options);
     copy.limit(1);
     cursor cursor =
         session ? find(*session, std::move(filter), copy) : find(std::move(filter), copy);
-    cursor::iterator it = cursor.begin();
+    cursor::iterator it = ec ? cursor.begin(*ec) : cursor.begin();
     if (it == cursor.end()) {
         return stdx::nullopt;
     }
@@ -444,19 +451,54 @@ stdx::optional<bsoncxx::document::value> collection::_find_one(const client_sess
 
 stdx::optional<bsoncxx::document::value> collection::find_one(view_or_value filter,
                                                               const options::find& options) {
-    return _find_one(nullptr, std::move(filter), options);
+    return _find_one(nullptr, std::move(filter), options, nullptr);
 }
 
 stdx::optional<bsoncxx::document::value> collection::find_one(const client_session& session,
                                                               view_or_value filter,
                                                               const options::find& options) {
-    return _find_one(&session, std::move(filter), options);
+    return _find_one(&session, std::move(filter), options, nullptr);
+}
+
+stdx::optional<bsoncxx::document::value> collection::find_one(view_or_value filter,
+                                                              std::error_code& ec,
+                                                              const options::find& options) {
+    return _find_one(nullptr, std::move(filter), options, &ec);
+}
+
+stdx::optional<bsoncxx::document::value> collection::find_one(const client_session& session,
+                                                              view_or_value filter,
+                                                              std::error_code& ec,
+                                                              const options::find& options) {
+    return _find_one(&session, std::move(filter), options, &ec);
+}
+
+prepared_find collection::prepare_find(view_or_value filter,
+                                       const std::vector<std::string>& parameters,
+                                       const options::find& options) {
+    stdx::optional<std::uint32_t> max_await_time_ms;
+    if (options.max_await_time()) {
+        const auto count = options.max_await_time()->count();
+        if ((count < 0) || (count >= std::numeric_limits<std::uint32_t>::max())) {
+            throw logic_error{error_code::k_invalid_parameter};
+        }
+        max_await_time_ms = static_cast<std::uint32_t>(count);
+    }
+
+    return prepared_find{
+        stdx::make_unique<prepared_find::impl>(*this,
+                                               bson_template{filter.view(), parameters},
+                                               build_find_options_document(options).extract(),
+                                               options.read_preference(),
+                                               options.cursor_type(),
+                                               max_await_time_ms)};
 }
 
 cursor collection::_aggregate(const client_session* session,
-                              const pipeline& pipeline,
+                              bsoncxx::document::view pipeline,
                               const options::aggregate& options) {
-    scoped_bson_t stages(bsoncxx::document::view(pipeline._impl->view_array()));
+    // libmongoc takes either the array of stages or a document wrapping it as "pipeline".
+    scoped_bson_t stages(pipeline);
 
     bsoncxx::builder::basic::document b;
 
@@ -482,18 +524,42 @@ cursor collection::_aggregate(const client_session* session,
 }
 
 cursor collection::aggregate(const pipeline& pipeline, const options::aggregate& options) {
-    return _aggregate(nullptr, pipeline, options);
+    return _aggregate(nullptr, bsoncxx::document::view(pipeline._impl->view_array()), options);
 }
 
 cursor collection::aggregate(const client_session& session,
                              const pipeline& pipeline,
                              const options::aggregate& options) {
-    return _aggregate(&session, pipeline, options);
+    return _aggregate(&session, bsoncxx::document::view(pipeline._impl->view_array()), options);
+}
+
+cursor collection::aggregate(const compiled_pipeline& pipeline,
+                             const options::aggregate& options) {
+    return _aggregate(nullptr, pipeline._impl->stages.view(), options);
+}
+
+cursor collection::aggregate(const client_session& session,
+                             const compiled_pipeline& pipeline,
+                             const options::aggregate& options) {
+    return _aggregate(&session, pipeline._impl->stages.view(), options);
+}
+
+prepared_aggregate collection::prepare_aggregate(const pipeline& pipeline,
+                                                 const std::vector<std::string>& parameters,
+                                                 const options::aggregate& options) {
+    bsoncxx::builder::basic::document b;
+    options.append(b);
+
+    bson_template stages{pipeline.view_array(), parameters};
+
+    return prepared_aggregate{stdx::make_unique<prepared_aggregate::impl>(
+        *this, std::move(stages), b.extract(), options.read_preference())};
 }
 
 stdx::optional<result::insert_one> collection::_insert_one(const client_session* session,
                                                            view_or_value document,
-                                                           const options::insert& options) {
+                                                           const options::insert& options,
+                                                           std::error_code* ec) {
     // TODO: We should consider making it possible to convert from an options::insert into
     // an options::bulk_write at the type level, removing the need to re-iterate this code
     // many times here and below.
@@ -526,7 +592,7 @@ stdx::optional<result::insert_one> collection::_insert_one(const client_session*
         oid = document.view()["_id"];
     }
 
-    auto result = bulk_op.execute();
+    auto result = ec ? bulk_op.execute(*ec) : bulk_op.execute();
     if (!result) {
         return stdx::nullopt;
     }
@@ -537,13 +603,134 @@ stdx::optional<result::insert_one> collection::_insert_one(const client_session*
 
 stdx::optional<result::insert_one> collection::insert_one(view_or_value document,
                                                           const options::insert& options) {
-    return _insert_one(nullptr, document, options);
+    return _insert_one(nullptr, document, options, nullptr);
+}
+
+stdx::optional<result::insert_one> collection::insert_one(const client_session& session,
+                                                          view_or_value document,
+                                                          const options::insert& options) {
+    return _insert_one(&session, document, options, nullptr);
+}
+
+stdx::optional<result::insert_one> collection::insert_one(view_or_value document,
+                                                          std::error_code& ec,
+                                                          const options::insert& options) {
+    return _insert_one(nullptr, document, options, &ec);
 }
 
 stdx::optional<result::insert_one> collection::insert_one(const client_session& session,
                                                           view_or_value document,
+                                                          std::error_code& ec,
                                                           const options::insert& options) {
-    return _insert_one(&session, document, options);
+    return _insert_one(&session, document, options, &ec);
+}
+
+namespace {
+// A BSON sequence is inserted in sub-batches bounded by the server's default maxWriteBatchSize
+// and maxMessageSizeBytes, so that only one sub-batch is buffered at a time.
+constexpr std::size_t k_sequence_batch_documents = 100000;
+constexpr std::size_t k_sequence_batch_bytes = 48 * 1000 * 1000;
+}  // namespace
+
+stdx::optional<result::insert_many> collection::_insert_many(const client_session* session,
+                                                             const std::uint8_t* data,
+                                                             std::size_t length,
+                                                             const options::insert& options) {
+    if (length == 0) {
+        throw logic_error{error_code::k_invalid_parameter, "cannot insert an empty BSON sequence"};
+    }
+
+    std::vector<result::bulk_write> results;
+    bool acknowledged = true;
+
+    std::size_t offset = 0;
+    while (offset < length) {
+        auto writes = _init_insert_many(options, session);
+        std::size_t batch_documents = 0;
+        std::size_t batch_bytes = 0;
+
+        // The _ids of a sub-batch are discarded with it, so that they do not grow with the
+        // sequence.
+        bsoncxx::builder::basic::array inserted_ids;
+
+        while (offset < length && batch_documents < k_sequence_batch_documents &&
+               batch_bytes < k_sequence_batch_bytes) {
+            const std::size_t doc_length =
+                bsoncxx::bson_sequence::document_length(data + offset, length - offset);
+            if (doc_length == 0) {
+                throw logic_error{
+                    error_code::k_invalid_parameter,
+                    "BSON sequence has a truncated or malformed document at offset " +
+                        std::to_string(offset)};
+            }
+
+            _insert_many_doc_handler(
+                writes, inserted_ids, bsoncxx::document::view{data + offset, doc_length});
+            offset += doc_length;
+            ++batch_documents;
+            batch_bytes += doc_length;
+        }
+
+        auto result = writes.execute();
+        if (result) {
+            results.push_back(std::move(*result));
+        } else {
+            acknowledged = false;
+        }
+    }
+
+    if (!acknowledged) {
+        return stdx::nullopt;
+    }
+
+    if (results.size() == 1) {
+        return result::insert_many{std::move(results.front()), make_array()};
+    }
+
+    // The sub-batches are reported as a single bulk write.
+    std::int64_t inserted = 0;
+    std::int64_t matched = 0;
+    std::int64_t modified = 0;
+    std::int64_t deleted = 0;
+    std::int64_t upserted = 0;
+    for (auto&& result : results) {
+        inserted += result.inserted_count();
+        matched += result.matched_count();
+        modified += result.modified_count();
+        deleted += result.deleted_count();
+        upserted += result.upserted_count();
+    }
+
+    // A server reports its counts as int32s. A total too large for one is stored as an int64.
+    bsoncxx::builder::basic::document merged;
+    auto append_count = [&merged](stdx::string_view name, std::int64_t count) {
+        if (count <= std::numeric_limits<std::int32_t>::max()) {
+            merged.append(kvp(name, static_cast<std::int32_t>(count)));
+        } else {
+            merged.append(kvp(name, count));
+        }
+    };
+    append_count("nInserted", inserted);
+    append_count("nMatched", matched);
+    append_count("nModified", modified);
+    append_count("nRemoved", deleted);
+    append_count("nUpserted", upserted);
+    merged.append(kvp("writeErrors", make_array()));
+
+    return result::insert_many{result::bulk_write{merged.extract()}, make_array()};
+}
+
+stdx::optional<result::insert_many> collection::insert_many(const std::uint8_t* data,
+                                                            std::size_t length,
+                                                            const options::insert& options) {
+    return _insert_many(nullptr, data, length, options);
+}
+
+stdx::optional<result::insert_many> collection::insert_many(const client_session& session,
+                                                            const std::uint8_t* data,
+                                                            std::size_t length,
+                                                            const options::insert& options) {
+    return _insert_many(&session, data, length, options);
 }
 
 stdx::optional<result::replace_one> collection::_replace_one(const client_session* session,
@@ -683,7 +870,8 @@ stdx::optional<result::update> collection::update_many(const client_session& ses
 stdx::optional<result::update> collection::_update_one(const client_session* session,
                                                        view_or_value filter,
                                                        view_or_value update,
-                                                       const options::update& options) {
+                                                       const options::update& options,
+                                                       std::error_code* ec) {
     options::bulk_write bulk_opts;
 
     if (options.bypass_document_validation()) {
@@ -711,7 +899,7 @@ stdx::optional<result::update> collection::_update_one(const client_session* ses
 
     bulk_op.append(update_op);
 
-    auto result = bulk_op.execute();
+    auto result = ec ? bulk_op.execute(*ec) : bulk_op.execute();
     if (!result) {
         return stdx::nullopt;
     }
@@ -722,42 +910,63 @@ stdx::optional<result::update> collection::_update_one(const client_session* ses
 stdx::optional<result::update> collection::update_one(view_or_value filter,
                                                       view_or_value update,
                                                       const options::update& options) {
-    return _update_one(nullptr, std::move(filter), update, options);
+    return _update_one(nullptr, std::move(filter), update, options, nullptr);
 }
 
 stdx::optional<result::update> collection::update_one(view_or_value filter,
                                                       const pipeline& update,
                                                       const options::update& options) {
-    return _update_one(
-        nullptr, std::move(filter), bsoncxx::document::view(update.view_array()), options);
+    return _update_one(nullptr,
+                       std::move(filter),
+                       bsoncxx::document::view(update.view_array()),
+                       options,
+                       nullptr);
 }
 
 stdx::optional<result::update> collection::update_one(view_or_value filter,
                                                       std::initializer_list<_empty_doc_tag>,
                                                       const options::update& options) {
-    return _update_one(nullptr, std::move(filter), bsoncxx::document::view{}, options);
+    return _update_one(nullptr, std::move(filter), bsoncxx::document::view{}, options, nullptr);
+}
+
+stdx::optional<result::update> collection::update_one(const client_session& session,
+                                                      view_or_value filter,
+                                                      view_or_value update,
+                                                      const options::update& options) {
+    return _update_one(&session, std::move(filter), update, options, nullptr);
+}
+
+stdx::optional<result::update> collection::update_one(view_or_value filter,
+                                                      view_or_value update,
+                                                      std::error_code& ec,
+                                                      const options::update& options) {
+    return _update_one(nullptr, std::move(filter), update, options, &ec);
 }
 
 stdx::optional<result::update> collection::update_one(const client_session& session,
                                                       view_or_value filter,
                                                       view_or_value update,
+                                                      std::error_code& ec,
                                                       const options::update& options) {
-    return _update_one(&session, std::move(filter), update, options);
+    return _update_one(&session, std::move(filter), update, options, &ec);
 }
 
 stdx::optional<result::update> collection::update_one(const client_session& session,
                                                       view_or_value filter,
                                                       const pipeline& update,
                                                       const options::update& options) {
-    return _update_one(
-        &session, std::move(filter), bsoncxx::document::view(update.view_array()), options);
+    return _update_one(&session,
+                       std::move(filter),
+                       bsoncxx::document::view(update.view_array()),
+                       options,
+                       nullptr);
 }
 
 stdx::optional<result::update> collection::update_one(const client_session& session,
                                                       view_or_value filter,
                                                       std::initializer_list<_empty_doc_tag>,
                                                       const options::update& options) {
-    return _update_one(&session, std::move(filter), bsoncxx::document::view{}, options);
+    return _update_one(&session, std::move(filter), bsoncxx::document::view{}, options, nullptr);
 }
 
 stdx::optional<result::delete_result> collection::_delete_many(
@@ -798,7 +1007,10 @@ stdx::optional<result::delete_result> collection::delete_many(
 }
 
 stdx::optional<result::delete_result> collection::_delete_one(
-    const client_session* session, view_or_value filter, const options::delete_options& options) {
+    const client_session* session,
+    view_or_value filter,
+    const options::delete_options& options,
+    std::error_code* ec) {
     options::bulk_write bulk_opts;
 
     if (options.write_concern()) {
@@ -816,7 +1028,7 @@ stdx::optional<result::delete_result> collection::_delete_one(
     }
     bulk_op.append(delete_op);
 
-    auto result = bulk_op.execute();
+    auto result = ec ? bulk_op.execute(*ec) : bulk_op.execute();
     if (!result) {
         return stdx::nullopt;
     }
@@ -826,12 +1038,25 @@ stdx::optional<result::delete_result> collection::_delete_one(
 
 stdx::optional<result::delete_result> collection::delete_one(
     view_or_value filter, const options::delete_options& options) {
-    return _delete_one(nullptr, std::move(filter), options);
+    return _delete_one(nullptr, std::move(filter), options, nullptr);
 }
 
 stdx::optional<result::delete_result> collection::delete_one(
     const client_session& session, view_or_value filter, const options::delete_options& options) {
-    return _delete_one(&session, std::move(filter), options);
+    return _delete_one(&session, std::move(filter), options, nullptr);
+}
+
+stdx::optional<result::delete_result> collection::delete_one(
+    view_or_value filter, std::error_code& ec, const options::delete_options& options) {
+    return _delete_one(nullptr, std::move(filter), options, &ec);
+}
+
+stdx::optional<result::delete_result> collection::delete_one(
+    const client_session& session,
+    view_or_value filter,
+    std::error_code& ec,
+    const options::delete_options& options) {
+    return _delete_one(&session, std::move(filter), options, &ec);
 }
 
 stdx::optional<bsoncxx::document::value> collection::_find_one_and_replace(
@@ -1268,12 +1493,29 @@ class change_stream collection::watch(const client_session& session,
     return _watch(&session, pipe, options);
 }
 
+class change_stream collection::watch(const compiled_pipeline& pipe,
+                                      const options::change_stream& options) {
+    return _watch(nullptr, pipe._impl->stages.view(), options);
+}
+
+class change_stream collection::watch(const client_session& session,
+                                      const compiled_pipeline& pipe,
+                                      const options::change_stream& options) {
+    return _watch(&session, pipe._impl->stages.view(), options);
+}
+
 class change_stream collection::_watch(const client_session* session,
                                        const pipeline& pipe,
                                        const options::change_stream& options) {
     bsoncxx::builder::basic::document container;
     container.append(kvp("pipeline", pipe._impl->view_array()));
-    scoped_bson_t pipeline_bson{container.view()};
+    return _watch(session, container.view(), options);
+}
+
+class change_stream collection::_watch(const client_session* session,
+                                       bsoncxx::document::view container,
+                                       const options::change_stream& options) {
+    scoped_bson_t pipeline_bson{container};
 
     bsoncxx::builder::basic::document options_builder;
     options_builder.append(bsoncxx::builder::concatenate(options.as_bson()));
@@ -1286,7 +1528,8 @@ class change_stream collection::_watch(const client_session* session,
 
     // NOTE: collection_watch copies what it needs so we're safe to destroy our copies.
     return change_stream{libmongoc::collection_watch(
-        _get_impl().collection_t, pipeline_bson.bson(), options_bson.bson())};
+                             _get_impl().collection_t, pipeline_bson.bson(), options_bson.bson()),
+                         options.batch_size()};
 }
 
 class index_view collection::indexes() {
@@ -1315,12 +1558,13 @@ void collection::_insert_many_doc_handler(class bulk_write& writes,
                                           bsoncxx::document::view doc) const {
     bsoncxx::builder::basic::document id_doc;
 
-    if (!doc["_id"]) {
+    auto id = doc["_id"];
+    if (!id) {
         id_doc.append(kvp("_id", bsoncxx::oid{}));
         writes.append(
             model::insert_one{make_document(concatenate(id_doc.view()), concatenate(doc))});
     } else {
-        id_doc.append(kvp("_id", doc["_id"].get_value()));
+        id_doc.append(kvp("_id", id.get_value()));
         writes.append(model::insert_one{doc});
     }
 
@@ -26,6 +26,7 @@
 #include <mongocxx/bulk_write.hpp>
 #include <mongocxx/change_stream.hpp>
 #include <mongocxx/client_session.hpp>
+#include <mongocxx/compiled_pipeline.hpp>
 #include <mongocxx/config/prelude.hpp>
 #include <mongocxx/cursor.hpp>
 #include <mongocxx/index_view.hpp>
@@ -47,6 +48,8 @@
 #include <mongocxx/options/replace.hpp>
 #include <mongocxx/options/update.hpp>
 #include <mongocxx/pipeline.hpp>
+#include <mongocxx/prepared_aggregate.hpp>
+#include <mongocxx/prepared_find.hpp>
 #include <mongocxx/read_concern.hpp>
 #include <mongocxx/read_preference.hpp>
 #include <mongocxx/result/bulk_write.hpp>
@@ -57,6 +60,7 @@
 #include <mongocxx/result/update.hpp>
 #include <mongocxx/write_concern.hpp>
 #include <string>
+#include <vector>
 
 namespace mongocxx {
 MONGOCXX_INLINE_NAMESPACE_BEGIN
@@ -183,10 +187,77 @@ class MONGOCXX_API collection {
     cursor aggregate(const client_session& session,
                      const pipeline& pipeline,
                      const options::aggregate& options = options::aggregate());
+
+    ///
+    /// Runs a compiled aggregation framework pipeline against this collection. The stages are
+    /// sent as they were serialized when the pipeline was compiled.
+    ///
+    /// @param pipeline
+    ///   The compiled pipeline of aggregation operations to perform.
+    /// @param options
+    ///   Optional arguments, see mongocxx::options::aggregate.
+    ///
+    /// @return A mongocxx::cursor with the results.  If the query fails,
+    /// the cursor throws mongocxx::query_exception when the returned cursor
+    /// is iterated.
+    ///
+    /// @see https://docs.mongodb.com/master/reference/command/aggregate/
+    ///
+    cursor aggregate(const compiled_pipeline& pipeline,
+                     const options::aggregate& options = options::aggregate());
+
+    ///
+    /// Runs a compiled aggregation framework pipeline against this collection. The stages are
+    /// sent as they were serialized when the pipeline was compiled.
+    ///
+    /// @param session
+    ///   The mongocxx::client_session with which to perform the aggregation.
+    /// @param pipeline
+    ///   The compiled pipeline of aggregation operations to perform.
+    /// @param options
+    ///   Optional arguments, see mongocxx::options::aggregate.
+    ///
+    /// @return A mongocxx::cursor with the results.  If the query fails,
+    /// the cursor throws mongocxx::query_exception when the returned cursor
+    /// is iterated.
+    ///
+    /// @see https://docs.mongodb.com/master/reference/command/aggregate/
+    ///
+    cursor aggregate(const client_session& session,
+                     const compiled_pipeline& pipeline,
+                     const options::aggregate& options = options::aggregate());
     ///
     /// @}
     ///
 
+    ///
+    /// Prepares an aggregation framework pipeline to be run many times with different values.
+    ///
+    /// The pipeline and options are serialized once. Each parameter is a value in the pipeline,
+    /// named by its dotted path starting with the index of its stage, e.g. "0.$match.status", whose
+    /// type stays fixed. Values bound with prepared_aggregate::bind() are patched into the
+    /// serialized pipeline before each prepared_aggregate::execute().
+    ///
+    /// @param pipeline
+    ///   The pipeline of aggregation operations to perform, holding a value of the right type at
+    ///   each parameter's path.
+    /// @param parameters
+    ///   The dotted paths of the parameters, in the order of their indexes.
+    /// @param options
+    ///   Optional arguments, see mongocxx::options::aggregate.
+    ///
+    /// @return
+    ///   The prepared aggregation.
+    ///
+    /// @throws mongocxx::logic_error if a path does not name a value in the pipeline, names a
+    ///   value of a type that cannot be a parameter, or lies inside another parameter.
+    ///
+    /// @see https://docs.mongodb.com/master/reference/command/aggregate/
+    ///
+    prepared_aggregate prepare_aggregate(const pipeline& pipeline,
+                                         const std::vector<std::string>& parameters,
+                                         const options::aggregate& options = options::aggregate());
+
     ///
     /// @{
     ///
@@ -604,6 +675,53 @@ class MONGOCXX_API collection {
         bsoncxx::document::view_or_value filter,
         const options::delete_options& options = options::delete_options());
 
+    ///
+    /// Deletes a single matching document from the collection, reporting a failed write
+    /// through an error code instead of throwing.
+    ///
+    /// @param filter
+    ///   Document view representing the data to be deleted.
+    /// @param ec
+    ///   Set to the error if the write failed, otherwise cleared. The code is the one that
+    ///   mongocxx::bulk_write_exception::code() would have returned.
+    /// @param options
+    ///   Optional arguments, see mongocxx::options::delete_options.
+    ///
+    /// @return The optional result of performing the deletion. It is disengaged if the write
+    /// failed or if the write concern is unacknowledged.
+    ///
+    /// @see https://docs.mongodb.com/master/reference/command/delete/
+    ///
+    stdx::optional<result::delete_result> delete_one(
+        bsoncxx::document::view_or_value filter,
+        std::error_code& ec,
+        const options::delete_options& options = options::delete_options());
+
+    ///
+    /// Deletes a single matching document from the collection, reporting a failed write
+    /// through an error code instead of throwing.
+    ///
+    /// @param session
+    ///   The mongocxx::client_session with which to perform the deletion.
+    /// @param filter
+    ///   Document view representing the data to be deleted.
+    /// @param ec
+    ///   Set to the error if the write failed, otherwise cleared. The code is the one that
+    ///   mongocxx::bulk_write_exception::code() would have returned.
+    /// @param options
+    ///   Optional arguments, see mongocxx::options::delete_options.
+    ///
+    /// @return The optional result of performing the deletion. It is disengaged if the write
+    /// failed or if the write concern is unacknowledged.
+    ///
+    /// @see https://docs.mongodb.com/master/reference/command/delete/
+    ///
+    stdx::optional<result::delete_result> delete_one(
+        const client_session& session,
+        bsoncxx::document::view_or_value filter,
+        std::error_code& ec,
+        const options::delete_options& options = options::delete_options());
+
     ///
     /// @}
     ///
@@ -787,10 +905,84 @@ class MONGOCXX_API collection {
         bsoncxx::document::view_or_value filter,
         const options::find& options = options::find());
 
+    ///
+    /// Finds a single document in this collection that match the provided filter, reporting a
+    /// failed query through an error code instead of throwing.
+    ///
+    /// @param filter
+    ///   Document view representing a document that should match the query.
+    /// @param ec
+    ///   Set to the error if the query failed, otherwise cleared. The code is the one that
+    ///   mongocxx::query_exception::code() would have returned.
+    /// @param options
+    ///   Optional arguments, see options::find
+    ///
+    /// @return An optional document that matched the filter. It is disengaged if the query failed.
+    ///
+    /// @see https://docs.mongodb.com/master/core/read-operations-introduction/
+    ///
+    stdx::optional<bsoncxx::document::value> find_one(
+        bsoncxx::document::view_or_value filter,
+        std::error_code& ec,
+        const options::find& options = options::find());
+
+    ///
+    /// Finds a single document in this collection that match the provided filter, reporting a
+    /// failed query through an error code instead of throwing.
+    ///
+    /// @param session
+    ///   The mongocxx::client_session with which to perform the query.
+    /// @param filter
+    ///   Document view representing a document that should match the query.
+    /// @param ec
+    ///   Set to the error if the query failed, otherwise cleared. The code is the one that
+    ///   mongocxx::query_exception::code() would have returned.
+    /// @param options
+    ///   Optional arguments, see options::find
+    ///
+    /// @return An optional document that matched the filter. It is disengaged if the query failed.
+    ///
+    /// @see https://docs.mongodb.com/master/core/read-operations-introduction/
+    ///
+    stdx::optional<bsoncxx::document::value> find_one(
+        const client_session& session,
+        bsoncxx::document::view_or_value filter,
+        std::error_code& ec,
+        const options::find& options = options::find());
+
     ///
     /// @}
     ///
 
+    ///
+    /// Prepares a find to be run many times with different filter values.
+    ///
+    /// The filter and options are serialized once. Each parameter is a value in the filter, named
+    /// by its dotted path, e.g. "user.id" or "ts.$gte", whose type stays fixed. Values bound with
+    /// prepared_find::bind() are patched into the serialized filter before each
+    /// prepared_find::execute(). Parameters may be of any BSON type with a fixed width, or a
+    /// string, document, array or binary.
+    ///
+    /// @param filter
+    ///   The filter, holding a value of the right type at each parameter's path.
+    /// @param parameters
+    ///   The dotted paths of the parameters, in the order of their indexes.
+    /// @param options
+    ///   Optional arguments, see options::find
+    ///
+    /// @return
+    ///   The prepared find.
+    ///
+    /// @throws mongocxx::logic_error if the options are invalid, or if a path does not name a value
+    ///   in the filter, names a value of a type that cannot be a parameter, or lies inside another
+    ///   parameter.
+    ///
+    /// @see https://docs.mongodb.com/master/core/read-operations-introduction/
+    ///
+    prepared_find prepare_find(bsoncxx::document::view_or_value filter,
+                               const std::vector<std::string>& parameters,
+                               const options::find& options = options::find());
+
     ///
     /// @{
     ///
@@ -1103,6 +1295,53 @@ class MONGOCXX_API collection {
     stdx::optional<result::insert_one> insert_one(const client_session& session,
                                                   bsoncxx::document::view_or_value document,
                                                   const options::insert& options = {});
+
+    ///
+    /// Inserts a single document into the collection, reporting a failed write through an error
+    /// code instead of throwing. If the document is missing an identifier (@c _id field) one
+    /// will be generated for it.
+    ///
+    /// @param document
+    ///   The document to insert.
+    /// @param ec
+    ///   Set to the error if the write failed, otherwise cleared. The code is the one that
+    ///   mongocxx::bulk_write_exception::code() would have returned.
+    /// @param options
+    ///   Optional arguments, see options::insert.
+    ///
+    /// @return The optional result of attempting to perform the insert. It is disengaged if the
+    /// write failed or if the write concern is unacknowledged.
+    ///
+    /// @see https://docs.mongodb.com/master/reference/command/insert/
+    ///
+    stdx::optional<result::insert_one> insert_one(bsoncxx::document::view_or_value document,
+                                                  std::error_code& ec,
+                                                  const options::insert& options = {});
+
+    ///
+    /// Inserts a single document into the collection, reporting a failed write through an error
+    /// code instead of throwing. If the document is missing an identifier (@c _id field) one
+    /// will be generated for it.
+    ///
+    /// @param session
+    ///   The mongocxx::client_session with which to perform the insert.
+    /// @param document
+    ///   The document to insert.
+    /// @param ec
+    ///   Set to the error if the write failed, otherwise cleared. The code is the one that
+    ///   mongocxx::bulk_write_exception::code() would have returned.
+    /// @param options
+    ///   Optional arguments, see options::insert.
+    ///
+    /// @return The optional result of attempting to perform the insert. It is disengaged if the
+    /// write failed or if the write concern is unacknowledged.
+    ///
+    /// @see https://docs.mongodb.com/master/reference/command/insert/
+    ///
+    stdx::optional<result::insert_one> insert_one(const client_session& session,
+                                                  bsoncxx::document::view_or_value document,
+                                                  std::error_code& ec,
+                                                  const options::insert& options = {});
     ///
     /// @}
     ///
@@ -1225,6 +1464,71 @@ class MONGOCXX_API collection {
     /// @}
     ///
 
+    ///
+    /// @{
+    ///
+    /// Inserts the documents of a contiguous BSON sequence into the collection, such as the
+    /// contents of a mongodump .bson file or an arena of concatenated documents. If any of the
+    /// documents are missing identifiers the driver will generate them.
+    ///
+    /// Documents that have an identifier are handed to the bulk insert without being copied into
+    /// an intermediate document. The sequence is executed in sub-batches of at most 100,000
+    /// documents or about 48 MB, so the memory held by the driver is bounded by one sub-batch
+    /// rather than by the whole sequence, and the counts of the sub-batches are reported
+    /// together. For the same reason, the result does not list the _ids of the inserted
+    /// documents: result::insert_many::inserted_ids() is empty. If a sub-batch fails, the
+    /// exception is thrown without executing the following ones, even for an unordered insert;
+    /// the documents of earlier sub-batches stay inserted. The sequence must outlive the call.
+    ///
+    /// A count too large for the int32 that a server reports is stored in the result document as
+    /// an int64, which the count accessors of result::bulk_write cannot return.
+    ///
+    /// @param data
+    ///   The first byte of the first document.
+    /// @param length
+    ///   The total length of the sequence in bytes.
+    /// @param options
+    ///   Optional arguments, see options::insert.
+    ///
+    /// @return The result of attempting to performing the insert.
+    ///
+    /// @throws mongocxx::logic_error if the sequence is empty or does not consist of whole BSON
+    ///   documents.
+    /// @throws mongocxx::bulk_write_exception if the operation fails.
+    ///
+    stdx::optional<result::insert_many> insert_many(const std::uint8_t* data,
+                                                    std::size_t length,
+                                                    const options::insert& options = {});
+
+    ///
+    /// Inserts the documents of a contiguous BSON sequence into the collection. If any of the
+    /// documents are missing identifiers the driver will generate them.
+    ///
+    /// @param session
+    ///   The mongocxx::client_session with which to perform the inserts.
+    /// @param data
+    ///   The first byte of the first document.
+    /// @param length
+    ///   The total length of the sequence in bytes.
+    /// @param options
+    ///   Optional arguments, see options::insert.
+    ///
+    /// @return The result of attempting to performing the insert.
+    ///
+    /// @throws mongocxx::logic_error if the sequence is empty or does not consist of whole BSON
+    ///   documents.
+    /// @throws mongocxx::bulk_write_exception if the operation fails.
+    ///
+    /// @see insert_many(const std::uint8_t*, std::size_t, const options::insert&)
+    ///
+    stdx::optional<result::insert_many> insert_many(const client_session& session,
+                                                    const std::uint8_t* data,
+                                                    std::size_t length,
+                                                    const options::insert& options = {});
+    ///
+    /// @}
+    ///
+
     ///
     /// @{
     ///
@@ -1727,6 +2031,61 @@ class MONGOCXX_API collection {
                                               std::initializer_list<_empty_doc_tag> update,
                                               const options::update& options = options::update());
 
+    ///
+    /// Updates a single document matching the provided filter in this collection, reporting a
+    /// failed write through an error code instead of throwing.
+    ///
+    /// @param filter
+    ///   Document representing the match criteria.
+    /// @param update
+    ///   Document representing the update to be applied to a matching document.
+    /// @param ec
+    ///   Set to the error if the write failed, otherwise cleared. The code is the one that
+    ///   mongocxx::bulk_write_exception::code() would have returned.
+    /// @param options
+    ///   Optional arguments, see options::update.
+    ///
+    /// @return The optional result of attempting to update a document. It is disengaged if the
+    /// write failed or if the write concern is unacknowledged.
+    ///
+    /// @throws mongocxx::logic_error if the update is invalid.
+    ///
+    /// @see https://docs.mongodb.com/master/reference/command/update/
+    ///
+    stdx::optional<result::update> update_one(bsoncxx::document::view_or_value filter,
+                                              bsoncxx::document::view_or_value update,
+                                              std::error_code& ec,
+                                              const options::update& options = options::update());
+
+    ///
+    /// Updates a single document matching the provided filter in this collection, reporting a
+    /// failed write through an error code instead of throwing.
+    ///
+    /// @param session
+    ///   The mongocxx::client_session with which to perform the update.
+    /// @param filter
+    ///   Document representing the match criteria.
+    /// @param update
+    ///   Document representing the update to be applied to a matching document.
+    /// @param ec
+    ///   Set to the error if the write failed, otherwise cleared. The code is the one that
+    ///   mongocxx::bulk_write_exception::code() would have returned.
+    /// @param options
+    ///   Optional arguments, see options::update.
+    ///
+    /// @return The optional result of attempting to update a document. It is disengaged if the
+    /// write failed or if the write concern is unacknowledged.
+    ///
+    /// @throws mongocxx::logic_error if the update is invalid.
+    ///
+    /// @see https://docs.mongodb.com/master/reference/command/update/
+    ///
+    stdx::optional<result::update> update_one(const client_session& session,
+                                              bsoncxx::document::view_or_value filter,
+                                              bsoncxx::document::view_or_value update,
+                                              std::error_code& ec,
+                                              const options::update& options = options::update());
+
     ///
     /// @}
     ///
@@ -1817,6 +2176,42 @@ class MONGOCXX_API collection {
                         const pipeline& pipe,
                         const options::change_stream& options = {});
 
+    ///
+    /// Gets a change stream on this collection with a compiled pipeline. The stages are sent as
+    /// they were serialized when the pipeline was compiled.
+    ///
+    /// @param pipe
+    ///   The compiled aggregation pipeline to be used on the change notifications.
+    /// @param options
+    ///   The options to use when creating the change stream.
+    ///
+    /// @return
+    ///  A change stream on this collection.
+    ///
+    /// @see https://docs.mongodb.com/manual/changeStreams/
+    ///
+    change_stream watch(const compiled_pipeline& pipe, const options::change_stream& options = {});
+
+    ///
+    /// Gets a change stream on this collection with a compiled pipeline. The stages are sent as
+    /// they were serialized when the pipeline was compiled.
+    ///
+    /// @param session
+    ///   The mongocxx::client_session with which to perform the watch operation.
+    /// @param pipe
+    ///   The compiled aggregation pipeline to be used on the change notifications.
+    /// @param options
+    ///   The options to use when creating the change stream.
+    ///
+    /// @return
+    ///  A change stream on this collection.
+    ///
+    /// @see https://docs.mongodb.com/manual/changeStreams/
+    ///
+    change_stream watch(const client_session& session,
+                        const compiled_pipeline& pipe,
+                        const options::change_stream& options = {});
+
     ///
     /// @}
     ///
@@ -1824,6 +2219,8 @@ class MONGOCXX_API collection {
    private:
     friend class bulk_write;
     friend class database;
+    friend class prepared_aggregate;
+    friend class prepared_find;
 
     MONGOCXX_PRIVATE collection(const database& database,
                                 bsoncxx::string::view_or_value collection_name);
@@ -1831,7 +2228,7 @@ class MONGOCXX_API collection {
     MONGOCXX_PRIVATE collection(const database& database, void* collection);
 
     MONGOCXX_PRIVATE cursor _aggregate(const client_session* session,
-                                       const pipeline& pipeline,
+                                       bsoncxx::document::view stages,
                                        const options::aggregate& options);
 
     MONGOCXX_PRIVATE std::int64_t _count(const client_session* session,
@@ -1856,7 +2253,8 @@ class MONGOCXX_API collection {
     MONGOCXX_PRIVATE stdx::optional<result::delete_result> _delete_one(
         const client_session* session,
         bsoncxx::document::view_or_value filter,
-        const options::delete_options& options);
+        const options::delete_options& options,
+        std::error_code* ec);
 
     MONGOCXX_PRIVATE cursor _distinct(const client_session* session,
                                       bsoncxx::string::view_or_value name,
@@ -1874,7 +2272,8 @@ class MONGOCXX_API collection {
     MONGOCXX_PRIVATE stdx::optional<bsoncxx::document::value> _find_one(
         const client_session* session,
         bsoncxx::document::view_or_value filter,
-        const options::find& options);
+        const options::find& options,
+        std::error_code* ec);
 
     MONGOCXX_PRIVATE stdx::optional<bsoncxx::document::value> _find_one_and_delete(
         const client_session* session,
@@ -1896,7 +2295,8 @@ class MONGOCXX_API collection {
     MONGOCXX_PRIVATE stdx::optional<result::insert_one> _insert_one(
         const client_session* session,
         bsoncxx::document::view_or_value document,
-        const options::insert& options);
+        const options::insert& options,
+        std::error_code* ec);
 
     MONGOCXX_PRIVATE void _rename(
         const client_session* session,
@@ -1919,7 +2319,8 @@ class MONGOCXX_API collection {
         const client_session* session,
         bsoncxx::document::view_or_value filter,
         bsoncxx::document::view_or_value update,
-        const options::update& options);
+        const options::update& options,
+        std::error_code* ec);
 
     MONGOCXX_PRIVATE stdx::optional<result::update> _update_many(
         const client_session* session,
@@ -1931,6 +2332,10 @@ class MONGOCXX_API collection {
                                           const pipeline& pipe,
                                           const options::change_stream& options);
 
+    MONGOCXX_PRIVATE change_stream _watch(const client_session* session,
+                                          bsoncxx::document::view container,
+                                          const options::change_stream& options);
+
     // Helpers for the insert_many method templates.
     class bulk_write _init_insert_many(const options::insert& options,
                                        const client_session* session);
@@ -1942,6 +2347,12 @@ class MONGOCXX_API collection {
     stdx::optional<result::insert_many> _exec_insert_many(
         class bulk_write& writes, bsoncxx::builder::basic::array& inserted_ids);
 
+    MONGOCXX_PRIVATE stdx::optional<result::insert_many> _insert_many(
+        const client_session* session,
+        const std::uint8_t* data,
+        std::size_t length,
+        const options::insert& options);
+
     template <typename document_view_iterator_type>
     MONGOCXX_PRIVATE stdx::optional<result::insert_many> _insert_many(
         const client_session* session,
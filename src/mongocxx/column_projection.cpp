@@ -0,0 +1,390 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <mongocxx/column_projection.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include <bsoncxx/stdx/make_unique.hpp>
+#include <mongocxx/cursor.hpp>
+#include <mongocxx/exception/error_code.hpp>
+#include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/private/column_projection.hh>
+#include <mongocxx/private/field_decoder.hh>
+#include <mongocxx/private/libbson.hh>
+
+#include <mongocxx/config/private/prelude.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+namespace {
+
+constexpr std::size_t k_no_column = field_decoder::k_no_field;
+
+// The fields are kept as a tree of keys, so that each document is walked once and only the
+// subdocuments that hold requested fields are entered.
+struct field_node {
+    std::string key;
+    std::size_t column = k_no_column;
+    std::vector<field_node> children;
+};
+
+bool is_column_type(bsoncxx::type type) {
+    switch (type) {
+        case bsoncxx::type::k_double:
+        case bsoncxx::type::k_int64:
+        case bsoncxx::type::k_int32:
+        case bsoncxx::type::k_bool:
+        case bsoncxx::type::k_date:
+        case bsoncxx::type::k_utf8:
+            return true;
+        default:
+            return false;
+    }
+}
+
+}  // namespace
+
+std::size_t& column_projection_string_limit() {
+    static std::size_t limit = static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max());
+    return limit;
+}
+
+class column_projection::impl {
+   public:
+    // Appends the value at iter to the end of a column, returning false if the value does not
+    // have a type the column accepts.
+    static bool push_value(column& column, const bson_iter_t* iter) {
+        field_decoder::scalar value;
+        if (!field_decoder::read_scalar(column._type, iter, &value)) {
+            return false;
+        }
+
+        switch (column._type) {
+            case bsoncxx::type::k_double:
+                column._doubles.push_back(value.f64);
+                break;
+            case bsoncxx::type::k_int64:
+            case bsoncxx::type::k_date:
+                column._int64s.push_back(value.i64);
+                break;
+            case bsoncxx::type::k_int32:
+                column._int32s.push_back(value.i32);
+                break;
+            case bsoncxx::type::k_bool:
+                column._bools.push_back(value.b ? 1 : 0);
+                break;
+            case bsoncxx::type::k_utf8:
+                if (column._string_data.size() + value.str.size() >
+                    column_projection_string_limit()) {
+                    throw logic_error{error_code::k_invalid_parameter,
+                                      "string column " + column._path + " exceeds 2 GiB"};
+                }
+                column._string_data.append(value.str.data(), value.str.size());
+                column._string_offsets.push_back(
+                    static_cast<std::int32_t>(column._string_data.size()));
+                break;
+            default:
+                return false;
+        }
+        return true;
+    }
+
+    static void push_null(column& column) {
+        switch (column._type) {
+            case bsoncxx::type::k_double:
+                column._doubles.push_back(0);
+                break;
+            case bsoncxx::type::k_int64:
+            case bsoncxx::type::k_date:
+                column._int64s.push_back(0);
+                break;
+            case bsoncxx::type::k_int32:
+                column._int32s.push_back(0);
+                break;
+            case bsoncxx::type::k_bool:
+                column._bools.push_back(0);
+                break;
+            case bsoncxx::type::k_utf8:
+                column._string_offsets.push_back(
+                    static_cast<std::int32_t>(column._string_data.size()));
+                break;
+            default:
+                break;
+        }
+        ++column._null_count;
+    }
+
+    // Drops whatever a failed append() wrote to the columns for the row at index row, so that
+    // each of them holds exactly row values again.
+    void truncate(std::size_t row) {
+        for (auto& column : columns) {
+            // Only the vector of the column's type holds values. A null pushed for the row has
+            // been counted.
+            const std::size_t held = column._type == bsoncxx::type::k_utf8
+                                         ? column._string_offsets.size() - 1
+                                         : column._doubles.size() + column._int64s.size() +
+                                               column._int32s.size() + column._bools.size();
+            if (held > row && !column.is_valid(row)) {
+                --column._null_count;
+            }
+
+            column._doubles.resize(std::min(column._doubles.size(), row));
+            column._int64s.resize(std::min(column._int64s.size(), row));
+            column._int32s.resize(std::min(column._int32s.size(), row));
+            column._bools.resize(std::min(column._bools.size(), row));
+            if (column._type == bsoncxx::type::k_utf8) {
+                column._string_offsets.resize(row + 1);
+                column._string_data.resize(static_cast<std::size_t>(column._string_offsets[row]));
+            }
+
+            column._validity.resize((row + 7) / 8);
+            if (row % 8 != 0) {
+                column._validity[row / 8] &= static_cast<std::uint8_t>((1u << (row % 8)) - 1);
+            }
+        }
+    }
+
+    // Makes room in every validity bitmap for a row, whose bit starts unset.
+    void grow_validity(std::size_t row) {
+        const std::size_t byte = row / 8;
+        for (auto& column : columns) {
+            if (column._validity.size() <= byte) {
+                column._validity.push_back(0);
+            }
+        }
+    }
+
+    void walk(bson_iter_t* iter, const field_node& node) {
+        decoder.walk(
+            iter,
+            [&](const char* key, bson_iter_t* value) -> std::size_t {
+                const field_node* match = nullptr;
+                for (const auto& child : node.children) {
+                    if (std::strcmp(child.key.c_str(), key) == 0) {
+                        match = &child;
+                        break;
+                    }
+                }
+                if (!match) {
+                    return field_decoder::k_no_field;
+                }
+
+                if (!match->children.empty() && BSON_ITER_HOLDS_DOCUMENT(value)) {
+                    bson_iter_t child;
+                    if (bson_iter_recurse(value, &child)) {
+                        walk(&child, *match);
+                    }
+                }
+
+                return match->column;
+            },
+            [&](std::size_t field, bson_iter_t* value) -> bool {
+                column& target = columns[field];
+                if (!push_value(target, value)) {
+                    return false;
+                }
+                target._validity[rows / 8] |= static_cast<std::uint8_t>(1u << (rows % 8));
+                return true;
+            });
+    }
+
+    std::vector<column> columns;
+    field_node root;
+    std::size_t rows = 0;
+
+    // Tracks the columns filled in the row being appended.
+    field_decoder decoder;
+};
+
+column_projection::column_projection() : _impl{stdx::make_unique<impl>()} {}
+
+column_projection::column_projection(column_projection&&) noexcept = default;
+column_projection& column_projection::operator=(column_projection&&) noexcept = default;
+column_projection::~column_projection() = default;
+
+column_projection& column_projection::add_field(std::string path, bsoncxx::type type) {
+    if (!is_column_type(type)) {
+        throw logic_error{error_code::k_invalid_parameter,
+                          "unsupported column type for field " + path};
+    }
+    if (path.empty()) {
+        throw logic_error{error_code::k_invalid_parameter, "empty column_projection field path"};
+    }
+    if (_impl->rows > 0) {
+        throw logic_error{error_code::k_invalid_parameter,
+                          "fields cannot be added to a column_projection holding rows"};
+    }
+
+    field_node* node = &_impl->root;
+    std::size_t start = 0;
+    for (;;) {
+        const std::size_t dot = path.find('.', start);
+        const std::string key = path.substr(start, dot == std::string::npos ? dot : dot - start);
+
+        field_node* next = nullptr;
+        for (auto& child : node->children) {
+            if (child.key == key) {
+                next = &child;
+                break;
+            }
+        }
+        if (!next) {
+            node->children.push_back(field_node{key, k_no_column, {}});
+            next = &node->children.back();
+        }
+        node = next;
+
+        if (dot == std::string::npos) {
+            break;
+        }
+        start = dot + 1;
+    }
+
+    if (node->column != k_no_column) {
+        throw logic_error{error_code::k_invalid_parameter,
+                          "column_projection field " + path + " added twice"};
+    }
+
+    node->column = _impl->columns.size();
+    _impl->columns.push_back(column{std::move(path), type});
+    _impl->decoder.reset(_impl->columns.size());
+
+    return *this;
+}
+
+void column_projection::append(bsoncxx::document::view document) {
+    const std::size_t row = _impl->rows;
+
+    try {
+        _impl->grow_validity(row);
+        _impl->decoder.start_document();
+
+        bson_iter_t iter;
+        if (bson_iter_init_from_data(&iter, document.data(), document.length())) {
+            _impl->walk(&iter, _impl->root);
+        }
+
+        if (_impl->decoder.unfilled() > 0) {
+            for (std::size_t i = 0; i < _impl->columns.size(); ++i) {
+                if (!_impl->decoder.filled(i)) {
+                    impl::push_null(_impl->columns[i]);
+                }
+            }
+        }
+    } catch (...) {
+        // The fields walked before the failure have already been pushed to their columns.
+        _impl->truncate(row);
+        throw;
+    }
+
+    ++_impl->rows;
+}
+
+std::size_t column_projection::append(cursor& cursor) {
+    std::size_t appended = 0;
+    for (auto&& document : cursor) {
+        append(document);
+        ++appended;
+    }
+    return appended;
+}
+
+std::size_t column_projection::rows() const {
+    return _impl->rows;
+}
+
+const std::vector<column_projection::column>& column_projection::columns() const {
+    return _impl->columns;
+}
+
+void column_projection::clear() {
+    for (auto& column : _impl->columns) {
+        column._null_count = 0;
+        column._validity.clear();
+        column._doubles.clear();
+        column._int64s.clear();
+        column._int32s.clear();
+        column._bools.clear();
+        column._string_offsets.assign(1, 0);
+        column._string_data.clear();
+    }
+
+    _impl->decoder.reset(_impl->columns.size());
+    _impl->rows = 0;
+}
+
+column_projection::column::column(std::string path, bsoncxx::type type)
+    : _path{std::move(path)}, _type{type} {
+    if (type == bsoncxx::type::k_utf8) {
+        _string_offsets.push_back(0);
+    }
+}
+
+const std::string& column_projection::column::path() const {
+    return _path;
+}
+
+bsoncxx::type column_projection::column::type() const {
+    return _type;
+}
+
+std::size_t column_projection::column::null_count() const {
+    return _null_count;
+}
+
+bool column_projection::column::is_valid(std::size_t row) const {
+    return row / 8 < _validity.size() && ((_validity[row / 8] >> (row % 8)) & 1) != 0;
+}
+
+const std::vector<std::uint8_t>& column_projection::column::validity() const {
+    return _validity;
+}
+
+const std::vector<double>& column_projection::column::doubles() const {
+    return _doubles;
+}
+
+const std::vector<std::int64_t>& column_projection::column::int64s() const {
+    return _int64s;
+}
+
+const std::vector<std::int32_t>& column_projection::column::int32s() const {
+    return _int32s;
+}
+
+const std::vector<std::uint8_t>& column_projection::column::bools() const {
+    return _bools;
+}
+
+const std::vector<std::int32_t>& column_projection::column::string_offsets() const {
+    return _string_offsets;
+}
+
+const std::string& column_projection::column::string_data() const {
+    return _string_data;
+}
+
+bsoncxx::stdx::string_view column_projection::column::string(std::size_t row) const {
+    const auto begin = static_cast<std::size_t>(_string_offsets[row]);
+    const auto end = static_cast<std::size_t>(_string_offsets[row + 1]);
+    return bsoncxx::stdx::string_view{_string_data.data() + begin, end - begin};
+}
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
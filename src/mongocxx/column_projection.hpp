@@ -0,0 +1,217 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <bsoncxx/document/view.hpp>
+#include <bsoncxx/stdx/string_view.hpp>
+#include <bsoncxx/types.hpp>
+
+#include <mongocxx/config/prelude.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+class cursor;
+
+///
+/// Extracts fields of many documents into typed columns, for client-side analytics over query
+/// results.
+///
+/// Each appended document is walked once, whatever the number of fields, and the value of each
+/// field is written to the end of its column. A field that is missing, or whose value does not
+/// have the column's type, is null in that row. When a document repeats a key, the first
+/// occurrence whose value has the column's type is used.
+///
+/// The column types and the BSON types they accept are:
+///
+///  - bsoncxx::type::k_double: double, int32 and int64 values, converted to double.
+///  - bsoncxx::type::k_int64: int32 and int64 values.
+///  - bsoncxx::type::k_int32: int32 values.
+///  - bsoncxx::type::k_bool: boolean values.
+///  - bsoncxx::type::k_date: date values, as milliseconds since the Unix epoch.
+///  - bsoncxx::type::k_utf8: string values.
+///
+/// The buffers follow the layout of the Apache Arrow columnar format, so they can be handed to
+/// Arrow without conversion.
+///
+class MONGOCXX_API column_projection {
+   public:
+    class MONGOCXX_API column;
+
+    ///
+    /// Creates a projection with no fields.
+    ///
+    column_projection();
+
+    column_projection(column_projection&&) noexcept;
+    column_projection& operator=(column_projection&&) noexcept;
+
+    ~column_projection();
+
+    ///
+    /// Adds a field, and a column for it.
+    ///
+    /// @param path
+    ///   The path of the field. The keys of nested documents are separated by dots.
+    /// @param type
+    ///   The type of the column.
+    ///
+    /// @return A reference to this projection, to chain calls.
+    ///
+    /// @throws mongocxx::logic_error if the type is not a supported column type, if the path is
+    /// empty or already added, or if documents have already been appended.
+    ///
+    column_projection& add_field(std::string path, bsoncxx::type type);
+
+    ///
+    /// Appends one row, holding the fields of a document.
+    ///
+    /// @param document
+    ///   The document to append.
+    ///
+    /// @throws mongocxx::logic_error if the values of a string column would exceed 2 GiB. The
+    /// projection is left as it was before the call.
+    ///
+    void append(bsoncxx::document::view document);
+
+    ///
+    /// Appends one row for each of the remaining documents of a cursor.
+    ///
+    /// @param cursor
+    ///   The cursor to consume.
+    ///
+    /// @return The number of rows appended.
+    ///
+    /// @throws mongocxx::query_exception if the cursor fails.
+    /// @throws mongocxx::logic_error if the values of a string column would exceed 2 GiB. The rows
+    /// appended before the failing document are kept.
+    ///
+    std::size_t append(cursor& cursor);
+
+    ///
+    /// @return The number of rows appended.
+    ///
+    std::size_t rows() const;
+
+    ///
+    /// @return The columns, in the order their fields were added.
+    ///
+    const std::vector<column>& columns() const;
+
+    ///
+    /// Removes every row, keeping the fields and the memory the columns have allocated.
+    ///
+    void clear();
+
+   private:
+    class MONGOCXX_PRIVATE impl;
+    std::unique_ptr<impl> _impl;
+};
+
+///
+/// A column of values extracted by a column_projection.
+///
+class MONGOCXX_API column_projection::column {
+   public:
+    ///
+    /// @return The path of the field this column holds.
+    ///
+    const std::string& path() const;
+
+    ///
+    /// @return The type of the column.
+    ///
+    bsoncxx::type type() const;
+
+    ///
+    /// @return The number of null rows.
+    ///
+    std::size_t null_count() const;
+
+    ///
+    /// @return Whether a row has a value.
+    ///
+    bool is_valid(std::size_t row) const;
+
+    ///
+    /// @return The validity bitmap. Bit i, counting from the least significant bit of byte 0, is
+    /// set when row i has a value.
+    ///
+    const std::vector<std::uint8_t>& validity() const;
+
+    ///
+    /// @return The values of a k_double column. Null rows hold zero.
+    ///
+    const std::vector<double>& doubles() const;
+
+    ///
+    /// @return The values of a k_int64 or k_date column. Null rows hold zero.
+    ///
+    const std::vector<std::int64_t>& int64s() const;
+
+    ///
+    /// @return The values of a k_int32 column. Null rows hold zero.
+    ///
+    const std::vector<std::int32_t>& int32s() const;
+
+    ///
+    /// @return The values of a k_bool column, one byte per row. Null rows hold zero.
+    ///
+    const std::vector<std::uint8_t>& bools() const;
+
+    ///
+    /// @return The offsets of a k_utf8 column: rows() + 1 entries, where the value of row i is
+    /// string_data()[offsets[i], offsets[i + 1]). Null rows are empty.
+    ///
+    const std::vector<std::int32_t>& string_offsets() const;
+
+    ///
+    /// @return The concatenated values of a k_utf8 column.
+    ///
+    const std::string& string_data() const;
+
+    ///
+    /// @return The value of a row of a k_utf8 column.
+    ///
+    bsoncxx::stdx::string_view string(std::size_t row) const;
+
+   private:
+    friend class column_projection;
+
+    MONGOCXX_PRIVATE column(std::string path, bsoncxx::type type);
+
+    std::string _path;
+    bsoncxx::type _type;
+    std::size_t _null_count = 0;
+    std::vector<std::uint8_t> _validity;
+    std::vector<double> _doubles;
+    std::vector<std::int64_t> _int64s;
+    std::vector<std::int32_t> _int32s;
+    std::vector<std::uint8_t> _bools;
+    std::vector<std::int32_t> _string_offsets;
+    std::string _string_data;
+};
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/postlude.hpp>
@@ -0,0 +1,78 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <mongocxx/compiled_pipeline.hpp>
+
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
+#include <mongocxx/private/compiled_pipeline.hh>
+
+#include <mongocxx/config/private/prelude.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_document;
+
+compiled_pipeline::compiled_pipeline(const pipeline& pipeline)
+    : compiled_pipeline{pipeline, std::vector<std::string>{}} {}
+
+compiled_pipeline::compiled_pipeline(const pipeline& pipeline,
+                                     const std::vector<std::string>& parameters) {
+    // Parameter paths are relative to the array of stages, which is wrapped in a document.
+    std::vector<std::string> paths;
+    paths.reserve(parameters.size());
+    for (const auto& parameter : parameters) {
+        paths.push_back("pipeline." + parameter);
+    }
+
+    auto container = make_document(kvp("pipeline", pipeline.view_array()));
+    _impl = std::make_shared<impl>(bson_template{container.view(), paths}, !parameters.empty());
+}
+
+compiled_pipeline::compiled_pipeline(const compiled_pipeline& other)
+    : _impl{other._impl && other._impl->parameterized ? std::make_shared<impl>(*other._impl)
+                                                      : other._impl} {}
+
+compiled_pipeline& compiled_pipeline::operator=(const compiled_pipeline& other) {
+    if (this != &other) {
+        _impl = other._impl && other._impl->parameterized ? std::make_shared<impl>(*other._impl)
+                                                          : other._impl;
+    }
+    return *this;
+}
+
+compiled_pipeline::compiled_pipeline(compiled_pipeline&&) noexcept = default;
+compiled_pipeline& compiled_pipeline::operator=(compiled_pipeline&&) noexcept = default;
+compiled_pipeline::~compiled_pipeline() = default;
+
+bsoncxx::array::view compiled_pipeline::view_array() const {
+    return _impl->stages.view()["pipeline"].get_array().value;
+}
+
+parameterized_pipeline::parameterized_pipeline(const pipeline& pipeline,
+                                               const std::vector<std::string>& parameters)
+    : compiled_pipeline{pipeline, parameters} {}
+
+parameterized_pipeline& parameterized_pipeline::bind(std::size_t index,
+                                                     bsoncxx::types::bson_value::view value) {
+    // No other pipeline shares these stages, so they are patched in place.
+    _impl->stages.bind(index, value);
+    return *this;
+}
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
@@ -0,0 +1,143 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <bsoncxx/array/view.hpp>
+#include <bsoncxx/types/bson_value/view.hpp>
+#include <mongocxx/pipeline.hpp>
+
+#include <mongocxx/config/prelude.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+class collection;
+
+///
+/// Class representing an aggregation pipeline that has been serialized once for reuse.
+///
+/// A compiled_pipeline holds the stages of a pipeline in the form that collection::aggregate() and
+/// collection::watch() send to the server, so running it does not build or copy the stages again.
+/// It is immutable: copies share the same serialized stages, and a compiled_pipeline may be used
+/// by many threads at once.
+///
+class MONGOCXX_API compiled_pipeline {
+   public:
+    ///
+    /// Serializes the stages of a pipeline.
+    ///
+    /// @param pipeline
+    ///   The pipeline to compile. Later changes to it do not affect the compiled_pipeline.
+    ///
+    explicit compiled_pipeline(const pipeline& pipeline);
+
+    ///
+    /// Copy constructs a compiled pipeline. The copy shares the serialized stages, unless they
+    /// belong to a parameterized_pipeline, in which case they are copied.
+    ///
+    compiled_pipeline(const compiled_pipeline&);
+
+    ///
+    /// Copy assigns a compiled pipeline. The copy shares the serialized stages, unless they
+    /// belong to a parameterized_pipeline, in which case they are copied.
+    ///
+    compiled_pipeline& operator=(const compiled_pipeline&);
+
+    ///
+    /// Move constructs a compiled pipeline.
+    ///
+    compiled_pipeline(compiled_pipeline&&) noexcept;
+
+    ///
+    /// Move assigns a compiled pipeline.
+    ///
+    compiled_pipeline& operator=(compiled_pipeline&&) noexcept;
+
+    ///
+    /// Destroys a compiled pipeline.
+    ///
+    ~compiled_pipeline();
+
+    ///
+    /// @return A view of the BSON array of stages this compiled pipeline represents.
+    ///
+    bsoncxx::array::view view_array() const;
+
+   protected:
+    MONGOCXX_PRIVATE compiled_pipeline(const pipeline& pipeline,
+                                       const std::vector<std::string>& parameters);
+
+    class MONGOCXX_PRIVATE impl;
+    std::shared_ptr<impl> _impl;
+
+   private:
+    friend class collection;
+};
+
+///
+/// Class representing a compiled aggregation pipeline whose literal values can be rebound.
+///
+/// Each parameter is a value in the pipeline, named by its dotted path starting with the index of
+/// its stage, e.g. "0.$match.status". The value the pipeline holds at that path when it is compiled
+/// fixes the parameter's type. bind() patches a new value into the serialized stages without
+/// rebuilding them.
+///
+/// A parameterized_pipeline is not thread-safe, but copies of it are independent: copying one
+/// copies its serialized stages, which is cheaper than compiling the pipeline again. A common
+/// pattern is to compile a parameterized_pipeline once and copy it for each request.
+///
+class MONGOCXX_API parameterized_pipeline : public compiled_pipeline {
+   public:
+    ///
+    /// Serializes the stages of a pipeline and locates its parameters.
+    ///
+    /// @param pipeline
+    ///   The pipeline to compile, holding a value of the right type at each parameter's path.
+    /// @param parameters
+    ///   The dotted paths of the parameters, in the order of their indexes.
+    ///
+    /// @throws mongocxx::logic_error if a path does not name a value in the pipeline, names a
+    ///   value of a type that cannot be a parameter, or lies inside another parameter.
+    ///
+    parameterized_pipeline(const pipeline& pipeline, const std::vector<std::string>& parameters);
+
+    ///
+    /// Binds a value to a parameter. The value stays bound until it is replaced.
+    ///
+    /// @param index
+    ///   The position of the parameter in the list of paths the pipeline was compiled with.
+    /// @param value
+    ///   The value to bind. It must have the same BSON type as the parameter.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called. This facilitates
+    ///   method chaining.
+    ///
+    /// @throws mongocxx::logic_error if the index is out of range or the value's type differs from
+    ///   the parameter's.
+    ///
+    parameterized_pipeline& bind(std::size_t index, bsoncxx::types::bson_value::view value);
+};
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/postlude.hpp>
@@ -17,5 +17,7 @@
 
 #undef MONGOCXX_ENABLE_SSL
 #pragma pop_macro("MONGOCXX_ENABLE_SSL")
+#undef MONGOCXX_ENABLE_ZLIB_CHUNK_CODEC
+#pragma pop_macro("MONGOCXX_ENABLE_ZLIB_CHUNK_CODEC")
 
 #include <mongocxx/config/postlude.hpp>
@@ -19,5 +19,7 @@
 
 #pragma push_macro("MONGOCXX_ENABLE_SSL")
 #undef MONGOCXX_ENABLE_SSL
+#pragma push_macro("MONGOCXX_ENABLE_ZLIB_CHUNK_CODEC")
+#undef MONGOCXX_ENABLE_ZLIB_CHUNK_CODEC
 
 #include <mongocxx/config/private/config.hh>
@@ -39,15 +39,10 @@ void cursor::iterator::operator++(int) {
 }
 
 cursor::iterator& cursor::iterator::operator++() {
-    const bson_t* out;
     const bson_t* error_document;
     bson_error_t error;
 
-    if (libmongoc::cursor_next(_cursor->_impl->cursor_t, &out)) {
-        _cursor->_impl->doc = bsoncxx::document::view{bson_get_data(out), out->len};
-    } else if (libmongoc::cursor_error_document(
-                   _cursor->_impl->cursor_t, &error, &error_document)) {
-        _cursor->_impl->mark_dead();
+    if (!_cursor->_impl->advance(&error, &error_document)) {
         if (error_document) {
             bsoncxx::document::value error_doc{
                 bsoncxx::document::view{bson_get_data(error_document), error_document->len}};
@@ -55,8 +50,18 @@ cursor::iterator& cursor::iterator::operator++() {
         } else {
             throw_exception<query_exception>(error);
         }
+    }
+    return *this;
+}
+
+cursor::iterator& cursor::iterator::increment(std::error_code& ec) noexcept {
+    const bson_t* error_document;
+    bson_error_t error;
+
+    if (_cursor->_impl->advance(&error, &error_document)) {
+        ec.clear();
     } else {
-        _cursor->_impl->mark_nothing_left();
+        ec = make_error_code(error);
     }
     return *this;
 }
@@ -68,6 +73,25 @@ cursor::iterator cursor::begin() {
     return iterator(this);
 }
 
+cursor::iterator cursor::begin(std::error_code& ec) noexcept {
+    ec.clear();
+
+    if (_impl->is_dead()) {
+        return end();
+    }
+
+    if (_impl->has_started()) {
+        return iterator(this);
+    }
+
+    // Mark the cursor started first so that constructing the iterator does not advance it, which
+    // could throw.
+    _impl->mark_started();
+    iterator it(this);
+    it.increment(ec);
+    return it;
+}
+
 cursor::iterator cursor::end() {
     return iterator(nullptr);
 }
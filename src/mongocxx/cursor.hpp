@@ -15,6 +15,7 @@
 #pragma once
 
 #include <memory>
+#include <system_error>
 
 #include <bsoncxx/document/view.hpp>
 #include <bsoncxx/stdx/optional.hpp>
@@ -70,6 +71,20 @@ class MONGOCXX_API cursor {
     ///
     iterator begin();
 
+    ///
+    /// Like begin(), but reports a failed query through an error code instead of throwing.
+    ///
+    /// On failure the cursor is dead and the returned iterator compares equal to end(). The
+    /// server's error reply is not retained; use begin() where it is needed.
+    ///
+    /// @param ec
+    ///   Set to the error if the query failed, otherwise cleared. The code is the one that
+    ///   mongocxx::query_exception::code() would have returned.
+    ///
+    /// @return the cursor::iterator
+    ///
+    iterator begin(std::error_code& ec) noexcept;
+
     ///
     /// A cursor::iterator indicating cursor exhaustion, meaning that
     /// no documents are available from the cursor.
@@ -83,6 +98,8 @@ class MONGOCXX_API cursor {
     friend class client;
     friend class database;
     friend class index_view;
+    friend class prepared_aggregate;
+    friend class prepared_find;
     friend class cursor::iterator;
 
     MONGOCXX_PRIVATE cursor(void* cursor_ptr,
@@ -145,6 +162,20 @@ class MONGOCXX_API cursor::iterator {
     ///
     void operator++(int);
 
+    ///
+    /// Pre-increments the iterator to move to the next document, reporting a failed query through
+    /// an error code instead of throwing.
+    ///
+    /// On failure the originating cursor is dead and this iterator is exhausted. The server's
+    /// error reply is not retained; use operator++() where it is needed.
+    ///
+    /// @param ec
+    ///   Set to the error if the query failed, otherwise cleared.
+    ///
+    /// @return a reference to this iterator
+    ///
+    iterator& increment(std::error_code& ec) noexcept;
+
    private:
     friend class cursor;
 
@@ -510,7 +510,8 @@ class change_stream database::_watch(const client_session* session,
     scoped_bson_t options_bson{options_builder.extract()};
 
     return change_stream{libmongoc::database_watch(
-        _get_impl().database_t, pipeline_bson.bson(), options_bson.bson())};
+                             _get_impl().database_t, pipeline_bson.bson(), options_bson.bson()),
+                         options.batch_size()};
 }
 
 const database::impl& database::_get_impl() const {
@@ -0,0 +1,536 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <mongocxx/document_cache.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+#include <bsoncxx/exception/exception.hpp>
+#include <bsoncxx/private/libbson.hh>
+#include <bsoncxx/stdx/make_unique.hpp>
+#include <bsoncxx/string/to_string.hpp>
+#include <bsoncxx/types.hpp>
+#include <mongocxx/client.hpp>
+#include <mongocxx/collection.hpp>
+#include <mongocxx/database.hpp>
+#include <mongocxx/exception/error_code.hpp>
+#include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/options/change_stream.hpp>
+#include <mongocxx/private/document_cache.hh>
+
+#include <mongocxx/config/private/prelude.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+namespace {
+
+constexpr std::int64_t k_default_max_bytes = 64 * 1024 * 1024;
+constexpr std::int32_t k_default_shard_count = 16;
+constexpr std::chrono::milliseconds k_default_max_await_time{1000};
+
+// What an entry costs beyond its key, id, document and filter: the list, index and set nodes and
+// the compiled plan of its matcher.
+constexpr std::size_t k_entry_overhead = 256;
+
+// Returns the bytes of an element, from its type byte to the end of its value.
+bsoncxx::stdx::string_view element_bytes(const bsoncxx::document::element& element) {
+    bson_iter_t iter;
+    if (!bson_iter_init_from_data_at_offset(
+            &iter, element.raw(), element.length(), element.offset(), element.keylen())) {
+        return {};
+    }
+    return {reinterpret_cast<const char*>(element.raw()) + element.offset(),
+            iter.next_off - element.offset()};
+}
+
+// Returns the type byte and value bytes of an element, which identify its value regardless of its
+// key.
+std::string value_bytes(const bsoncxx::document::element& element) {
+    const auto bytes = element_bytes(element);
+    if (bytes.empty()) {
+        return {};
+    }
+
+    std::string value(bytes.data(), 1);
+    value.append(bytes.data() + 1 + element.keylen() + 1, bytes.size() - element.keylen() - 2);
+    return value;
+}
+
+// Returns the filter's top-level elements, sorted by key and concatenated. The elements of a
+// filter are ANDed, so filters that differ only in their order are equivalent.
+std::string normalize(bsoncxx::document::view filter) {
+    std::vector<bsoncxx::document::element> elements{filter.begin(), filter.end()};
+    std::sort(elements.begin(),
+              elements.end(),
+              [](const bsoncxx::document::element& a, const bsoncxx::document::element& b) {
+                  return a.key() < b.key();
+              });
+
+    std::string key;
+    key.reserve(filter.length());
+    for (const auto& element : elements) {
+        const auto bytes = element_bytes(element);
+        key.append(bytes.data(), bytes.size());
+    }
+    return key;
+}
+
+// Returns the _id value of a filter that is an equality on _id, such as {"_id": ObjectId(...)},
+// or an empty string. Only types whose equality is byte equality qualify, so that the value can
+// be compared with the _id in change events; a numeric _id of 1 also matches 1.0, for instance.
+std::string filter_id(bsoncxx::document::view filter) {
+    auto first = filter.begin();
+    if (first == filter.end() || std::next(first) != filter.end() || first->key() != "_id") {
+        return {};
+    }
+
+    switch (first->type()) {
+        case bsoncxx::type::k_oid:
+        case bsoncxx::type::k_utf8:
+        case bsoncxx::type::k_binary:
+        case bsoncxx::type::k_date:
+            return value_bytes(*first);
+        default:
+            return {};
+    }
+}
+
+}  // namespace
+
+document_cache::impl::impl(class pool& pool,
+                           std::string db_name,
+                           std::string collection_name,
+                           std::size_t shard_bytes,
+                           std::size_t shard_count,
+                           std::chrono::milliseconds max_await_time)
+    : client_pool{pool},
+      db_name{std::move(db_name)},
+      collection_name{std::move(collection_name)},
+      shard_bytes{shard_bytes},
+      max_await_time{max_await_time},
+      valid{true},
+      stopping{false} {
+    shards.reserve(shard_count);
+    for (std::size_t i = 0; i < shard_count; ++i) {
+        shards.push_back(stdx::make_unique<shard>());
+    }
+}
+
+document_cache::impl::~impl() {
+    {
+        std::lock_guard<std::mutex> lock{stop_mutex};
+        stopping = true;
+    }
+    stop_cv.notify_all();
+
+    if (watcher.joinable()) {
+        watcher.join();
+    }
+}
+
+void document_cache::impl::start_watching() {
+    watch_client = client_pool.acquire();
+    stream = stdx::make_unique<change_stream>(open_stream(stdx::nullopt));
+    watcher = std::thread{[this] { run(); }};
+}
+
+change_stream document_cache::impl::open_stream(
+    stdx::optional<bsoncxx::document::view> start_after) {
+    options::change_stream options;
+    options.full_document("updateLookup");
+    options.max_await_time(max_await_time);
+    if (start_after) {
+        options.start_after(*start_after);
+    }
+
+    return (**watch_client)[db_name][collection_name].watch(options);
+}
+
+void document_cache::impl::run() {
+    while (!stopping) {
+        try {
+            if (!stream) {
+                stream = stdx::make_unique<change_stream>(open_stream(stdx::nullopt));
+                valid = true;
+            }
+
+            stdx::optional<bsoncxx::document::value> invalidated_at;
+            for (auto&& event : *stream) {
+                invalidate(event);
+
+                // An invalidate event closes the stream. Reopening it right after that event
+                // misses nothing.
+                auto type = event["operationType"];
+                if (type && type.type() == bsoncxx::type::k_utf8 &&
+                    type.get_string().value == stdx::string_view{"invalidate"}) {
+                    invalidated_at = bsoncxx::document::value{event["_id"].get_document().value};
+                    break;
+                }
+                if (stopping) {
+                    return;
+                }
+            }
+
+            if (invalidated_at) {
+                stream = stdx::make_unique<change_stream>(open_stream(invalidated_at->view()));
+            }
+        } catch (...) {
+            // The change stream failed and could not resume, so changes may have been missed.
+            // Bypass and empty the cache until a new change stream is open.
+            valid = false;
+            clear();
+            stream.reset();
+
+            std::unique_lock<std::mutex> lock{stop_mutex};
+            stop_cv.wait_for(lock, max_await_time, [this] { return stopping.load(); });
+        }
+    }
+}
+
+document_cache::impl::shard& document_cache::impl::shard_for(const std::string& key) {
+    return *shards[std::hash<std::string>{}(key) % shards.size()];
+}
+
+stdx::optional<bsoncxx::document::value> document_cache::impl::find_one(
+    bsoncxx::document::view filter) {
+    std::string key = normalize(filter);
+    std::string id = filter_id(filter);
+    shard& s = shard_for(key);
+
+    bool cacheable;
+    std::list<fetch>::iterator pending;
+    {
+        std::lock_guard<std::mutex> lock{s.mutex};
+        cacheable = valid;
+        if (cacheable) {
+            auto found = s.index.find(key);
+            if (found != s.index.end()) {
+                s.entries.splice(s.entries.begin(), s.entries, found->second);
+                ++s.hits;
+                return found->second->document;
+            }
+            pending = s.fetches.insert(s.fetches.end(), fetch{id, false});
+        }
+        ++s.misses;
+    }
+
+    stdx::optional<bsoncxx::document::value> result;
+    try {
+        auto client = client_pool.acquire();
+        result = (*client)[db_name][collection_name].find_one(filter);
+    } catch (...) {
+        if (cacheable) {
+            std::lock_guard<std::mutex> lock{s.mutex};
+            s.fetches.erase(pending);
+        }
+        throw;
+    }
+
+    if (cacheable) {
+        entry e = make_entry(std::move(key), std::move(id), filter, result);
+
+        std::lock_guard<std::mutex> lock{s.mutex};
+        const bool stale = pending->stale;
+        s.fetches.erase(pending);
+        if (!stale && valid) {
+            insert(s, std::move(e));
+        }
+    }
+
+    return result;
+}
+
+document_cache::impl::entry document_cache::impl::make_entry(
+    std::string key,
+    std::string id,
+    bsoncxx::document::view filter,
+    const stdx::optional<bsoncxx::document::value>& result) const {
+    entry e;
+    e.key = std::move(key);
+    e.document = result;
+    e.id_filter = !id.empty();
+    e.id = std::move(id);
+    e.bytes = k_entry_overhead + e.key.size();
+
+    if (!e.id_filter) {
+        if (result) {
+            if (auto result_id = result->view()["_id"]) {
+                e.id = value_bytes(result_id);
+            }
+        }
+
+        // Filters that the matcher does not support are checked conservatively instead.
+        try {
+            e.matcher = stdx::make_unique<bsoncxx::matcher>(filter);
+            e.bytes += filter.length();
+        } catch (const bsoncxx::exception&) {
+        }
+    }
+
+    e.bytes += e.id.size();
+    if (result) {
+        e.bytes += result->view().length();
+    }
+
+    return e;
+}
+
+void document_cache::impl::insert(shard& s, entry e) {
+    // A concurrent miss for the same filter may have cached it already.
+    erase(s, e.key);
+
+    if (e.bytes > shard_bytes) {
+        return;
+    }
+
+    while (s.bytes + e.bytes > shard_bytes) {
+        erase(s, s.entries.back().key);
+        ++s.evictions;
+    }
+
+    s.entries.push_front(std::move(e));
+    entry& inserted = s.entries.front();
+
+    s.index.emplace(inserted.key, s.entries.begin());
+    if (!inserted.id.empty()) {
+        s.by_id.emplace(inserted.id, &inserted);
+    }
+    if (!inserted.id_filter) {
+        s.general.insert(&inserted);
+    }
+    s.bytes += inserted.bytes;
+}
+
+bool document_cache::impl::erase(shard& s, const std::string& key) {
+    auto found = s.index.find(key);
+    if (found == s.index.end()) {
+        return false;
+    }
+
+    entry& e = *found->second;
+
+    if (!e.id.empty()) {
+        auto range = s.by_id.equal_range(e.id);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second == &e) {
+                s.by_id.erase(it);
+                break;
+            }
+        }
+    }
+    s.general.erase(&e);
+    s.bytes -= e.bytes;
+
+    // The key is owned by the entry, so the index node goes first.
+    auto position = found->second;
+    s.index.erase(found);
+    s.entries.erase(position);
+    return true;
+}
+
+void document_cache::impl::invalidate(bsoncxx::document::view event) {
+    auto type = event["operationType"];
+    auto document_key = event["documentKey"];
+
+    const bsoncxx::stdx::string_view operation =
+        type && type.type() == bsoncxx::type::k_utf8 ? type.get_string().value
+                                                     : bsoncxx::stdx::string_view{};
+    const bool changes_one_document = operation == "insert" || operation == "update" ||
+                                      operation == "replace" || operation == "delete";
+
+    bsoncxx::document::element id;
+    if (changes_one_document && document_key &&
+        document_key.type() == bsoncxx::type::k_document) {
+        id = document_key.get_document().value["_id"];
+    }
+
+    // Drops, renames and anything else that does not name a single document may affect every
+    // entry.
+    if (!id) {
+        clear();
+        return;
+    }
+
+    const std::string id_bytes = value_bytes(id);
+
+    stdx::optional<bsoncxx::document::view> document;
+    auto full_document = event["fullDocument"];
+    if (full_document && full_document.type() == bsoncxx::type::k_document) {
+        document = full_document.get_document().value;
+    }
+
+    // A deleted document can no longer match any filter, so only the entries for its _id change.
+    const bool may_match = operation != "delete";
+
+    for (auto&& s : shards) {
+        std::lock_guard<std::mutex> lock{s->mutex};
+        invalidate(*s, id_bytes, may_match, document);
+    }
+}
+
+void document_cache::impl::invalidate(shard& s,
+                                      const std::string& id,
+                                      bool may_match,
+                                      const stdx::optional<bsoncxx::document::view>& document) {
+    std::vector<std::string> affected;
+
+    auto range = s.by_id.equal_range(id);
+    for (auto it = range.first; it != range.second; ++it) {
+        affected.push_back(it->second->key);
+    }
+
+    if (may_match) {
+        for (entry* e : s.general) {
+            if (!e->matcher || !document || e->matcher->matches(*document)) {
+                affected.push_back(e->key);
+            }
+        }
+    }
+
+    for (const auto& key : affected) {
+        if (erase(s, key)) {
+            ++s.invalidations;
+        }
+    }
+
+    for (auto&& f : s.fetches) {
+        if (f.id.empty() || f.id == id) {
+            f.stale = true;
+        }
+    }
+}
+
+void document_cache::impl::clear() {
+    for (auto&& s : shards) {
+        std::lock_guard<std::mutex> lock{s->mutex};
+        clear(*s);
+    }
+}
+
+void document_cache::impl::clear(shard& s) {
+    s.invalidations += static_cast<std::int64_t>(s.entries.size());
+    s.index.clear();
+    s.by_id.clear();
+    s.general.clear();
+    s.entries.clear();
+    s.bytes = 0;
+
+    for (auto&& f : s.fetches) {
+        f.stale = true;
+    }
+}
+
+std::int64_t document_cache::impl::sum(std::int64_t (*statistic)(const shard&)) const {
+    std::int64_t total = 0;
+    for (auto&& s : shards) {
+        std::lock_guard<std::mutex> lock{s->mutex};
+        total += statistic(*s);
+    }
+    return total;
+}
+
+document_cache::document_cache(class pool& pool,
+                               bsoncxx::string::view_or_value db_name,
+                               bsoncxx::string::view_or_value collection_name,
+                               const options::document_cache& options) {
+    std::int64_t max_bytes = k_default_max_bytes;
+    if (auto bytes = options.max_bytes()) {
+        if (*bytes <= 0) {
+            throw logic_error{error_code::k_invalid_parameter,
+                              "positive value required for options::document_cache::max_bytes()"};
+        }
+        max_bytes = *bytes;
+    }
+
+    std::int32_t shard_count = k_default_shard_count;
+    if (auto count = options.shard_count()) {
+        if (*count <= 0) {
+            throw logic_error{
+                error_code::k_invalid_parameter,
+                "positive value required for options::document_cache::shard_count()"};
+        }
+        shard_count = *count;
+    }
+
+    std::chrono::milliseconds max_await_time = k_default_max_await_time;
+    if (auto time = options.max_await_time()) {
+        if (time->count() <= 0) {
+            throw logic_error{
+                error_code::k_invalid_parameter,
+                "positive value required for options::document_cache::max_await_time()"};
+        }
+        max_await_time = *time;
+    }
+
+    _impl = stdx::make_unique<impl>(
+        pool,
+        bsoncxx::string::to_string(db_name.view()),
+        bsoncxx::string::to_string(collection_name.view()),
+        std::max<std::size_t>(static_cast<std::size_t>(max_bytes / shard_count), 1),
+        static_cast<std::size_t>(shard_count),
+        max_await_time);
+
+    if (options.watch().value_or(true)) {
+        _impl->start_watching();
+    }
+}
+
+document_cache::document_cache(document_cache&&) noexcept = default;
+document_cache& document_cache::operator=(document_cache&&) noexcept = default;
+document_cache::~document_cache() = default;
+
+stdx::optional<bsoncxx::document::value> document_cache::find_one(
+    bsoncxx::document::view filter) {
+    return _impl->find_one(filter);
+}
+
+void document_cache::invalidate(bsoncxx::document::view event) {
+    _impl->invalidate(event);
+}
+
+void document_cache::clear() {
+    _impl->clear();
+}
+
+std::int64_t document_cache::hits() const {
+    return _impl->sum([](const impl::shard& s) { return s.hits; });
+}
+
+std::int64_t document_cache::misses() const {
+    return _impl->sum([](const impl::shard& s) { return s.misses; });
+}
+
+std::int64_t document_cache::evictions() const {
+    return _impl->sum([](const impl::shard& s) { return s.evictions; });
+}
+
+std::int64_t document_cache::invalidations() const {
+    return _impl->sum([](const impl::shard& s) { return s.invalidations; });
+}
+
+std::int64_t document_cache::size() const {
+    return _impl->sum(
+        [](const impl::shard& s) { return static_cast<std::int64_t>(s.entries.size()); });
+}
+
+std::int64_t document_cache::size_bytes() const {
+    return _impl->sum([](const impl::shard& s) { return static_cast<std::int64_t>(s.bytes); });
+}
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
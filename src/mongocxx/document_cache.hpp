@@ -0,0 +1,154 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/document/view.hpp>
+#include <bsoncxx/stdx/optional.hpp>
+#include <bsoncxx/string/view_or_value.hpp>
+#include <mongocxx/options/document_cache.hpp>
+#include <mongocxx/stdx.hpp>
+
+#include <mongocxx/config/prelude.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+class pool;
+
+///
+/// Class representing a read-through cache of collection::find_one results for one collection.
+///
+/// Results are cached by filter, after sorting the filter's top-level fields so that filters that
+/// differ only in field order share an entry. Entries are held in a fixed number of shards, each
+/// with its own lock, least-recently-used order and share of the memory limit.
+///
+/// The cache watches its collection with a change stream and drops the entries a change may
+/// have affected: every entry for the changed document's _id, and every entry whose filter the
+/// new version of the document matches, as evaluated by bsoncxx::matcher. An entry whose filter is
+/// an equality on a string, ObjectId, binary or date _id is only ever affected by changes to that
+/// document. Entries whose filters bsoncxx::matcher does not support are dropped by every insert,
+/// update and replace. Any other kind of change, such as a drop or rename, empties the cache.
+///
+/// While the change stream is failing the cache is bypassed, since changes may be missed, and it
+/// starts empty again once the stream is reopened.
+///
+/// A document_cache may be used by any number of threads at once. It acquires a client from the
+/// pool for each miss, and keeps one client for as long as it watches the collection.
+///
+class MONGOCXX_API document_cache {
+   public:
+    ///
+    /// Constructs a cache and opens its change stream. Writes made after the constructor returns
+    /// always invalidate the cache entries they affect.
+    ///
+    /// @param pool
+    ///   The pool to acquire clients from. It must outlive the cache.
+    /// @param db_name
+    ///   The name of the database of the cached collection.
+    /// @param collection_name
+    ///   The name of the cached collection.
+    /// @param options
+    ///   Optional arguments; see mongocxx::options::document_cache.
+    ///
+    /// @throws mongocxx::logic_error if an option has an invalid value.
+    /// @throws mongocxx::operation_exception if the change stream cannot be opened.
+    ///
+    document_cache(pool& pool,
+                   bsoncxx::string::view_or_value db_name,
+                   bsoncxx::string::view_or_value collection_name,
+                   const options::document_cache& options = {});
+
+    document_cache(document_cache&&) noexcept;
+    document_cache& operator=(document_cache&&) noexcept;
+
+    ///
+    /// Stops watching the collection and destroys the cache.
+    ///
+    ~document_cache();
+
+    ///
+    /// Finds a single document matching the filter, from the cache if possible and otherwise with
+    /// collection::find_one, whose result is then cached. That a filter matches no document is
+    /// cached as well.
+    ///
+    /// @param filter
+    ///   Document view representing a document that should match the query.
+    ///
+    /// @return An optional document that matched the filter.
+    ///
+    /// @throws mongocxx::query_exception if the operation fails.
+    ///
+    stdx::optional<bsoncxx::document::value> find_one(bsoncxx::document::view filter);
+
+    ///
+    /// Drops the entries a change may have affected. The background change stream calls this for
+    /// each change; applications only need to call it when options::document_cache::watch is
+    /// false.
+    ///
+    /// @param event
+    ///   A change event for the cached collection.
+    ///
+    void invalidate(bsoncxx::document::view event);
+
+    ///
+    /// Drops every entry.
+    ///
+    void clear();
+
+    ///
+    /// @return The number of find_one calls answered from the cache.
+    ///
+    std::int64_t hits() const;
+
+    ///
+    /// @return The number of find_one calls that went to the server, including those made while
+    ///   the cache was bypassed.
+    ///
+    std::int64_t misses() const;
+
+    ///
+    /// @return The number of entries evicted to stay within the memory limit.
+    ///
+    std::int64_t evictions() const;
+
+    ///
+    /// @return The number of entries dropped by invalidate() or clear().
+    ///
+    std::int64_t invalidations() const;
+
+    ///
+    /// @return The number of entries in the cache.
+    ///
+    std::int64_t size() const;
+
+    ///
+    /// @return The number of bytes the entries in the cache are accounted as using.
+    ///
+    std::int64_t size_bytes() const;
+
+   private:
+    class MONGOCXX_PRIVATE impl;
+    std::unique_ptr<impl> _impl;
+};
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/postlude.hpp>
@@ -84,6 +84,13 @@ class error_category final : public std::error_category {
                 return "an invalid client session was provided";
             case error_code::k_invalid_transaction_options_object:
                 return "an invalid transactions options object was provided";
+            case error_code::k_resume_token_store_corrupted:
+                return "a stored change stream resume token could not be read back";
+            case error_code::k_gridfs_unsupported_chunk_codec:
+                return "a GridFS file was compressed with a chunk codec that the bucket is not "
+                       "configured with";
+            case error_code::k_zlib_not_supported:
+                return "zlib support not available";
             default:
                 return "unknown mongocxx error";
         }
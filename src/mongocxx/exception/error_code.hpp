@@ -90,6 +90,16 @@ enum class error_code : std::int32_t {
     /// A moved-from mongocxx::options::transaction object has been used.
     k_invalid_transaction_options_object,
 
+    /// A stored change stream resume token could not be read back.
+    k_resume_token_store_corrupted,
+
+    /// A GridFS file was compressed with a chunk codec that the bucket is not configured with.
+    k_gridfs_unsupported_chunk_codec,
+
+    /// The driver was built without zlib support, so mongocxx::gridfs::zlib_chunk_codec is not
+    /// available.
+    k_zlib_not_supported,
+
     // Add new constant string message to error_code.cpp as well!
 };
 
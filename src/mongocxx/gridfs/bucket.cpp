@@ -14,21 +14,37 @@
 
 #include <mongocxx/gridfs/bucket.hpp>
 
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <future>
 #include <ios>
+#include <limits>
+#include <sstream>
 #include <string>
+#include <vector>
 
 #include <bsoncxx/builder/basic/document.hpp>
 #include <bsoncxx/builder/basic/kvp.hpp>
 #include <bsoncxx/oid.hpp>
 #include <bsoncxx/stdx/make_unique.hpp>
 #include <bsoncxx/stdx/optional.hpp>
+#include <bsoncxx/string/to_string.hpp>
+#include <mongocxx/client.hpp>
 #include <mongocxx/database.hpp>
 #include <mongocxx/exception/error_code.hpp>
 #include <mongocxx/exception/gridfs_exception.hpp>
 #include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/gridfs/private/blob_refs.hh>
 #include <mongocxx/gridfs/private/bucket.hh>
+#include <mongocxx/gridfs/private/crc32c.hh>
+#include <mongocxx/gridfs/private/mapped_file.hh>
 #include <mongocxx/options/delete.hpp>
+#include <mongocxx/options/find.hpp>
+#include <mongocxx/options/find_one_and_delete.hpp>
 #include <mongocxx/options/index.hpp>
+#include <mongocxx/pool.hpp>
 #include <mongocxx/stdx.hpp>
 
 #include <mongocxx/config/private/prelude.hh>
@@ -37,6 +53,20 @@ namespace mongocxx {
 MONGOCXX_INLINE_NAMESPACE_BEGIN
 namespace gridfs {
 
+namespace {
+
+// Copies the rest of a download to consecutive bytes starting at `out`.
+void copy_chunks(downloader* download, std::uint8_t* out) {
+    bsoncxx::types::b_binary data;
+    while ((data = download->read_chunk()).size != 0) {
+        std::memcpy(out, data.bytes, data.size);
+        out += data.size;
+    }
+    download->close();
+}
+
+}  // namespace
+
 bucket::bucket(const database& db, const options::gridfs::bucket& options) {
     std::string bucket_name = "fs";
     if (auto name = options.bucket_name()) {
@@ -59,24 +89,35 @@ bucket::bucket(const database& db, const options::gridfs::bucket& options) {
 
     collection chunks = db[bucket_name + ".chunks"];
     collection files = db[bucket_name + ".files"];
+    collection blobs = db[bucket_name + ".blobs"];
 
-    _impl = stdx::make_unique<impl>(
-        std::move(bucket_name), default_chunk_size_bytes, std::move(chunks), std::move(files));
+    _impl = stdx::make_unique<impl>(bsoncxx::string::to_string(db.name()),
+                                    std::move(bucket_name),
+                                    default_chunk_size_bytes,
+                                    std::move(chunks),
+                                    std::move(files),
+                                    std::move(blobs));
 
     if (auto read_concern = options.read_concern()) {
         _get_impl().files.read_concern(*read_concern);
         _get_impl().chunks.read_concern(*read_concern);
+        _get_impl().blobs.read_concern(*read_concern);
     }
 
     if (auto read_preference = options.read_preference()) {
         _get_impl().files.read_preference(*read_preference);
         _get_impl().chunks.read_preference(*read_preference);
+        _get_impl().blobs.read_preference(*read_preference);
     }
 
     if (auto write_concern = options.write_concern()) {
         _get_impl().files.write_concern(*write_concern);
         _get_impl().chunks.write_concern(*write_concern);
+        _get_impl().blobs.write_concern(*write_concern);
     }
+
+    _get_impl().codec = options.chunk_codec();
+    _get_impl().deduplicate = options.deduplicate().value_or(false);
 }
 
 bucket::bucket() noexcept = default;
@@ -134,6 +175,33 @@ uploader bucket::_open_upload_stream_with_id(const client_session* session,
         chunk_size_bytes = *chunk_size;
     }
 
+    std::int32_t concurrency = 1;
+    if (auto max_in_flight = options.concurrency()) {
+        if (*max_in_flight <= 0) {
+            throw logic_error{
+                error_code::k_invalid_parameter,
+                "positive value required for options::gridfs::upload::concurrency()"};
+        }
+
+        if (*max_in_flight > 1 && !options.pool()) {
+            throw logic_error{error_code::k_invalid_parameter,
+                              "options::gridfs::upload::pool() required for concurrent uploads"};
+        }
+
+        concurrency = *max_in_flight;
+    }
+
+    if (options.pool() && session) {
+        throw logic_error{error_code::k_invalid_parameter,
+                          "options::gridfs::upload::pool() cannot be used with a client_session"};
+    }
+
+    if (options.pool() && _get_impl().deduplicate) {
+        throw logic_error{error_code::k_invalid_parameter,
+                          "options::gridfs::upload::pool() cannot be used with "
+                          "options::gridfs::bucket::deduplicate()"};
+    }
+
     create_indexes_if_nonexistent(session);
 
     return uploader{session,
@@ -142,7 +210,14 @@ uploader bucket::_open_upload_stream_with_id(const client_session* session,
                     _get_impl().files,
                     _get_impl().chunks,
                     chunk_size_bytes,
-                    std::move(options.metadata())};
+                    std::move(options.metadata()),
+                    options.pool().value_or(nullptr),
+                    _get_impl().database_name,
+                    concurrency,
+                    _get_impl().codec,
+                    options.compute_checksum().value_or(false),
+                    _get_impl().deduplicate ? stdx::make_optional(_get_impl().blobs)
+                                            : stdx::nullopt};
 }
 
 uploader bucket::open_upload_stream_with_id(bsoncxx::types::bson_value::view id,
@@ -216,10 +291,70 @@ void bucket::upload_from_stream_with_id(const client_session& session,
     return _upload_from_stream_with_id(&session, id, filename, source, options);
 }
 
+result::gridfs::upload bucket::_upload_from_file(const client_session* session,
+                                                 stdx::string_view filename,
+                                                 stdx::string_view path,
+                                                 const options::gridfs::upload& options) {
+    // The source is mapped before the upload is opened, so that a missing file leaves no trace in
+    // the bucket.
+    mapped_file source = mapped_file::open_for_read(bsoncxx::string::to_string(path));
+
+    auto id = bsoncxx::types::bson_value::view{bsoncxx::types::b_oid{}};
+    uploader upload_stream = _open_upload_stream_with_id(session, id, filename, options);
+
+    // The uploader copies the mapped pages straight into its chunks documents.
+    upload_stream.write(source.data(), source.size());
+    upload_stream.close();
+
+    return id;
+}
+
+result::gridfs::upload bucket::upload_from_file(stdx::string_view filename,
+                                                stdx::string_view path,
+                                                const options::gridfs::upload& options) {
+    return _upload_from_file(nullptr, filename, path, options);
+}
+
+result::gridfs::upload bucket::upload_from_file(const client_session& session,
+                                                stdx::string_view filename,
+                                                stdx::string_view path,
+                                                const options::gridfs::upload& options) {
+    return _upload_from_file(&session, filename, path, options);
+}
+
 downloader bucket::_open_download_stream(const client_session* session,
-                                         bsoncxx::types::bson_value::view id) {
+                                         bsoncxx::types::bson_value::view id,
+                                         std::int64_t start,
+                                         std::int64_t end,
+                                         const options::gridfs::download& options) {
     using namespace bsoncxx;
 
+    if (start < 0 || end < start) {
+        throw logic_error{error_code::k_invalid_parameter,
+                          "download range must satisfy 0 <= start <= end"};
+    }
+
+    std::size_t prefetch_chunks = 4;
+    if (auto window = options.prefetch_chunks()) {
+        if (*window <= 0) {
+            throw logic_error{
+                error_code::k_invalid_parameter,
+                "positive value required for options::gridfs::download::prefetch_chunks()"};
+        }
+
+        if (!options.pool()) {
+            throw logic_error{error_code::k_invalid_parameter,
+                              "options::gridfs::download::pool() required for prefetching"};
+        }
+
+        prefetch_chunks = static_cast<std::size_t>(*window);
+    }
+
+    if (options.pool() && session) {
+        throw logic_error{error_code::k_invalid_parameter,
+                          "options::gridfs::download::pool() cannot be used with a client_session"};
+    }
+
     builder::basic::document files_filter;
     files_filter.append(builder::basic::kvp("_id", id));
 
@@ -239,51 +374,58 @@ downloader bucket::_open_download_stream(const client_session* session,
                                "k_int32 or k_int64"};
     }
 
-    auto length = files_doc_view["length"];
-
-    if ((length.type() == type::k_int64 && !length.get_int64().value) ||
-        (length.type() == type::k_int32 && !length.get_int32().value)) {
-        return downloader{stdx::nullopt, *files_doc};
-    }
-
-    builder::basic::document chunks_filter;
-    chunks_filter.append(builder::basic::kvp("files_id", id));
-
-    builder::basic::document chunks_sort;
-    chunks_sort.append(builder::basic::kvp("n", 1));
-
-    options::find chunks_options;
-    chunks_options.sort(chunks_sort.extract());
+    return downloader{session,
+                      _get_impl().chunks,
+                      _get_impl().blobs,
+                      _get_impl().database_name,
+                      *files_doc,
+                      start,
+                      end,
+                      options.pool().value_or(nullptr),
+                      prefetch_chunks,
+                      _get_impl().codec,
+                      options.verify_checksum().value_or(false)};
+}
 
-    auto cursor = session
-                      ? _get_impl().chunks.find(*session, chunks_filter.extract(), chunks_options)
-                      : _get_impl().chunks.find(chunks_filter.extract(), chunks_options);
+downloader bucket::open_download_stream(bsoncxx::types::bson_value::view id,
+                                        const options::gridfs::download& options) {
+    return _open_download_stream(
+        nullptr, id, 0, std::numeric_limits<std::int64_t>::max(), options);
+}
 
-    return downloader{std::move(cursor), *files_doc};
+downloader bucket::open_download_stream(const client_session& session,
+                                        bsoncxx::types::bson_value::view id,
+                                        const options::gridfs::download& options) {
+    return _open_download_stream(
+        &session, id, 0, std::numeric_limits<std::int64_t>::max(), options);
 }
 
-downloader bucket::open_download_stream(bsoncxx::types::bson_value::view id) {
-    return _open_download_stream(nullptr, id);
+downloader bucket::open_download_stream(bsoncxx::types::bson_value::view id,
+                                        std::int64_t start,
+                                        std::int64_t end,
+                                        const options::gridfs::download& options) {
+    return _open_download_stream(nullptr, id, start, end, options);
 }
 
 downloader bucket::open_download_stream(const client_session& session,
-                                        bsoncxx::types::bson_value::view id) {
-    return _open_download_stream(&session, id);
+                                        bsoncxx::types::bson_value::view id,
+                                        std::int64_t start,
+                                        std::int64_t end,
+                                        const options::gridfs::download& options) {
+    return _open_download_stream(&session, id, start, end, options);
 }
 
 void bucket::_download_to_stream(const client_session* session,
                                  bsoncxx::types::bson_value::view id,
                                  std::ostream* destination) {
-    downloader download_stream = _open_download_stream(session, id);
-    std::int32_t chunk_size = download_stream.chunk_size();
-    std::unique_ptr<std::uint8_t[]> buffer =
-        stdx::make_unique<std::uint8_t[]>(static_cast<std::size_t>(chunk_size));
-    std::size_t bytes_read;
-
-    while ((bytes_read =
-                download_stream.read(buffer.get(), static_cast<std::size_t>(chunk_size))) != 0) {
-        destination->write(reinterpret_cast<char*>(buffer.get()),
-                           static_cast<std::streamsize>(bytes_read));
+    downloader download_stream =
+        _open_download_stream(session, id, 0, std::numeric_limits<std::int64_t>::max(), {});
+
+    // Each chunk is written straight out of its chunks document.
+    bsoncxx::types::b_binary data;
+    while ((data = download_stream.read_chunk()).size != 0) {
+        destination->write(reinterpret_cast<const char*>(data.bytes),
+                           static_cast<std::streamsize>(data.size));
     }
 
     download_stream.close();
@@ -299,18 +441,182 @@ void bucket::download_to_stream(const client_session& session,
     _download_to_stream(&session, id, destination);
 }
 
+void bucket::_download_to_file(const client_session* session,
+                               bsoncxx::types::bson_value::view id,
+                               stdx::string_view path,
+                               const options::gridfs::download& options) {
+    std::int32_t concurrency = 1;
+    if (auto fill_threads = options.concurrency()) {
+        if (*fill_threads <= 0) {
+            throw logic_error{
+                error_code::k_invalid_parameter,
+                "positive value required for options::gridfs::download::concurrency()"};
+        }
+
+        if (*fill_threads > 1 && !options.pool()) {
+            throw logic_error{
+                error_code::k_invalid_parameter,
+                "options::gridfs::download::pool() required for concurrent downloads"};
+        }
+
+        concurrency = *fill_threads;
+    }
+
+    // A concurrent download only needs the files document here, which an empty range reads
+    // without querying the chunks. Its checksum is verified over the whole destination instead.
+    const bool split = concurrency > 1;
+    const bool verify_checksum = split && options.verify_checksum().value_or(false);
+    downloader download_stream =
+        split ? _open_download_stream(
+                    session, id, 0, 0, options::gridfs::download{options}.verify_checksum(false))
+              : _open_download_stream(
+                    session, id, 0, std::numeric_limits<std::int64_t>::max(), options);
+
+    std::uint32_t expected_checksum = 0;
+    if (verify_checksum) {
+        auto checksum_ele = download_stream.files_document()["crc32c"];
+        if (!checksum_ele || checksum_ele.type() != bsoncxx::type::k_int64) {
+            throw logic_error{error_code::k_invalid_parameter,
+                              "options::gridfs::download::verify_checksum() requires a file "
+                              "uploaded with options::gridfs::upload::compute_checksum()"};
+        }
+        expected_checksum = static_cast<std::uint32_t>(checksum_ele.get_int64().value);
+    }
+
+    // The file is downloaded next to its destination and renamed over it only once it is
+    // complete, so a failed download leaves whatever was at the destination untouched.
+    const std::string destination_path = bsoncxx::string::to_string(path);
+    const std::string temporary_path =
+        destination_path + "." + bsoncxx::oid{}.to_string() + ".part";
+    const std::int64_t length = download_stream.file_length();
+    mapped_file destination;
+    bool created = false;
+
+    try {
+        // A failure to size or map the file is cleaned up by create() itself.
+        destination = mapped_file::create(temporary_path, static_cast<std::uint64_t>(length));
+        created = true;
+
+        if (!split) {
+            copy_chunks(&download_stream, destination.data());
+        } else {
+            const std::int64_t chunk_size = download_stream.chunk_size();
+            const std::int64_t chunk_count = (length + chunk_size - 1) / chunk_size;
+            const std::int64_t workers = std::min<std::int64_t>(concurrency, chunk_count);
+
+            pool* fill_pool = *options.pool();
+            const std::string& database_name = _get_impl().database_name;
+            const std::string chunks_name = bsoncxx::string::to_string(_get_impl().chunks.name());
+            const std::string blobs_name = bsoncxx::string::to_string(_get_impl().blobs.name());
+            const read_concern chunks_read_concern = _get_impl().chunks.read_concern();
+            const read_preference chunks_read_preference = _get_impl().chunks.read_preference();
+            const bsoncxx::document::view files_doc = download_stream.files_document();
+            const std::shared_ptr<chunk_codec>& codec = _get_impl().codec;
+
+            std::vector<std::future<void>> fills;
+            for (std::int64_t i = 0; i < workers; ++i) {
+                // Each worker fills a contiguous run of whole chunks.
+                const std::int64_t start = chunk_count * i / workers * chunk_size;
+                const std::int64_t end =
+                    std::min(chunk_count * (i + 1) / workers * chunk_size, length);
+
+                fills.push_back(std::async(std::launch::async, [&, start, end] {
+                    auto client = fill_pool->acquire();
+                    collection chunks = (*client)[database_name][chunks_name];
+                    chunks.read_concern(chunks_read_concern);
+                    chunks.read_preference(chunks_read_preference);
+                    collection blobs = (*client)[database_name][blobs_name];
+                    blobs.read_concern(chunks_read_concern);
+                    blobs.read_preference(chunks_read_preference);
+
+                    downloader range{nullptr,
+                                     std::move(chunks),
+                                     std::move(blobs),
+                                     database_name,
+                                     bsoncxx::document::value{files_doc},
+                                     start,
+                                     end,
+                                     nullptr,
+                                     0,
+                                     codec,
+                                     false};
+                    copy_chunks(&range, destination.data() + start);
+                }));
+            }
+
+            std::exception_ptr error;
+            for (auto&& fill : fills) {
+                try {
+                    fill.get();
+                } catch (...) {
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                }
+            }
+
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+
+        if (verify_checksum) {
+            const std::uint32_t checksum = crc32c(0, destination.data(), destination.size());
+            if (checksum != expected_checksum) {
+                std::ostringstream err;
+                err << "expected file to have CRC-32C " << expected_checksum
+                    << ", but its contents have CRC-32C " << checksum;
+                throw gridfs_exception{error_code::k_gridfs_file_corrupted, err.str()};
+            }
+        }
+
+        destination = mapped_file{};
+        replace_file(temporary_path, destination_path);
+    } catch (...) {
+        destination = mapped_file{};
+        if (created) {
+            std::remove(temporary_path.c_str());
+        }
+        throw;
+    }
+}
+
+void bucket::download_to_file(bsoncxx::types::bson_value::view id,
+                              stdx::string_view path,
+                              const options::gridfs::download& options) {
+    _download_to_file(nullptr, id, path, options);
+}
+
+void bucket::download_to_file(const client_session& session,
+                              bsoncxx::types::bson_value::view id,
+                              stdx::string_view path,
+                              const options::gridfs::download& options) {
+    _download_to_file(&session, id, path, options);
+}
+
 void bucket::_delete_file(const client_session* session, bsoncxx::types::bson_value::view id) {
     using namespace bsoncxx;
 
     builder::basic::document files_builder;
     files_builder.append(builder::basic::kvp("_id", id));
+    document::value files_filter = files_builder.extract();
+
+    // The manifest of a deduplicated file is returned by the delete itself, so that the references
+    // it holds on the blobs can be given back without another round trip.
+    auto delete_opts = options::find_one_and_delete{}.projection(
+        builder::basic::make_document(builder::basic::kvp("manifest", 1)));
+    auto files_doc =
+        session
+            ? _get_impl().files.find_one_and_delete(*session, files_filter.view(), delete_opts)
+            : _get_impl().files.find_one_and_delete(files_filter.view(), delete_opts);
+    if (!files_doc) {
+        throw gridfs_exception{error_code::k_gridfs_file_not_found};
+    }
 
-    auto result = session ? _get_impl().files.delete_one(*session, files_builder.extract())
-                          : _get_impl().files.delete_one(files_builder.extract());
-    if (result) {
-        if (result->deleted_count() == 0) {
-            throw gridfs_exception{error_code::k_gridfs_file_not_found};
-        }
+    auto manifest = files_doc->view()["manifest"];
+    if (manifest && manifest.type() == type::k_binary) {
+        release_blobs(
+            _get_impl().blobs, session, manifest.get_binary().bytes, manifest.get_binary().size);
     }
 
     builder::basic::document chunks_builder;
@@ -26,6 +26,7 @@
 #include <mongocxx/gridfs/uploader.hpp>
 #include <mongocxx/options/find.hpp>
 #include <mongocxx/options/gridfs/bucket.hpp>
+#include <mongocxx/options/gridfs/download.hpp>
 #include <mongocxx/options/gridfs/upload.hpp>
 #include <mongocxx/result/gridfs/upload.hpp>
 #include <mongocxx/stdx.hpp>
@@ -432,6 +433,71 @@ class MONGOCXX_API bucket {
     /// @}
     ///
 
+    ///
+    /// @{
+    ///
+    /// Creates a new GridFS file by uploading the contents of a local file. The id of the file
+    /// will be automatically generated as an ObjectId.
+    ///
+    /// The source is mapped into memory, and its pages are copied straight into the chunks
+    /// documents, without going through an intermediate buffer.
+    ///
+    /// @param filename
+    ///   The name of the file to be uploaded. A bucket can contain multiple files with the same
+    ///   name.
+    ///
+    /// @param path
+    ///   The path of the local file to upload. It must not be modified during the upload.
+    ///
+    /// @param options
+    ///   Optional arguments; see options::gridfs::upload.
+    ///
+    /// @return
+    ///   The id of the uploaded file.
+    ///
+    /// @note
+    ///   If this GridFS bucket does not already exist in the database, it will be implicitly
+    ///   created and initialized with GridFS indexes.
+    ///
+    /// @throws mongocxx::logic_error if `options` are invalid.
+    ///
+    /// @throws mongocxx::exception
+    ///   if the local file cannot be opened or mapped. The error code is in
+    ///   std::system_category().
+    ///
+    /// @throws mongocxx::bulk_write_exception
+    ///   if an error occurs when writing chunk data or file metadata to the database.
+    ///
+    /// @throws mongocxx::gridfs_exception
+    ///   if the uploader requires more than 2^31-1 chunks to store the file at the requested chunk
+    ///   size.
+    ///
+    /// @throws mongocxx::query_exception
+    ///   if an error occurs when reading from the files collection for this bucket.
+    ///
+    /// @throws mongocxx::operation_exception if an error occurs when building GridFS indexes.
+    ///
+    result::gridfs::upload upload_from_file(stdx::string_view filename,
+                                            stdx::string_view path,
+                                            const options::gridfs::upload& options = {});
+
+    ///
+    /// Creates a new GridFS file by uploading the contents of a local file. The id of the file
+    /// will be automatically generated as an ObjectId.
+    ///
+    /// @param session
+    ///   The mongocxx::client_session with which to perform the upload.
+    ///
+    /// @see upload_from_file(stdx::string_view, stdx::string_view, const options::gridfs::upload&)
+    ///
+    result::gridfs::upload upload_from_file(const client_session& session,
+                                            stdx::string_view filename,
+                                            stdx::string_view path,
+                                            const options::gridfs::upload& options = {});
+    ///
+    /// @}
+    ///
+
     ///
     /// @{
     ///
@@ -440,16 +506,22 @@ class MONGOCXX_API bucket {
     /// @param id
     ///   The id of the file to read.
     ///
+    /// @param options
+    ///   Optional arguments for this operation.
+    ///
     /// @return
     ///   The gridfs::downloader from which the GridFS file should be read.
     ///
+    /// @throws mongocxx::logic_error if `options` are invalid.
+    ///
     /// @throws mongocxx::gridfs_exception
     ///   if the requested file does not exist, or if the requested file has been corrupted.
     ///
     /// @throws mongocxx::query_exception
     ///   if an error occurs when reading from the files collection for this bucket.
     ///
-    downloader open_download_stream(bsoncxx::types::bson_value::view id);
+    downloader open_download_stream(bsoncxx::types::bson_value::view id,
+                                    const options::gridfs::download& options = {});
 
     ///
     /// Opens a gridfs::downloader to read a GridFS file.
@@ -461,9 +533,14 @@ class MONGOCXX_API bucket {
     /// @param id
     ///   The id of the file to read.
     ///
+    /// @param options
+    ///   Optional arguments for this operation. A pool cannot be used together with a session.
+    ///
     /// @return
     ///   The gridfs::downloader from which the GridFS file should be read.
     ///
+    /// @throws mongocxx::logic_error if `options` are invalid.
+    ///
     /// @throws mongocxx::gridfs_exception
     ///   if the requested file does not exist, or if the requested file has been corrupted.
     ///
@@ -471,7 +548,58 @@ class MONGOCXX_API bucket {
     ///   if an error occurs when reading from the files collection for this bucket.
     ///
     downloader open_download_stream(const client_session& session,
-                                    bsoncxx::types::bson_value::view id);
+                                    bsoncxx::types::bson_value::view id,
+                                    const options::gridfs::download& options = {});
+
+    ///
+    /// Opens a gridfs::downloader to read a byte range of a GridFS file. Only the chunks
+    /// overlapping the range are queried, and the bytes outside of it are skipped.
+    ///
+    /// @param id
+    ///   The id of the file to read.
+    ///
+    /// @param start
+    ///   The offset of the first byte to read.
+    ///
+    /// @param end
+    ///   The offset past the last byte to read. A range extending past the end of the file is
+    ///   truncated to the file's length.
+    ///
+    /// @param options
+    ///   Optional arguments for this operation.
+    ///
+    /// @return
+    ///   The gridfs::downloader from which the range should be read.
+    ///
+    /// @throws mongocxx::logic_error
+    ///   if `options` are invalid, or unless 0 <= `start` <= `end`.
+    ///
+    /// @throws mongocxx::gridfs_exception
+    ///   if the requested file does not exist, or if the requested file has been corrupted.
+    ///
+    /// @throws mongocxx::query_exception
+    ///   if an error occurs when reading from the files collection for this bucket.
+    ///
+    downloader open_download_stream(bsoncxx::types::bson_value::view id,
+                                    std::int64_t start,
+                                    std::int64_t end,
+                                    const options::gridfs::download& options = {});
+
+    ///
+    /// Opens a gridfs::downloader to read a byte range of a GridFS file.
+    ///
+    /// @param session
+    ///   The mongocxx::client_session with which to perform the download. The client session must
+    ///   remain valid for the lifetime of the downloader.
+    ///
+    /// @see open_download_stream(bsoncxx::types::bson_value::view, std::int64_t, std::int64_t,
+    ///   const options::gridfs::download&)
+    ///
+    downloader open_download_stream(const client_session& session,
+                                    bsoncxx::types::bson_value::view id,
+                                    std::int64_t start,
+                                    std::int64_t end,
+                                    const options::gridfs::download& options = {});
     ///
     /// @}
     ///
@@ -530,6 +658,62 @@ class MONGOCXX_API bucket {
     /// @}
     ///
 
+    ///
+    /// @{
+    ///
+    /// Downloads the contents of a stored GridFS file from the bucket into a local file.
+    ///
+    /// The contents are written to a new file next to the destination, created at the length of
+    /// the GridFS file and mapped into memory, and each chunk is copied straight out of its chunks
+    /// document into place. Once the download is complete, the new file is renamed over the
+    /// destination. When options::gridfs::download::concurrency() is greater than 1, the file is
+    /// split into that many runs of chunks, which are read concurrently on clients acquired from
+    /// the pool.
+    ///
+    /// @param id
+    ///   The id of the file to read.
+    ///
+    /// @param path
+    ///   The path of the local file to write. If the download fails, any file already at this
+    ///   path is left unchanged.
+    ///
+    /// @param options
+    ///   Optional arguments for this operation.
+    ///
+    /// @throws mongocxx::logic_error if `options` are invalid.
+    ///
+    /// @throws mongocxx::exception
+    ///   if the local file cannot be created or mapped. The error code is in
+    ///   std::system_category().
+    ///
+    /// @throws mongocxx::gridfs_exception
+    ///   if the requested file does not exist, or if the requested file has been corrupted.
+    ///
+    /// @throws mongocxx::query_exception
+    ///   if an error occurs when reading from the files or chunks collections for this bucket.
+    ///
+    void download_to_file(bsoncxx::types::bson_value::view id,
+                          stdx::string_view path,
+                          const options::gridfs::download& options = {});
+
+    ///
+    /// Downloads the contents of a stored GridFS file from the bucket into a local file.
+    ///
+    /// @param session
+    ///   The mongocxx::client_session with which to perform the download. A session cannot be
+    ///   combined with a pool, so the download is not split.
+    ///
+    /// @see download_to_file(bsoncxx::types::bson_value::view, stdx::string_view,
+    ///   const options::gridfs::download&)
+    ///
+    void download_to_file(const client_session& session,
+                          bsoncxx::types::bson_value::view id,
+                          stdx::string_view path,
+                          const options::gridfs::download& options = {});
+    ///
+    /// @}
+    ///
+
     ///
     /// @{
     ///
@@ -642,13 +826,27 @@ class MONGOCXX_API bucket {
                                                       std::istream* source,
                                                       const options::gridfs::upload& options);
 
+    MONGOCXX_PRIVATE result::gridfs::upload _upload_from_file(
+        const client_session* session,
+        stdx::string_view filename,
+        stdx::string_view path,
+        const options::gridfs::upload& options);
+
     MONGOCXX_PRIVATE downloader _open_download_stream(const client_session* session,
-                                                      bsoncxx::types::bson_value::view id);
+                                                      bsoncxx::types::bson_value::view id,
+                                                      std::int64_t start,
+                                                      std::int64_t end,
+                                                      const options::gridfs::download& options);
 
     MONGOCXX_PRIVATE void _download_to_stream(const client_session* session,
                                               bsoncxx::types::bson_value::view id,
                                               std::ostream* destination);
 
+    MONGOCXX_PRIVATE void _download_to_file(const client_session* session,
+                                            bsoncxx::types::bson_value::view id,
+                                            stdx::string_view path,
+                                            const options::gridfs::download& options);
+
     MONGOCXX_PRIVATE void _delete_file(const client_session* session,
                                        bsoncxx::types::bson_value::view id);
 
@@ -0,0 +1,130 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <bsoncxx/stdx/string_view.hpp>
+#include <mongocxx/stdx.hpp>
+
+#include <mongocxx/config/prelude.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace gridfs {
+
+///
+/// The interface that codecs used to compress GridFS chunks must implement.
+///
+/// A codec is set on a bucket through options::gridfs::bucket::chunk_codec(). Each chunk of a file
+/// uploaded through that bucket is compressed on its own, and the codec's name is recorded in the
+/// "chunkCodec" field of the files document. Downloads through a bucket configured with a codec of
+/// the same name decompress each chunk transparently. The "length" and "chunkSize" fields still
+/// describe the uncompressed file, so byte ranges and seeking work unchanged.
+///
+/// Compressed files can only be read through a bucket configured with their codec. Other GridFS
+/// implementations will return the compressed bytes.
+///
+/// The driver ships one implementation, gridfs::zlib_chunk_codec, which is built when the CMake
+/// option MONGOCXX_ENABLE_ZLIB_CHUNK_CODEC is enabled. Other algorithms, such as zstd or lz4, can
+/// be plugged in by implementing this interface over a library the application already links.
+///
+/// Concurrent uploads and downloads call a codec from several threads at once, so every member
+/// function must be safe to call concurrently. An uploader compresses each chunk on the calling
+/// thread as the chunk is finished.
+///
+class MONGOCXX_API chunk_codec {
+   public:
+    virtual ~chunk_codec();
+
+    ///
+    /// Gets the name recorded in the files document of each file compressed with this codec, such
+    /// as "zstd".
+    ///
+    /// @return
+    ///   The name of the codec.
+    ///
+    virtual stdx::string_view name() const = 0;
+
+    ///
+    /// Gets the largest number of bytes that compress() may produce for an input of the given
+    /// length.
+    ///
+    /// @param length
+    ///   The length of the uncompressed input.
+    ///
+    /// @return
+    ///   The size of the buffer to pass to compress().
+    ///
+    virtual std::size_t max_compressed_size(std::size_t length) const = 0;
+
+    ///
+    /// Compresses one chunk.
+    ///
+    /// @param data
+    ///   The bytes to compress.
+    ///
+    /// @param length
+    ///   The number of bytes to compress.
+    ///
+    /// @param out
+    ///   A buffer of max_compressed_size(length) bytes that receives the compressed bytes.
+    ///
+    /// @return
+    ///   The number of bytes written to `out`.
+    ///
+    virtual std::size_t compress(const std::uint8_t* data,
+                                 std::size_t length,
+                                 std::uint8_t* out) const = 0;
+
+    ///
+    /// Decompresses one chunk.
+    ///
+    /// @param data
+    ///   The compressed bytes.
+    ///
+    /// @param length
+    ///   The number of compressed bytes.
+    ///
+    /// @param out
+    ///   The buffer that receives the decompressed bytes.
+    ///
+    /// @param capacity
+    ///   The size of `out`, which is the chunk size of the file.
+    ///
+    /// @return
+    ///   The number of bytes written to `out`.
+    ///
+    /// @throws mongocxx::gridfs_exception
+    ///   (or any other exception) if `data` cannot be decompressed into `capacity` bytes.
+    ///
+    virtual std::size_t decompress(const std::uint8_t* data,
+                                   std::size_t length,
+                                   std::uint8_t* out,
+                                   std::size_t capacity) const = 0;
+
+   protected:
+    ///
+    /// Default constructor
+    ///
+    chunk_codec();
+};
+
+}  // namespace gridfs
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/postlude.hpp>
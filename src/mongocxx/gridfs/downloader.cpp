@@ -17,12 +17,19 @@
 #include <algorithm>
 #include <cstring>
 #include <sstream>
+#include <unordered_set>
 
+#include <bsoncxx/builder/basic/array.hpp>
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
 #include <bsoncxx/stdx/make_unique.hpp>
+#include <bsoncxx/string/to_string.hpp>
 #include <bsoncxx/types.hpp>
 #include <mongocxx/exception/error_code.hpp>
 #include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/gridfs/private/crc32c.hh>
 #include <mongocxx/gridfs/private/downloader.hh>
+#include <mongocxx/options/find.hpp>
 
 #include <mongocxx/config/private/prelude.hh>
 
@@ -30,8 +37,36 @@ namespace mongocxx {
 MONGOCXX_INLINE_NAMESPACE_BEGIN
 namespace gridfs {
 
-downloader::downloader(stdx::optional<cursor> chunks, bsoncxx::document::value files_doc)
-    : _impl{stdx::make_unique<impl>(std::move(chunks), std::move(files_doc))} {}
+namespace {
+// The chunks of a deduplicated file are fetched in batches of up to this many chunks or bytes.
+constexpr std::int32_t k_blob_batch_chunks = 64;
+constexpr std::int64_t k_blob_batch_bytes = 8 * 1024 * 1024;
+}  // namespace
+
+downloader::downloader(const client_session* session,
+                       collection chunks,
+                       collection blobs,
+                       stdx::string_view database_name,
+                       bsoncxx::document::value files_doc,
+                       std::int64_t start,
+                       std::int64_t end,
+                       class pool* pool,
+                       std::size_t prefetch_chunks,
+                       std::shared_ptr<chunk_codec> codec,
+                       bool verify_checksum)
+    : _impl{stdx::make_unique<impl>(session,
+                                    std::move(chunks),
+                                    std::move(blobs),
+                                    database_name,
+                                    std::move(files_doc),
+                                    start,
+                                    end,
+                                    pool,
+                                    prefetch_chunks,
+                                    std::move(codec),
+                                    verify_checksum)} {
+    open_chunks();
+}
 
 downloader::downloader() noexcept = default;
 downloader::downloader(downloader&&) noexcept = default;
@@ -47,15 +82,9 @@ std::size_t downloader::read(std::uint8_t* buffer, std::size_t length_requested)
         throw logic_error{error_code::k_gridfs_stream_not_open};
     }
 
-    if (_get_impl().file_len == 0) {
-        return 0;
-    }
-
     std::size_t bytes_read = 0;
 
-    while (length_requested > 0 &&
-           (_get_impl().chunks_seen != _get_impl().file_chunk_count ||
-            _get_impl().chunk_buffer_offset < _get_impl().chunk_buffer_len)) {
+    while (length_requested > 0 && _get_impl().position < _get_impl().range_end) {
         if (_get_impl().chunk_buffer_offset == _get_impl().chunk_buffer_len) {
             fetch_chunk();
         }
@@ -65,6 +94,7 @@ std::size_t downloader::read(std::uint8_t* buffer, std::size_t length_requested)
         std::memcpy(buffer, &_get_impl().chunk_buffer_ptr[_get_impl().chunk_buffer_offset], length);
         buffer = &buffer[length];
         _get_impl().chunk_buffer_offset += length;
+        _get_impl().position += static_cast<std::int64_t>(length);
         bytes_read += length;
         length_requested -= length;
     }
@@ -72,13 +102,87 @@ std::size_t downloader::read(std::uint8_t* buffer, std::size_t length_requested)
     return bytes_read;
 }
 
+bsoncxx::types::b_binary downloader::read_chunk() {
+    if (_get_impl().closed) {
+        throw logic_error{error_code::k_gridfs_stream_not_open};
+    }
+
+    if (_get_impl().position == _get_impl().range_end) {
+        return bsoncxx::types::b_binary{bsoncxx::binary_sub_type::k_binary, 0, nullptr};
+    }
+
+    if (_get_impl().chunk_buffer_offset == _get_impl().chunk_buffer_len) {
+        fetch_chunk();
+    }
+
+    std::size_t length = _get_impl().chunk_buffer_len - _get_impl().chunk_buffer_offset;
+    bsoncxx::types::b_binary data{bsoncxx::binary_sub_type::k_binary,
+                                  static_cast<std::uint32_t>(length),
+                                  &_get_impl().chunk_buffer_ptr[_get_impl().chunk_buffer_offset]};
+    _get_impl().chunk_buffer_offset = _get_impl().chunk_buffer_len;
+    _get_impl().position += static_cast<std::int64_t>(length);
+
+    return data;
+}
+
+void downloader::seek(std::int64_t offset) {
+    if (_get_impl().closed) {
+        throw logic_error{error_code::k_gridfs_stream_not_open};
+    }
+
+    if (offset < _get_impl().range_start || offset > _get_impl().range_end) {
+        std::ostringstream err;
+        err << "cannot seek to offset " << offset << " outside of the downloaded range ["
+            << _get_impl().range_start << ", " << _get_impl().range_end << "]";
+        throw logic_error{error_code::k_invalid_parameter, err.str()};
+    }
+
+    // The current chunk, if any, is the one before `next_chunk_n`.
+    if (_get_impl().chunk_buffer_len > 0) {
+        std::int64_t chunk_start = _get_impl().chunk_offset(_get_impl().next_chunk_n - 1);
+        std::int64_t chunk_end =
+            chunk_start + static_cast<std::int64_t>(_get_impl().chunk_buffer_len);
+
+        if (offset >= chunk_start && offset < chunk_end) {
+            _get_impl().chunk_buffer_offset = static_cast<std::size_t>(offset - chunk_start);
+            _get_impl().position = offset;
+            return;
+        }
+    }
+
+    _get_impl().position = offset;
+    open_chunks();
+}
+
 void downloader::close() {
     if (_get_impl().closed) {
         throw logic_error{error_code::k_gridfs_stream_not_open};
     }
 
-    _get_impl().chunks = {};
+    _get_impl().prefetcher.reset();
+    _get_impl().prefetched_chunk = stdx::nullopt;
+    _get_impl().chunks_curr = stdx::nullopt;
+    _get_impl().chunks_end = stdx::nullopt;
+    _get_impl().chunks = stdx::nullopt;
     _get_impl().closed = true;
+
+    if (!_get_impl().verify_checksum ||
+        _get_impl().checksum_chunks != _get_impl().file_chunk_count) {
+        return;
+    }
+
+    if (_get_impl().checksum != _get_impl().expected_checksum) {
+        std::ostringstream err;
+        err << "expected file to have CRC-32C " << _get_impl().expected_checksum
+            << ", but its contents have CRC-32C " << _get_impl().checksum;
+        throw gridfs_exception{error_code::k_gridfs_file_corrupted, err.str()};
+    }
+
+    _get_impl().checksum_verified = true;
+}
+
+bool downloader::checksum_verified() const {
+    return _get_impl().checksum_verified;
 }
 
 std::int32_t downloader::chunk_size() const {
@@ -93,74 +197,237 @@ bsoncxx::document::view downloader::files_document() const {
     return _get_impl().files_doc.view();
 }
 
+void downloader::open_chunks() {
+    using bsoncxx::builder::basic::kvp;
+    using bsoncxx::builder::basic::make_document;
+
+    _get_impl().prefetcher.reset();
+    _get_impl().prefetched_chunk = stdx::nullopt;
+    _get_impl().chunks_curr = stdx::nullopt;
+    _get_impl().chunks_end = stdx::nullopt;
+    _get_impl().chunks = stdx::nullopt;
+    _get_impl().chunks_started = false;
+    _get_impl().chunk_buffer_ptr = nullptr;
+    _get_impl().chunk_buffer_len = 0;
+    _get_impl().chunk_buffer_offset = 0;
+
+    if (_get_impl().position == _get_impl().range_end) {
+        return;
+    }
+
+    _get_impl().next_chunk_n = _get_impl().chunk_index(_get_impl().position);
+
+    // The chunks of a deduplicated file are looked up by digest as they are needed.
+    if (_get_impl().deduplicated()) {
+        _get_impl().blob_batch.clear();
+        _get_impl().blob_batch_end = _get_impl().next_chunk_n;
+        return;
+    }
+
+    bsoncxx::builder::basic::document chunks_filter;
+    chunks_filter.append(kvp("files_id", _get_impl().files_doc.view()["_id"].get_value()));
+
+    // Only restrict n when part of the file is skipped, so that whole-file downloads issue the
+    // same query as always.
+    if (_get_impl().next_chunk_n > 0 || _get_impl().end_chunk_n < _get_impl().file_chunk_count) {
+        chunks_filter.append(kvp("n",
+                                 make_document(kvp("$gte", _get_impl().next_chunk_n),
+                                               kvp("$lt", _get_impl().end_chunk_n))));
+    }
+
+    options::find chunks_options;
+    chunks_options.sort(make_document(kvp("n", 1)));
+
+    if (_get_impl().pool) {
+        _get_impl().prefetcher = stdx::make_unique<chunk_prefetcher>(
+            _get_impl().pool,
+            _get_impl().database_name,
+            bsoncxx::string::to_string(_get_impl().chunks_collection.name()),
+            _get_impl().chunks_collection.read_concern(),
+            _get_impl().chunks_collection.read_preference(),
+            chunks_filter.extract(),
+            std::move(chunks_options),
+            _get_impl().prefetch_chunks);
+        return;
+    }
+
+    _get_impl().chunks =
+        _get_impl().session
+            ? _get_impl().chunks_collection.find(
+                  *_get_impl().session, chunks_filter.extract(), chunks_options)
+            : _get_impl().chunks_collection.find(chunks_filter.extract(), chunks_options);
+    _get_impl().chunks_curr = _get_impl().chunks->begin();
+    _get_impl().chunks_end = _get_impl().chunks->end();
+}
+
 void downloader::fetch_chunk() {
-    if (_get_impl().chunks_curr == _get_impl().chunks_end) {
+    auto throw_missing_chunks = [this]() {
         std::ostringstream err;
         err << "expected file to have " << _get_impl().file_chunk_count
-            << " chunk(s), but query to chunks collection only returned " << _get_impl().chunks_seen
-            << " chunk(s)";
+            << " chunk(s), but query to chunks collection did not return chunk #"
+            << _get_impl().next_chunk_n;
         throw gridfs_exception{error_code::k_gridfs_file_corrupted, err.str()};
-    }
+    };
 
-    if (_get_impl().chunks_seen) {
-        ++(*_get_impl().chunks_curr);
-    }
+    bsoncxx::document::view chunk_doc;
+
+    if (_get_impl().deduplicated()) {
+        if (_get_impl().next_chunk_n >= _get_impl().blob_batch_end) {
+            fetch_blobs();
+        }
+
+        auto blob = _get_impl().blob_batch.find(_get_impl().chunk_digest(_get_impl().next_chunk_n));
+        if (blob == _get_impl().blob_batch.end()) {
+            std::ostringstream err;
+            err << "chunk #" << _get_impl().next_chunk_n
+                << ": expected to find chunk in the blobs collection";
+            throw gridfs_exception{error_code::k_gridfs_file_corrupted, err.str()};
+        }
 
-    bsoncxx::document::view chunk_doc = **_get_impl().chunks_curr;
+        chunk_doc = blob->second.view();
+    } else if (_get_impl().prefetcher) {
+        _get_impl().prefetched_chunk = _get_impl().prefetcher->next();
+        if (!_get_impl().prefetched_chunk) {
+            throw_missing_chunks();
+        }
 
+        chunk_doc = _get_impl().prefetched_chunk->view();
+    } else {
+        if (_get_impl().chunks_started) {
+            ++(*_get_impl().chunks_curr);
+        }
+
+        if (*_get_impl().chunks_curr == *_get_impl().chunks_end) {
+            throw_missing_chunks();
+        }
+
+        _get_impl().chunks_started = true;
+        chunk_doc = **_get_impl().chunks_curr;
+    }
+
+    // Blobs are shared between files, so they carry no n.
     auto chunk_n_ele = chunk_doc["n"];
-    if (!chunk_n_ele || chunk_n_ele.type() != bsoncxx::type::k_int32 ||
-        chunk_n_ele.get_int32().value != _get_impl().chunks_seen) {
+    if (!_get_impl().deduplicated() &&
+        (!chunk_n_ele || chunk_n_ele.type() != bsoncxx::type::k_int32 ||
+         chunk_n_ele.get_int32().value != _get_impl().next_chunk_n)) {
         std::ostringstream err;
-        err << "chunk #" << _get_impl().chunks_seen
+        err << "chunk #" << _get_impl().next_chunk_n
             << ": expected to find field \"n\" with k_int32 type";
         throw gridfs_exception{error_code::k_gridfs_file_corrupted, err.str()};
     }
 
-    if (_get_impl().chunks_seen == std::numeric_limits<std::int32_t>::max()) {
+    if (_get_impl().next_chunk_n == std::numeric_limits<std::int32_t>::max()) {
         throw gridfs_exception{error_code::k_gridfs_file_corrupted, "file has too many chunks"};
     }
 
     auto chunk_data_ele = chunk_doc["data"];
     if (!chunk_data_ele || chunk_data_ele.type() != bsoncxx::type::k_binary) {
         std::ostringstream err;
-        err << "chunk #" << _get_impl().chunks_seen
+        err << "chunk #" << _get_impl().next_chunk_n
             << ": expected to find field \"data\" with k_binary type";
         throw gridfs_exception{error_code::k_gridfs_file_corrupted, err.str()};
     }
 
     auto binary_data = chunk_data_ele.get_binary();
 
-    if (_get_impl().chunks_seen != _get_impl().file_chunk_count - 1) {
-        if (binary_data.size != static_cast<std::uint32_t>(_get_impl().chunk_size)) {
-            std::ostringstream err;
-            err << "chunk #" << _get_impl().chunks_seen << ": expected size of chunk to be "
-                << _get_impl().chunk_size << " bytes, but actual size of chunk is "
-                << binary_data.size << " bytes";
-            throw gridfs_exception{error_code::k_gridfs_file_corrupted, err.str()};
-        }
-    } else {
-        auto expected_size =
-            _get_impl().file_len % static_cast<std::int64_t>(_get_impl().chunk_size);
+    std::int64_t expected_size = static_cast<std::int64_t>(_get_impl().chunk_size);
+    if (_get_impl().deduplicated()) {
+        expected_size = _get_impl().chunk_offset(_get_impl().next_chunk_n + 1) -
+                        _get_impl().chunk_offset(_get_impl().next_chunk_n);
+    } else if (_get_impl().next_chunk_n == _get_impl().file_chunk_count - 1) {
+        expected_size = _get_impl().file_len % static_cast<std::int64_t>(_get_impl().chunk_size);
 
         if (expected_size == 0) {
             expected_size = static_cast<std::int64_t>(_get_impl().chunk_size);
         }
+    }
 
-        if (binary_data.size != static_cast<std::uint32_t>(expected_size)) {
-            std::ostringstream err;
-            err << "chunk #" << _get_impl().chunks_seen << ": expected size of chunk to be "
-                << expected_size << " bytes, but actual size of chunk is " << binary_data.size
-                << " bytes";
-            throw gridfs_exception{error_code::k_gridfs_file_corrupted, err.str()};
+    // A compressed chunk may have any stored size; it is its decompressed size that must match.
+    if (auto& codec = _get_impl().codec) {
+        if (!_get_impl().decompressed) {
+            _get_impl().decompressed =
+                stdx::make_unique<std::uint8_t[]>(_get_impl().max_chunk_len);
         }
+
+        binary_data.size =
+            static_cast<std::uint32_t>(codec->decompress(binary_data.bytes,
+                                                         binary_data.size,
+                                                         _get_impl().decompressed.get(),
+                                                         _get_impl().max_chunk_len));
+        binary_data.bytes = _get_impl().decompressed.get();
+    }
+
+    if (binary_data.size != static_cast<std::uint32_t>(expected_size)) {
+        std::ostringstream err;
+        err << "chunk #" << _get_impl().next_chunk_n << ": expected size of chunk to be "
+            << expected_size << " bytes, but actual size of chunk is " << binary_data.size
+            << " bytes";
+        throw gridfs_exception{error_code::k_gridfs_file_corrupted, err.str()};
+    }
+
+    // Chunks are added to the checksum only the first time they are read in order, so that a
+    // backwards seek does not count them twice.
+    if (_get_impl().verify_checksum && _get_impl().next_chunk_n == _get_impl().checksum_chunks) {
+        _get_impl().checksum = crc32c(_get_impl().checksum, binary_data.bytes, binary_data.size);
+        ++_get_impl().checksum_chunks;
     }
 
-    ++_get_impl().chunks_seen;
+    // Trim the chunk to the requested range: a read may start partway into the first chunk and
+    // end partway into the last.
+    std::int64_t chunk_start = _get_impl().chunk_offset(_get_impl().next_chunk_n);
+    std::int64_t chunk_end = std::min(chunk_start + static_cast<std::int64_t>(binary_data.size),
+                                      _get_impl().range_end);
+
+    ++_get_impl().next_chunk_n;
 
     _get_impl().chunk_buffer_ptr = binary_data.bytes;
-    _get_impl().chunk_buffer_len = binary_data.size;
-    _get_impl().chunk_buffer_offset = 0;
+    _get_impl().chunk_buffer_len = static_cast<std::size_t>(chunk_end - chunk_start);
+    _get_impl().chunk_buffer_offset = static_cast<std::size_t>(_get_impl().position - chunk_start);
+}
+
+void downloader::fetch_blobs() {
+    using bsoncxx::builder::basic::kvp;
+    using bsoncxx::builder::basic::make_document;
+
+    auto& impl = _get_impl();
+
+    // The batch holds the chunks from the next one onwards, each distinct digest requested once.
+    bsoncxx::builder::basic::array digests;
+    std::unordered_set<std::string> requested;
+    std::int32_t batch_end = impl.next_chunk_n;
+    std::int64_t batch_bytes = 0;
+
+    while (batch_end < impl.end_chunk_n && batch_end - impl.next_chunk_n < k_blob_batch_chunks &&
+           batch_bytes < k_blob_batch_bytes) {
+        std::string digest = impl.chunk_digest(batch_end);
+        if (requested.insert(digest).second) {
+            digests.append(bsoncxx::types::b_binary{
+                bsoncxx::binary_sub_type::k_binary,
+                static_cast<std::uint32_t>(digest.size()),
+                reinterpret_cast<const std::uint8_t*>(digest.data())});
+        }
+
+        batch_bytes += impl.chunk_offset(batch_end + 1) - impl.chunk_offset(batch_end);
+        ++batch_end;
+    }
+
+    auto filter = make_document(kvp("_id", make_document(kvp("$in", digests.extract()))));
+    auto blobs = impl.session ? impl.blobs_collection.find(*impl.session, filter.view())
+                              : impl.blobs_collection.find(filter.view());
+
+    impl.blob_batch.clear();
+    for (auto&& blob : blobs) {
+        auto id_ele = blob["_id"];
+        if (id_ele.type() != bsoncxx::type::k_binary) {
+            continue;
+        }
+
+        auto id = id_ele.get_binary();
+        impl.blob_batch.emplace(std::string{reinterpret_cast<const char*>(id.bytes), id.size},
+                                bsoncxx::document::value{blob});
+    }
+
+    impl.blob_batch_end = batch_end;
 }
 
 const downloader::impl& downloader::_get_impl() const {
@@ -21,16 +21,24 @@
 #include <bsoncxx/document/value.hpp>
 #include <bsoncxx/document/view.hpp>
 #include <bsoncxx/stdx/optional.hpp>
+#include <bsoncxx/stdx/string_view.hpp>
+#include <bsoncxx/types.hpp>
 #include <bsoncxx/types/bson_value/view.hpp>
-#include <mongocxx/cursor.hpp>
+#include <mongocxx/client_session.hpp>
+#include <mongocxx/collection.hpp>
 #include <mongocxx/stdx.hpp>
 
 #include <mongocxx/config/prelude.hpp>
 
 namespace mongocxx {
 MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+class pool;
+
 namespace gridfs {
 
+class chunk_codec;
+
 ///
 /// Class used to download a GridFS file.
 ///
@@ -90,6 +98,46 @@ class MONGOCXX_API downloader {
     ///
     std::size_t read(std::uint8_t* buffer, std::size_t length);
 
+    ///
+    /// Returns the unread bytes of the current chunk without copying them, first fetching the next
+    /// chunk if the current one has been fully read. The bytes count as read.
+    ///
+    /// This lets large files be streamed elsewhere, such as to a socket, straight out of the
+    /// chunks documents. It may be mixed freely with read().
+    ///
+    /// @return
+    ///   A view of the unread bytes of the chunk, decompressed if the file was compressed with a
+    ///   gridfs::chunk_codec. It remains valid until the next call to read(), read_chunk() or
+    ///   close(). Its size is zero once the end of the file has been reached.
+    ///
+    /// @throws mongocxx::logic_error if the download stream was already closed.
+    ///
+    /// @throws mongocxx::gridfs_exception if the requested file has been corrupted.
+    ///
+    /// @throws mongocxx::query_exception
+    ///   if an error occurs when reading chunk data from the database for the requested file.
+    ///
+    bsoncxx::types::b_binary read_chunk();
+
+    ///
+    /// Moves the position from which the next read starts.
+    ///
+    /// Seeking within the chunk currently being read only moves the position. Otherwise the chunks
+    /// query is reissued starting at the chunk containing `offset`, so that no chunk before it is
+    /// transferred.
+    ///
+    /// @param offset
+    ///   The new position, as an offset from the beginning of the file. It must lie within the
+    ///   range that the downloader was opened for; the end of that range is allowed.
+    ///
+    /// @throws mongocxx::logic_error
+    ///   if the download stream was already closed or if `offset` is outside of the range.
+    ///
+    /// @throws mongocxx::query_exception
+    ///   if an error occurs when reading chunk data from the database for the requested file.
+    ///
+    void seek(std::int64_t offset);
+
     ///
     /// Closes the downloader stream.
     ///
@@ -97,6 +145,19 @@ class MONGOCXX_API downloader {
     ///
     void close();
 
+    ///
+    /// Gets whether close() checked the contents of the file against its stored checksum and found
+    /// them intact.
+    ///
+    /// The checksum is only checked when options::gridfs::download::verify_checksum() was set and
+    /// every chunk of the file was read in order. A download closed early or one that never read
+    /// the chunks skipped by seek() is not checked, and this returns false.
+    ///
+    /// @return
+    ///   Whether the contents were verified.
+    ///
+    bool checksum_verified() const;
+
     ///
     /// Gets the chunk size of the file being downloaded.
     ///
@@ -127,16 +188,55 @@ class MONGOCXX_API downloader {
     //
     // Constructs a new downloader stream.
     //
+    // @param session
+    //   The client session to read the chunks with, or nullptr.
+    //
     // @param chunks
-    //   The cursor to read the chunks of the file from. It must have a value if the length of the
-    //   file is non-zero.
+    //   The chunks collection of the bucket holding the file.
+    //
+    // @param blobs
+    //   The collection of the bucket holding deduplicated chunks, which are read instead of
+    //   `chunks` when `files_doc` has a manifest.
+    //
+    // @param database_name
+    //   The name of the database holding the bucket, used to reach it through `pool`.
     //
     // @param files_doc
     //   The files collection document of the file being downloaded.
     //
-    MONGOCXX_PRIVATE downloader(stdx::optional<cursor> chunks, bsoncxx::document::value files_doc);
-
+    // @param start
+    //   The offset of the first byte to read.
+    //
+    // @param end
+    //   The offset past the last byte to read. It is truncated to the length of the file.
+    //
+    // @param pool
+    //   The pool to read chunks ahead through, or nullptr to read them with `chunks`.
+    //
+    // @param prefetch_chunks
+    //   The number of chunks to read ahead through `pool`.
+    //
+    // @param codec
+    //   The codec of the bucket, which must match the codec recorded in `files_doc`, if any.
+    //
+    // @param verify_checksum
+    //   Whether close() checks the contents against the checksum recorded in `files_doc`.
+    //
+    MONGOCXX_PRIVATE downloader(const client_session* session,
+                                collection chunks,
+                                collection blobs,
+                                stdx::string_view database_name,
+                                bsoncxx::document::value files_doc,
+                                std::int64_t start,
+                                std::int64_t end,
+                                pool* pool,
+                                std::size_t prefetch_chunks,
+                                std::shared_ptr<chunk_codec> codec,
+                                bool verify_checksum);
+
+    MONGOCXX_PRIVATE void open_chunks();
     MONGOCXX_PRIVATE void fetch_chunk();
+    MONGOCXX_PRIVATE void fetch_blobs();
 
     class MONGOCXX_PRIVATE impl;
 
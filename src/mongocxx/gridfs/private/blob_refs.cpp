@@ -0,0 +1,97 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <mongocxx/gridfs/private/blob_refs.hh>
+
+#include <iterator>
+
+#include <bsoncxx/builder/basic/array.hpp>
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
+#include <bsoncxx/types.hpp>
+#include <mongocxx/bulk_write.hpp>
+#include <mongocxx/model/update_one.hpp>
+#include <mongocxx/options/bulk_write.hpp>
+
+#include <mongocxx/config/private/prelude.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace gridfs {
+
+namespace {
+// Blobs are released this many at a time, so that the $in filter of each delete stays well below
+// the maximum command size.
+constexpr std::size_t k_release_batch = 10000;
+}  // namespace
+
+std::map<std::string, std::int64_t> count_blob_refs(const std::uint8_t* manifest,
+                                                    std::size_t length) {
+    std::map<std::string, std::int64_t> refs;
+
+    for (std::size_t off = 0; off + k_manifest_entry_size <= length;
+         off += k_manifest_entry_size) {
+        ++refs[std::string{reinterpret_cast<const char*>(&manifest[off]), k_manifest_digest_size}];
+    }
+
+    return refs;
+}
+
+void release_blobs(collection& blobs,
+                   const client_session* session,
+                   const std::uint8_t* manifest,
+                   std::size_t length) {
+    using bsoncxx::builder::basic::kvp;
+    using bsoncxx::builder::basic::make_document;
+
+    const auto refs = count_blob_refs(manifest, length);
+
+    const auto bulk_opts = options::bulk_write{}.ordered(false);
+
+    for (auto it = refs.begin(); it != refs.end();) {
+        auto bulk = session ? blobs.create_bulk_write(*session, bulk_opts)
+                            : blobs.create_bulk_write(bulk_opts);
+        bsoncxx::builder::basic::array digests;
+
+        for (std::size_t i = 0; i < k_release_batch && it != refs.end(); ++i, ++it) {
+            const bsoncxx::types::b_binary digest{
+                bsoncxx::binary_sub_type::k_binary,
+                static_cast<std::uint32_t>(it->first.size()),
+                reinterpret_cast<const std::uint8_t*>(it->first.data())};
+
+            bulk.append(model::update_one{
+                make_document(kvp("_id", digest)),
+                make_document(kvp("$inc", make_document(kvp("refs", -it->second))))});
+            digests.append(digest);
+        }
+
+        bulk.execute();
+
+        // A blob that another upload references again in the meantime has a positive count and
+        // is kept.
+        auto unreferenced =
+            make_document(kvp("_id", make_document(kvp("$in", digests.extract()))),
+                          kvp("refs", make_document(kvp("$lte", 0))));
+        if (session) {
+            blobs.delete_many(*session, unreferenced.view());
+        } else {
+            blobs.delete_many(unreferenced.view());
+        }
+    }
+}
+
+}  // namespace gridfs
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
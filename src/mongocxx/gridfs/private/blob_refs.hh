@@ -0,0 +1,54 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include <mongocxx/client_session.hpp>
+#include <mongocxx/collection.hpp>
+
+#include <mongocxx/config/private/prelude.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace gridfs {
+
+// Deduplicated chunks ("blobs") are shared by every file whose manifest lists them. A blob counts
+// in its "refs" field the manifest entries that refer to it, and is removed once no entry does.
+
+// Each manifest entry is a SHA-256 digest followed by a little-endian 32-bit length.
+constexpr std::size_t k_manifest_digest_size = 32;
+constexpr std::size_t k_manifest_entry_size = k_manifest_digest_size + 4;
+
+// Returns how many of the entries in `length` bytes of manifest refer to each digest.
+std::map<std::string, std::int64_t> count_blob_refs(const std::uint8_t* manifest,
+                                                    std::size_t length);
+
+// Drops the references held by `length` bytes of manifest and removes the blobs that are left
+// unreferenced.
+void release_blobs(collection& blobs,
+                   const client_session* session,
+                   const std::uint8_t* manifest,
+                   std::size_t length);
+
+}  // namespace gridfs
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/private/postlude.hh>
@@ -15,10 +15,12 @@
 #pragma once
 
 #include <cstddef>
+#include <memory>
 #include <string>
 
 #include <mongocxx/collection.hpp>
 #include <mongocxx/gridfs/bucket.hpp>
+#include <mongocxx/gridfs/chunk_codec.hpp>
 
 #include <mongocxx/config/private/prelude.hh>
 
@@ -28,15 +30,23 @@ namespace gridfs {
 
 class bucket::impl {
    public:
-    impl(std::string bucket_name,
+    impl(std::string database_name,
+         std::string bucket_name,
          std::int32_t default_chunk_size_bytes,
          collection chunks,
-         collection files)
-        : bucket_name{std::move(bucket_name)},
+         collection files,
+         collection blobs)
+        : database_name{std::move(database_name)},
+          bucket_name{std::move(bucket_name)},
           default_chunk_size_bytes{default_chunk_size_bytes},
           chunks{std::move(chunks)},
           files{std::move(files)},
-          indexes_created{false} {}
+          blobs{std::move(blobs)},
+          indexes_created{false},
+          deduplicate{false} {}
+
+    // The name of the database holding the bucket.
+    std::string database_name;
 
     // The name of the bucket.
     std::string bucket_name;
@@ -50,8 +60,17 @@ class bucket::impl {
     // The collection holding the files.
     collection files;
 
+    // The collection holding the chunks of deduplicated files, keyed by digest.
+    collection blobs;
+
     // Whether the required indexes have been created.
     bool indexes_created;
+
+    // The codec with which chunks are compressed, or null to store them uncompressed.
+    std::shared_ptr<chunk_codec> codec;
+
+    // Whether uploaded files are deduplicated.
+    bool deduplicate;
 };
 
 }  // namespace gridfs
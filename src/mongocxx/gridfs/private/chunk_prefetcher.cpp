@@ -0,0 +1,133 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <mongocxx/gridfs/private/chunk_prefetcher.hh>
+
+#include <chrono>
+
+#include <mongocxx/client.hpp>
+#include <mongocxx/collection.hpp>
+#include <mongocxx/cursor.hpp>
+#include <mongocxx/pool.hpp>
+
+#include <mongocxx/config/private/prelude.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace gridfs {
+
+namespace {
+
+// How often a prefetcher waiting for a client from an exhausted pool checks whether it has been
+// stopped.
+constexpr std::chrono::milliseconds k_acquire_poll_interval{10};
+
+}  // namespace
+
+chunk_prefetcher::chunk_prefetcher(pool* pool,
+                                   std::string database_name,
+                                   std::string collection_name,
+                                   class read_concern read_concern,
+                                   class read_preference read_preference,
+                                   bsoncxx::document::value filter,
+                                   options::find find_options,
+                                   std::size_t window)
+    : _pool{pool},
+      _database_name{std::move(database_name)},
+      _collection_name{std::move(collection_name)},
+      _read_concern{std::move(read_concern)},
+      _read_preference{std::move(read_preference)},
+      _filter{std::move(filter)},
+      _find_options{std::move(find_options)},
+      _window{window},
+      _done{false},
+      _stopped{false},
+      _thread{&chunk_prefetcher::run, this} {}
+
+chunk_prefetcher::~chunk_prefetcher() {
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+        _stopped = true;
+    }
+    _cv.notify_all();
+    _thread.join();
+}
+
+stdx::optional<bsoncxx::document::value> chunk_prefetcher::next() {
+    std::unique_lock<std::mutex> lock{_mutex};
+    _cv.wait(lock, [this] { return !_chunks.empty() || _done; });
+
+    if (_chunks.empty()) {
+        if (_error) {
+            std::rethrow_exception(_error);
+        }
+        return stdx::nullopt;
+    }
+
+    bsoncxx::document::value chunk = std::move(_chunks.front());
+    _chunks.pop_front();
+    lock.unlock();
+
+    // There is room in the window again.
+    _cv.notify_all();
+    return {std::move(chunk)};
+}
+
+void chunk_prefetcher::run() {
+    try {
+        // pool::acquire() blocks until a client is returned, without noticing that the prefetcher
+        // is being destroyed, so an exhausted pool is polled instead.
+        stdx::optional<pool::entry> client;
+        {
+            std::unique_lock<std::mutex> lock{_mutex};
+            while (!(client = _pool->try_acquire())) {
+                if (_cv.wait_for(lock, k_acquire_poll_interval, [this] { return _stopped; })) {
+                    return;
+                }
+            }
+        }
+
+        collection chunks = (**client)[_database_name][_collection_name];
+        chunks.read_concern(_read_concern);
+        chunks.read_preference(_read_preference);
+
+        for (auto&& chunk : chunks.find(_filter.view(), _find_options)) {
+            // The cursor reuses its buffer on the next getMore, so each chunk is copied out before
+            // it is handed over.
+            bsoncxx::document::value owned{chunk};
+
+            std::unique_lock<std::mutex> lock{_mutex};
+            _cv.wait(lock, [this] { return _chunks.size() < _window || _stopped; });
+            if (_stopped) {
+                return;
+            }
+            _chunks.push_back(std::move(owned));
+            lock.unlock();
+            _cv.notify_all();
+        }
+    } catch (...) {
+        std::lock_guard<std::mutex> lock{_mutex};
+        _error = std::current_exception();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+        _done = true;
+    }
+    _cv.notify_all();
+}
+
+}  // namespace gridfs
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
@@ -0,0 +1,96 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/stdx/optional.hpp>
+#include <mongocxx/options/find.hpp>
+#include <mongocxx/read_concern.hpp>
+#include <mongocxx/read_preference.hpp>
+#include <mongocxx/stdx.hpp>
+
+#include <mongocxx/config/private/prelude.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+class pool;
+
+namespace gridfs {
+
+// Reads the chunks documents of a file on a background thread, using a client acquired from a
+// pool, and keeps up to a fixed number of them buffered ahead of the consumer.
+class chunk_prefetcher {
+   public:
+    chunk_prefetcher(pool* pool,
+                     std::string database_name,
+                     std::string collection_name,
+                     class read_concern read_concern,
+                     class read_preference read_preference,
+                     bsoncxx::document::value filter,
+                     options::find find_options,
+                     std::size_t window);
+
+    // no copy or move
+    chunk_prefetcher(const chunk_prefetcher&) = delete;
+    chunk_prefetcher(chunk_prefetcher&&) = delete;
+    void operator=(const chunk_prefetcher&) = delete;
+    void operator=(chunk_prefetcher&&) = delete;
+
+    // Stops reading ahead and waits for the background thread to finish, including while the
+    // thread is still waiting for a client from the pool.
+    ~chunk_prefetcher();
+
+    // Blocks until the next chunks document is available. Returns no document once the query has
+    // been exhausted, and rethrows any error that occurred on the background thread.
+    stdx::optional<bsoncxx::document::value> next();
+
+   private:
+    void run();
+
+    pool* _pool;
+    std::string _database_name;
+    std::string _collection_name;
+    class read_concern _read_concern;
+    class read_preference _read_preference;
+    bsoncxx::document::value _filter;
+    options::find _find_options;
+    const std::size_t _window;
+
+    // Guards every member below.
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    std::deque<bsoncxx::document::value> _chunks;
+    std::exception_ptr _error;
+    bool _done;
+    bool _stopped;
+
+    // Declared last so that the thread starts after everything it uses has been initialized.
+    std::thread _thread;
+};
+
+}  // namespace gridfs
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/private/postlude.hh>
@@ -0,0 +1,108 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <mongocxx/gridfs/private/content_chunker.hh>
+
+#include <algorithm>
+
+#include <mongocxx/config/private/prelude.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace gridfs {
+
+namespace {
+
+// Chunks must fit in a 16MB document along with their key and any compression overhead.
+constexpr std::size_t k_max_chunk_size = 15 * 1024 * 1024;
+
+// The gear table: 256 pseudo-random values generated with splitmix64 from a fixed seed.
+struct gear_table {
+    gear_table() {
+        std::uint64_t state = 0x6d6f6e676f637878;  // "mongocxx"
+        for (auto& value : values) {
+            std::uint64_t z = (state += 0x9e3779b97f4a7c15);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+            value = z ^ (z >> 31);
+        }
+    }
+
+    std::uint64_t values[256];
+};
+
+const gear_table& gear() {
+    static const gear_table table;
+    return table;
+}
+
+// A mask of the top `bits` bits. The gear hash shifts left, so its top bits depend on the most
+// bytes.
+std::uint64_t top_bits_mask(int bits) {
+    bits = std::max(0, std::min(bits, 63));
+    return bits == 0 ? 0 : ~std::uint64_t{0} << (64 - bits);
+}
+
+}  // namespace
+
+content_chunker::content_chunker(std::size_t average_size)
+    : _hash{0},
+      _min_size{std::max<std::size_t>(average_size / 4, 1)},
+      _average_size{std::min(std::max<std::size_t>(average_size, 1), k_max_chunk_size)},
+      _max_size{std::min(average_size * 4, k_max_chunk_size)} {
+    _max_size = std::max(_max_size, _average_size);
+
+    int bits = 0;
+    while ((std::size_t{1} << (bits + 1)) <= _average_size) {
+        ++bits;
+    }
+
+    // A cut happens with probability 2^-bits per byte on average, biased by two bits either side
+    // of the average size.
+    _strict_mask = top_bits_mask(bits + 2);
+    _loose_mask = top_bits_mask(bits - 2);
+}
+
+std::size_t content_chunker::scan(const std::uint8_t* data,
+                                  std::size_t length,
+                                  std::size_t chunk_len,
+                                  bool* cut) {
+    const auto& table = gear().values;
+    *cut = false;
+
+    // Bytes before the minimum size are never a boundary, and the hash only depends on the last 64
+    // bytes scanned, so they are skipped without hashing.
+    std::size_t i = 0;
+    if (chunk_len < _min_size) {
+        i = std::min(length, _min_size - chunk_len);
+    }
+
+    for (; i < length; ++i) {
+        const std::size_t len = chunk_len + i + 1;
+        _hash = (_hash << 1) + table[data[i]];
+
+        const std::uint64_t mask = len < _average_size ? _strict_mask : _loose_mask;
+        if ((_hash & mask) == 0 || len >= _max_size) {
+            *cut = true;
+            _hash = 0;
+            return i + 1;
+        }
+    }
+
+    return length;
+}
+
+}  // namespace gridfs
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
@@ -0,0 +1,69 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <mongocxx/config/private/prelude.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace gridfs {
+
+// Finds content-defined chunk boundaries with a gear rolling hash. A boundary depends only on the
+// bytes shortly before it, so an insertion or deletion only changes the chunks around the edit,
+// and the chunks after it are found again at their shifted offsets.
+//
+// Chunks are between a quarter of and four times the average size. Following FastCDC, a boundary
+// is harder to find before the average size and easier after it, which narrows the spread of
+// chunk sizes around the average.
+//
+// The gear table is fixed, so the same contents are always cut at the same places, on any
+// platform and by any version of the driver.
+class content_chunker {
+   public:
+    explicit content_chunker(std::size_t average_size);
+
+    // Scans up to `length` more bytes of the current chunk, of which `chunk_len` bytes have already
+    // been scanned. Returns the number of bytes that belong to the current chunk, and sets `*cut`
+    // if the chunk ends after them. The hash is reset at a cut.
+    std::size_t scan(const std::uint8_t* data,
+                     std::size_t length,
+                     std::size_t chunk_len,
+                     bool* cut);
+
+    std::size_t min_size() const {
+        return _min_size;
+    }
+
+    std::size_t max_size() const {
+        return _max_size;
+    }
+
+   private:
+    std::uint64_t _hash;
+    std::size_t _min_size;
+    std::size_t _average_size;
+    std::size_t _max_size;
+    std::uint64_t _strict_mask;
+    std::uint64_t _loose_mask;
+};
+
+}  // namespace gridfs
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/private/postlude.hh>
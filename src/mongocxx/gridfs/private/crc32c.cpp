@@ -0,0 +1,158 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <mongocxx/gridfs/private/crc32c.hh>
+
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define MONGOCXX_CRC32C_SSE42 1
+#include <nmmintrin.h>
+#elif defined(_M_X64)
+#define MONGOCXX_CRC32C_SSE42 1
+#include <intrin.h>
+#include <nmmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#define MONGOCXX_CRC32C_ARMV8 1
+#include <arm_acle.h>
+#endif
+
+#include <mongocxx/config/private/prelude.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace gridfs {
+
+namespace {
+
+constexpr std::uint32_t k_polynomial = 0x82F63B78;  // Castagnoli, reversed.
+
+// Tables for processing eight bytes per step: table[k][b] is the CRC of byte b followed by k zero
+// bytes.
+struct slice_tables {
+    slice_tables() {
+        for (std::uint32_t b = 0; b < 256; ++b) {
+            std::uint32_t crc = b;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc >> 1) ^ (k_polynomial & (0u - (crc & 1)));
+            }
+            table[0][b] = crc;
+        }
+
+        for (std::uint32_t b = 0; b < 256; ++b) {
+            for (std::size_t k = 1; k < 8; ++k) {
+                table[k][b] = (table[k - 1][b] >> 8) ^ table[0][table[k - 1][b] & 0xFF];
+            }
+        }
+    }
+
+    std::uint32_t table[8][256];
+};
+
+std::uint32_t crc32c_portable(std::uint32_t crc, const std::uint8_t* data, std::size_t length) {
+    static const slice_tables tables;
+    const auto& t = tables.table;
+
+    while (length >= 8) {
+        std::uint32_t low = crc ^ (static_cast<std::uint32_t>(data[0]) |
+                                   static_cast<std::uint32_t>(data[1]) << 8 |
+                                   static_cast<std::uint32_t>(data[2]) << 16 |
+                                   static_cast<std::uint32_t>(data[3]) << 24);
+        crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^
+              t[4][low >> 24] ^ t[3][data[4]] ^ t[2][data[5]] ^ t[1][data[6]] ^ t[0][data[7]];
+        data += 8;
+        length -= 8;
+    }
+
+    while (length-- > 0) {
+        crc = (crc >> 8) ^ t[0][(crc ^ *data++) & 0xFF];
+    }
+
+    return crc;
+}
+
+#if defined(MONGOCXX_CRC32C_SSE42)
+#if defined(_MSC_VER)
+bool cpu_has_crc32() {
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 20)) != 0;
+}
+
+std::uint32_t crc32c_hardware(std::uint32_t crc, const std::uint8_t* data, std::size_t length) {
+#else
+bool cpu_has_crc32() {
+    return __builtin_cpu_supports("sse4.2");
+}
+
+__attribute__((target("sse4.2"))) std::uint32_t crc32c_hardware(std::uint32_t crc,
+                                                                 const std::uint8_t* data,
+                                                                 std::size_t length) {
+#endif
+    std::uint64_t crc64 = crc;
+    while (length >= 8) {
+        std::uint64_t word;
+        std::memcpy(&word, data, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+        data += 8;
+        length -= 8;
+    }
+
+    crc = static_cast<std::uint32_t>(crc64);
+    while (length-- > 0) {
+        crc = _mm_crc32_u8(crc, *data++);
+    }
+
+    return crc;
+}
+#elif defined(MONGOCXX_CRC32C_ARMV8)
+bool cpu_has_crc32() {
+    return true;
+}
+
+std::uint32_t crc32c_hardware(std::uint32_t crc, const std::uint8_t* data, std::size_t length) {
+    while (length >= 8) {
+        std::uint64_t word;
+        std::memcpy(&word, data, sizeof(word));
+        crc = __crc32cd(crc, word);
+        data += 8;
+        length -= 8;
+    }
+
+    while (length-- > 0) {
+        crc = __crc32cb(crc, *data++);
+    }
+
+    return crc;
+}
+#endif
+
+}  // namespace
+
+std::uint32_t crc32c(std::uint32_t crc, const std::uint8_t* data, std::size_t length) {
+    crc = ~crc;
+
+#if defined(MONGOCXX_CRC32C_SSE42) || defined(MONGOCXX_CRC32C_ARMV8)
+    static const bool use_hardware = cpu_has_crc32();
+    if (use_hardware) {
+        return ~crc32c_hardware(crc, data, length);
+    }
+#endif
+
+    return ~crc32c_portable(crc, data, length);
+}
+
+}  // namespace gridfs
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
@@ -14,10 +14,20 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdlib>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
+#include <bsoncxx/string/to_string.hpp>
 #include <mongocxx/exception/gridfs_exception.hpp>
+#include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/gridfs/chunk_codec.hpp>
 #include <mongocxx/gridfs/downloader.hpp>
+#include <mongocxx/gridfs/private/blob_refs.hh>
+#include <mongocxx/gridfs/private/chunk_prefetcher.hh>
 
 #include <mongocxx/config/private/prelude.hh>
 
@@ -83,21 +93,46 @@ std::int32_t read_chunk_size_from_files_document(bsoncxx::document::view files_d
 
 class downloader::impl {
    public:
-    impl(stdx::optional<cursor> chunks_param, bsoncxx::document::value files_doc_param)
+    impl(const client_session* session_param,
+         collection chunks_collection_param,
+         collection blobs_collection_param,
+         stdx::string_view database_name_param,
+         bsoncxx::document::value files_doc_param,
+         std::int64_t start,
+         std::int64_t end,
+         class pool* pool_param,
+         std::size_t prefetch_chunks_param,
+         std::shared_ptr<chunk_codec> codec_param,
+         bool verify_checksum_param)
         : files_doc{std::move(files_doc_param)},
           chunk_buffer_len{0},
           chunk_buffer_offset{0},
           chunk_buffer_ptr{nullptr},
-          chunks{chunks_param ? std::move(chunks_param) : stdx::nullopt},
-          chunks_curr{chunks ? stdx::make_optional<cursor::iterator>(chunks->begin())
-                             : stdx::nullopt},
-          chunks_end{chunks ? stdx::make_optional<cursor::iterator>(chunks->end()) : stdx::nullopt},
-          chunks_seen{0},
+          chunks_started{false},
+          next_chunk_n{0},
           chunk_size{read_chunk_size_from_files_document(files_doc.view())},
           closed{false},
           file_chunk_count{0},
-          file_len{read_length_from_files_document(files_doc.view())} {
-        if (chunk_size) {
+          file_len{read_length_from_files_document(files_doc.view())},
+          session{session_param},
+          chunks_collection{std::move(chunks_collection_param)},
+          blobs_collection{std::move(blobs_collection_param)},
+          database_name{bsoncxx::string::to_string(database_name_param)},
+          pool{pool_param},
+          prefetch_chunks{prefetch_chunks_param},
+          verify_checksum{verify_checksum_param},
+          expected_checksum{0},
+          checksum{0},
+          checksum_chunks{0},
+          checksum_verified{false},
+          manifest{nullptr},
+          max_chunk_len{static_cast<std::size_t>(chunk_size)},
+          blob_batch_end{0} {
+        // Deduplicated files list their chunks, which vary in size, in a manifest.
+        auto manifest_ele = files_doc.view()["manifest"];
+        if (manifest_ele) {
+            read_manifest(manifest_ele);
+        } else if (chunk_size) {
             std::lldiv_t num_chunks_div = std::lldiv(file_len, chunk_size);
             if (num_chunks_div.rem) {
                 ++num_chunks_div.quot;
@@ -113,12 +148,139 @@ class downloader::impl {
 
             file_chunk_count = static_cast<std::int32_t>(num_chunks_div.quot);
         }
+
+        range_end = std::min(end, file_len);
+        range_start = std::min(start, range_end);
+        position = range_start;
+
+        // The chunk after the one holding the last byte of the range.
+        end_chunk_n = range_end == 0 ? 0 : chunk_index(range_end - 1) + 1;
+
+        // The bucket's codec is only used for files that were compressed with it.
+        auto codec_ele = files_doc.view()["chunkCodec"];
+        if (codec_ele) {
+            if (codec_ele.type() != bsoncxx::type::k_utf8) {
+                throw gridfs_exception{error_code::k_gridfs_file_corrupted,
+                                       "expected files document field \"chunkCodec\" to have type "
+                                       "k_utf8"};
+            }
+
+            auto codec_name = codec_ele.get_string().value;
+            if (!codec_param || codec_param->name() != codec_name) {
+                std::ostringstream err;
+                err << "file was compressed with chunk codec \"" << codec_name << "\"";
+                throw gridfs_exception{error_code::k_gridfs_unsupported_chunk_codec, err.str()};
+            }
+
+            codec = std::move(codec_param);
+        }
+
+        if (verify_checksum) {
+            if (range_start != 0 || range_end != file_len) {
+                throw logic_error{error_code::k_invalid_parameter,
+                                  "options::gridfs::download::verify_checksum() requires "
+                                  "downloading the whole file"};
+            }
+
+            auto checksum_ele = files_doc.view()["crc32c"];
+            if (!checksum_ele) {
+                throw logic_error{error_code::k_invalid_parameter,
+                                  "options::gridfs::download::verify_checksum() requires a file "
+                                  "uploaded with options::gridfs::upload::compute_checksum()"};
+            }
+
+            if (checksum_ele.type() != bsoncxx::type::k_int64) {
+                throw gridfs_exception{error_code::k_gridfs_file_corrupted,
+                                       "expected files document field \"crc32c\" to have type "
+                                       "k_int64"};
+            }
+
+            expected_checksum = static_cast<std::uint32_t>(checksum_ele.get_int64().value);
+        }
+    }
+
+    void read_manifest(bsoncxx::document::element manifest_ele) {
+        const std::uint32_t k_max_document_size = 16 * 1024 * 1024;
+
+        if (manifest_ele.type() != bsoncxx::type::k_binary ||
+            manifest_ele.get_binary().size % k_manifest_entry_size != 0) {
+            std::ostringstream err;
+            err << "expected files document field \"manifest\" to have type k_binary and a size "
+                   "that is a multiple of "
+                << k_manifest_entry_size << " bytes";
+            throw gridfs_exception{error_code::k_gridfs_file_corrupted, err.str()};
+        }
+
+        auto binary = manifest_ele.get_binary();
+        const std::size_t entries = binary.size / k_manifest_entry_size;
+
+        manifest = binary.bytes;
+        max_chunk_len = 0;
+        chunk_offsets.reserve(entries + 1);
+        chunk_offsets.push_back(0);
+
+        for (std::size_t i = 0; i < entries; ++i) {
+            const std::uint8_t* len_bytes =
+                &manifest[i * k_manifest_entry_size + k_manifest_digest_size];
+            const std::uint32_t len = static_cast<std::uint32_t>(len_bytes[0]) |
+                                      static_cast<std::uint32_t>(len_bytes[1]) << 8 |
+                                      static_cast<std::uint32_t>(len_bytes[2]) << 16 |
+                                      static_cast<std::uint32_t>(len_bytes[3]) << 24;
+
+            if (len == 0 || len > k_max_document_size) {
+                std::ostringstream err;
+                err << "manifest entry #" << i << " has unexpected chunk length: " << len;
+                throw gridfs_exception{error_code::k_gridfs_file_corrupted, err.str()};
+            }
+
+            chunk_offsets.push_back(chunk_offsets.back() + len);
+            max_chunk_len = std::max(max_chunk_len, static_cast<std::size_t>(len));
+        }
+
+        if (chunk_offsets.back() != file_len) {
+            std::ostringstream err;
+            err << "expected manifest to describe " << file_len << " bytes, but it describes "
+                << chunk_offsets.back() << " bytes";
+            throw gridfs_exception{error_code::k_gridfs_file_corrupted, err.str()};
+        }
+
+        // The manifest fits in a document, so this cannot overflow.
+        file_chunk_count = static_cast<std::int32_t>(entries);
+    }
+
+    // Whether the file was uploaded with deduplication and has a manifest.
+    bool deduplicated() const {
+        return !chunk_offsets.empty();
+    }
+
+    // The offset in the file of the first byte of chunk `n`.
+    std::int64_t chunk_offset(std::int32_t n) const {
+        if (deduplicated()) {
+            return chunk_offsets[static_cast<std::size_t>(n)];
+        }
+        return static_cast<std::int64_t>(n) * static_cast<std::int64_t>(chunk_size);
+    }
+
+    // The n of the chunk holding the byte at `offset`.
+    std::int32_t chunk_index(std::int64_t offset) const {
+        if (deduplicated()) {
+            auto next = std::upper_bound(chunk_offsets.begin(), chunk_offsets.end(), offset);
+            return static_cast<std::int32_t>(next - chunk_offsets.begin() - 1);
+        }
+        return static_cast<std::int32_t>(offset / chunk_size);
+    }
+
+    // The digest of chunk `n` of a deduplicated file, as raw bytes.
+    std::string chunk_digest(std::int32_t n) const {
+        return std::string{reinterpret_cast<const char*>(
+                               &manifest[static_cast<std::size_t>(n) * k_manifest_entry_size]),
+                           k_manifest_digest_size};
     }
 
     // The files document for the file being downloaded.
     bsoncxx::document::value files_doc;
 
-    // The number of bytes in the current chunk.
+    // The number of bytes in the current chunk, excluding any bytes past `range_end`.
     std::size_t chunk_buffer_len;
 
     // The offset from `chunk_buffer_ptr` to the next byte to be read.
@@ -127,20 +289,21 @@ class downloader::impl {
     // A pointer to the current chunk being read.
     const uint8_t* chunk_buffer_ptr;
 
-    // A cursor iterating over the chunks documents being read. In the case of a zero-length file,
-    // this member does not have a value.
+    // A cursor iterating over the chunks documents being read. It does not have a value when
+    // nothing is left to read or when `prefetcher` is used instead.
     stdx::optional<cursor> chunks;
 
-    // An iterator to the current chunk document. In the case of a zero-length file, this member
-    // does not have a value.
+    // An iterator to the current chunk document. It has a value whenever `chunks` does.
     stdx::optional<cursor::iterator> chunks_curr;
 
-    // An iterator to the end of `chunks`. In the case of a zero-length file, this member does not
-    // have a value.
+    // An iterator to the end of `chunks`. It has a value whenever `chunks` does.
     stdx::optional<cursor::iterator> chunks_end;
 
-    // The number of chunks already downloaded from the server.
-    std::int32_t chunks_seen;
+    // Whether `chunks_curr` points to a chunk that has already been consumed.
+    bool chunks_started;
+
+    // The n of the next chunk to be fetched from `chunks` or `prefetcher`.
+    std::int32_t next_chunk_n;
 
     // The size of a chunk in bytes.
     std::int32_t chunk_size;
@@ -153,6 +316,79 @@ class downloader::impl {
 
     // The total length of the file in bytes.
     std::int64_t file_len;
+
+    // The offset of the first byte of the file that may be read.
+    std::int64_t range_start;
+
+    // The offset past the last byte of the file that may be read.
+    std::int64_t range_end;
+
+    // The n of the chunk following the one that holds the last byte of the range.
+    std::int32_t end_chunk_n;
+
+    // The offset in the file of the next byte to be read.
+    std::int64_t position;
+
+    // Client session to use for reading chunks.
+    const client_session* session;
+
+    // The collection from which the chunks are read when no pool is used.
+    collection chunks_collection;
+
+    // The collection from which the chunks of a deduplicated file are read.
+    collection blobs_collection;
+
+    // The name of the database holding `chunks_collection`, used to reach it through `pool`.
+    std::string database_name;
+
+    // The pool through which chunks are read ahead, or nullptr.
+    class pool* pool;
+
+    // The maximum number of chunks read ahead through `pool`.
+    std::size_t prefetch_chunks;
+
+    // Reads the chunks documents ahead on a background thread when `pool` is set.
+    std::unique_ptr<chunk_prefetcher> prefetcher;
+
+    // The chunks document obtained from `prefetcher` that is currently being read.
+    stdx::optional<bsoncxx::document::value> prefetched_chunk;
+
+    // The codec the file's chunks were compressed with, or null if they are stored uncompressed.
+    std::shared_ptr<chunk_codec> codec;
+
+    // When `codec` is set, the decompressed bytes of the current chunk, which `chunk_buffer_ptr`
+    // points into.
+    std::unique_ptr<std::uint8_t[]> decompressed;
+
+    // Whether close() compares `checksum` with `expected_checksum`.
+    bool verify_checksum;
+
+    // The CRC-32C recorded in the files document.
+    std::uint32_t expected_checksum;
+
+    // The CRC-32C of the first `checksum_chunks` chunks of the file.
+    std::uint32_t checksum;
+
+    // The number of leading chunks of the file that `checksum` covers.
+    std::int32_t checksum_chunks;
+
+    // Whether close() found `checksum` equal to `expected_checksum`.
+    bool checksum_verified;
+
+    // For a deduplicated file, its manifest within `files_doc`.
+    const std::uint8_t* manifest;
+
+    // For a deduplicated file, the offset of each of its chunks in the file, followed by the
+    // length of the file.
+    std::vector<std::int64_t> chunk_offsets;
+
+    // The length of the largest chunk of the file.
+    std::size_t max_chunk_len;
+
+    // For a deduplicated file, the blobs documents of the chunks from `next_chunk_n` up to
+    // `blob_batch_end`, keyed by digest.
+    std::unordered_map<std::string, bsoncxx::document::value> blob_batch;
+    std::int32_t blob_batch_end;
 };
 
 }  // namespace gridfs
@@ -0,0 +1,304 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <mongocxx/gridfs/private/mapped_file.hh>
+
+#include <cerrno>
+#include <cstdio>
+#include <limits>
+#include <system_error>
+#include <utility>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <mongocxx/exception/exception.hpp>
+
+#include <mongocxx/config/private/prelude.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace gridfs {
+
+namespace {
+
+std::size_t checked_size(std::uint64_t length, const std::string& path) {
+    if (length > std::numeric_limits<std::size_t>::max()) {
+        throw exception{std::make_error_code(std::errc::file_too_large),
+                        "file " + path + " is too large to be mapped into memory"};
+    }
+    return static_cast<std::size_t>(length);
+}
+
+#if defined(_WIN32)
+[[noreturn]] void throw_last_error(const std::string& what) {
+    throw exception{std::error_code{static_cast<int>(::GetLastError()), std::system_category()},
+                    what};
+}
+
+void map_view(void* file,
+              DWORD protection,
+              DWORD access,
+              std::uint64_t length,
+              const std::string& path,
+              void** mapping,
+              std::uint8_t** data) {
+    *mapping = ::CreateFileMappingA(file,
+                                    nullptr,
+                                    protection,
+                                    static_cast<DWORD>(length >> 32),
+                                    static_cast<DWORD>(length & 0xFFFFFFFF),
+                                    nullptr);
+    if (!*mapping) {
+        throw_last_error("could not map file " + path);
+    }
+
+    *data = static_cast<std::uint8_t*>(::MapViewOfFile(*mapping, access, 0, 0, 0));
+    if (!*data) {
+        throw_last_error("could not map file " + path);
+    }
+}
+#else
+[[noreturn]] void throw_errno(const std::string& what) {
+    throw exception{std::error_code{errno, std::system_category()}, what};
+}
+
+std::uint8_t* map_view(int fd, std::size_t length, int protection, const std::string& path) {
+    void* data = ::mmap(nullptr, length, protection, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) {
+        throw_errno("could not map file " + path);
+    }
+    return static_cast<std::uint8_t*>(data);
+}
+#endif
+
+}  // namespace
+
+#if defined(_WIN32)
+mapped_file::mapped_file() noexcept
+    : _data{nullptr}, _size{0}, _file{INVALID_HANDLE_VALUE}, _mapping{nullptr} {}
+
+mapped_file::mapped_file(mapped_file&& other) noexcept
+    : _data{other._data}, _size{other._size}, _file{other._file}, _mapping{other._mapping} {
+    other._data = nullptr;
+    other._size = 0;
+    other._file = INVALID_HANDLE_VALUE;
+    other._mapping = nullptr;
+}
+
+mapped_file& mapped_file::operator=(mapped_file&& other) noexcept {
+    if (this != &other) {
+        reset();
+        std::swap(_data, other._data);
+        std::swap(_size, other._size);
+        std::swap(_file, other._file);
+        std::swap(_mapping, other._mapping);
+    }
+    return *this;
+}
+
+void mapped_file::reset() noexcept {
+    if (_data) {
+        ::UnmapViewOfFile(_data);
+    }
+    if (_mapping) {
+        ::CloseHandle(_mapping);
+    }
+    if (_file != INVALID_HANDLE_VALUE) {
+        ::CloseHandle(_file);
+    }
+    _data = nullptr;
+    _size = 0;
+    _file = INVALID_HANDLE_VALUE;
+    _mapping = nullptr;
+}
+
+mapped_file mapped_file::open_for_read(const std::string& path) {
+    mapped_file file;
+    file._file = ::CreateFileA(path.c_str(),
+                               GENERIC_READ,
+                               FILE_SHARE_READ,
+                               nullptr,
+                               OPEN_EXISTING,
+                               FILE_FLAG_SEQUENTIAL_SCAN,
+                               nullptr);
+    if (file._file == INVALID_HANDLE_VALUE) {
+        throw_last_error("could not open file " + path);
+    }
+
+    LARGE_INTEGER length;
+    if (!::GetFileSizeEx(file._file, &length)) {
+        throw_last_error("could not get the size of file " + path);
+    }
+
+    file._size = checked_size(static_cast<std::uint64_t>(length.QuadPart), path);
+    if (file._size > 0) {
+        map_view(file._file, PAGE_READONLY, FILE_MAP_READ, 0, path, &file._mapping, &file._data);
+    }
+    return file;
+}
+
+mapped_file mapped_file::create(const std::string& path, std::uint64_t length) {
+    mapped_file file;
+    file._file = ::CreateFileA(path.c_str(),
+                               GENERIC_READ | GENERIC_WRITE,
+                               0,
+                               nullptr,
+                               CREATE_NEW,
+                               FILE_ATTRIBUTE_NORMAL,
+                               nullptr);
+    if (file._file == INVALID_HANDLE_VALUE) {
+        throw_last_error("could not create file " + path);
+    }
+
+    try {
+        // Creating the mapping extends the file to its full length.
+        file._size = checked_size(length, path);
+        if (file._size > 0) {
+            map_view(file._file,
+                     PAGE_READWRITE,
+                     FILE_MAP_WRITE,
+                     length,
+                     path,
+                     &file._mapping,
+                     &file._data);
+        }
+    } catch (...) {
+        file = mapped_file{};
+        std::remove(path.c_str());
+        throw;
+    }
+    return file;
+}
+
+void replace_file(const std::string& source, const std::string& destination) {
+    if (!::MoveFileExA(source.c_str(), destination.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+        throw_last_error("could not rename file " + source + " to " + destination);
+    }
+}
+#else
+mapped_file::mapped_file() noexcept : _data{nullptr}, _size{0}, _fd{-1} {}
+
+mapped_file::mapped_file(mapped_file&& other) noexcept
+    : _data{other._data}, _size{other._size}, _fd{other._fd} {
+    other._data = nullptr;
+    other._size = 0;
+    other._fd = -1;
+}
+
+mapped_file& mapped_file::operator=(mapped_file&& other) noexcept {
+    if (this != &other) {
+        reset();
+        std::swap(_data, other._data);
+        std::swap(_size, other._size);
+        std::swap(_fd, other._fd);
+    }
+    return *this;
+}
+
+void mapped_file::reset() noexcept {
+    if (_data) {
+        ::munmap(_data, _size);
+    }
+    if (_fd >= 0) {
+        ::close(_fd);
+    }
+    _data = nullptr;
+    _size = 0;
+    _fd = -1;
+}
+
+mapped_file mapped_file::open_for_read(const std::string& path) {
+    mapped_file file;
+    file._fd = ::open(path.c_str(), O_RDONLY);
+    if (file._fd < 0) {
+        throw_errno("could not open file " + path);
+    }
+
+    struct stat info;
+    if (::fstat(file._fd, &info) != 0) {
+        throw_errno("could not get the size of file " + path);
+    }
+
+    if (!S_ISREG(info.st_mode)) {
+        throw exception{std::make_error_code(std::errc::invalid_argument),
+                        path + " is not a regular file"};
+    }
+
+    file._size = checked_size(static_cast<std::uint64_t>(info.st_size), path);
+    if (file._size > 0) {
+        file._data = map_view(file._fd, file._size, PROT_READ, path);
+#if defined(MADV_SEQUENTIAL)
+        ::madvise(file._data, file._size, MADV_SEQUENTIAL);
+#endif
+    }
+    return file;
+}
+
+mapped_file mapped_file::create(const std::string& path, std::uint64_t length) {
+    mapped_file file;
+    file._fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (file._fd < 0) {
+        throw_errno("could not create file " + path);
+    }
+
+    try {
+        file._size = checked_size(length, path);
+        if (file._size == 0) {
+            return file;
+        }
+
+        if (::ftruncate(file._fd, static_cast<off_t>(length)) != 0) {
+            throw_errno("could not extend file " + path);
+        }
+
+#if defined(__linux__)
+        // ftruncate() leaves the file sparse. Some filesystems cannot preallocate, in which case
+        // space is allocated as the pages are written.
+        int err = ::posix_fallocate(file._fd, 0, static_cast<off_t>(length));
+        if (err != 0 && err != EINVAL && err != EOPNOTSUPP) {
+            errno = err;
+            throw_errno("could not allocate storage for file " + path);
+        }
+#endif
+
+        file._data = map_view(file._fd, file._size, PROT_READ | PROT_WRITE, path);
+    } catch (...) {
+        file = mapped_file{};
+        std::remove(path.c_str());
+        throw;
+    }
+    return file;
+}
+
+void replace_file(const std::string& source, const std::string& destination) {
+    if (::rename(source.c_str(), destination.c_str()) != 0) {
+        throw_errno("could not rename file " + source + " to " + destination);
+    }
+}
+#endif
+
+mapped_file::~mapped_file() {
+    reset();
+}
+
+}  // namespace gridfs
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
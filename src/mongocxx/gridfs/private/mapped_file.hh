@@ -0,0 +1,85 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <mongocxx/config/private/prelude.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace gridfs {
+
+// A file mapped into memory in its entirety. An empty file is not mapped, and has a null data().
+//
+// Errors from the operating system are thrown as mongocxx::exception with an error code in
+// std::system_category().
+class mapped_file {
+   public:
+    // Maps an existing file for reading. The kernel is told that it will be read sequentially.
+    static mapped_file open_for_read(const std::string& path);
+
+    // Creates a new file, allocates `length` bytes of storage for it and maps it for writing. The
+    // file must not exist yet. Storage is reserved up front where the platform allows it, so that
+    // running out of disk space is reported here rather than as a fault while the mapping is being
+    // written. If the file was created but could not be sized or mapped, it is removed.
+    static mapped_file create(const std::string& path, std::uint64_t length);
+
+    mapped_file() noexcept;
+    mapped_file(mapped_file&& other) noexcept;
+    mapped_file& operator=(mapped_file&& other) noexcept;
+
+    // no copy
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    // Unmaps and closes the file.
+    ~mapped_file();
+
+    std::uint8_t* data() const noexcept {
+        return _data;
+    }
+
+    std::size_t size() const noexcept {
+        return _size;
+    }
+
+   private:
+    void reset() noexcept;
+
+    std::uint8_t* _data;
+    std::size_t _size;
+
+#if defined(_WIN32)
+    void* _file;
+    void* _mapping;
+#else
+    int _fd;
+#endif
+};
+
+// Renames the file at `source` to `destination`, replacing any file already there.
+//
+// Errors from the operating system are thrown as mongocxx::exception with an error code in
+// std::system_category().
+void replace_file(const std::string& source, const std::string& destination);
+
+}  // namespace gridfs
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/private/postlude.hh>
@@ -0,0 +1,157 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <mongocxx/gridfs/private/sha256.hh>
+
+#include <algorithm>
+#include <cstring>
+
+#include <mongocxx/config/private/prelude.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace gridfs {
+
+namespace {
+
+constexpr std::uint32_t k_round_constants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+std::uint32_t rotr(std::uint32_t x, int n) {
+    return (x >> n) | (x << (32 - n));
+}
+
+}  // namespace
+
+constexpr std::size_t sha256::digest_size;
+
+sha256::sha256()
+    : _state{0x6a09e667,
+             0xbb67ae85,
+             0x3c6ef372,
+             0xa54ff53a,
+             0x510e527f,
+             0x9b05688c,
+             0x1f83d9ab,
+             0x5be0cd19},
+      _block{},
+      _block_len{0},
+      _total_len{0} {}
+
+void sha256::update(const std::uint8_t* data, std::size_t length) {
+    _total_len += length;
+
+    if (_block_len > 0) {
+        std::size_t take = std::min(length, sizeof(_block) - _block_len);
+        std::memcpy(&_block[_block_len], data, take);
+        _block_len += take;
+        data += take;
+        length -= take;
+
+        if (_block_len < sizeof(_block)) {
+            return;
+        }
+        compress(_block);
+        _block_len = 0;
+    }
+
+    for (; length >= sizeof(_block); data += sizeof(_block), length -= sizeof(_block)) {
+        compress(data);
+    }
+
+    std::memcpy(_block, data, length);
+    _block_len = length;
+}
+
+sha256::digest sha256::finish() {
+    const std::uint64_t bit_len = _total_len * 8;
+
+    // Pad with a 1 bit, then zeros up to 8 bytes short of a block boundary, then the bit length.
+    _block[_block_len++] = 0x80;
+    if (_block_len > sizeof(_block) - 8) {
+        std::memset(&_block[_block_len], 0, sizeof(_block) - _block_len);
+        compress(_block);
+        _block_len = 0;
+    }
+    std::memset(&_block[_block_len], 0, sizeof(_block) - 8 - _block_len);
+    for (int i = 0; i < 8; ++i) {
+        _block[56 + i] = static_cast<std::uint8_t>(bit_len >> (56 - 8 * i));
+    }
+    compress(_block);
+
+    digest result;
+    for (std::size_t i = 0; i < 8; ++i) {
+        result[4 * i] = static_cast<std::uint8_t>(_state[i] >> 24);
+        result[4 * i + 1] = static_cast<std::uint8_t>(_state[i] >> 16);
+        result[4 * i + 2] = static_cast<std::uint8_t>(_state[i] >> 8);
+        result[4 * i + 3] = static_cast<std::uint8_t>(_state[i]);
+    }
+    return result;
+}
+
+void sha256::compress(const std::uint8_t* block) {
+    std::uint32_t w[64];
+    for (std::size_t i = 0; i < 16; ++i) {
+        w[i] = static_cast<std::uint32_t>(block[4 * i]) << 24 |
+               static_cast<std::uint32_t>(block[4 * i + 1]) << 16 |
+               static_cast<std::uint32_t>(block[4 * i + 2]) << 8 |
+               static_cast<std::uint32_t>(block[4 * i + 3]);
+    }
+    for (std::size_t i = 16; i < 64; ++i) {
+        std::uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        std::uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    std::uint32_t a = _state[0], b = _state[1], c = _state[2], d = _state[3];
+    std::uint32_t e = _state[4], f = _state[5], g = _state[6], h = _state[7];
+
+    for (std::size_t i = 0; i < 64; ++i) {
+        std::uint32_t s1 = rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25);
+        std::uint32_t ch = (e & f) ^ (~e & g);
+        std::uint32_t t1 = h + s1 + ch + k_round_constants[i] + w[i];
+        std::uint32_t s0 = rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22);
+        std::uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+        std::uint32_t t2 = s0 + maj;
+
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    _state[0] += a;
+    _state[1] += b;
+    _state[2] += c;
+    _state[3] += d;
+    _state[4] += e;
+    _state[5] += f;
+    _state[6] += g;
+    _state[7] += h;
+}
+
+}  // namespace gridfs
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
@@ -0,0 +1,54 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include <mongocxx/config/private/prelude.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace gridfs {
+
+// An incremental SHA-256, used to address deduplicated chunks by their contents.
+class sha256 {
+   public:
+    static constexpr std::size_t digest_size = 32;
+
+    using digest = std::array<std::uint8_t, digest_size>;
+
+    sha256();
+
+    void update(const std::uint8_t* data, std::size_t length);
+
+    // Returns the digest of everything passed to update(). The object must not be used afterwards.
+    digest finish();
+
+   private:
+    void compress(const std::uint8_t* block);
+
+    std::uint32_t _state[8];
+    std::uint8_t _block[64];
+    std::size_t _block_len;
+    std::uint64_t _total_len;
+};
+
+}  // namespace gridfs
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/private/postlude.hh>
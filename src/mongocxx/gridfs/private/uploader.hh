@@ -14,11 +14,19 @@
 
 #pragma once
 
+#include <cstring>
+#include <deque>
+#include <future>
+#include <memory>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
+#include <bsoncxx/document/view.hpp>
 #include <bsoncxx/stdx/make_unique.hpp>
 #include <bsoncxx/string/to_string.hpp>
+#include <mongocxx/gridfs/chunk_codec.hpp>
+#include <mongocxx/gridfs/private/content_chunker.hh>
 #include <mongocxx/gridfs/uploader.hpp>
 
 #include <mongocxx/config/private/prelude.hh>
@@ -27,6 +35,13 @@ namespace mongocxx {
 MONGOCXX_INLINE_NAMESPACE_BEGIN
 namespace gridfs {
 
+// A batch of chunks documents, each built in place in a buffer of its own. The buffers are handed
+// back to the uploader for reuse once the batch has been inserted.
+struct chunk_batch {
+    std::vector<std::unique_ptr<std::uint8_t[]>> buffers;
+    std::vector<bsoncxx::document::view> documents;
+};
+
 class uploader::impl {
    public:
     impl(const client_session* session,
@@ -35,9 +50,14 @@ class uploader::impl {
          collection files,
          collection chunks,
          std::int32_t chunk_size,
-         stdx::optional<bsoncxx::document::value> metadata)
+         stdx::optional<bsoncxx::document::value> metadata,
+         class pool* pool,
+         stdx::string_view database_name,
+         std::int32_t concurrency,
+         std::shared_ptr<chunk_codec> codec,
+         bool compute_checksum,
+         stdx::optional<collection> blobs)
         : session{session},
-          buffer{stdx::make_unique<std::uint8_t[]>(static_cast<size_t>(chunk_size))},
           buffer_off{0},
           chunks{std::move(chunks)},
           chunk_size{chunk_size},
@@ -46,22 +66,67 @@ class uploader::impl {
           filename{bsoncxx::string::to_string(filename)},
           files{std::move(files)},
           metadata{std::move(metadata)},
-          result{std::move(result)} {}
+          result{std::move(result)},
+          pool{pool},
+          database_name{bsoncxx::string::to_string(database_name)},
+          concurrency{concurrency},
+          codec{std::move(codec)},
+          data_capacity{this->codec
+                            ? this->codec->max_compressed_size(static_cast<std::size_t>(chunk_size))
+                            : static_cast<std::size_t>(chunk_size)},
+          compute_checksum{compute_checksum},
+          checksum{0},
+          blobs{std::move(blobs)},
+          length{0},
+          flushed_manifest_size{0},
+          pending_blob_bytes{0} {
+        if (this->blobs) {
+            chunker = stdx::make_unique<content_chunker>(static_cast<std::size_t>(chunk_size));
+        }
+    }
+
+    // Makes `buffer` available for the next chunk, reusing a free buffer if there is one.
+    void take_buffer() {
+        if (buffer) {
+            return;
+        }
+
+        if (!free_buffers.empty()) {
+            buffer = std::move(free_buffers.back());
+            free_buffers.pop_back();
+            return;
+        }
+
+        buffer = stdx::make_unique<std::uint8_t[]>(chunk_prefix.size() + data_capacity + 1);
+        std::memcpy(buffer.get(), chunk_prefix.data(), chunk_prefix.size());
+    }
 
     // Client session to use for upload operations.
     const client_session* session;
 
-    // Bytes that have been written for the current chunk.
+    // The chunks document being written, laid out as `chunk_prefix` followed by room for
+    // `data_capacity` bytes of data and the document terminator. Allocated on the first write to a
+    // chunk.
     std::unique_ptr<std::uint8_t[]> buffer;
 
-    // The offset from `buffer` to the next byte to be written.
+    // The number of data bytes of the current chunk written so far, to `buffer` or, when `codec`
+    // is set, to `raw_buffer`.
     std::size_t buffer_off;
 
     // The collection to which the chunks will be written.
     collection chunks;
 
+    // The leading bytes shared by every chunks document of the file: the document length, "_id",
+    // "files_id", "n" and the header of the "data" binary. The length, _id value, n value and
+    // binary length are patched for each chunk.
+    std::vector<std::uint8_t> chunk_prefix;
+
     // Chunks that have been fully written but not yet uploaded to the server.
-    std::vector<bsoncxx::document::value> chunks_collection_documents;
+    chunk_batch chunks_collection_documents;
+
+    // Chunk buffers whose batch has been inserted, ready to be reused. They still hold
+    // `chunk_prefix`.
+    std::vector<std::unique_ptr<std::uint8_t[]>> free_buffers;
 
     // The size of a chunk in bytes.
     std::int32_t chunk_size;
@@ -83,6 +148,69 @@ class uploader::impl {
 
     // Contains the id of the file being written.
     result::gridfs::upload result;
+
+    // The pool from which chunk batches are inserted in the background, or nullptr to insert them
+    // synchronously with `chunks`.
+    class pool* pool;
+
+    // The name of the database holding `chunks`, used to reach it through a pooled client.
+    std::string database_name;
+
+    // The maximum number of chunk batches being inserted at once.
+    std::int32_t concurrency;
+
+    // Chunk batches that are being inserted in the background, oldest first. Each yields its batch
+    // back so that the buffers can be reused.
+    std::deque<std::future<chunk_batch>> pending_inserts;
+
+    // The codec each chunk is compressed with, or null.
+    std::shared_ptr<chunk_codec> codec;
+
+    // The room for data in each chunks document: the chunk size, or the largest compressed size of
+    // a chunk when `codec` is set.
+    std::size_t data_capacity;
+
+    // When `codec` is set, the uncompressed bytes of the current chunk, which are compressed into
+    // `buffer` when the chunk is finished.
+    std::unique_ptr<std::uint8_t[]> raw_buffer;
+
+    // Whether `checksum` is computed and stored in the files document.
+    bool compute_checksum;
+
+    // The CRC-32C of the bytes written so far.
+    std::uint32_t checksum;
+
+    // When set, the file is cut into content-defined chunks that are stored once in this
+    // collection, keyed by digest, and the files document lists them in a manifest. `chunks` is
+    // not written to.
+    stdx::optional<collection> blobs;
+
+    // Finds the boundaries of content-defined chunks.
+    std::unique_ptr<content_chunker> chunker;
+
+    // The bytes of the current content-defined chunk.
+    std::vector<std::uint8_t> blob_data;
+
+    // The scratch space `blob_data` is compressed into when `codec` is set.
+    std::vector<std::uint8_t> compressed_blob_data;
+
+    // The manifest of the file: for each chunk, its 32-byte digest and its little-endian 32-bit
+    // length.
+    std::vector<std::uint8_t> manifest;
+
+    // The number of bytes in the chunks listed in `manifest`.
+    std::int64_t length;
+
+    // The leading bytes of `manifest` whose references have been added to `blobs`, and that must
+    // be released if the upload is aborted.
+    std::size_t flushed_manifest_size;
+
+    // Blobs that have been fully written but not yet looked up and inserted, and their digests.
+    std::vector<bsoncxx::document::value> pending_blobs;
+    std::unordered_set<std::string> pending_digests;
+
+    // The total size of the data in `pending_blobs`.
+    std::size_t pending_blob_bytes;
 };
 
 }  // namespace gridfs
@@ -17,15 +17,34 @@
 #include <algorithm>
 #include <chrono>
 #include <cstring>
+#include <exception>
+#include <iterator>
 #include <limits>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
+#include <bsoncxx/builder/basic/array.hpp>
 #include <bsoncxx/builder/basic/document.hpp>
 #include <bsoncxx/builder/basic/kvp.hpp>
+#include <bsoncxx/oid.hpp>
 #include <bsoncxx/types.hpp>
+#include <mongocxx/bulk_write.hpp>
+#include <mongocxx/client.hpp>
+#include <mongocxx/exception/bulk_write_exception.hpp>
 #include <mongocxx/exception/error_code.hpp>
 #include <mongocxx/exception/gridfs_exception.hpp>
 #include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/gridfs/private/blob_refs.hh>
+#include <mongocxx/gridfs/private/crc32c.hh>
+#include <mongocxx/gridfs/private/sha256.hh>
 #include <mongocxx/gridfs/private/uploader.hh>
+#include <mongocxx/model/update_one.hpp>
+#include <mongocxx/options/bulk_write.hpp>
+#include <mongocxx/options/find.hpp>
+#include <mongocxx/pool.hpp>
 
 #include <mongocxx/config/private/prelude.hh>
 
@@ -35,6 +54,92 @@ std::size_t chunks_collection_documents_max_length(std::size_t chunk_size) {
     // to the server has space for the other fields.
     return 16 * 1000 * 1000 / chunk_size;
 }
+
+// The chunk prefix ends with the header of the "data" element: its type, key, binary length and
+// binary subtype.
+constexpr std::uint8_t k_data_header[] = {
+    0x05, 'd', 'a', 't', 'a', 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+
+// Offset of the "_id" ObjectId value: the document length, then the element type and key.
+constexpr std::size_t k_id_offset = 4 + 1 + sizeof("_id");
+
+// Builds the leading bytes of every chunks document of a file, in the order
+// {_id, files_id, n, data}, stopping right before the binary data.
+std::vector<std::uint8_t> make_chunk_prefix(bsoncxx::types::bson_value::view files_id) {
+    using bsoncxx::builder::basic::kvp;
+    using bsoncxx::builder::basic::make_document;
+
+    auto head = make_document(
+        kvp("_id", bsoncxx::oid{}), kvp("files_id", files_id), kvp("n", std::int32_t{0}));
+
+    // Everything but the terminator, followed by the "data" element header.
+    std::vector<std::uint8_t> prefix(head.view().data(),
+                                     head.view().data() + head.view().length() - 1);
+    prefix.insert(prefix.end(), std::begin(k_data_header), std::end(k_data_header));
+    return prefix;
+}
+
+void write_int32_le(std::uint8_t* dest, std::uint32_t value) {
+    dest[0] = static_cast<std::uint8_t>(value);
+    dest[1] = static_cast<std::uint8_t>(value >> 8);
+    dest[2] = static_cast<std::uint8_t>(value >> 16);
+    dest[3] = static_cast<std::uint8_t>(value >> 24);
+}
+
+// Content-defined chunks are looked up and inserted in batches of about this many bytes.
+constexpr std::size_t k_blob_batch_bytes = 8 * 1024 * 1024;
+
+// The manifest is stored in the files document, so it must leave room for the other fields.
+constexpr std::size_t k_max_manifest_size = 15 * 1024 * 1024;
+
+constexpr std::int32_t k_duplicate_key = 11000;
+
+// Whether every error of a failed unordered insert is a duplicate key error.
+bool only_duplicate_keys(const mongocxx::bulk_write_exception& e) {
+    if (!e.raw_server_error()) {
+        return false;
+    }
+
+    auto reply = e.raw_server_error()->view();
+    if (reply["writeConcernErrors"] && !reply["writeConcernErrors"].get_array().value.empty()) {
+        return false;
+    }
+
+    auto write_errors = reply["writeErrors"];
+    if (!write_errors || write_errors.get_array().value.empty()) {
+        return false;
+    }
+
+    for (auto&& error : write_errors.get_array().value) {
+        if (error["code"].get_int32().value != k_duplicate_key) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Makes the buffers of an inserted batch available for the following chunks.
+void recycle_buffers(std::vector<std::unique_ptr<std::uint8_t[]>>& free_buffers,
+                     mongocxx::gridfs::chunk_batch batch) {
+    for (auto&& buffer : batch.buffers) {
+        free_buffers.push_back(std::move(buffer));
+    }
+}
+
+// Inserts one batch of chunks with a client of its own, so that batches can be in flight
+// concurrently.
+mongocxx::gridfs::chunk_batch insert_chunks(mongocxx::pool* pool,
+                                            std::string database_name,
+                                            std::string collection_name,
+                                            mongocxx::write_concern write_concern,
+                                            mongocxx::gridfs::chunk_batch batch) {
+    auto client = pool->acquire();
+    auto chunks = (*client)[database_name][collection_name];
+    chunks.write_concern(std::move(write_concern));
+    chunks.insert_many(batch.documents);
+    return batch;
+}
 }  // namespace
 
 namespace mongocxx {
@@ -47,7 +152,13 @@ uploader::uploader(const client_session* session,
                    collection files,
                    collection chunks,
                    std::int32_t chunk_size,
-                   stdx::optional<bsoncxx::document::view_or_value> metadata)
+                   stdx::optional<bsoncxx::document::view_or_value> metadata,
+                   class pool* pool,
+                   stdx::string_view database_name,
+                   std::int32_t concurrency,
+                   std::shared_ptr<chunk_codec> codec,
+                   bool compute_checksum,
+                   stdx::optional<collection> blobs)
     : _impl{stdx::make_unique<impl>(session,
                                     id,
                                     filename,
@@ -56,7 +167,15 @@ uploader::uploader(const client_session* session,
                                     chunk_size,
                                     metadata ? stdx::make_optional<bsoncxx::document::value>(
                                                    bsoncxx::document::value{metadata->view()})
-                                             : stdx::nullopt)} {}
+                                             : stdx::nullopt,
+                                    pool,
+                                    database_name,
+                                    concurrency,
+                                    std::move(codec),
+                                    compute_checksum,
+                                    std::move(blobs))} {
+    _get_impl().chunk_prefix = make_chunk_prefix(_get_impl().result.id());
+}
 
 uploader::uploader() noexcept = default;
 uploader::uploader(uploader&&) noexcept = default;
@@ -72,16 +191,44 @@ void uploader::write(const std::uint8_t* bytes, std::size_t length) {
         throw logic_error{error_code::k_gridfs_stream_not_open};
     }
 
+    if (_get_impl().blobs) {
+        write_deduplicated(bytes, length);
+        return;
+    }
+
+    const std::size_t prefix_len = _get_impl().chunk_prefix.size();
+
     while (length > 0) {
         std::size_t buffer_free_space =
             static_cast<std::size_t>(_get_impl().chunk_size) - _get_impl().buffer_off;
 
         if (buffer_free_space == 0) {
             finish_chunk();
+            buffer_free_space = static_cast<std::size_t>(_get_impl().chunk_size);
+        }
+
+        // Without a codec, the user's bytes are copied only once, straight into the chunks
+        // document.
+        std::uint8_t* chunk_data;
+        if (_get_impl().codec) {
+            if (!_get_impl().raw_buffer) {
+                _get_impl().raw_buffer = stdx::make_unique<std::uint8_t[]>(
+                    static_cast<std::size_t>(_get_impl().chunk_size));
+            }
+            chunk_data = _get_impl().raw_buffer.get();
+        } else {
+            _get_impl().take_buffer();
+            chunk_data = &_get_impl().buffer.get()[prefix_len];
         }
 
         std::size_t length_written = std::min(length, buffer_free_space);
-        std::memcpy(&_get_impl().buffer.get()[_get_impl().buffer_off], bytes, length_written);
+        std::memcpy(&chunk_data[_get_impl().buffer_off], bytes, length_written);
+
+        // The checksum is computed while the bytes are still in cache from the copy.
+        if (_get_impl().compute_checksum) {
+            _get_impl().checksum = crc32c(_get_impl().checksum, bytes, length_written);
+        }
+
         bytes = &bytes[length_written];
         _get_impl().buffer_off += length_written;
         length -= length_written;
@@ -103,8 +250,15 @@ result::gridfs::upload uploader::close() {
                                   static_cast<std::int64_t>(_get_impl().chunk_size);
     std::int64_t leftover = static_cast<std::int64_t>(_get_impl().buffer_off);
 
-    finish_chunk();
-    flush_chunks();
+    if (_get_impl().blobs) {
+        finish_deduplicated_chunk();
+        flush_blobs();
+        bytes_uploaded = _get_impl().length;
+    } else {
+        finish_chunk();
+        flush_chunks();
+        wait_for_chunks();
+    }
 
     file.append(kvp("_id", _get_impl().result.id()));
     file.append(kvp("length", bytes_uploaded + leftover));
@@ -116,6 +270,22 @@ result::gridfs::upload uploader::close() {
         file.append(kvp("metadata", *_get_impl().metadata));
     }
 
+    if (_get_impl().codec) {
+        file.append(kvp("chunkCodec", _get_impl().codec->name()));
+    }
+
+    if (_get_impl().blobs) {
+        const auto& manifest = _get_impl().manifest;
+        file.append(kvp("manifest",
+                        bsoncxx::types::b_binary{bsoncxx::binary_sub_type::k_binary,
+                                                 static_cast<std::uint32_t>(manifest.size()),
+                                                 manifest.data()}));
+    }
+
+    if (_get_impl().compute_checksum) {
+        file.append(kvp("crc32c", static_cast<std::int64_t>(_get_impl().checksum)));
+    }
+
     if (_get_impl().session) {
         _get_impl().files.insert_one(*_get_impl().session, file.extract());
     } else {
@@ -132,6 +302,22 @@ void uploader::abort() {
 
     _get_impl().closed = true;
 
+    // Let in-flight inserts settle so that none of their chunks outlive the delete below. Their
+    // errors are irrelevant since the file is being discarded anyway.
+    try {
+        wait_for_chunks();
+    } catch (...) {
+    }
+
+    if (_get_impl().blobs) {
+        // Blobs still pending hold no references yet; the flushed ones give theirs back.
+        release_blobs(*_get_impl().blobs,
+                      _get_impl().session,
+                      _get_impl().manifest.data(),
+                      _get_impl().flushed_manifest_size);
+        return;
+    }
+
     bsoncxx::builder::basic::document filter;
     filter.append(bsoncxx::builder::basic::kvp("files_id", _get_impl().result.id()));
 
@@ -147,55 +333,314 @@ std::int32_t uploader::chunk_size() const {
 }
 
 void uploader::finish_chunk() {
-    using bsoncxx::builder::basic::kvp;
-
     if (!_get_impl().buffer_off) {
         return;
     }
 
-    bsoncxx::builder::basic::document chunk;
-
-    std::size_t bytes_in_chunk = _get_impl().buffer_off;
-
-    chunk.append(kvp("files_id", _get_impl().result.id()));
-    chunk.append(kvp("n", _get_impl().chunks_written));
-
     if (_get_impl().chunks_written == std::numeric_limits<std::int32_t>::max()) {
         throw gridfs_exception{error_code::k_gridfs_upload_requires_too_many_chunks};
     }
 
-    ++_get_impl().chunks_written;
+    const std::size_t prefix_len = _get_impl().chunk_prefix.size();
+    std::size_t data_len = _get_impl().buffer_off;
+
+    if (auto& codec = _get_impl().codec) {
+        _get_impl().take_buffer();
+        data_len = codec->compress(_get_impl().raw_buffer.get(),
+                                   _get_impl().buffer_off,
+                                   &_get_impl().buffer.get()[prefix_len]);
+    }
 
-    bsoncxx::types::b_binary data{bsoncxx::binary_sub_type::k_binary,
-                                  static_cast<std::uint32_t>(bytes_in_chunk),
-                                  _get_impl().buffer.get()};
+    // Patch the per-chunk fields of the prefix and terminate the document after the data.
+    const std::size_t doc_len = prefix_len + data_len + 1;
+    std::uint8_t* doc = _get_impl().buffer.get();
 
-    chunk.append(kvp("data", data));
-    _get_impl().chunks_collection_documents.push_back(chunk.extract());
+    bsoncxx::oid id;
+    std::memcpy(&doc[k_id_offset], id.bytes(), id.size());
+    write_int32_le(doc, static_cast<std::uint32_t>(doc_len));
+    write_int32_le(&doc[prefix_len - sizeof(k_data_header) - 4],
+                   static_cast<std::uint32_t>(_get_impl().chunks_written));
+    write_int32_le(&doc[prefix_len - 5], static_cast<std::uint32_t>(data_len));
+    doc[doc_len - 1] = 0x00;
+
+    ++_get_impl().chunks_written;
+
+    _get_impl().chunks_collection_documents.documents.emplace_back(doc, doc_len);
+    _get_impl().chunks_collection_documents.buffers.push_back(std::move(_get_impl().buffer));
+    _get_impl().buffer_off = 0;
 
     // To reduce the number of calls to the server, chunks are sent in batches rather than each one
     // being sent immediately upon being written.
-    if (_get_impl().chunks_collection_documents.size() >=
-        chunks_collection_documents_max_length(static_cast<std::size_t>(_get_impl().chunk_size))) {
+    if (_get_impl().chunks_collection_documents.documents.size() >=
+        chunks_collection_documents_max_length(_get_impl().data_capacity)) {
         flush_chunks();
     }
-
-    _get_impl().buffer_off = 0;
 }
 
 void uploader::flush_chunks() {
-    if (_get_impl().chunks_collection_documents.empty()) {
+    if (_get_impl().chunks_collection_documents.documents.empty()) {
+        return;
+    }
+
+    chunk_batch batch = std::move(_get_impl().chunks_collection_documents);
+    _get_impl().chunks_collection_documents = chunk_batch{};
+
+    if (auto pool = _get_impl().pool) {
+        auto& pending = _get_impl().pending_inserts;
+
+        // Waiting for the oldest batch bounds memory use and surfaces its error, if any.
+        if (pending.size() >= static_cast<std::size_t>(_get_impl().concurrency)) {
+            auto oldest = std::move(pending.front());
+            pending.pop_front();
+            recycle_buffers(_get_impl().free_buffers, oldest.get());
+        }
+
+        pending.push_back(std::async(std::launch::async,
+                                     insert_chunks,
+                                     pool,
+                                     _get_impl().database_name,
+                                     bsoncxx::string::to_string(_get_impl().chunks.name()),
+                                     _get_impl().chunks.write_concern(),
+                                     std::move(batch)));
         return;
     }
 
     if (_get_impl().session) {
-        _get_impl().chunks.insert_many(*_get_impl().session,
-                                       _get_impl().chunks_collection_documents);
+        _get_impl().chunks.insert_many(*_get_impl().session, batch.documents);
     } else {
-        _get_impl().chunks.insert_many(_get_impl().chunks_collection_documents);
+        _get_impl().chunks.insert_many(batch.documents);
+    }
+
+    recycle_buffers(_get_impl().free_buffers, std::move(batch));
+}
+
+void uploader::wait_for_chunks() {
+    auto& pending = _get_impl().pending_inserts;
+    std::exception_ptr error;
+
+    // Every batch is waited for, even after a failure, so that none is left running unobserved.
+    while (!pending.empty()) {
+        try {
+            recycle_buffers(_get_impl().free_buffers, pending.front().get());
+        } catch (...) {
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+        pending.pop_front();
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void uploader::write_deduplicated(const std::uint8_t* bytes, std::size_t length) {
+    auto& impl = _get_impl();
+
+    while (length > 0) {
+        bool cut;
+        std::size_t scanned = impl.chunker->scan(bytes, length, impl.blob_data.size(), &cut);
+
+        impl.blob_data.insert(impl.blob_data.end(), bytes, &bytes[scanned]);
+
+        if (impl.compute_checksum) {
+            impl.checksum = crc32c(impl.checksum, bytes, scanned);
+        }
+
+        bytes = &bytes[scanned];
+        length -= scanned;
+
+        if (cut) {
+            finish_deduplicated_chunk();
+        }
+    }
+}
+
+void uploader::finish_deduplicated_chunk() {
+    using bsoncxx::builder::basic::kvp;
+    using bsoncxx::builder::basic::make_document;
+
+    auto& impl = _get_impl();
+
+    if (impl.blob_data.empty()) {
+        return;
+    }
+
+    if (impl.manifest.size() + k_manifest_entry_size > k_max_manifest_size) {
+        throw gridfs_exception{error_code::k_gridfs_upload_requires_too_many_chunks};
+    }
+
+    // Compressed chunks are keyed by the codec as well, since their stored form differs.
+    sha256 hasher;
+    if (impl.codec) {
+        const std::string name = bsoncxx::string::to_string(impl.codec->name());
+        hasher.update(reinterpret_cast<const std::uint8_t*>(name.c_str()), name.size() + 1);
+    }
+    hasher.update(impl.blob_data.data(), impl.blob_data.size());
+    const sha256::digest digest = hasher.finish();
+
+    const std::size_t chunk_len = impl.blob_data.size();
+    impl.manifest.insert(impl.manifest.end(), digest.begin(), digest.end());
+    std::uint8_t length_le[4];
+    write_int32_le(length_le, static_cast<std::uint32_t>(chunk_len));
+    impl.manifest.insert(impl.manifest.end(), std::begin(length_le), std::end(length_le));
+    impl.length += static_cast<std::int64_t>(chunk_len);
+
+    // A chunk that occurs more than once in a batch is only sent once.
+    std::string key{reinterpret_cast<const char*>(digest.data()), digest.size()};
+    if (impl.pending_digests.insert(std::move(key)).second) {
+        const std::uint8_t* data = impl.blob_data.data();
+        std::size_t data_len = chunk_len;
+
+        if (auto& codec = impl.codec) {
+            impl.compressed_blob_data.resize(codec->max_compressed_size(chunk_len));
+            data = impl.compressed_blob_data.data();
+            data_len =
+                codec->compress(impl.blob_data.data(), chunk_len, &impl.compressed_blob_data[0]);
+        }
+
+        impl.pending_blobs.push_back(make_document(
+            kvp("_id",
+                bsoncxx::types::b_binary{
+                    bsoncxx::binary_sub_type::k_binary, sha256::digest_size, digest.data()}),
+            kvp("data",
+                bsoncxx::types::b_binary{bsoncxx::binary_sub_type::k_binary,
+                                         static_cast<std::uint32_t>(data_len),
+                                         data})));
+        impl.pending_blob_bytes += data_len;
+    }
+
+    impl.blob_data.clear();
+
+    if (impl.pending_blob_bytes >= k_blob_batch_bytes) {
+        flush_blobs();
+    }
+}
+
+void uploader::flush_blobs() {
+    using bsoncxx::builder::basic::kvp;
+    using bsoncxx::builder::basic::make_document;
+
+    auto& impl = _get_impl();
+    auto& blobs = *impl.blobs;
+
+    if (impl.pending_blobs.empty()) {
+        return;
+    }
+
+    // Only the chunks that are not stored yet are sent to the server.
+    bsoncxx::builder::basic::array digests;
+    for (auto&& blob : impl.pending_blobs) {
+        digests.append(blob.view()["_id"].get_value());
+    }
+
+    auto filter = make_document(kvp("_id", make_document(kvp("$in", digests.extract()))));
+    auto find_opts = options::find{}.projection(make_document(kvp("_id", 1)));
+    auto stored = impl.session ? blobs.find(*impl.session, filter.view(), find_opts)
+                               : blobs.find(filter.view(), find_opts);
+
+    std::unordered_set<std::string> stored_digests;
+    for (auto&& blob : stored) {
+        auto id = blob["_id"].get_binary();
+        stored_digests.emplace(reinterpret_cast<const char*>(id.bytes), id.size);
+    }
+
+    // Each blob gains a reference per manifest entry added since the last flush. Stored blobs
+    // only have their count raised, without sending their data again.
+    const auto refs = count_blob_refs(&impl.manifest[impl.flushed_manifest_size],
+                                      impl.manifest.size() - impl.flushed_manifest_size);
+
+    auto blob_write = [&](std::size_t i) {
+        auto blob = impl.pending_blobs[i].view();
+        auto id = blob["_id"].get_binary();
+        const std::string key{reinterpret_cast<const char*>(id.bytes), id.size};
+
+        auto increment = make_document(kvp("refs", refs.at(key)));
+        auto update =
+            stored_digests.count(key)
+                ? make_document(kvp("$inc", increment.view()))
+                : make_document(
+                      kvp("$setOnInsert", make_document(kvp("data", blob["data"].get_value()))),
+                      kvp("$inc", increment.view()));
+
+        model::update_one write{make_document(kvp("_id", id)), std::move(update)};
+        write.upsert(true);
+        return write;
+    };
+
+    // Indexes in `pending_blobs` of the blobs created by this flush.
+    std::vector<std::size_t> created;
+    std::vector<std::size_t> writes(impl.pending_blobs.size());
+    for (std::size_t i = 0; i < writes.size(); ++i) {
+        writes[i] = i;
+    }
+
+    for (bool retried = false; !writes.empty(); retried = true) {
+        auto bulk_opts = options::bulk_write{}.ordered(false);
+        auto bulk = impl.session ? blobs.create_bulk_write(*impl.session, bulk_opts)
+                                 : blobs.create_bulk_write(bulk_opts);
+        for (auto i : writes) {
+            bulk.append(blob_write(i));
+        }
+
+        try {
+            auto result = bulk.execute();
+            if (result) {
+                for (auto&& upserted : result->upserted_ids()) {
+                    created.push_back(writes[upserted.first]);
+                }
+            }
+            writes.clear();
+        } catch (const bulk_write_exception& e) {
+            // Two uploads creating the same blob at once may fail with a duplicate key error, in
+            // which case the blob exists now and the write is retried once to add to its count.
+            if (retried || !only_duplicate_keys(e)) {
+                throw;
+            }
+
+            auto reply = e.raw_server_error()->view();
+            if (reply["upserted"]) {
+                for (auto&& upserted : reply["upserted"].get_array().value) {
+                    created.push_back(writes[upserted["index"].get_int32().value]);
+                }
+            }
+
+            std::vector<std::size_t> failed;
+            for (auto&& error : reply["writeErrors"].get_array().value) {
+                failed.push_back(writes[error["index"].get_int32().value]);
+            }
+            writes = std::move(failed);
+        }
+    }
+
+    // A blob that was found stored but was released by another file before its count was raised
+    // has been created again without its data, which is sent now.
+    stdx::optional<bulk_write> restore;
+    for (auto i : created) {
+        auto blob = impl.pending_blobs[i].view();
+        auto id = blob["_id"].get_binary();
+        if (!stored_digests.count(std::string{reinterpret_cast<const char*>(id.bytes), id.size})) {
+            continue;
+        }
+
+        if (!restore) {
+            restore = impl.session ? blobs.create_bulk_write(*impl.session)
+                                   : blobs.create_bulk_write();
+        }
+        restore->append(model::update_one{
+            make_document(kvp("_id", id)),
+            make_document(kvp("$set", make_document(kvp("data", blob["data"].get_value()))))});
+    }
+
+    if (restore) {
+        restore->execute();
     }
 
-    _get_impl().chunks_collection_documents.clear();
+    impl.flushed_manifest_size = impl.manifest.size();
+    impl.pending_blobs.clear();
+    impl.pending_digests.clear();
+    impl.pending_blob_bytes = 0;
 }
 
 const uploader::impl& uploader::_get_impl() const {
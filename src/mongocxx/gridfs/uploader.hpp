@@ -32,8 +32,13 @@
 
 namespace mongocxx {
 MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+class pool;
+
 namespace gridfs {
 
+class chunk_codec;
+
 ///
 /// Class used to upload a GridFS file.
 ///
@@ -91,7 +96,8 @@ class MONGOCXX_API uploader {
     void write(const std::uint8_t* bytes, std::size_t length);
 
     ///
-    /// Closes the uploader stream.
+    /// Closes the uploader stream. If chunks are being inserted through a pool, this waits for all
+    /// of them to be acknowledged before the files collection document is written.
     ///
     /// @throws mongocxx::logic_error if the upload stream was already closed.
     ///
@@ -146,16 +152,46 @@ class MONGOCXX_API uploader {
     // @param metadata
     //   Optional metadata field of the files collection document.
     //
+    // @param pool
+    //   The pool to insert chunks from in the background, or nullptr to insert them with `chunks`.
+    //
+    // @param database_name
+    //   The name of the database holding the bucket, used to reach it through the pool.
+    //
+    // @param concurrency
+    //   The maximum number of chunk batches being inserted through the pool at once.
+    //
+    // @param codec
+    //   The codec to compress each chunk with, or null to store the chunks uncompressed.
+    //
+    // @param compute_checksum
+    //   Whether to store a CRC-32C checksum of the contents in the files document.
+    //
+    // @param blobs
+    //   The collection to store content-defined chunks in, keyed by their SHA-256 digest, or
+    //   nothing to store fixed-size chunks in `chunks`.
+    //
     MONGOCXX_PRIVATE uploader(const client_session* session,
                               bsoncxx::types::bson_value::view id,
                               stdx::string_view filename,
                               collection files,
                               collection chunks,
                               std::int32_t chunk_size,
-                              stdx::optional<bsoncxx::document::view_or_value> metadata = {});
+                              stdx::optional<bsoncxx::document::view_or_value> metadata = {},
+                              pool* pool = nullptr,
+                              stdx::string_view database_name = {},
+                              std::int32_t concurrency = 1,
+                              std::shared_ptr<chunk_codec> codec = {},
+                              bool compute_checksum = false,
+                              stdx::optional<collection> blobs = {});
 
     MONGOCXX_PRIVATE void finish_chunk();
     MONGOCXX_PRIVATE void flush_chunks();
+    MONGOCXX_PRIVATE void wait_for_chunks();
+
+    MONGOCXX_PRIVATE void write_deduplicated(const std::uint8_t* bytes, std::size_t length);
+    MONGOCXX_PRIVATE void finish_deduplicated_chunk();
+    MONGOCXX_PRIVATE void flush_blobs();
 
     class MONGOCXX_PRIVATE impl;
 
@@ -0,0 +1,119 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <mongocxx/gridfs/zlib_chunk_codec.hpp>
+
+#include <limits>
+#include <new>
+
+#include <mongocxx/exception/error_code.hpp>
+#include <mongocxx/exception/exception.hpp>
+#include <mongocxx/exception/gridfs_exception.hpp>
+#include <mongocxx/exception/logic_error.hpp>
+
+#include <mongocxx/config/private/prelude.hh>
+
+#if defined(MONGOCXX_ENABLE_ZLIB_CHUNK_CODEC)
+#include <zlib.h>
+#endif
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace gridfs {
+
+zlib_chunk_codec::zlib_chunk_codec(std::int32_t level) : _level{level} {
+    if (level < -1 || level > 9) {
+        throw logic_error{error_code::k_invalid_parameter,
+                          "zlib compression level must be between -1 and 9"};
+    }
+
+#if !defined(MONGOCXX_ENABLE_ZLIB_CHUNK_CODEC)
+    throw exception{error_code::k_zlib_not_supported};
+#endif
+}
+
+zlib_chunk_codec::~zlib_chunk_codec() = default;
+
+stdx::string_view zlib_chunk_codec::name() const {
+    return "zlib";
+}
+
+#if defined(MONGOCXX_ENABLE_ZLIB_CHUNK_CODEC)
+namespace {
+
+// zlib measures buffers in uLong, which is 32 bits wide on some platforms. Chunks are far smaller
+// than that, but a length that does not fit is rejected rather than truncated.
+uLong checked_length(std::size_t length) {
+    if (length > std::numeric_limits<uLong>::max()) {
+        throw logic_error{error_code::k_invalid_parameter, "chunk too large for zlib"};
+    }
+    return static_cast<uLong>(length);
+}
+
+}  // namespace
+
+std::size_t zlib_chunk_codec::max_compressed_size(std::size_t length) const {
+    return static_cast<std::size_t>(::compressBound(checked_length(length)));
+}
+
+std::size_t zlib_chunk_codec::compress(const std::uint8_t* data,
+                                       std::size_t length,
+                                       std::uint8_t* out) const {
+    uLongf out_length = ::compressBound(checked_length(length));
+    const int result = ::compress2(out, &out_length, data, checked_length(length), _level);
+
+    // The output buffer is compressBound() bytes long, so only running out of memory can fail.
+    if (result != Z_OK) {
+        throw std::bad_alloc{};
+    }
+    return static_cast<std::size_t>(out_length);
+}
+
+std::size_t zlib_chunk_codec::decompress(const std::uint8_t* data,
+                                         std::size_t length,
+                                         std::uint8_t* out,
+                                         std::size_t capacity) const {
+    uLongf out_length = checked_length(capacity);
+    const int result = ::uncompress(out, &out_length, data, checked_length(length));
+
+    if (result == Z_MEM_ERROR) {
+        throw std::bad_alloc{};
+    }
+    if (result != Z_OK) {
+        throw gridfs_exception{error_code::k_gridfs_file_corrupted,
+                               "chunk is not a zlib stream of at most the chunk size"};
+    }
+    return static_cast<std::size_t>(out_length);
+}
+#else
+// The constructor throws, so these are never reached.
+std::size_t zlib_chunk_codec::max_compressed_size(std::size_t) const {
+    throw exception{error_code::k_zlib_not_supported};
+}
+
+std::size_t zlib_chunk_codec::compress(const std::uint8_t*, std::size_t, std::uint8_t*) const {
+    throw exception{error_code::k_zlib_not_supported};
+}
+
+std::size_t zlib_chunk_codec::decompress(const std::uint8_t*,
+                                         std::size_t,
+                                         std::uint8_t*,
+                                         std::size_t) const {
+    throw exception{error_code::k_zlib_not_supported};
+}
+#endif
+
+}  // namespace gridfs
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
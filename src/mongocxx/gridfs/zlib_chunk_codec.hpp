@@ -0,0 +1,78 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <mongocxx/gridfs/chunk_codec.hpp>
+
+#include <mongocxx/config/prelude.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace gridfs {
+
+///
+/// A chunk_codec that compresses GridFS chunks with zlib. Its name is "zlib".
+///
+/// The codec is only available when the driver is built with the CMake option
+/// MONGOCXX_ENABLE_ZLIB_CHUNK_CODEC, which links the driver against zlib.
+///
+class MONGOCXX_API zlib_chunk_codec : public chunk_codec {
+   public:
+    ///
+    /// Constructs a zlib codec.
+    ///
+    /// @param level
+    ///   The zlib compression level, from 0 (no compression) to 9 (best compression), or -1 for
+    ///   zlib's default.
+    ///
+    /// @throws mongocxx::logic_error if the level is out of range.
+    ///
+    /// @throws mongocxx::exception with error_code::k_zlib_not_supported if the driver was built
+    ///   without zlib support.
+    ///
+    explicit zlib_chunk_codec(std::int32_t level = -1);
+
+    ~zlib_chunk_codec() override;
+
+    stdx::string_view name() const override;
+
+    std::size_t max_compressed_size(std::size_t length) const override;
+
+    std::size_t compress(const std::uint8_t* data,
+                         std::size_t length,
+                         std::uint8_t* out) const override;
+
+    ///
+    /// @throws mongocxx::gridfs_exception
+    ///   with error_code::k_gridfs_file_corrupted if `data` is not a zlib stream that decompresses
+    ///   into `capacity` bytes.
+    ///
+    std::size_t decompress(const std::uint8_t* data,
+                           std::size_t length,
+                           std::uint8_t* out,
+                           std::size_t capacity) const override;
+
+   private:
+    std::int32_t _level;
+};
+
+}  // namespace gridfs
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/postlude.hpp>
@@ -0,0 +1,44 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <mongocxx/options/arrow_export.hpp>
+
+#include <mongocxx/config/private/prelude.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace options {
+
+arrow_export& arrow_export::batch_size(std::int32_t batch_size) {
+    _batch_size = batch_size;
+    return *this;
+}
+
+const stdx::optional<std::int32_t>& arrow_export::batch_size() const {
+    return _batch_size;
+}
+
+arrow_export& arrow_export::threads(std::int32_t threads) {
+    _threads = threads;
+    return *this;
+}
+
+const stdx::optional<std::int32_t>& arrow_export::threads() const {
+    return _threads;
+}
+
+}  // namespace options
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
@@ -0,0 +1,89 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <cstdint>
+
+#include <bsoncxx/stdx/optional.hpp>
+#include <mongocxx/stdx.hpp>
+
+#include <mongocxx/config/prelude.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace options {
+
+///
+/// Class representing the optional arguments to a mongocxx::arrow_exporter.
+///
+class MONGOCXX_API arrow_export {
+   public:
+    ///
+    /// Sets the maximum number of documents in each exported record batch.
+    ///
+    /// If unset, batches hold up to 65536 documents.
+    ///
+    /// @param batch_size
+    ///   The maximum number of rows per batch. Must be positive.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called. This facilitates
+    ///   method chaining.
+    ///
+    arrow_export& batch_size(std::int32_t batch_size);
+
+    ///
+    /// Gets the current maximum number of documents in each record batch.
+    ///
+    /// @return
+    ///   The current maximum number of rows per batch.
+    ///
+    const stdx::optional<std::int32_t>& batch_size() const;
+
+    ///
+    /// Sets the number of threads that fill the columns of each batch. The top-level fields of the
+    /// schema are divided between the threads. The calling thread is one of them; the others are
+    /// started with the first batch and kept until the arrow_exporter is destroyed.
+    ///
+    /// If unset, the columns are filled on the calling thread, walking each document once.
+    ///
+    /// @param threads
+    ///   The number of threads. Must be positive.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called. This facilitates
+    ///   method chaining.
+    ///
+    arrow_export& threads(std::int32_t threads);
+
+    ///
+    /// Gets the current number of threads that fill the columns of each batch.
+    ///
+    /// @return
+    ///   The current number of threads.
+    ///
+    const stdx::optional<std::int32_t>& threads() const;
+
+   private:
+    stdx::optional<std::int32_t> _batch_size;
+    stdx::optional<std::int32_t> _threads;
+};
+
+}  // namespace options
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/postlude.hpp>
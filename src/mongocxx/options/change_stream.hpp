@@ -26,6 +26,7 @@
 namespace mongocxx {
 MONGOCXX_INLINE_NAMESPACE_BEGIN
 
+class checkpointed_change_stream;
 class client;
 class collection;
 class database;
@@ -194,6 +195,7 @@ class MONGOCXX_API change_stream {
     change_stream& start_at_operation_time(bsoncxx::types::b_timestamp timestamp);
 
    private:
+    friend class ::mongocxx::checkpointed_change_stream;
     friend class ::mongocxx::client;
     friend class ::mongocxx::collection;
     friend class ::mongocxx::database;
@@ -0,0 +1,55 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <mongocxx/options/change_stream_dispatcher.hpp>
+
+#include <mongocxx/config/private/prelude.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace options {
+
+change_stream_dispatcher& change_stream_dispatcher::worker_count(std::int32_t worker_count) {
+    _worker_count = worker_count;
+    return *this;
+}
+
+const stdx::optional<std::int32_t>& change_stream_dispatcher::worker_count() const {
+    return _worker_count;
+}
+
+change_stream_dispatcher& change_stream_dispatcher::max_pending_events(
+    std::int32_t max_pending_events) {
+    _max_pending_events = max_pending_events;
+    return *this;
+}
+
+const stdx::optional<std::int32_t>& change_stream_dispatcher::max_pending_events() const {
+    return _max_pending_events;
+}
+
+change_stream_dispatcher& change_stream_dispatcher::key_extractor(
+    key_extractor_type key_extractor) {
+    _key_extractor = std::move(key_extractor);
+    return *this;
+}
+
+const change_stream_dispatcher::key_extractor_type& change_stream_dispatcher::key_extractor()
+    const {
+    return _key_extractor;
+}
+
+}  // namespace options
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
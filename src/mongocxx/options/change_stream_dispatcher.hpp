@@ -0,0 +1,124 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+#include <bsoncxx/document/element.hpp>
+#include <bsoncxx/document/view.hpp>
+#include <bsoncxx/stdx/optional.hpp>
+#include <mongocxx/stdx.hpp>
+
+#include <mongocxx/config/prelude.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace options {
+
+///
+/// Class representing the optional arguments to a mongocxx::change_stream_dispatcher.
+///
+class MONGOCXX_API change_stream_dispatcher {
+   public:
+    ///
+    /// The type of a function that selects the partitioning key of a change event.
+    ///
+    using key_extractor_type =
+        std::function<bsoncxx::document::element(const bsoncxx::document::view&)>;
+
+    ///
+    /// Sets the number of worker threads that events are dispatched to.
+    ///
+    /// If unset, the number of hardware threads reported by the platform is used.
+    ///
+    /// @param worker_count
+    ///   The number of worker threads. Must be positive.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called. This facilitates
+    ///   method chaining.
+    ///
+    change_stream_dispatcher& worker_count(std::int32_t worker_count);
+
+    ///
+    /// Gets the current number of worker threads.
+    ///
+    /// @return
+    ///   The current number of worker threads.
+    ///
+    const stdx::optional<std::int32_t>& worker_count() const;
+
+    ///
+    /// Sets the maximum number of events that may be read from the change stream but not yet
+    /// handled. Once this limit is reached, mongocxx::change_stream_dispatcher::dispatch blocks
+    /// until a worker finishes an event.
+    ///
+    /// If unset, a limit of 1024 events is used.
+    ///
+    /// @param max_pending_events
+    ///   The maximum number of in-flight events. Must be positive.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called. This facilitates
+    ///   method chaining.
+    ///
+    change_stream_dispatcher& max_pending_events(std::int32_t max_pending_events);
+
+    ///
+    /// Gets the current maximum number of in-flight events.
+    ///
+    /// @return
+    ///   The current maximum number of in-flight events.
+    ///
+    const stdx::optional<std::int32_t>& max_pending_events() const;
+
+    ///
+    /// Sets the function used to select the partitioning key of each change event. Events whose
+    /// keys have equal BSON values are always handled by the same worker, in stream order.
+    ///
+    /// The returned element must point into the event passed to the function. An unset element
+    /// routes the event to the first worker.
+    ///
+    /// If unset, the "documentKey" field of the event is used.
+    ///
+    /// @param key_extractor
+    ///   The key extractor function.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called. This facilitates
+    ///   method chaining.
+    ///
+    change_stream_dispatcher& key_extractor(key_extractor_type key_extractor);
+
+    ///
+    /// Gets the current key extractor function.
+    ///
+    /// @return
+    ///   The current key extractor function.
+    ///
+    const key_extractor_type& key_extractor() const;
+
+   private:
+    stdx::optional<std::int32_t> _worker_count;
+    stdx::optional<std::int32_t> _max_pending_events;
+    key_extractor_type _key_extractor;
+};
+
+}  // namespace options
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/postlude.hpp>
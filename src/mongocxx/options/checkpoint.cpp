@@ -0,0 +1,43 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <mongocxx/options/checkpoint.hpp>
+
+#include <mongocxx/config/private/prelude.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace options {
+
+checkpoint& checkpoint::event_interval(std::int32_t event_interval) {
+    _event_interval = event_interval;
+    return *this;
+}
+
+const stdx::optional<std::int32_t>& checkpoint::event_interval() const {
+    return _event_interval;
+}
+
+checkpoint& checkpoint::time_interval(std::chrono::milliseconds time_interval) {
+    _time_interval = time_interval;
+    return *this;
+}
+
+const stdx::optional<std::chrono::milliseconds>& checkpoint::time_interval() const {
+    return _time_interval;
+}
+
+}  // namespace options
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
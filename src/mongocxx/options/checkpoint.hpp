@@ -0,0 +1,90 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include <bsoncxx/stdx/optional.hpp>
+#include <mongocxx/stdx.hpp>
+
+#include <mongocxx/config/prelude.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace options {
+
+///
+/// Class representing how often a mongocxx::checkpointed_change_stream persists its resume token.
+///
+/// A checkpoint is written as soon as either interval has elapsed since the previous checkpoint.
+///
+class MONGOCXX_API checkpoint {
+   public:
+    ///
+    /// Sets the number of acknowledged events after which a checkpoint is written.
+    ///
+    /// If unset, a checkpoint is written every 1000 events.
+    ///
+    /// @param event_interval
+    ///   The number of events between checkpoints. Must be positive.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called. This facilitates
+    ///   method chaining.
+    ///
+    checkpoint& event_interval(std::int32_t event_interval);
+
+    ///
+    /// Gets the current number of events between checkpoints.
+    ///
+    /// @return
+    ///   The current number of events between checkpoints.
+    ///
+    const stdx::optional<std::int32_t>& event_interval() const;
+
+    ///
+    /// Sets the amount of time after which an acknowledged event causes a checkpoint to be written,
+    /// regardless of how many events have been acknowledged since the previous checkpoint.
+    ///
+    /// If unset, a checkpoint is written at least every second while events are acknowledged.
+    ///
+    /// @param time_interval
+    ///   The time between checkpoints. Must be positive.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called. This facilitates
+    ///   method chaining.
+    ///
+    checkpoint& time_interval(std::chrono::milliseconds time_interval);
+
+    ///
+    /// Gets the current time between checkpoints.
+    ///
+    /// @return
+    ///   The current time between checkpoints.
+    ///
+    const stdx::optional<std::chrono::milliseconds>& time_interval() const;
+
+   private:
+    stdx::optional<std::int32_t> _event_interval;
+    stdx::optional<std::chrono::milliseconds> _time_interval;
+};
+
+}  // namespace options
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/postlude.hpp>
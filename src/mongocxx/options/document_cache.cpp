@@ -0,0 +1,62 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <mongocxx/options/document_cache.hpp>
+
+#include <mongocxx/config/private/prelude.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace options {
+
+document_cache& document_cache::max_bytes(std::int64_t max_bytes) {
+    _max_bytes = max_bytes;
+    return *this;
+}
+
+const stdx::optional<std::int64_t>& document_cache::max_bytes() const {
+    return _max_bytes;
+}
+
+document_cache& document_cache::shard_count(std::int32_t shard_count) {
+    _shard_count = shard_count;
+    return *this;
+}
+
+const stdx::optional<std::int32_t>& document_cache::shard_count() const {
+    return _shard_count;
+}
+
+document_cache& document_cache::watch(bool watch) {
+    _watch = watch;
+    return *this;
+}
+
+const stdx::optional<bool>& document_cache::watch() const {
+    return _watch;
+}
+
+document_cache& document_cache::max_await_time(std::chrono::milliseconds max_await_time) {
+    _max_await_time = max_await_time;
+    return *this;
+}
+
+const stdx::optional<std::chrono::milliseconds>& document_cache::max_await_time() const {
+    return _max_await_time;
+}
+
+}  // namespace options
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
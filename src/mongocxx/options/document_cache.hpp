@@ -0,0 +1,144 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include <bsoncxx/stdx/optional.hpp>
+#include <mongocxx/stdx.hpp>
+
+#include <mongocxx/config/prelude.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace options {
+
+///
+/// Class representing the optional arguments to a mongocxx::document_cache.
+///
+class MONGOCXX_API document_cache {
+   public:
+    ///
+    /// Sets the maximum number of bytes the cache may use for its entries, counting each entry's
+    /// document, filter and bookkeeping. The least recently used entries are evicted to stay
+    /// within the limit.
+    ///
+    /// If unset, a limit of 64 MiB is used.
+    ///
+    /// @param max_bytes
+    ///   The maximum size of the cache in bytes. Must be positive.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called. This facilitates
+    ///   method chaining.
+    ///
+    document_cache& max_bytes(std::int64_t max_bytes);
+
+    ///
+    /// Gets the current maximum size of the cache.
+    ///
+    /// @return
+    ///   The current maximum size of the cache in bytes.
+    ///
+    const stdx::optional<std::int64_t>& max_bytes() const;
+
+    ///
+    /// Sets the number of shards the cache is split into. Each shard has its own lock and its own
+    /// share of the memory limit, so more shards let more threads read the cache at once.
+    ///
+    /// If unset, 16 shards are used.
+    ///
+    /// @param shard_count
+    ///   The number of shards. Must be positive.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called. This facilitates
+    ///   method chaining.
+    ///
+    document_cache& shard_count(std::int32_t shard_count);
+
+    ///
+    /// Gets the current number of shards.
+    ///
+    /// @return
+    ///   The current number of shards.
+    ///
+    const stdx::optional<std::int32_t>& shard_count() const;
+
+    ///
+    /// Sets whether the cache watches its collection with a change stream on a background thread
+    /// and invalidates entries as changes arrive.
+    ///
+    /// When false, the application must pass every change event for the collection to
+    /// mongocxx::document_cache::invalidate, for instance from a change_stream_dispatcher it
+    /// already runs. Those events must include the full document of updates for the cache to
+    /// keep entries that an update cannot affect.
+    ///
+    /// If unset, the cache watches its collection.
+    ///
+    /// @param watch
+    ///   Whether to watch the collection.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called. This facilitates
+    ///   method chaining.
+    ///
+    document_cache& watch(bool watch);
+
+    ///
+    /// Gets whether the cache watches its collection.
+    ///
+    /// @return
+    ///   Whether the cache watches its collection.
+    ///
+    const stdx::optional<bool>& watch() const;
+
+    ///
+    /// Sets the maximum time the background change stream waits for new changes. This bounds how
+    /// long destroying the cache waits for its background thread to stop.
+    ///
+    /// If unset, one second is used.
+    ///
+    /// @param max_await_time
+    ///   The maximum time to wait for new changes. Must be positive.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called. This facilitates
+    ///   method chaining.
+    ///
+    document_cache& max_await_time(std::chrono::milliseconds max_await_time);
+
+    ///
+    /// Gets the current maximum time to wait for new changes.
+    ///
+    /// @return
+    ///   The current maximum time to wait for new changes.
+    ///
+    const stdx::optional<std::chrono::milliseconds>& max_await_time() const;
+
+   private:
+    stdx::optional<std::int64_t> _max_bytes;
+    stdx::optional<std::int32_t> _shard_count;
+    stdx::optional<bool> _watch;
+    stdx::optional<std::chrono::milliseconds> _max_await_time;
+};
+
+}  // namespace options
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/postlude.hpp>
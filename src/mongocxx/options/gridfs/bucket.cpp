@@ -72,6 +72,24 @@ const stdx::optional<class write_concern>& bucket::write_concern() const {
     return _write_concern;
 }
 
+bucket& bucket::chunk_codec(std::shared_ptr<mongocxx::gridfs::chunk_codec> chunk_codec) {
+    _chunk_codec = std::move(chunk_codec);
+    return *this;
+}
+
+const std::shared_ptr<mongocxx::gridfs::chunk_codec>& bucket::chunk_codec() const {
+    return _chunk_codec;
+}
+
+bucket& bucket::deduplicate(bool deduplicate) {
+    _deduplicate = deduplicate;
+    return *this;
+}
+
+const stdx::optional<bool>& bucket::deduplicate() const {
+    return _deduplicate;
+}
+
 }  // namespace gridfs
 }  // namespace options
 MONGOCXX_INLINE_NAMESPACE_END
@@ -14,9 +14,11 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 
 #include <bsoncxx/stdx/optional.hpp>
+#include <mongocxx/gridfs/chunk_codec.hpp>
 #include <mongocxx/read_concern.hpp>
 #include <mongocxx/read_preference.hpp>
 #include <mongocxx/stdx.hpp>
@@ -144,12 +146,69 @@ class MONGOCXX_API bucket {
     ///
     const stdx::optional<class write_concern>& write_concern() const;
 
+    ///
+    /// Sets the codec with which the chunks of files uploaded through the bucket are compressed,
+    /// and with which compressed files are decompressed when downloaded. By default, chunks are
+    /// stored uncompressed, and downloading a compressed file fails.
+    ///
+    /// @param chunk_codec
+    ///   The codec to compress chunks with.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called. This facilitates
+    ///   method chaining.
+    ///
+    /// @see mongocxx::gridfs::chunk_codec
+    ///
+    bucket& chunk_codec(std::shared_ptr<mongocxx::gridfs::chunk_codec> chunk_codec);
+
+    ///
+    /// Gets the codec with which chunks are compressed.
+    ///
+    /// @return
+    ///   The codec, or a null pointer if chunks are stored uncompressed.
+    ///
+    const std::shared_ptr<mongocxx::gridfs::chunk_codec>& chunk_codec() const;
+
+    ///
+    /// Sets whether files uploaded through the bucket are deduplicated. Defaults to false.
+    ///
+    /// A deduplicated file is cut into chunks at boundaries chosen from its contents, averaging the
+    /// upload's chunk size. Each distinct chunk is stored once, keyed by its SHA-256 digest, in the
+    /// "<bucket name>.blobs" collection, and the files document lists the file's chunks in a
+    /// "manifest" field. Uploading a file that shares most of its contents with a stored one, even
+    /// at shifted offsets, only stores the chunks that differ.
+    ///
+    /// Deduplicated files can be downloaded by any bucket of the same name. Each stored chunk counts
+    /// the manifest entries that refer to it in a "refs" field; deleting a file or aborting an
+    /// upload decrements the counts and removes the chunks no other file refers to. Deduplicated
+    /// uploads cannot be combined with options::gridfs::upload::pool().
+    ///
+    /// @param deduplicate
+    ///   Whether to deduplicate uploaded files.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called. This facilitates
+    ///   method chaining.
+    ///
+    bucket& deduplicate(bool deduplicate);
+
+    ///
+    /// Gets whether files uploaded through the bucket are deduplicated.
+    ///
+    /// @return
+    ///   Whether files are deduplicated.
+    ///
+    const stdx::optional<bool>& deduplicate() const;
+
    private:
     stdx::optional<std::string> _bucket_name;
     stdx::optional<std::int32_t> _chunk_size_bytes;
     stdx::optional<class read_concern> _read_concern;
     stdx::optional<class read_preference> _read_preference;
     stdx::optional<class write_concern> _write_concern;
+    std::shared_ptr<mongocxx::gridfs::chunk_codec> _chunk_codec;
+    stdx::optional<bool> _deduplicate;
 };
 
 }  // namespace gridfs
@@ -0,0 +1,63 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <mongocxx/options/gridfs/download.hpp>
+
+#include <mongocxx/config/private/prelude.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace options {
+namespace gridfs {
+
+download& download::pool(mongocxx::pool* pool) {
+    _pool = pool;
+    return *this;
+}
+
+const stdx::optional<mongocxx::pool*>& download::pool() const {
+    return _pool;
+}
+
+download& download::prefetch_chunks(std::int32_t prefetch_chunks) {
+    _prefetch_chunks = prefetch_chunks;
+    return *this;
+}
+
+const stdx::optional<std::int32_t>& download::prefetch_chunks() const {
+    return _prefetch_chunks;
+}
+
+download& download::concurrency(std::int32_t concurrency) {
+    _concurrency = concurrency;
+    return *this;
+}
+
+const stdx::optional<std::int32_t>& download::concurrency() const {
+    return _concurrency;
+}
+
+download& download::verify_checksum(bool verify_checksum) {
+    _verify_checksum = verify_checksum;
+    return *this;
+}
+
+const stdx::optional<bool>& download::verify_checksum() const {
+    return _verify_checksum;
+}
+
+}  // namespace gridfs
+}  // namespace options
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
@@ -0,0 +1,148 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+
+#include <bsoncxx/stdx/optional.hpp>
+#include <mongocxx/stdx.hpp>
+
+#include <mongocxx/config/prelude.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+class pool;
+
+namespace options {
+namespace gridfs {
+
+///
+/// Class representing the optional arguments to a MongoDB GridFS download operation.
+///
+class MONGOCXX_API download {
+   public:
+    ///
+    /// Sets a pool from which the downloader acquires a client to read chunks ahead of the caller.
+    ///
+    /// Without a pool, each chunk is fetched from the bucket's own collection when the previous
+    /// one has been consumed, so the caller waits on every getMore. With a pool, a background
+    /// thread reads up to prefetch_chunks() chunks ahead on a client of its own while the caller
+    /// consumes the current one.
+    ///
+    /// The pool must connect to the same deployment as the bucket and must outlive the download.
+    /// A pool cannot be combined with a client_session, since a session is bound to one client.
+    ///
+    /// @param pool
+    ///   The pool to acquire a client from.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called. This facilitates
+    ///   method chaining.
+    ///
+    download& pool(mongocxx::pool* pool);
+
+    ///
+    /// Gets the pool used to read chunks ahead.
+    ///
+    /// @return
+    ///   An optional pointer to the pool.
+    ///
+    const stdx::optional<mongocxx::pool*>& pool() const;
+
+    ///
+    /// Sets the maximum number of chunks that are read ahead of the caller when a pool is set.
+    /// Defaults to 4. Requires a pool.
+    ///
+    /// @param prefetch_chunks
+    ///   The number of chunks to keep buffered.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called. This facilitates
+    ///   method chaining.
+    ///
+    download& prefetch_chunks(std::int32_t prefetch_chunks);
+
+    ///
+    /// Gets the maximum number of chunks that are read ahead of the caller.
+    ///
+    /// @return
+    ///   The number of chunks to keep buffered.
+    ///
+    const stdx::optional<std::int32_t>& prefetch_chunks() const;
+
+    ///
+    /// Sets the number of threads that fill the destination concurrently in
+    /// gridfs::bucket::download_to_file(). Each thread reads a contiguous run of chunks on a
+    /// client acquired from pool(). Defaults to 1. Values greater than 1 require a pool, and are
+    /// ignored by the stream-based download functions.
+    ///
+    /// @param concurrency
+    ///   The number of threads filling the destination file.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called. This facilitates
+    ///   method chaining.
+    ///
+    download& concurrency(std::int32_t concurrency);
+
+    ///
+    /// Gets the number of threads that fill the destination file concurrently.
+    ///
+    /// @return
+    ///   The number of threads filling the destination file.
+    ///
+    const stdx::optional<std::int32_t>& concurrency() const;
+
+    ///
+    /// Sets whether the contents of the file are checked against the CRC-32C checksum stored by
+    /// options::gridfs::upload::compute_checksum(). Defaults to false.
+    ///
+    /// The checksum is computed as the chunks are read in order, and gridfs::downloader::close()
+    /// compares it provided that every chunk of the file has been read. A download closed early,
+    /// or that skipped chunks with gridfs::downloader::seek() and never went back to read them, is
+    /// not checked and does not fail. gridfs::downloader::checksum_verified() reports whether the
+    /// check took place. Only whole-file downloads can be verified.
+    ///
+    /// @param verify_checksum
+    ///   Whether to verify the checksum.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called. This facilitates
+    ///   method chaining.
+    ///
+    download& verify_checksum(bool verify_checksum);
+
+    ///
+    /// Gets whether the contents of the file are checked against the stored checksum.
+    ///
+    /// @return
+    ///   Whether to verify the checksum.
+    ///
+    const stdx::optional<bool>& verify_checksum() const;
+
+   private:
+    stdx::optional<mongocxx::pool*> _pool;
+    stdx::optional<std::int32_t> _prefetch_chunks;
+    stdx::optional<std::int32_t> _concurrency;
+    stdx::optional<bool> _verify_checksum;
+};
+
+}  // namespace gridfs
+}  // namespace options
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/postlude.hpp>
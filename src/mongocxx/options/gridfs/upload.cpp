@@ -41,6 +41,33 @@ const stdx::optional<bsoncxx::document::view_or_value>& upload::metadata() const
     return _metadata;
 }
 
+upload& upload::pool(mongocxx::pool* pool) {
+    _pool = pool;
+    return *this;
+}
+
+const stdx::optional<mongocxx::pool*>& upload::pool() const {
+    return _pool;
+}
+
+upload& upload::concurrency(std::int32_t concurrency) {
+    _concurrency = concurrency;
+    return *this;
+}
+
+const stdx::optional<std::int32_t>& upload::concurrency() const {
+    return _concurrency;
+}
+
+upload& upload::compute_checksum(bool compute_checksum) {
+    _compute_checksum = compute_checksum;
+    return *this;
+}
+
+const stdx::optional<bool>& upload::compute_checksum() const {
+    return _compute_checksum;
+}
+
 }  // namespace gridfs
 }  // namespace options
 MONGOCXX_INLINE_NAMESPACE_END
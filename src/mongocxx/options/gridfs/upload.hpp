@@ -22,6 +22,9 @@
 
 namespace mongocxx {
 MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+class pool;
+
 namespace options {
 namespace gridfs {
 
@@ -72,9 +75,87 @@ class MONGOCXX_API upload {
     ///
     const stdx::optional<bsoncxx::document::view_or_value>& metadata() const;
 
+    ///
+    /// Sets a pool from which the uploader acquires clients to insert chunks in the background.
+    ///
+    /// Without a pool, full batches of chunks are inserted with the bucket's own collection and
+    /// write() blocks until each batch is acknowledged. With a pool, each batch is inserted on a
+    /// client of its own while the caller keeps writing, and close() waits for every batch to be
+    /// acknowledged before writing the files collection document.
+    ///
+    /// The pool must connect to the same deployment as the bucket and must outlive the upload.
+    /// A pool cannot be combined with a client_session, since a session is bound to one client.
+    ///
+    /// @param pool
+    ///   The pool to acquire clients from.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called. This facilitates
+    ///   method chaining.
+    ///
+    upload& pool(mongocxx::pool* pool);
+
+    ///
+    /// Gets the pool used to insert chunks in the background.
+    ///
+    /// @return
+    ///   An optional pointer to the pool.
+    ///
+    const stdx::optional<mongocxx::pool*>& pool() const;
+
+    ///
+    /// Sets the maximum number of batches of chunks that may be in flight at once when a pool is
+    /// set. Defaults to 1, which still lets the caller fill the next batch while the previous one
+    /// is being inserted. Values greater than 1 require a pool.
+    ///
+    /// @param concurrency
+    ///   The maximum number of concurrent chunk inserts.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called. This facilitates
+    ///   method chaining.
+    ///
+    upload& concurrency(std::int32_t concurrency);
+
+    ///
+    /// Gets the maximum number of concurrent chunk inserts.
+    ///
+    /// @return
+    ///   The maximum number of concurrent chunk inserts.
+    ///
+    const stdx::optional<std::int32_t>& concurrency() const;
+
+    ///
+    /// Sets whether a CRC-32C checksum of the file's contents is computed as the bytes are
+    /// written, and stored in the "crc32c" field of the files document as a 64-bit integer.
+    /// Defaults to false.
+    ///
+    /// The checksum covers the uncompressed contents, and can be verified on download with
+    /// options::gridfs::download::verify_checksum().
+    ///
+    /// @param compute_checksum
+    ///   Whether to compute and store a checksum.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called. This facilitates
+    ///   method chaining.
+    ///
+    upload& compute_checksum(bool compute_checksum);
+
+    ///
+    /// Gets whether a checksum of the file's contents is computed and stored.
+    ///
+    /// @return
+    ///   Whether to compute and store a checksum.
+    ///
+    const stdx::optional<bool>& compute_checksum() const;
+
    private:
     stdx::optional<std::int32_t> _chunk_size_bytes;
     stdx::optional<bsoncxx::document::view_or_value> _metadata;
+    stdx::optional<mongocxx::pool*> _pool;
+    stdx::optional<std::int32_t> _concurrency;
+    stdx::optional<bool> _compute_checksum;
 };
 
 }  // namespace gridfs
@@ -0,0 +1,67 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <mongocxx/prepared_aggregate.hpp>
+
+#include <mongocxx/private/collection.hh>
+#include <mongocxx/private/libbson.hh>
+#include <mongocxx/private/libmongoc.hh>
+#include <mongocxx/private/prepared_aggregate.hh>
+#include <mongocxx/private/read_preference.hh>
+
+#include <mongocxx/config/private/prelude.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+using namespace libbson;
+
+prepared_aggregate::prepared_aggregate(std::unique_ptr<impl> implementation)
+    : _impl{std::move(implementation)} {}
+
+prepared_aggregate::prepared_aggregate(prepared_aggregate&&) noexcept = default;
+prepared_aggregate& prepared_aggregate::operator=(prepared_aggregate&&) noexcept = default;
+
+prepared_aggregate::~prepared_aggregate() = default;
+
+prepared_aggregate& prepared_aggregate::bind(std::size_t index,
+                                             bsoncxx::types::bson_value::view value) {
+    _impl->pipeline.bind(index, value);
+    return *this;
+}
+
+bsoncxx::array::view prepared_aggregate::pipeline() const {
+    auto stages = _impl->pipeline.view();
+    return bsoncxx::array::view{stages.data(), stages.length()};
+}
+
+cursor prepared_aggregate::execute() {
+    scoped_bson_t stages{_impl->pipeline.view()};
+    scoped_bson_t options_bson{_impl->options.view()};
+
+    const ::mongoc_read_prefs_t* rp_ptr = NULL;
+    if (_impl->read_preference) {
+        rp_ptr = _impl->read_preference->_impl->read_preference_t;
+    }
+
+    return cursor(libmongoc::collection_aggregate(_impl->coll._get_impl().collection_t,
+                                                  static_cast<::mongoc_query_flags_t>(0),
+                                                  stages.bson(),
+                                                  options_bson.bson(),
+                                                  rp_ptr));
+}
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
@@ -0,0 +1,111 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+#include <bsoncxx/array/view.hpp>
+#include <bsoncxx/types/bson_value/view.hpp>
+#include <mongocxx/cursor.hpp>
+
+#include <mongocxx/config/prelude.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+class collection;
+
+///
+/// Class representing an aggregation whose pipeline and options are serialized once and executed
+/// many times.
+///
+/// A prepared_aggregate is created by collection::prepare_aggregate() from a pipeline template and
+/// the dotted paths of its parameters, which start with the index of a stage, e.g.
+/// "0.$match.status". Each call to execute() sends the pipeline with the values most recently bound
+/// to its parameters, reusing the options document built when the aggregation was prepared.
+///
+/// A prepared_aggregate keeps its own copy of the collection, including its read concern, write
+/// concern and read preference, as they were when it was prepared. It is not thread-safe.
+///
+class MONGOCXX_API prepared_aggregate {
+   public:
+    ///
+    /// Move constructs a prepared aggregate.
+    ///
+    prepared_aggregate(prepared_aggregate&&) noexcept;
+
+    ///
+    /// Move assigns a prepared aggregate.
+    ///
+    prepared_aggregate& operator=(prepared_aggregate&&) noexcept;
+
+    ///
+    /// Destroys a prepared aggregate.
+    ///
+    ~prepared_aggregate();
+
+    ///
+    /// Binds a value to a parameter of the pipeline. The value stays bound until it is replaced.
+    ///
+    /// @param index
+    ///   The position of the parameter in the list of paths the aggregation was prepared with.
+    /// @param value
+    ///   The value to bind. It must have the same BSON type as the value the pipeline template held
+    ///   at the parameter's path.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called. This facilitates
+    ///   method chaining.
+    ///
+    /// @throws mongocxx::logic_error if the index is out of range or the value's type differs from
+    ///   the parameter's.
+    ///
+    prepared_aggregate& bind(std::size_t index, bsoncxx::types::bson_value::view value);
+
+    ///
+    /// Gets the pipeline with the currently bound values.
+    ///
+    /// @return
+    ///   The array of pipeline stages. The view is invalidated by the next call to bind().
+    ///
+    bsoncxx::array::view pipeline() const;
+
+    ///
+    /// Runs the pipeline with the currently bound values.
+    ///
+    /// @return A mongocxx::cursor with the results.  If the query fails,
+    /// the cursor throws mongocxx::query_exception when the returned cursor
+    /// is iterated.
+    ///
+    /// @see collection::aggregate()
+    ///
+    cursor execute();
+
+   private:
+    friend class collection;
+
+    class MONGOCXX_PRIVATE impl;
+
+    MONGOCXX_PRIVATE prepared_aggregate(std::unique_ptr<impl> implementation);
+
+    std::unique_ptr<impl> _impl;
+};
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/postlude.hpp>
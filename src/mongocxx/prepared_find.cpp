@@ -0,0 +1,74 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <mongocxx/prepared_find.hpp>
+
+#include <mongocxx/private/collection.hh>
+#include <mongocxx/private/cursor.hh>
+#include <mongocxx/private/libbson.hh>
+#include <mongocxx/private/libmongoc.hh>
+#include <mongocxx/private/prepared_find.hh>
+#include <mongocxx/private/read_preference.hh>
+
+#include <mongocxx/config/private/prelude.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+using namespace libbson;
+
+prepared_find::prepared_find(std::unique_ptr<impl> implementation)
+    : _impl{std::move(implementation)} {}
+
+prepared_find::prepared_find(prepared_find&&) noexcept = default;
+prepared_find& prepared_find::operator=(prepared_find&&) noexcept = default;
+
+prepared_find::~prepared_find() = default;
+
+prepared_find& prepared_find::bind(std::size_t index, bsoncxx::types::bson_value::view value) {
+    _impl->filter.bind(index, value);
+    return *this;
+}
+
+bsoncxx::document::view prepared_find::filter() const {
+    return _impl->filter.view();
+}
+
+cursor prepared_find::execute() {
+    scoped_bson_t filter_bson{_impl->filter.view()};
+    scoped_bson_t options_bson{_impl->options.view()};
+
+    const mongoc_read_prefs_t* rp_ptr = NULL;
+    if (_impl->read_preference) {
+        rp_ptr = _impl->read_preference->_impl->read_preference_t;
+    }
+
+    cursor query_cursor{
+        libmongoc::collection_find_with_opts(_impl->coll._get_impl().collection_t,
+                                             filter_bson.bson(),
+                                             options_bson.bson(),
+                                             rp_ptr),
+        _impl->cursor_type};
+
+    if (_impl->max_await_time_ms) {
+        libmongoc::cursor_set_max_await_time_ms(query_cursor._impl->cursor_t,
+                                                *_impl->max_await_time_ms);
+    }
+
+    return query_cursor;
+}
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
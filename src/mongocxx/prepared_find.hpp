@@ -0,0 +1,110 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+#include <bsoncxx/document/view.hpp>
+#include <bsoncxx/types/bson_value/view.hpp>
+#include <mongocxx/cursor.hpp>
+
+#include <mongocxx/config/prelude.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+class collection;
+
+///
+/// Class representing a find whose filter and options are serialized once and executed many times.
+///
+/// A prepared_find is created by collection::prepare_find() from a filter template and the dotted
+/// paths of its parameters. Each call to execute() sends the filter with the values most recently
+/// bound to its parameters, reusing the options document built when the find was prepared, so the
+/// cost per query is that of patching the bound values into the filter.
+///
+/// A prepared_find keeps its own copy of the collection, including its read concern and read
+/// preference, as they were when it was prepared. It is not thread-safe.
+///
+class MONGOCXX_API prepared_find {
+   public:
+    ///
+    /// Move constructs a prepared find.
+    ///
+    prepared_find(prepared_find&&) noexcept;
+
+    ///
+    /// Move assigns a prepared find.
+    ///
+    prepared_find& operator=(prepared_find&&) noexcept;
+
+    ///
+    /// Destroys a prepared find.
+    ///
+    ~prepared_find();
+
+    ///
+    /// Binds a value to a parameter of the filter. The value stays bound until it is replaced.
+    ///
+    /// @param index
+    ///   The position of the parameter in the list of paths the find was prepared with.
+    /// @param value
+    ///   The value to bind. It must have the same BSON type as the value the filter template held
+    ///   at the parameter's path.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called. This facilitates
+    ///   method chaining.
+    ///
+    /// @throws mongocxx::logic_error if the index is out of range or the value's type differs from
+    ///   the parameter's.
+    ///
+    prepared_find& bind(std::size_t index, bsoncxx::types::bson_value::view value);
+
+    ///
+    /// Gets the filter with the currently bound values.
+    ///
+    /// @return
+    ///   The filter. The view is invalidated by the next call to bind().
+    ///
+    bsoncxx::document::view filter() const;
+
+    ///
+    /// Finds the documents that match the filter with the currently bound values.
+    ///
+    /// @return A mongocxx::cursor with the results.  If the query fails,
+    /// the cursor throws mongocxx::query_exception when the returned cursor
+    /// is iterated.
+    ///
+    /// @see collection::find()
+    ///
+    cursor execute();
+
+   private:
+    friend class collection;
+
+    class MONGOCXX_PRIVATE impl;
+
+    MONGOCXX_PRIVATE prepared_find(std::unique_ptr<impl> implementation);
+
+    std::unique_ptr<impl> _impl;
+};
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/postlude.hpp>
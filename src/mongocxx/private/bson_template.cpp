@@ -0,0 +1,272 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <mongocxx/private/bson_template.hh>
+
+#include <cstring>
+
+#include <mongocxx/exception/error_code.hpp>
+#include <mongocxx/exception/logic_error.hpp>
+
+#include <mongocxx/config/private/prelude.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+namespace {
+
+void write_le(std::uint8_t* out, std::uint64_t value, std::size_t width) {
+    for (std::size_t i = 0; i < width; ++i) {
+        out[i] = static_cast<std::uint8_t>(value >> (8 * i));
+    }
+}
+
+std::uint32_t read_le32(const std::uint8_t* in) {
+    return static_cast<std::uint32_t>(in[0]) | (static_cast<std::uint32_t>(in[1]) << 8) |
+           (static_cast<std::uint32_t>(in[2]) << 16) | (static_cast<std::uint32_t>(in[3]) << 24);
+}
+
+// Returns the length of the value's encoding, without its type byte and key, or zero if values of
+// its type cannot be parameters.
+std::size_t encoded_length(bsoncxx::types::bson_value::view value) {
+    switch (value.type()) {
+        case bsoncxx::type::k_bool:
+            return 1;
+        case bsoncxx::type::k_int32:
+            return 4;
+        case bsoncxx::type::k_double:
+        case bsoncxx::type::k_date:
+        case bsoncxx::type::k_timestamp:
+        case bsoncxx::type::k_int64:
+            return 8;
+        case bsoncxx::type::k_oid:
+            return 12;
+        case bsoncxx::type::k_decimal128:
+            return 16;
+        case bsoncxx::type::k_utf8:
+            return 4 + value.get_string().value.size() + 1;
+        case bsoncxx::type::k_document:
+            return value.get_document().value.length();
+        case bsoncxx::type::k_array:
+            return value.get_array().value.length();
+        case bsoncxx::type::k_binary:
+            // The deprecated subtype nests a second length prefix, so its encoding is not simply
+            // the bytes that b_binary exposes.
+            if (value.get_binary().sub_type == bsoncxx::binary_sub_type::k_binary_deprecated) {
+                return 0;
+            }
+            return 4 + 1 + value.get_binary().size;
+        default:
+            return 0;
+    }
+}
+
+// Writes the value's encoding, whose length is encoded_length(value), to out.
+void encode(bsoncxx::types::bson_value::view value, std::uint8_t* out) {
+    switch (value.type()) {
+        case bsoncxx::type::k_bool:
+            out[0] = value.get_bool().value ? 1 : 0;
+            break;
+        case bsoncxx::type::k_int32:
+            write_le(out, static_cast<std::uint32_t>(value.get_int32().value), 4);
+            break;
+        case bsoncxx::type::k_double: {
+            std::uint64_t bits;
+            std::memcpy(&bits, &value.get_double().value, sizeof(bits));
+            write_le(out, bits, 8);
+            break;
+        }
+        case bsoncxx::type::k_date:
+            write_le(out, static_cast<std::uint64_t>(value.get_date().to_int64()), 8);
+            break;
+        case bsoncxx::type::k_timestamp:
+            write_le(out, value.get_timestamp().increment, 4);
+            write_le(out + 4, value.get_timestamp().timestamp, 4);
+            break;
+        case bsoncxx::type::k_int64:
+            write_le(out, static_cast<std::uint64_t>(value.get_int64().value), 8);
+            break;
+        case bsoncxx::type::k_oid:
+            std::memcpy(out, value.get_oid().value.bytes(), bsoncxx::oid::size());
+            break;
+        case bsoncxx::type::k_decimal128:
+            write_le(out, value.get_decimal128().value.low(), 8);
+            write_le(out + 8, value.get_decimal128().value.high(), 8);
+            break;
+        case bsoncxx::type::k_utf8: {
+            auto string = value.get_string().value;
+            write_le(out, string.size() + 1, 4);
+            std::memcpy(out + 4, string.data(), string.size());
+            out[4 + string.size()] = 0;
+            break;
+        }
+        case bsoncxx::type::k_document: {
+            auto document = value.get_document().value;
+            std::memcpy(out, document.data(), document.length());
+            break;
+        }
+        case bsoncxx::type::k_array: {
+            auto array = value.get_array().value;
+            std::memcpy(out, array.data(), array.length());
+            break;
+        }
+        case bsoncxx::type::k_binary: {
+            auto binary = value.get_binary();
+            write_le(out, binary.size, 4);
+            out[4] = static_cast<std::uint8_t>(binary.sub_type);
+            std::memcpy(out + 5, binary.bytes, binary.size);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+}  // namespace
+
+bson_template::bson_template(bsoncxx::document::view document,
+                             const std::vector<std::string>& parameters)
+    : _bytes(document.data(), document.data() + document.length()) {
+    for (const auto& path : parameters) {
+        slot parameter;
+        parameter.enclosing.push_back(0);
+
+        bsoncxx::document::view current = view();
+        std::size_t start = 0;
+
+        for (;;) {
+            const std::size_t dot = path.find('.', start);
+            const std::string key =
+                path.substr(start, dot == std::string::npos ? dot : dot - start);
+
+            auto element = current[key];
+            if (!element) {
+                throw logic_error{error_code::k_invalid_parameter,
+                                  "no value for prepared statement parameter " + path};
+            }
+
+            // The value follows the element's type byte and its NUL-terminated key.
+            const std::size_t value_offset =
+                static_cast<std::size_t>(element.raw() - _bytes.data()) + element.offset() + 1 +
+                element.keylen() + 1;
+
+            if (dot == std::string::npos) {
+                parameter.type = element.type();
+                parameter.value_offset = value_offset;
+                parameter.value_length = encoded_length(element.get_value());
+                if (parameter.value_length == 0) {
+                    throw logic_error{error_code::k_invalid_parameter,
+                                      "unsupported type for prepared statement parameter " + path};
+                }
+                break;
+            }
+
+            if (element.type() == bsoncxx::type::k_document) {
+                current = element.get_document().value;
+            } else if (element.type() == bsoncxx::type::k_array) {
+                auto array = element.get_array().value;
+                current = bsoncxx::document::view{array.data(), array.length()};
+            } else {
+                throw logic_error{error_code::k_invalid_parameter,
+                                  "no value for prepared statement parameter " + path};
+            }
+
+            parameter.enclosing.push_back(value_offset);
+            start = dot + 1;
+        }
+
+        for (const auto& other : _slots) {
+            if (parameter.value_offset < other.value_offset + other.value_length &&
+                other.value_offset < parameter.value_offset + parameter.value_length) {
+                throw logic_error{error_code::k_invalid_parameter,
+                                  "prepared statement parameter " + path +
+                                      " overlaps another parameter"};
+            }
+        }
+
+        _slots.push_back(std::move(parameter));
+    }
+}
+
+void bson_template::bind(std::size_t index, bsoncxx::types::bson_value::view value) {
+    if (index >= _slots.size()) {
+        throw logic_error{error_code::k_invalid_parameter,
+                          "prepared statement parameter index out of range"};
+    }
+
+    slot& target = _slots[index];
+    if (value.type() != target.type) {
+        throw logic_error{error_code::k_invalid_parameter,
+                          "prepared statement parameter bound to a value of a different type"};
+    }
+
+    const std::size_t length = encoded_length(value);
+    if (length == 0) {
+        throw logic_error{error_code::k_invalid_parameter,
+                          "unsupported value for prepared statement parameter"};
+    }
+
+    if (length != target.value_length) {
+        resize(target, length);
+    }
+
+    encode(value, _bytes.data() + target.value_offset);
+}
+
+void bson_template::resize(slot& target, std::size_t length) {
+    const std::size_t end = target.value_offset + target.value_length;
+
+    if (length > target.value_length) {
+        _bytes.insert(_bytes.begin() + static_cast<std::ptrdiff_t>(end),
+                      length - target.value_length,
+                      0);
+    } else {
+        _bytes.erase(_bytes.begin() + static_cast<std::ptrdiff_t>(target.value_offset + length),
+                     _bytes.begin() + static_cast<std::ptrdiff_t>(end));
+    }
+
+    // Unsigned arithmetic wraps, so adding the new length and subtracting the old one is correct
+    // whether the value grew or shrank.
+    for (auto offset : target.enclosing) {
+        const std::uint32_t enclosing_length = read_le32(&_bytes[offset]);
+        write_le(&_bytes[offset],
+                 enclosing_length + static_cast<std::uint32_t>(length) -
+                     static_cast<std::uint32_t>(target.value_length),
+                 4);
+    }
+
+    // Parameters never overlap, so everything recorded after this value's offset lies after its
+    // end and moves with it.
+    auto move = [&](std::size_t& offset) {
+        if (offset > target.value_offset) {
+            offset = offset + length - target.value_length;
+        }
+    };
+
+    for (auto& other : _slots) {
+        if (&other == &target) {
+            continue;
+        }
+        move(other.value_offset);
+        for (auto& offset : other.enclosing) {
+            move(offset);
+        }
+    }
+
+    target.value_length = length;
+}
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
@@ -0,0 +1,85 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <bsoncxx/document/view.hpp>
+#include <bsoncxx/types.hpp>
+#include <bsoncxx/types/bson_value/view.hpp>
+
+#include <mongocxx/config/private/prelude.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+///
+/// A serialized BSON document with parameter slots that can be overwritten in place.
+///
+/// Each parameter names a value in the document by its dotted path, e.g. "a.b" or, for an array,
+/// "0.$match.a". The value found there when the template is created fixes the parameter's type.
+/// Binding a value of a fixed-width type overwrites its bytes; binding a string, document, array
+/// or binary of a different length moves the rest of the document and fixes up the lengths of the
+/// documents that enclose it.
+///
+class bson_template {
+   public:
+    ///
+    /// @throws mongocxx::logic_error if a path does not name a value in the document, names a
+    ///   value of an unsupported type, or lies inside the value named by another path.
+    ///
+    bson_template(bsoncxx::document::view document, const std::vector<std::string>& parameters);
+
+    ///
+    /// @throws mongocxx::logic_error if the index is out of range or the value's type differs from
+    ///   the parameter's.
+    ///
+    void bind(std::size_t index, bsoncxx::types::bson_value::view value);
+
+    bsoncxx::document::view view() const {
+        return bsoncxx::document::view{_bytes.data(), _bytes.size()};
+    }
+
+    std::size_t parameter_count() const {
+        return _slots.size();
+    }
+
+   private:
+    struct slot {
+        bsoncxx::type type;
+
+        // The offset and length of the value, after its type byte and key.
+        std::size_t value_offset;
+        std::size_t value_length;
+
+        // The offsets of the length prefixes of the documents and arrays enclosing the value,
+        // outermost first.
+        std::vector<std::size_t> enclosing;
+    };
+
+    void resize(slot& target, std::size_t length);
+
+    std::vector<std::uint8_t> _bytes;
+    std::vector<slot> _slots;
+};
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/private/postlude.hh>
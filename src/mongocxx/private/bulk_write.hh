@@ -24,13 +24,20 @@ MONGOCXX_INLINE_NAMESPACE_BEGIN
 
 class bulk_write::impl {
    public:
-    impl(mongoc_bulk_operation_t* op) : operation_t(op) {}
+    impl(mongoc_bulk_operation_t* op) : operation_t(op) {
+        bson_init(&options);
+    }
 
     ~impl() {
+        bson_destroy(&options);
         libmongoc::bulk_operation_destroy(operation_t);
     }
 
     mongoc_bulk_operation_t* operation_t;
+
+    // Scratch space for the options of the model being appended. libmongoc copies the options
+    // into the bulk operation, so the buffer is reset and reused by every append.
+    bson_t options;
 };
 
 MONGOCXX_INLINE_NAMESPACE_END
@@ -14,6 +14,10 @@
 
 #pragma once
 
+#include <cstring>
+#include <limits>
+#include <vector>
+
 #include <bsoncxx/document/view.hpp>
 #include <bsoncxx/stdx/optional.hpp>
 #include <mongocxx/change_stream.hpp>
@@ -36,8 +40,13 @@ class change_stream::impl {
     // k_dead means that an error was indicated by a call to next
     enum class state { k_pending, k_started, k_dead };
 
-    explicit impl(mongoc_change_stream_t* change_stream)
-        : change_stream_(change_stream), status_{state::k_pending}, exhausted_{true} {}
+    impl(mongoc_change_stream_t* change_stream, stdx::optional<std::int32_t> batch_size)
+        : change_stream_(change_stream),
+          max_batch_events_{batch_size && *batch_size > 0
+                                ? static_cast<std::size_t>(*batch_size)
+                                : std::numeric_limits<std::size_t>::max()},
+          status_{state::k_pending},
+          exhausted_{true} {}
 
     // no copy or move
     impl(impl&) = delete;
@@ -87,19 +96,63 @@ class change_stream::impl {
         }
 
         // Check for errors or just nothing left.
-        bson_error_t error;
-        if (libmongoc::change_stream_error_document(this->change_stream_, &error, &out)) {
-            this->mark_dead();
-            this->doc_ = bsoncxx::document::view{};
-            mongocxx::libbson::scoped_bson_t scoped_error_reply{};
-            bson_copy_to(out, scoped_error_reply.bson_for_init());
-            throw_exception<query_exception>(scoped_error_reply.steal(), error);
-        }
+        this->throw_if_error();
 
         // Just nothing left.
         this->mark_nothing_left();
     }
 
+    // Reads notifications until the end of the current server batch, copying each one into a
+    // buffer that is reused from batch to batch. libmongoc only guarantees a returned document
+    // until the next call to change_stream_next, so the copy is what keeps the whole batch alive.
+    //
+    // libmongoc does not say when a server batch has been used up, and a server's
+    // postBatchResumeToken usually equals the last notification's _id, so the batch is also ended
+    // once it holds batch_size notifications or as many bytes as a single server reply can carry.
+    // Without those limits a busy stream would never end a batch and the buffer would grow
+    // without bound.
+    const std::vector<bsoncxx::document::view>& advance_batch() {
+        batch_buffer_.clear();
+        batch_offsets_.clear();
+        batch_events_.clear();
+
+        // Like begin(), a stream that has already reported an error yields nothing.
+        if (this->is_dead()) {
+            return batch_events_;
+        }
+
+        // Iterators must not keep pointing at a document from before the batch.
+        this->mark_nothing_left();
+
+        const bson_t* out;
+        bool has_next;
+        while ((has_next = libmongoc::change_stream_next(this->change_stream_, &out))) {
+            const std::uint8_t* data = bson_get_data(out);
+            batch_offsets_.push_back(batch_buffer_.size());
+            batch_buffer_.insert(batch_buffer_.end(), data, data + out->len);
+
+            if (this->ends_batch(out) || batch_offsets_.size() >= max_batch_events_ ||
+                batch_buffer_.size() >= k_max_batch_bytes) {
+                break;
+            }
+        }
+
+        // An error after some notifications is left for the next call, since libmongoc keeps
+        // reporting it.
+        if (!has_next && batch_offsets_.empty()) {
+            this->throw_if_error();
+        }
+
+        for (std::size_t i = 0; i < batch_offsets_.size(); ++i) {
+            const std::size_t end =
+                i + 1 < batch_offsets_.size() ? batch_offsets_[i + 1] : batch_buffer_.size();
+            batch_events_.emplace_back(batch_buffer_.data() + batch_offsets_[i],
+                                       end - batch_offsets_[i]);
+        }
+
+        return batch_events_;
+    }
+
     bsoncxx::document::view& doc() {
         return this->doc_;
     }
@@ -114,8 +167,43 @@ class change_stream::impl {
     }
 
    private:
+    void throw_if_error() {
+        const bson_t* out;
+        bson_error_t error;
+        if (libmongoc::change_stream_error_document(this->change_stream_, &error, &out)) {
+            this->mark_dead();
+            this->doc_ = bsoncxx::document::view{};
+            mongocxx::libbson::scoped_bson_t scoped_error_reply{};
+            bson_copy_to(out, scoped_error_reply.bson_for_init());
+            throw_exception<query_exception>(scoped_error_reply.steal(), error);
+        }
+    }
+
+    // Once the last notification of a batch has been returned, libmongoc reports the
+    // postBatchResumeToken instead of that notification's _id.
+    bool ends_batch(const bson_t* event) {
+        const bson_t* token = libmongoc::change_stream_get_resume_token(this->change_stream_);
+        bson_iter_t iter;
+        if (!token || !bson_iter_init_find(&iter, event, "_id") ||
+            !BSON_ITER_HOLDS_DOCUMENT(&iter)) {
+            return false;
+        }
+
+        std::uint32_t len;
+        const std::uint8_t* id;
+        bson_iter_document(&iter, &len, &id);
+        return len != token->len || std::memcmp(id, bson_get_data(token), len) != 0;
+    }
+
+    // The maximum size of a server reply.
+    static constexpr std::size_t k_max_batch_bytes = 16 * 1024 * 1024;
+
     mongoc_change_stream_t* const change_stream_;
+    const std::size_t max_batch_events_;
     bsoncxx::document::view doc_;
+    std::vector<std::uint8_t> batch_buffer_;
+    std::vector<std::size_t> batch_offsets_;
+    std::vector<bsoncxx::document::view> batch_events_;
     state status_;
     bool exhausted_;
 };
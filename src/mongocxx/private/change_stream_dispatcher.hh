@@ -0,0 +1,132 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/stdx/optional.hpp>
+#include <mongocxx/change_stream_dispatcher.hpp>
+
+#include <mongocxx/config/private/prelude.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+class change_stream_dispatcher::impl {
+   public:
+    // An event waiting to be handled by a worker. `seq` is the position of the event in the
+    // stream, counted from the construction of the dispatcher.
+    struct event {
+        std::uint64_t seq;
+        bsoncxx::document::value doc;
+    };
+
+    // A worker thread and the queue of events routed to it. Every event for a given key lands on
+    // the same queue, and each queue is drained by exactly one thread, which preserves per-key
+    // ordering.
+    struct worker {
+        std::deque<event> queue;
+        std::condition_variable cv;
+        std::thread thread;
+    };
+
+    // Bookkeeping for an event that has been read from the stream but whose predecessors may not
+    // all have been handled yet.
+    struct slot {
+        bool done;
+        stdx::optional<bsoncxx::document::value> token;
+    };
+
+    impl(change_stream* stream,
+         handler_type handler,
+         options::change_stream_dispatcher::key_extractor_type key_extractor,
+         std::size_t worker_count,
+         std::size_t max_pending);
+
+    impl(const impl&) = delete;
+    impl(impl&&) = delete;
+    void operator=(const impl&) = delete;
+    void operator=(impl&&) = delete;
+
+    ~impl();
+
+    std::size_t dispatch();
+
+    void wait();
+
+    stdx::optional<bsoncxx::document::value> safe_resume_token() const;
+
+    std::size_t worker_count() const {
+        return workers.size();
+    }
+
+   private:
+    worker& worker_for(const bsoncxx::document::view& event);
+
+    void run(worker& w);
+
+    void shutdown();
+
+    // Retires the event with the given sequence number and advances the safe resume token past
+    // every leading retired event, stopping short of the first event that was not handled. Must be
+    // called with `mutex` held.
+    void mark_done(std::uint64_t seq, bool handled);
+
+    // Rethrows the first handler exception, if any. Must be called with `mutex` held.
+    void rethrow_if_failed() const;
+
+    change_stream* const stream;
+    const handler_type handler;
+    const options::change_stream_dispatcher::key_extractor_type key_extractor;
+    const std::size_t max_pending;
+
+    // Guards every member below.
+    mutable std::mutex mutex;
+
+    // Signalled whenever an event finishes, so dispatch() and wait() can make progress.
+    std::condition_variable progress_cv;
+
+    std::vector<std::unique_ptr<worker>> workers;
+
+    // One slot per event that has been read but is not yet covered by `safe_token`. The front slot
+    // belongs to the event with sequence number `first_seq`.
+    std::deque<slot> in_flight;
+    std::uint64_t first_seq;
+    std::uint64_t next_seq;
+
+    // The sequence number of the first event retired without being handled successfully. The safe
+    // resume token never advances to or past this event.
+    std::uint64_t first_unhandled_seq;
+
+    stdx::optional<bsoncxx::document::value> safe_token;
+
+    // The first exception thrown by the handler.
+    std::exception_ptr error;
+
+    bool stopping;
+};
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/private/postlude.hh>
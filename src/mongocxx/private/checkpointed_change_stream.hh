@@ -0,0 +1,68 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/stdx/optional.hpp>
+#include <mongocxx/checkpointed_change_stream.hpp>
+
+#include <mongocxx/config/private/prelude.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+class checkpointed_change_stream::impl {
+   public:
+    impl(change_stream stream,
+         std::shared_ptr<resume_token_store> store,
+         std::int32_t event_interval,
+         std::chrono::milliseconds time_interval)
+        : stream{std::move(stream)},
+          store{std::move(store)},
+          event_interval{event_interval},
+          time_interval{time_interval},
+          unpersisted_events{0},
+          last_checkpoint{std::chrono::steady_clock::now()} {}
+
+    // The underlying change stream.
+    change_stream stream;
+
+    // Where checkpoints are written.
+    std::shared_ptr<resume_token_store> store;
+
+    // The number of acknowledged events after which a checkpoint is written.
+    std::int32_t event_interval;
+
+    // The time after which an acknowledged event causes a checkpoint to be written.
+    std::chrono::milliseconds time_interval;
+
+    // The number of events acknowledged since the last checkpoint.
+    std::int32_t unpersisted_events;
+
+    // The resume token of the last acknowledged event.
+    stdx::optional<bsoncxx::document::value> acknowledged_token;
+
+    // When the last checkpoint was written, or when the stream was opened.
+    std::chrono::steady_clock::time_point last_checkpoint;
+};
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/private/postlude.hh>
@@ -0,0 +1,43 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <mongocxx/compiled_pipeline.hpp>
+#include <mongocxx/private/bson_template.hh>
+
+#include <mongocxx/config/private/prelude.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+class compiled_pipeline::impl {
+   public:
+    impl(bson_template stages, bool parameterized)
+        : stages{std::move(stages)}, parameterized{parameterized} {}
+
+    // The stages, wrapped as {"pipeline": [...]}. libmongoc accepts this form for both
+    // aggregations and change streams, so neither has to wrap or copy the array again.
+    bson_template stages;
+
+    // Whether the stages belong to a parameterized_pipeline, whose bind() patches them in place.
+    // Such stages are never shared: copying the pipeline copies them.
+    bool parameterized;
+};
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/private/postlude.hh>
@@ -74,6 +74,23 @@ class cursor::impl {
         exhausted = false;
     }
 
+    // Moves to the next document, if any. On failure, marks the cursor dead and returns false with
+    // the error and the server's reply, which may be null, left in the out-parameters.
+    bool advance(bson_error_t* error, const bson_t** error_document) {
+        const bson_t* out;
+
+        if (libmongoc::cursor_next(cursor_t, &out)) {
+            doc = bsoncxx::document::view{bson_get_data(out), out->len};
+        } else if (libmongoc::cursor_error_document(cursor_t, error, error_document)) {
+            mark_dead();
+            return false;
+        } else {
+            mark_nothing_left();
+        }
+
+        return true;
+    }
+
     mongoc_cursor_t* cursor_t;
     bsoncxx::document::view doc;
     state status;
@@ -0,0 +1,170 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/document/view.hpp>
+#include <bsoncxx/matcher.hpp>
+#include <bsoncxx/stdx/optional.hpp>
+#include <mongocxx/change_stream.hpp>
+#include <mongocxx/document_cache.hpp>
+#include <mongocxx/pool.hpp>
+
+#include <mongocxx/config/private/prelude.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+class document_cache::impl {
+   public:
+    // A cached find_one result.
+    struct entry {
+        std::string key;
+        stdx::optional<bsoncxx::document::value> document;
+
+        // The type byte and value of the _id whose changes affect the entry, or empty if the
+        // entry caches that no document matches a filter that is not an equality on _id.
+        std::string id;
+
+        // Whether the filter is an equality on `id`, so that no other document can affect it.
+        bool id_filter;
+
+        // Evaluates the filter against changed documents. Null for _id filters and for filters
+        // that bsoncxx::matcher does not support.
+        std::unique_ptr<bsoncxx::matcher> matcher;
+
+        std::size_t bytes;
+    };
+
+    // A find_one that missed and is waiting for the server. It is marked stale by any change
+    // that might affect its result, which then is not cached, since the result may have been
+    // read before the change.
+    struct fetch {
+        std::string id;
+        bool stale;
+    };
+
+    struct shard {
+        std::mutex mutex;
+
+        // Most recently used first.
+        std::list<entry> entries;
+        std::unordered_map<std::string, std::list<entry>::iterator> index;
+
+        // The entries affected by changes to a given _id.
+        std::unordered_multimap<std::string, entry*> by_id;
+
+        // The entries whose filters are checked against every changed document.
+        std::unordered_set<entry*> general;
+
+        std::list<fetch> fetches;
+
+        std::size_t bytes = 0;
+        std::int64_t hits = 0;
+        std::int64_t misses = 0;
+        std::int64_t evictions = 0;
+        std::int64_t invalidations = 0;
+    };
+
+    impl(pool& pool,
+         std::string db_name,
+         std::string collection_name,
+         std::size_t shard_bytes,
+         std::size_t shard_count,
+         std::chrono::milliseconds max_await_time);
+
+    impl(const impl&) = delete;
+    impl(impl&&) = delete;
+    void operator=(const impl&) = delete;
+    void operator=(impl&&) = delete;
+
+    ~impl();
+
+    // Opens the change stream on the calling thread and starts the background thread that
+    // reads it.
+    void start_watching();
+
+    stdx::optional<bsoncxx::document::value> find_one(bsoncxx::document::view filter);
+
+    void invalidate(bsoncxx::document::view event);
+
+    void clear();
+
+    // Sums a statistic over every shard.
+    std::int64_t sum(std::int64_t (*statistic)(const shard&)) const;
+
+   private:
+    shard& shard_for(const std::string& key);
+
+    entry make_entry(std::string key,
+                     std::string id,
+                     bsoncxx::document::view filter,
+                     const stdx::optional<bsoncxx::document::value>& result) const;
+
+    // Each of these must be called with the shard's mutex held.
+    void insert(shard& s, entry e);
+    bool erase(shard& s, const std::string& key);
+    void invalidate(shard& s,
+                    const std::string& id,
+                    bool may_match,
+                    const stdx::optional<bsoncxx::document::view>& document);
+    void clear(shard& s);
+
+    change_stream open_stream(stdx::optional<bsoncxx::document::view> start_after);
+
+    void run();
+
+    pool& client_pool;
+    const std::string db_name;
+    const std::string collection_name;
+    const std::size_t shard_bytes;
+    const std::chrono::milliseconds max_await_time;
+
+    std::vector<std::unique_ptr<shard>> shards;
+
+    // False while the change stream is failing, when the cache is bypassed. It is set before the
+    // shards are cleared and read with a shard mutex held, so a fetch either sees it unset or is
+    // marked stale by the clear.
+    std::atomic<bool> valid;
+
+    // The client and change stream of the background thread.
+    stdx::optional<pool::entry> watch_client;
+    std::unique_ptr<change_stream> stream;
+    std::thread watcher;
+
+    std::mutex stop_mutex;
+    std::condition_variable stop_cv;
+    std::atomic<bool> stopping;
+};
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/private/postlude.hh>
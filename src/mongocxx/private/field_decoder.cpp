@@ -0,0 +1,82 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <mongocxx/private/field_decoder.hh>
+
+#include <mongocxx/config/private/prelude.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+constexpr std::size_t field_decoder::k_no_field;
+
+bool field_decoder::read_scalar(bsoncxx::type type, const bson_iter_t* iter, scalar* out) {
+    const bson_type_t value_type = bson_iter_type(iter);
+
+    switch (type) {
+        case bsoncxx::type::k_double:
+            if (value_type == BSON_TYPE_DOUBLE) {
+                out->f64 = bson_iter_double(iter);
+            } else if (value_type == BSON_TYPE_INT32) {
+                out->f64 = bson_iter_int32(iter);
+            } else if (value_type == BSON_TYPE_INT64) {
+                out->f64 = static_cast<double>(bson_iter_int64(iter));
+            } else {
+                return false;
+            }
+            return true;
+        case bsoncxx::type::k_int64:
+            if (value_type == BSON_TYPE_INT64) {
+                out->i64 = bson_iter_int64(iter);
+            } else if (value_type == BSON_TYPE_INT32) {
+                out->i64 = bson_iter_int32(iter);
+            } else {
+                return false;
+            }
+            return true;
+        case bsoncxx::type::k_int32:
+            if (value_type != BSON_TYPE_INT32) {
+                return false;
+            }
+            out->i32 = bson_iter_int32(iter);
+            return true;
+        case bsoncxx::type::k_bool:
+            if (value_type != BSON_TYPE_BOOL) {
+                return false;
+            }
+            out->b = bson_iter_bool(iter);
+            return true;
+        case bsoncxx::type::k_date:
+            if (value_type != BSON_TYPE_DATE_TIME) {
+                return false;
+            }
+            out->i64 = bson_iter_date_time(iter);
+            return true;
+        case bsoncxx::type::k_utf8: {
+            if (value_type != BSON_TYPE_UTF8) {
+                return false;
+            }
+            std::uint32_t length;
+            const char* value = bson_iter_utf8(iter, &length);
+            out->str = bsoncxx::stdx::string_view{value, length};
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
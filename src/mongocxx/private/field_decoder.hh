@@ -0,0 +1,133 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <bsoncxx/stdx/string_view.hpp>
+#include <bsoncxx/types.hpp>
+#include <mongocxx/private/libbson.hh>
+
+#include <mongocxx/config/private/prelude.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+///
+/// Decodes fields of BSON documents into typed columns. It is shared by column_projection and
+/// arrow_exporter, so that both accept the same values and resolve duplicated keys the same way.
+///
+/// A field is filled by the first occurrence of its key whose value the field accepts. When a
+/// document repeats a key, a later occurrence fills a field that the earlier ones could not.
+///
+class field_decoder {
+   public:
+    static constexpr std::size_t k_no_field = std::numeric_limits<std::size_t>::max();
+
+    ///
+    /// A value as held by a column of a scalar type. Only the member for the column's type is set:
+    /// `f64` for k_double, `i64` for k_int64 and k_date (milliseconds since the Unix epoch), `i32`
+    /// for k_int32, `b` for k_bool and `str` for k_utf8.
+    ///
+    struct scalar {
+        double f64;
+        std::int64_t i64;
+        std::int32_t i32;
+        bool b;
+        bsoncxx::stdx::string_view str;
+    };
+
+    ///
+    /// Reads the element at iter as a value of a column of the given type. A k_double column
+    /// accepts double, int32 and int64 values, a k_int64 column int32 and int64 values, and the
+    /// other scalar columns only values of their own type.
+    ///
+    /// @return false if the column does not accept the element's type.
+    ///
+    static bool read_scalar(bsoncxx::type type, const bson_iter_t* iter, scalar* out);
+
+    ///
+    /// Finds, from iter onwards, the first element named `key` that `fill(iter)` accepts.
+    ///
+    /// @return false if no such element is found.
+    ///
+    template <typename Fill>
+    static bool find_field(bson_iter_t* iter, const char* key, Fill&& fill) {
+        while (bson_iter_find(iter, key)) {
+            if (fill(iter)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    ///
+    /// Sets the number of fields tracked, none of them filled.
+    ///
+    void reset(std::size_t fields) {
+        _filled.assign(fields, k_no_field);
+        _document = 0;
+        _unfilled = 0;
+    }
+
+    ///
+    /// Starts a document, in which no field is filled yet.
+    ///
+    void start_document() {
+        ++_document;
+        _unfilled = _filled.size();
+    }
+
+    bool filled(std::size_t field) const {
+        return _filled[field] == _document;
+    }
+
+    std::size_t unfilled() const {
+        return _unfilled;
+    }
+
+    ///
+    /// Walks the elements at iter until every field of the document is filled.
+    ///
+    /// `match(key, iter)` returns the field the element's key names, or k_no_field; it may walk a
+    /// subdocument with this decoder. An unfilled field is then offered the element through
+    /// `fill(field, iter)`, which returns whether the field accepted its value.
+    ///
+    template <typename Match, typename Fill>
+    void walk(bson_iter_t* iter, Match&& match, Fill&& fill) {
+        while (_unfilled > 0 && bson_iter_next(iter)) {
+            const std::size_t field = match(bson_iter_key(iter), iter);
+            if (field != k_no_field && !filled(field) && fill(field, iter)) {
+                _filled[field] = _document;
+                --_unfilled;
+            }
+        }
+    }
+
+   private:
+    // The document each field was last filled in.
+    std::vector<std::size_t> _filled;
+    std::size_t _document = 0;
+    std::size_t _unfilled = 0;
+};
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/private/postlude.hh>
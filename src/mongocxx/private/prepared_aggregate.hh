@@ -0,0 +1,58 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/stdx/optional.hpp>
+#include <mongocxx/collection.hpp>
+#include <mongocxx/prepared_aggregate.hpp>
+#include <mongocxx/private/bson_template.hh>
+#include <mongocxx/read_preference.hpp>
+
+#include <mongocxx/config/private/prelude.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+class prepared_aggregate::impl {
+   public:
+    impl(collection coll,
+         bson_template pipeline,
+         bsoncxx::document::value options,
+         stdx::optional<class read_preference> read_preference)
+        : coll{std::move(coll)},
+          pipeline{std::move(pipeline)},
+          options{std::move(options)},
+          read_preference{std::move(read_preference)} {}
+
+    // The collection the aggregation runs against.
+    collection coll;
+
+    // The array of pipeline stages, with its parameter slots.
+    bson_template pipeline;
+
+    // The options document, built once from the options::aggregate the aggregation was prepared
+    // with.
+    bsoncxx::document::value options;
+
+    // The read preference, which libmongoc takes separately from the options document.
+    stdx::optional<class read_preference> read_preference;
+};
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/private/postlude.hh>
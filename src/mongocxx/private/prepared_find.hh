@@ -0,0 +1,66 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+#include <cstdint>
+
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/stdx/optional.hpp>
+#include <mongocxx/collection.hpp>
+#include <mongocxx/cursor.hpp>
+#include <mongocxx/prepared_find.hpp>
+#include <mongocxx/private/bson_template.hh>
+#include <mongocxx/read_preference.hpp>
+
+#include <mongocxx/config/private/prelude.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+class prepared_find::impl {
+   public:
+    impl(collection coll,
+         bson_template filter,
+         bsoncxx::document::value options,
+         stdx::optional<class read_preference> read_preference,
+         stdx::optional<cursor::type> cursor_type,
+         stdx::optional<std::uint32_t> max_await_time_ms)
+        : coll{std::move(coll)},
+          filter{std::move(filter)},
+          options{std::move(options)},
+          read_preference{std::move(read_preference)},
+          cursor_type{std::move(cursor_type)},
+          max_await_time_ms{std::move(max_await_time_ms)} {}
+
+    // The collection the find runs against.
+    collection coll;
+
+    // The filter, with its parameter slots.
+    bson_template filter;
+
+    // The options document, built once from the options::find the find was prepared with.
+    bsoncxx::document::value options;
+
+    // The options that libmongoc takes separately from the options document.
+    stdx::optional<class read_preference> read_preference;
+    stdx::optional<cursor::type> cursor_type;
+    stdx::optional<std::uint32_t> max_await_time_ms;
+};
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/private/postlude.hh>
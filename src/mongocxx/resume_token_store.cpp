@@ -0,0 +1,194 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <mongocxx/resume_token_store.hpp>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <system_error>
+#include <vector>
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <bsoncxx/string/to_string.hpp>
+#include <bsoncxx/validate.hpp>
+#include <mongocxx/exception/error_code.hpp>
+#include <mongocxx/exception/exception.hpp>
+
+#include <mongocxx/config/private/prelude.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+namespace {
+
+[[noreturn]] void throw_errno(const std::string& what) {
+    throw exception{std::error_code{errno, std::system_category()}, what};
+}
+
+#if defined(_WIN32)
+int open_for_replace(const std::string& path) {
+    return ::_open(
+        path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+}
+
+int write_some(int fd, const std::uint8_t* data, std::size_t length) {
+    return ::_write(fd, data, static_cast<unsigned int>(length));
+}
+
+int sync_file(int fd) {
+    return ::_commit(fd);
+}
+
+int close_file(int fd) {
+    return ::_close(fd);
+}
+
+void replace_file(const std::string& from, const std::string& to) {
+    if (!::MoveFileExA(
+            from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+        throw exception{std::error_code{static_cast<int>(::GetLastError()), std::system_category()},
+                        "could not replace checkpoint file " + to};
+    }
+}
+#else
+int open_for_replace(const std::string& path) {
+    return ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+}
+
+ssize_t write_some(int fd, const std::uint8_t* data, std::size_t length) {
+    return ::write(fd, data, length);
+}
+
+int sync_file(int fd) {
+    return ::fsync(fd);
+}
+
+int close_file(int fd) {
+    return ::close(fd);
+}
+
+void replace_file(const std::string& from, const std::string& to) {
+    if (std::rename(from.c_str(), to.c_str()) != 0) {
+        throw_errno("could not replace checkpoint file " + to);
+    }
+
+    // The rename itself is only durable once the containing directory has been synced.
+    auto slash = to.find_last_of('/');
+    std::string dir = slash == std::string::npos ? "." : to.substr(0, slash + 1);
+    int dir_fd = ::open(dir.c_str(), O_RDONLY);
+    if (dir_fd >= 0) {
+        ::fsync(dir_fd);
+        ::close(dir_fd);
+    }
+}
+#endif
+
+}  // namespace
+
+resume_token_store::resume_token_store() = default;
+resume_token_store::~resume_token_store() = default;
+
+file_resume_token_store::file_resume_token_store(bsoncxx::string::view_or_value path)
+    : _path{bsoncxx::string::to_string(path.view())} {}
+
+file_resume_token_store::~file_resume_token_store() = default;
+
+stdx::optional<bsoncxx::document::value> file_resume_token_store::load() {
+    std::FILE* file = std::fopen(_path.c_str(), "rb");
+    if (!file) {
+        if (errno == ENOENT) {
+            return stdx::nullopt;
+        }
+        throw_errno("could not open checkpoint file " + _path);
+    }
+
+    std::vector<std::uint8_t> bytes;
+    std::uint8_t chunk[512];
+    std::size_t read;
+    while ((read = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        bytes.insert(bytes.end(), chunk, chunk + read);
+    }
+
+    const bool failed = std::ferror(file) != 0;
+    std::fclose(file);
+
+    if (failed) {
+        throw exception{error_code::k_resume_token_store_corrupted,
+                        "could not read checkpoint file " + _path};
+    }
+
+    auto token = bsoncxx::validate(bytes.data(), bytes.size());
+    if (!token) {
+        throw exception{error_code::k_resume_token_store_corrupted,
+                        "checkpoint file " + _path + " does not contain a valid BSON document"};
+    }
+
+    return bsoncxx::document::value{*token};
+}
+
+void file_resume_token_store::store(bsoncxx::document::view token) {
+    const std::string tmp_path = _path + ".tmp";
+
+    int fd = open_for_replace(tmp_path);
+    if (fd < 0) {
+        throw_errno("could not create checkpoint file " + tmp_path);
+    }
+
+    const std::uint8_t* data = token.data();
+    std::size_t remaining = token.length();
+    while (remaining > 0) {
+        auto written = write_some(fd, data, remaining);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            int err = errno;
+            close_file(fd);
+            errno = err;
+            throw_errno("could not write checkpoint file " + tmp_path);
+        }
+        data += written;
+        remaining -= static_cast<std::size_t>(written);
+    }
+
+    if (sync_file(fd) != 0) {
+        int err = errno;
+        close_file(fd);
+        errno = err;
+        throw_errno("could not flush checkpoint file " + tmp_path);
+    }
+
+    if (close_file(fd) != 0) {
+        throw_errno("could not close checkpoint file " + tmp_path);
+    }
+
+    replace_file(tmp_path, _path);
+}
+
+const std::string& file_resume_token_store::path() const {
+    return _path;
+}
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
@@ -0,0 +1,107 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/document/view.hpp>
+#include <bsoncxx/stdx/optional.hpp>
+#include <bsoncxx/string/view_or_value.hpp>
+#include <mongocxx/stdx.hpp>
+
+#include <mongocxx/config/prelude.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+///
+/// The interface that all user-defined change stream checkpoint stores must implement.
+///
+/// A resume_token_store holds at most one resume token. Implementations must make store() atomic:
+/// after a crash, load() returns either the previous token or the new one, never a partial write.
+///
+class MONGOCXX_API resume_token_store {
+   public:
+    virtual ~resume_token_store();
+
+    ///
+    /// Loads the most recently stored resume token.
+    ///
+    /// @return
+    ///   The stored token, or no token if nothing has been stored yet.
+    ///
+    virtual stdx::optional<bsoncxx::document::value> load() = 0;
+
+    ///
+    /// Durably replaces the stored resume token.
+    ///
+    /// @param token
+    ///   The resume token to store.
+    ///
+    virtual void store(bsoncxx::document::view token) = 0;
+
+   protected:
+    ///
+    /// Default constructor
+    ///
+    resume_token_store();
+};
+
+///
+/// A resume_token_store that keeps the token as raw BSON in a local file.
+///
+/// Each store() writes the token to a temporary file next to the target, flushes it to stable
+/// storage, and then renames it over the target, so a crash never leaves a torn checkpoint.
+///
+class MONGOCXX_API file_resume_token_store : public resume_token_store {
+   public:
+    ///
+    /// Constructs a store backed by the file at the given path. The file does not need to exist.
+    ///
+    /// @param path
+    ///   The path of the checkpoint file.
+    ///
+    explicit file_resume_token_store(bsoncxx::string::view_or_value path);
+
+    ~file_resume_token_store() override;
+
+    ///
+    /// @throws mongocxx::exception if the checkpoint file exists but cannot be read or does not
+    ///   contain a valid BSON document.
+    ///
+    stdx::optional<bsoncxx::document::value> load() override;
+
+    ///
+    /// @throws mongocxx::exception if the checkpoint file cannot be written.
+    ///
+    void store(bsoncxx::document::view token) override;
+
+    ///
+    /// Gets the path of the checkpoint file.
+    ///
+    /// @return
+    ///   The path of the checkpoint file.
+    ///
+    const std::string& path() const;
+
+   private:
+    std::string _path;
+};
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/postlude.hpp>
@@ -0,0 +1,241 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+#include <bsoncxx/builder/basic/array.hpp>
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/private/libbson.hh>
+#include <bsoncxx/test_util/catch.hh>
+#include <bsoncxx/types.hpp>
+#include <mongocxx/arrow_export.hpp>
+#include <mongocxx/client.hpp>
+#include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/instance.hpp>
+#include <mongocxx/private/libmongoc.hh>
+
+#include <third_party/catch/include/helpers.hpp>
+
+namespace {
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_array;
+using bsoncxx::builder::basic::make_document;
+
+using namespace mongocxx;
+
+template <typename T>
+T value_at(const ArrowArray* array, std::size_t buffer, std::size_t index) {
+    return static_cast<const T*>(array->buffers[buffer])[index];
+}
+
+bool bit_at(const ArrowArray* array, std::size_t buffer, std::size_t index) {
+    const auto* bits = static_cast<const std::uint8_t*>(array->buffers[buffer]);
+    return bits && ((bits[index / 8] >> (index % 8)) & 1) != 0;
+}
+
+std::vector<arrow_field> test_schema() {
+    return {arrow_field{"name", bsoncxx::type::k_utf8},
+            arrow_field{"price", bsoncxx::type::k_double},
+            arrow_field{"tags",
+                        bsoncxx::type::k_array,
+                        {arrow_field{"item", bsoncxx::type::k_utf8}}},
+            arrow_field{"dims",
+                        bsoncxx::type::k_document,
+                        {arrow_field{"w", bsoncxx::type::k_int32},
+                         arrow_field{"h", bsoncxx::type::k_int32}}},
+            arrow_field{"ok", bsoncxx::type::k_bool}};
+}
+
+TEST_CASE("arrow_exporter exports cursor results as Arrow arrays", "[arrow_export]") {
+    instance::current();
+
+    MOCK_CLIENT
+    MOCK_DATABASE
+    MOCK_COLLECTION
+    MOCK_CURSOR
+
+    client mongo_client{uri{}};
+    collection coll = mongo_client["arrow"]["export"];
+
+    std::vector<bsoncxx::document::value> docs;
+    docs.push_back(make_document(kvp("name", "a"),
+                                 kvp("price", 1.5),
+                                 kvp("tags", make_array("x", "y")),
+                                 kvp("dims", make_document(kvp("w", 1), kvp("h", 2))),
+                                 kvp("ok", true)));
+    docs.push_back(make_document(kvp("price", 2),
+                                 kvp("name", 7),
+                                 kvp("tags", "not an array"),
+                                 kvp("dims", make_document(kvp("w", 3)))));
+    docs.push_back(make_document(kvp("price", 3.0), kvp("tags", make_array()), kvp("dims", "x")));
+
+    std::vector<bson_t> bsons(docs.size());
+    for (std::size_t i = 0; i < docs.size(); ++i) {
+        bson_init_static(&bsons[i], docs[i].view().data(), docs[i].view().length());
+    }
+
+    MOCK_CURSOR_DOCUMENTS(bsons)
+
+    SECTION("the schema describes a struct of the fields") {
+        arrow_exporter exporter{coll.find({}), test_schema()};
+
+        ArrowSchema schema;
+        exporter.export_schema(&schema);
+
+        REQUIRE(std::strcmp(schema.format, "+s") == 0);
+        REQUIRE(schema.n_children == 5);
+        REQUIRE(std::strcmp(schema.children[0]->format, "u") == 0);
+        REQUIRE(std::strcmp(schema.children[1]->format, "g") == 0);
+        REQUIRE(std::strcmp(schema.children[2]->format, "+l") == 0);
+        REQUIRE(std::strcmp(schema.children[2]->children[0]->format, "u") == 0);
+        REQUIRE(std::strcmp(schema.children[3]->format, "+s") == 0);
+        REQUIRE(std::strcmp(schema.children[3]->children[1]->name, "h") == 0);
+        REQUIRE(std::strcmp(schema.children[4]->format, "b") == 0);
+        REQUIRE(schema.children[4]->flags == ARROW_FLAG_NULLABLE);
+
+        schema.release(&schema);
+        REQUIRE(schema.release == nullptr);
+    }
+
+    auto check_batches = [&](options::arrow_export options) {
+        arrow_exporter exporter{coll.find({}), test_schema(), options.batch_size(2)};
+
+        ArrowArray batch;
+        REQUIRE(exporter.next_batch(&batch));
+        REQUIRE(batch.length == 2);
+        REQUIRE(batch.n_children == 5);
+
+        const ArrowArray* name = batch.children[0];
+        REQUIRE(name->null_count == 1);
+        REQUIRE(bit_at(name, 0, 0));
+        REQUIRE(!bit_at(name, 0, 1));
+        REQUIRE(value_at<std::int32_t>(name, 1, 1) == 1);
+        REQUIRE(value_at<std::int32_t>(name, 1, 2) == 1);
+        REQUIRE(value_at<char>(name, 2, 0) == 'a');
+
+        const ArrowArray* price = batch.children[1];
+        REQUIRE(price->null_count == 0);
+        REQUIRE(price->buffers[0] == nullptr);
+        REQUIRE(value_at<double>(price, 1, 0) == 1.5);
+        REQUIRE(value_at<double>(price, 1, 1) == 2.0);
+
+        const ArrowArray* tags = batch.children[2];
+        REQUIRE(tags->null_count == 1);
+        REQUIRE(value_at<std::int32_t>(tags, 1, 1) == 2);
+        REQUIRE(value_at<std::int32_t>(tags, 1, 2) == 2);
+        REQUIRE(tags->children[0]->length == 2);
+        REQUIRE(value_at<char>(tags->children[0], 2, 1) == 'y');
+
+        const ArrowArray* dims = batch.children[3];
+        REQUIRE(dims->null_count == 0);
+        REQUIRE(dims->children[0]->length == 2);
+        REQUIRE(value_at<std::int32_t>(dims->children[0], 1, 1) == 3);
+        REQUIRE(dims->children[1]->null_count == 1);
+        REQUIRE(!bit_at(dims->children[1], 0, 1));
+
+        const ArrowArray* ok = batch.children[4];
+        REQUIRE(bit_at(ok, 1, 0));
+        REQUIRE(!bit_at(ok, 0, 1));
+
+        batch.release(&batch);
+        REQUIRE(batch.release == nullptr);
+
+        REQUIRE(exporter.next_batch(&batch));
+        REQUIRE(batch.length == 1);
+        REQUIRE(batch.children[2]->null_count == 0);
+        REQUIRE(batch.children[2]->children[0]->length == 0);
+        REQUIRE(batch.children[3]->null_count == 1);
+        REQUIRE(batch.children[3]->children[0]->length == 1);
+        batch.release(&batch);
+
+        REQUIRE(!exporter.next_batch(&batch));
+    };
+
+    SECTION("batches are filled on the calling thread") {
+        check_batches(options::arrow_export{});
+    }
+
+    SECTION("batches are filled by several threads") {
+        check_batches(options::arrow_export{}.threads(3));
+    }
+
+    SECTION("a duplicated key is read from its first occurrence the field accepts") {
+        docs.clear();
+        docs.push_back(make_document(kvp("price", "n/a"),
+                                     kvp("dims", 1),
+                                     kvp("price", 4.5),
+                                     kvp("dims", make_document(kvp("w", "x"), kvp("w", 5))),
+                                     kvp("price", 6.0)));
+        bson_init_static(&bsons[0], docs[0].view().data(), docs[0].view().length());
+        bsons.resize(1);
+
+        for (auto&& options : {options::arrow_export{}, options::arrow_export{}.threads(3)}) {
+            arrow_exporter exporter{coll.find({}), test_schema(), options};
+
+            ArrowArray batch;
+            REQUIRE(exporter.next_batch(&batch));
+            REQUIRE(batch.length == 1);
+
+            const ArrowArray* price = batch.children[1];
+            REQUIRE(price->null_count == 0);
+            REQUIRE(value_at<double>(price, 1, 0) == 4.5);
+
+            const ArrowArray* dims = batch.children[3];
+            REQUIRE(dims->null_count == 0);
+            REQUIRE(dims->children[0]->null_count == 0);
+            REQUIRE(value_at<std::int32_t>(dims->children[0], 1, 0) == 5);
+            REQUIRE(dims->children[1]->null_count == 1);
+
+            batch.release(&batch);
+        }
+    }
+
+    SECTION("an exporter can be exported as a stream") {
+        ArrowArrayStream stream;
+        arrow_exporter::export_stream(arrow_exporter{coll.find({}), test_schema()}, &stream);
+
+        ArrowSchema schema;
+        REQUIRE(stream.get_schema(&stream, &schema) == 0);
+        REQUIRE(schema.n_children == 5);
+        schema.release(&schema);
+
+        ArrowArray batch;
+        REQUIRE(stream.get_next(&stream, &batch) == 0);
+        REQUIRE(batch.length == 3);
+        batch.release(&batch);
+
+        REQUIRE(stream.get_next(&stream, &batch) == 0);
+        REQUIRE(batch.release == nullptr);
+        REQUIRE(stream.get_last_error(&stream) == nullptr);
+
+        stream.release(&stream);
+        REQUIRE(stream.release == nullptr);
+    }
+
+    SECTION("invalid schemas and options are rejected") {
+        REQUIRE_THROWS_AS(arrow_field("a", bsoncxx::type::k_array), logic_error);
+        REQUIRE_THROWS_AS(arrow_field("a", bsoncxx::type::k_document), logic_error);
+        REQUIRE_THROWS_AS(arrow_field("a", bsoncxx::type::k_oid), logic_error);
+        REQUIRE_THROWS_AS(arrow_exporter(coll.find({}), {}), logic_error);
+        REQUIRE_THROWS_AS(
+            arrow_exporter(coll.find({}), test_schema(), options::arrow_export{}.threads(0)),
+            logic_error);
+    }
+}
+
+}  // namespace
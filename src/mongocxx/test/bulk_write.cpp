@@ -12,6 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <vector>
+
+#include <bsoncxx/builder/basic/array.hpp>
 #include <bsoncxx/builder/basic/document.hpp>
 #include <bsoncxx/test_util/catch.hh>
 #include <bsoncxx/types.hpp>
@@ -25,6 +28,7 @@ namespace {
 using namespace mongocxx;
 
 using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_array;
 using bsoncxx::builder::basic::make_document;
 
 TEST_CASE("a bulk_write will setup a mongoc bulk operation", "[bulk_write]") {
@@ -107,7 +111,11 @@ class update_functor {
         REQUIRE(bson_get_data(filter) == _filter.data());
         REQUIRE(bson_get_data(update) == _update.data());
 
-        bsoncxx::document::view options_view{bson_get_data(options), options->len};
+        // Models without options are appended without an options document.
+        bsoncxx::document::view options_view;
+        if (options) {
+            options_view = bsoncxx::document::view{bson_get_data(options), options->len};
+        }
 
         bsoncxx::document::element collation = options_view["collation"];
         if (_expected_collation) {
@@ -156,7 +164,11 @@ class delete_functor {
         *_called = true;
         REQUIRE(bson_get_data(filter) == _filter.data());
 
-        bsoncxx::document::view options_view{bson_get_data(options), options->len};
+        // Models without options are appended without an options document.
+        bsoncxx::document::view options_view;
+        if (options) {
+            options_view = bsoncxx::document::view{bson_get_data(options), options->len};
+        }
 
         bsoncxx::document::element collation = options_view["collation"];
         if (_expected_collation) {
@@ -242,6 +254,49 @@ TEST_CASE("passing write operations to append calls corresponding C function", "
         REQUIRE(called);
     }
 
+    SECTION("update_one without options passes no options document") {
+        auto bulk_update = libmongoc::bulk_operation_update_one_with_opts.create_instance();
+        bulk_update->visit([&](mongoc_bulk_operation_t*,
+                               const bson_t*,
+                               const bson_t*,
+                               const bson_t* options,
+                               bson_error_t*) {
+            called = true;
+            REQUIRE(options == nullptr);
+        });
+
+        bw.append(model::update_one(filter, update_doc));
+        REQUIRE(called);
+    }
+
+    SECTION("update_one options are rebuilt for each appended model") {
+        auto bulk_update = libmongoc::bulk_operation_update_one_with_opts.create_instance();
+        std::vector<bsoncxx::document::value> sent;
+        bulk_update->visit([&](mongoc_bulk_operation_t*,
+                               const bson_t*,
+                               const bson_t*,
+                               const bson_t* options,
+                               bson_error_t*) {
+            sent.emplace_back(bsoncxx::document::view{bson_get_data(options), options->len});
+        });
+
+        auto array_filters = make_array(make_document(kvp("x", 1)));
+
+        model::update_one first(filter, update_doc);
+        first.hint(hint{"index_name"});
+        first.array_filters(array_filters.view());
+        bw.append(first);
+
+        model::update_one second(filter, update_doc);
+        second.upsert(false);
+        bw.append(second);
+
+        REQUIRE(sent.size() == 2);
+        REQUIRE(sent[0].view() == make_document(kvp("hint", "index_name"),
+                                                kvp("arrayFilters", array_filters.view())));
+        REQUIRE(sent[1].view() == make_document(kvp("upsert", false)));
+    }
+
     SECTION("update_many invokes mongoc_bulk_operation_update_many_with_opts") {
         auto bulk_update = libmongoc::bulk_operation_update_many_with_opts.create_instance();
         bulk_update->visit(update_func);
@@ -0,0 +1,145 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/private/libbson.hh>
+#include <bsoncxx/test_util/catch.hh>
+#include <mongocxx/change_stream_dispatcher.hpp>
+#include <mongocxx/client.hpp>
+#include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/instance.hpp>
+#include <mongocxx/private/libmongoc.hh>
+
+#include <third_party/catch/include/helpers.hpp>
+
+namespace {
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_document;
+
+using namespace mongocxx;
+
+TEST_CASE("change_stream_dispatcher partitions events by key", "[change_stream_dispatcher]") {
+    MOCK_CHANGE_STREAM
+
+    instance::current();
+    client mongodb_client{uri{}};
+    collection events = mongodb_client["streams"]["events"];
+
+    const std::int32_t k_num_events = 100;
+    const std::int32_t k_num_keys = 7;
+
+    std::vector<bsoncxx::document::value> stream_docs;
+    for (std::int32_t i = 0; i < k_num_events; ++i) {
+        stream_docs.emplace_back(make_document(kvp("_id", make_document(kvp("token", i))),
+                                               kvp("documentKey",
+                                                   make_document(kvp("_id", i % k_num_keys))),
+                                               kvp("seq", i)));
+    }
+
+    std::size_t next_doc = 0;
+    bson_t current;
+    collection_watch
+        ->interpose([](const mongoc_collection_t*, const bson_t*, const bson_t*)
+                        -> mongoc_change_stream_t* { return nullptr; })
+        .forever();
+    change_stream_destroy->interpose([](mongoc_change_stream_t*) {}).forever();
+    change_stream_next
+        ->interpose([&](mongoc_change_stream_t*, const bson_t** bson) {
+            if (next_doc == stream_docs.size()) {
+                return false;
+            }
+            auto view = stream_docs[next_doc++].view();
+            bson_init_static(&current, view.data(), view.length());
+            *bson = &current;
+            return true;
+        })
+        .forever();
+    change_stream_error_document
+        ->interpose([](const mongoc_change_stream_t*, bson_error_t*, const bson_t** bson) {
+            *bson = nullptr;
+            return false;
+        })
+        .forever();
+
+    auto get_resume_token = libmongoc::change_stream_get_resume_token.create_instance();
+    get_resume_token->interpose([](mongoc_change_stream_t*) -> const bson_t* { return nullptr; })
+        .forever();
+
+    auto stream = events.watch();
+
+    SECTION("events for the same key are handled in stream order") {
+        std::mutex mutex;
+        std::map<std::int32_t, std::vector<std::int32_t>> seen;
+
+        change_stream_dispatcher dispatcher{
+            &stream,
+            [&](const bsoncxx::document::view& event) {
+                std::lock_guard<std::mutex> lock{mutex};
+                seen[event["documentKey"]["_id"].get_int32().value].push_back(
+                    event["seq"].get_int32().value);
+            },
+            options::change_stream_dispatcher{}.worker_count(4).max_pending_events(8)};
+
+        REQUIRE(dispatcher.worker_count() == 4);
+        REQUIRE(dispatcher.dispatch() == static_cast<std::size_t>(k_num_events));
+        dispatcher.wait();
+
+        REQUIRE(seen.size() == static_cast<std::size_t>(k_num_keys));
+        for (auto&& key : seen) {
+            std::int32_t expected = key.first;
+            for (auto seq : key.second) {
+                REQUIRE(seq == expected);
+                expected += k_num_keys;
+            }
+        }
+
+        auto token = dispatcher.safe_resume_token();
+        REQUIRE(token);
+        REQUIRE(token->view() == make_document(kvp("token", k_num_events - 1)).view());
+    }
+
+    SECTION("the first handler exception is rethrown") {
+        change_stream_dispatcher dispatcher{
+            &stream,
+            [](const bsoncxx::document::view& event) {
+                if (event["seq"].get_int32().value == 0) {
+                    throw std::runtime_error{"handler failed"};
+                }
+            },
+            options::change_stream_dispatcher{}.worker_count(2)};
+
+        // The failure may surface from either call depending on when the worker reaches it.
+        auto run = [&] {
+            dispatcher.dispatch();
+            dispatcher.wait();
+        };
+        REQUIRE_THROWS_AS(run(), std::runtime_error);
+        REQUIRE(!dispatcher.safe_resume_token());
+    }
+
+    SECTION("a non-positive worker count is rejected") {
+        REQUIRE_THROWS_AS(
+            change_stream_dispatcher(&stream,
+                                     [](const bsoncxx::document::view&) {},
+                                     options::change_stream_dispatcher{}.worker_count(0)),
+            logic_error);
+    }
+}
+}  // namespace
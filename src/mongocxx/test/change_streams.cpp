@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #include <iostream>
+#include <string>
+#include <vector>
 
 #include <bsoncxx/builder/basic/document.hpp>
 #include <bsoncxx/document/value.hpp>
@@ -362,6 +364,157 @@ TEST_CASE("Mock streams and error-handling") {
     }
 }
 
+TEST_CASE("Mock batched consumption") {
+    MOCK_CHANGE_STREAM
+
+    instance::current();
+    client mongodb_client{uri{}};
+    collection events = mongodb_client["streams"]["events"];
+
+    collection_watch->interpose(watch_interpose).forever();
+    change_stream_destroy->interpose(destroy_interpose).forever();
+    auto stream = events.watch();
+
+    // Three notifications make up one server batch, followed by its postBatchResumeToken.
+    std::vector<bsoncxx::document::value> batch_docs;
+    for (int i = 0; i < 3; ++i) {
+        batch_docs.push_back(make_document(kvp("_id", make_document(kvp("_data", i)))));
+    }
+    bsoncxx::document::value post_batch_token = make_document(kvp("_data", "post"));
+
+    std::size_t returned = 0;
+    bson_t current;
+    bson_t token;
+    change_stream_next
+        ->interpose([&](mongoc_change_stream_t*, const bson_t** bson) {
+            if (returned == batch_docs.size()) {
+                return false;
+            }
+            auto view = batch_docs[returned++].view();
+            bson_init_static(&current, view.data(), view.length());
+            *bson = &current;
+            return true;
+        })
+        .forever();
+    change_stream_error_document->interpose(gen_error(false)).forever();
+
+    auto get_resume_token = libmongoc::change_stream_get_resume_token.create_instance();
+    get_resume_token
+        ->interpose([&](mongoc_change_stream_t*) -> const bson_t* {
+            auto view = returned == batch_docs.size()
+                            ? post_batch_token.view()
+                            : batch_docs[returned - 1].view()["_id"].get_document().value;
+            bson_init_static(&token, view.data(), view.length());
+            return &token;
+        })
+        .forever();
+
+    SECTION("A batch is returned whole with its postBatchResumeToken") {
+        auto batch = stream.next_batch();
+
+        REQUIRE(batch.size() == 3);
+        REQUIRE(returned == 3);
+        std::size_t i = 0;
+        for (auto&& event : batch) {
+            REQUIRE(event == batch_docs[i++].view());
+        }
+        REQUIRE(*batch.resume_token() == post_batch_token.view());
+        REQUIRE(stream.begin() == stream.end());
+
+        SECTION("An empty batch still reports the latest token") {
+            auto empty = stream.next_batch();
+            REQUIRE(empty.empty());
+            REQUIRE(*empty.resume_token() == post_batch_token.view());
+        }
+    }
+
+    SECTION("A batch picks up where iteration left off") {
+        auto it = stream.begin();
+        REQUIRE(*it == batch_docs[0].view());
+
+        auto batch = stream.next_batch();
+        REQUIRE(batch.size() == 2);
+        REQUIRE(*batch.begin() == batch_docs[1].view());
+        REQUIRE(it == stream.end());
+    }
+
+    SECTION("An error is reported once the batch is consumed") {
+        stream.next_batch();
+
+        change_stream_error_document->interpose(gen_error(true)).forever();
+        REQUIRE_THROWS(stream.next_batch());
+        REQUIRE(stream.next_batch().empty());
+        REQUIRE(stream.begin() == stream.end());
+    }
+}
+
+TEST_CASE("Mock batched consumption when the postBatchResumeToken equals the last _id") {
+    MOCK_CHANGE_STREAM
+
+    instance::current();
+    client mongodb_client{uri{}};
+    collection events = mongodb_client["streams"]["events"];
+
+    collection_watch->interpose(watch_interpose).forever();
+    change_stream_destroy->interpose(destroy_interpose).forever();
+
+    // A busy stream: every getMore returns more notifications and the resume token is always the
+    // _id of the latest one, so no postBatchResumeToken ever marks the end of a batch.
+    const std::string padding(1024, 'x');
+    std::int32_t returned = 0;
+    bsoncxx::document::value current_doc = make_document();
+    bson_t current;
+    bson_t token;
+    change_stream_next
+        ->interpose([&](mongoc_change_stream_t*, const bson_t** bson) {
+            current_doc = make_document(kvp("_id", make_document(kvp("_data", returned++))),
+                                        kvp("padding", padding));
+            bson_init_static(&current, current_doc.view().data(), current_doc.view().length());
+            *bson = &current;
+            return true;
+        })
+        .forever();
+    change_stream_error_document->interpose(gen_error(false)).forever();
+
+    auto get_resume_token = libmongoc::change_stream_get_resume_token.create_instance();
+    get_resume_token
+        ->interpose([&](mongoc_change_stream_t*) -> const bson_t* {
+            auto view = current_doc.view()["_id"].get_document().value;
+            bson_init_static(&token, view.data(), view.length());
+            return &token;
+        })
+        .forever();
+
+    SECTION("A batch ends after batch_size notifications") {
+        auto stream = events.watch(options::change_stream{}.batch_size(2));
+
+        auto batch = stream.next_batch();
+        REQUIRE(batch.size() == 2);
+        REQUIRE(returned == 2);
+        REQUIRE(*batch.resume_token() == make_document(kvp("_data", 1)).view());
+
+        REQUIRE(stream.next_batch().size() == 2);
+        REQUIRE(returned == 4);
+    }
+
+    SECTION("A batch without a batch_size is bounded by the size of a server reply") {
+        auto stream = events.watch();
+
+        auto batch = stream.next_batch();
+        REQUIRE(!batch.empty());
+        REQUIRE(static_cast<std::size_t>(returned) == batch.size());
+
+        std::size_t bytes = 0;
+        std::size_t last_length = 0;
+        for (auto&& event : batch) {
+            bytes += event.length();
+            last_length = event.length();
+        }
+        REQUIRE(bytes >= 16 * 1024 * 1024);
+        REQUIRE(bytes - last_length < 16 * 1024 * 1024);
+    }
+}
+
 // Put this before other tests which assume the collections already exists.
 TEST_CASE("Create streams.events and assert we can read a single event", "[min36]") {
     instance::current();
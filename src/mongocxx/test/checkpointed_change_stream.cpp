@@ -0,0 +1,216 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/private/libbson.hh>
+#include <bsoncxx/test_util/catch.hh>
+#include <mongocxx/checkpointed_change_stream.hpp>
+#include <mongocxx/client.hpp>
+#include <mongocxx/exception/exception.hpp>
+#include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/instance.hpp>
+#include <mongocxx/private/libmongoc.hh>
+
+#include <third_party/catch/include/helpers.hpp>
+
+namespace {
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_document;
+
+using namespace mongocxx;
+
+// A resume_token_store that keeps the token in memory and counts writes.
+class memory_store : public resume_token_store {
+   public:
+    stdx::optional<bsoncxx::document::value> load() override {
+        return token;
+    }
+
+    void store(bsoncxx::document::view new_token) override {
+        token = bsoncxx::document::value{new_token};
+        ++writes;
+    }
+
+    stdx::optional<bsoncxx::document::value> token;
+    int writes = 0;
+};
+
+TEST_CASE("file_resume_token_store round-trips a token", "[resume_token_store]") {
+    instance::current();
+
+    const std::string path = "test_checkpoint_resume_token.bson";
+    std::remove(path.c_str());
+
+    file_resume_token_store store{path};
+
+    SECTION("a missing file has no token") {
+        REQUIRE(!store.load());
+    }
+
+    SECTION("the last stored token is loaded") {
+        store.store(make_document(kvp("_data", "first")));
+        store.store(make_document(kvp("_data", "second")));
+
+        auto token = store.load();
+        REQUIRE(token);
+        REQUIRE(token->view() == make_document(kvp("_data", "second")).view());
+
+        file_resume_token_store reopened{path};
+        REQUIRE(reopened.load()->view() == token->view());
+    }
+
+    SECTION("a corrupted file is reported") {
+        {
+            std::ofstream out{path, std::ios::binary};
+            out << "not bson";
+        }
+        REQUIRE_THROWS_AS(store.load(), mongocxx::exception);
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST_CASE("checkpointed_change_stream resumes from and writes checkpoints",
+          "[checkpointed_change_stream]") {
+    MOCK_CHANGE_STREAM
+
+    instance::current();
+    client mongodb_client{uri{}};
+    collection events = mongodb_client["streams"]["events"];
+
+    // The stream alternates between two events. A server's resume token is the _id of the last
+    // event returned, not the whole event.
+    bsoncxx::document::value events_read[] = {
+        make_document(kvp("_id", make_document(kvp("_data", "a")))),
+        make_document(kvp("_id", make_document(kvp("_data", "b"))))};
+    bson_t event_bson[2];
+    bson_t token_bson[2];
+    for (int i = 0; i < 2; ++i) {
+        bsoncxx::document::view event = events_read[i].view();
+        bsoncxx::document::view token = event["_id"].get_document().value;
+        bson_init_static(&event_bson[i], event.data(), event.length());
+        bson_init_static(&token_bson[i], token.data(), token.length());
+    }
+    int next_event = 0;
+    int last_event = 0;
+
+    bsoncxx::stdx::optional<bsoncxx::document::value> watch_opts;
+    collection_watch
+        ->interpose([&](const mongoc_collection_t*,
+                        const bson_t*,
+                        const bson_t* opts) -> mongoc_change_stream_t* {
+            watch_opts = bsoncxx::document::value{
+                bsoncxx::document::view{bson_get_data(opts), opts->len}};
+            return nullptr;
+        })
+        .forever();
+    change_stream_destroy->interpose([](mongoc_change_stream_t*) {}).forever();
+    change_stream_next
+        ->interpose([&](mongoc_change_stream_t*, const bson_t** bson) {
+            last_event = next_event;
+            next_event = (next_event + 1) % 2;
+            *bson = &event_bson[last_event];
+            return true;
+        })
+        .forever();
+
+    auto get_resume_token = libmongoc::change_stream_get_resume_token.create_instance();
+    get_resume_token
+        ->interpose([&](mongoc_change_stream_t*) -> const bson_t* {
+            return &token_bson[last_event];
+        })
+        .forever();
+
+    auto store = std::make_shared<memory_store>();
+
+    SECTION("a fresh store keeps the caller's starting point") {
+        checkpointed_change_stream stream{
+            events,
+            store,
+            {},
+            {},
+            options::change_stream{}.start_after(make_document(kvp("_data", "start")))};
+
+        REQUIRE(watch_opts);
+        REQUIRE(!watch_opts->view()["resumeAfter"]);
+        REQUIRE(watch_opts->view()["startAfter"]);
+    }
+
+    SECTION("a stored checkpoint takes precedence") {
+        store->token = make_document(kvp("_data", "stored"));
+
+        checkpointed_change_stream stream{
+            events,
+            store,
+            {},
+            {},
+            options::change_stream{}.start_after(make_document(kvp("_data", "start")))};
+
+        REQUIRE(watch_opts);
+        REQUIRE(watch_opts->view()["resumeAfter"].get_document().value ==
+                make_document(kvp("_data", "stored")).view());
+        REQUIRE(!watch_opts->view()["startAfter"]);
+    }
+
+    SECTION("a checkpoint is written every event_interval acknowledgements") {
+        checkpointed_change_stream stream{
+            events,
+            store,
+            options::checkpoint{}.event_interval(3).time_interval(std::chrono::hours{1})};
+
+        auto it = stream.begin();
+        for (int i = 0; i < 7; ++i, ++it) {
+            REQUIRE(stream.acknowledge(*it) == ((i + 1) % 3 == 0));
+        }
+
+        // The sixth event acknowledged was "b".
+        REQUIRE(store->writes == 2);
+        REQUIRE(store->token->view() == make_document(kvp("_data", "b")).view());
+
+        stream.checkpoint();
+        REQUIRE(store->writes == 3);
+        REQUIRE(store->token->view() == make_document(kvp("_data", "a")).view());
+    }
+
+    SECTION("a checkpoint holds the acknowledged event, not one read ahead of it") {
+        checkpointed_change_stream stream{events, store, options::checkpoint{}.event_interval(1)};
+
+        auto it = stream.begin();
+        bsoncxx::document::value first{*it};
+        ++it;
+        REQUIRE((*it)["_id"].get_document().value == make_document(kvp("_data", "b")).view());
+
+        REQUIRE(stream.acknowledge(first.view()));
+        REQUIRE(store->token->view() == make_document(kvp("_data", "a")).view());
+    }
+
+    SECTION("checkpoint() writes nothing before an event is acknowledged") {
+        checkpointed_change_stream stream{events, store};
+
+        stream.checkpoint();
+        REQUIRE(store->writes == 0);
+    }
+
+    SECTION("a non-positive interval is rejected") {
+        REQUIRE_THROWS_AS(checkpointed_change_stream(
+                              events, store, options::checkpoint{}.event_interval(0)),
+                          logic_error);
+    }
+}
+}  // namespace
@@ -29,6 +29,7 @@
 #include <mongocxx/database.hpp>
 #include <mongocxx/exception/logic_error.hpp>
 #include <mongocxx/exception/operation_exception.hpp>
+#include <mongocxx/exception/server_error_code.hpp>
 #include <mongocxx/instance.hpp>
 #include <mongocxx/options/update.hpp>
 #include <mongocxx/pipeline.hpp>
@@ -462,6 +463,42 @@ TEST_CASE("Collection", "[collection]") {
         }
     }
 
+    SECTION("Find One With An Error Code", "[collection::find_one]") {
+        std::vector<bson_t> no_documents;
+        bool query_fails = true;
+
+        MOCK_CURSOR_DOCUMENTS(no_documents)
+        cursor_error_document
+            ->interpose([&](mongoc_cursor_t*, bson_error_t* error, const bson_t** reply) {
+                if (!query_fails) {
+                    return false;
+                }
+                bson_set_error(error, MONGOC_ERROR_SERVER, 13, "not authorized");
+                *reply = nullptr;
+                return true;
+            })
+            .forever();
+
+        SECTION("...reports the failure without throwing") {
+            std::error_code ec;
+            mongocxx::stdx::optional<bsoncxx::document::value> result;
+
+            REQUIRE_NOTHROW(result = mongo_coll.find_one({}, ec));
+            REQUIRE(!result);
+            REQUIRE(ec == std::error_code(13, server_error_category()));
+
+            REQUIRE_THROWS_AS(mongo_coll.find_one({}), operation_exception);
+        }
+
+        SECTION("...clears the error code when no document matches") {
+            query_fails = false;
+            std::error_code ec{13, server_error_category()};
+
+            REQUIRE(!mongo_coll.find_one({}, ec));
+            REQUIRE(!ec);
+        }
+    }
+
     SECTION("Writes", "[collection::writes]") {
         auto expected_order_setting = false;
         auto expect_set_bypass_document_validation_called = false;
@@ -568,6 +605,108 @@ TEST_CASE("Collection", "[collection]") {
             perform_checks();
         }
 
+        SECTION("Insert Many From A BSON Sequence", "[collection::insert_many]") {
+            expected_order_setting = true;
+
+            auto with_id = make_document(kvp("_id", 1), kvp("x", 1));
+            auto without_id = make_document(kvp("x", 2));
+
+            std::vector<std::uint8_t> sequence;
+            sequence.insert(sequence.end(),
+                            with_id.view().data(),
+                            with_id.view().data() + with_id.view().length());
+            sequence.insert(sequence.end(),
+                            without_id.view().data(),
+                            without_id.view().data() + without_id.view().length());
+
+            std::vector<bsoncxx::document::value> inserted;
+            std::vector<const std::uint8_t*> inserted_data;
+            bulk_operation_insert_with_opts->interpose(
+                [&](mongoc_bulk_operation_t*, const bson_t* doc, const bson_t*, bson_error_t*) {
+                    bulk_operation_op_called = true;
+                    inserted.emplace_back(bsoncxx::document::view{bson_get_data(doc), doc->len});
+                    inserted_data.push_back(bson_get_data(doc));
+                    return true;
+                })
+                .forever();
+
+            SECTION("...inserts each document") {
+                mongo_coll.insert_many(sequence.data(), sequence.size());
+                perform_checks();
+
+                REQUIRE(inserted.size() == 2);
+
+                // A document with an _id is passed straight from the sequence.
+                REQUIRE(inserted_data[0] == sequence.data());
+                REQUIRE(inserted[0].view() == with_id.view());
+
+                REQUIRE(inserted[1].view()["_id"].type() == bsoncxx::type::k_oid);
+                REQUIRE(inserted[1].view()["x"].get_int32().value == 2);
+            }
+
+            SECTION("...rejects an empty sequence") {
+                REQUIRE_THROWS_AS(mongo_coll.insert_many(sequence.data(), 0), logic_error);
+                REQUIRE(!bulk_operation_op_called);
+            }
+
+            SECTION("...rejects a truncated document") {
+                REQUIRE_THROWS_AS(mongo_coll.insert_many(sequence.data(), sequence.size() - 1),
+                                  logic_error);
+                REQUIRE(inserted.size() == 1);
+            }
+
+            SECTION("...executes bounded batches and merges their results") {
+                sequence.clear();
+                for (std::int32_t i = 0; i < 100001; ++i) {
+                    auto doc = make_document(kvp("_id", i));
+                    sequence.insert(
+                        sequence.end(), doc.view().data(), doc.view().data() + doc.view().length());
+                }
+
+                int bulks_created = 0;
+                std::vector<std::int32_t> batch_sizes;
+                collection_create_bulk_operation_with_opts
+                    ->interpose([&](mongoc_collection_t*, const bson_t*) {
+                        ++bulks_created;
+                        batch_sizes.push_back(0);
+                        return static_cast<mongoc_bulk_operation_t*>(nullptr);
+                    })
+                    .forever();
+                bulk_operation_insert_with_opts
+                    ->interpose([&](mongoc_bulk_operation_t*,
+                                    const bson_t*,
+                                    const bson_t*,
+                                    bson_error_t*) {
+                        ++batch_sizes.back();
+                        return true;
+                    })
+                    .forever();
+                bulk_operation_execute
+                    ->interpose([&](mongoc_bulk_operation_t*, bson_t* reply, bson_error_t*) {
+                        libbson::scoped_bson_t doc{
+                            make_document(kvp("nInserted", batch_sizes.back()),
+                                          kvp("nMatched", 0),
+                                          kvp("nModified", 0),
+                                          kvp("nRemoved", 0),
+                                          kvp("nUpserted", 0))};
+                        ::bson_copy_to(doc.bson(), reply);
+                        return 1;
+                    })
+                    .forever();
+                bulk_operation_destroy->interpose([&](mongoc_bulk_operation_t*) {}).forever();
+
+                auto result = mongo_coll.insert_many(sequence.data(), sequence.size());
+
+                REQUIRE(bulks_created == 2);
+                REQUIRE(batch_sizes == std::vector<std::int32_t>{100000, 1});
+                REQUIRE(result);
+                REQUIRE(result->inserted_count() == 100001);
+
+                // The _ids would grow with the sequence, so they are not collected.
+                REQUIRE(result->inserted_ids().empty());
+            }
+        }
+
         SECTION("Update One", "[collection::update_one]") {
             bool upsert_option = false;
             expected_order_setting = true;
@@ -658,6 +797,47 @@ TEST_CASE("Collection", "[collection]") {
             perform_checks();
         }
 
+        SECTION("Insert One With An Error Code", "[collection::insert_one]") {
+            expected_order_setting = true;
+            bool execute_fails = true;
+
+            bulk_operation_insert_with_opts->interpose(
+                [&](mongoc_bulk_operation_t*, const bson_t*, const bson_t*, bson_error_t*) {
+                    bulk_operation_op_called = true;
+                    return true;
+                });
+            bulk_operation_execute->interpose(
+                [&](mongoc_bulk_operation_t*, bson_t* reply, bson_error_t* err) {
+                    bulk_operation_execute_called = true;
+                    bson_init(reply);
+                    if (!execute_fails) {
+                        return 1;
+                    }
+                    bson_set_error(err, MONGOC_ERROR_SERVER, 11000, "duplicate key");
+                    return 0;
+                });
+
+            SECTION("...reports the failure without throwing") {
+                std::error_code ec;
+                mongocxx::stdx::optional<result::insert_one> result;
+
+                REQUIRE_NOTHROW(result = mongo_coll.insert_one(filter_doc.view(), ec));
+                REQUIRE(!result);
+                REQUIRE(ec == std::error_code(11000, server_error_category()));
+            }
+
+            SECTION("...clears the error code on success") {
+                execute_fails = false;
+                std::error_code ec{11000, server_error_category()};
+
+                mongo_coll.insert_one(filter_doc.view(), ec);
+                REQUIRE(!ec);
+            }
+
+            REQUIRE(bulk_operation_execute_called);
+            perform_checks();
+        }
+
         SECTION("Insert Many Error", "[collection::insert_many]") {
             expected_order_setting = true;
             bulk_operation_insert_with_opts->interpose(
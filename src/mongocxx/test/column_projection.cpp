@@ -0,0 +1,142 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/test_util/catch.hh>
+#include <bsoncxx/types.hpp>
+#include <mongocxx/column_projection.hpp>
+#include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/private/column_projection.hh>
+
+namespace {
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_document;
+
+using namespace mongocxx;
+
+TEST_CASE("column_projection extracts fields into typed columns", "[column_projection]") {
+    column_projection projection;
+    projection.add_field("price", bsoncxx::type::k_double)
+        .add_field("qty", bsoncxx::type::k_int64)
+        .add_field("item.name", bsoncxx::type::k_utf8)
+        .add_field("in_stock", bsoncxx::type::k_bool);
+
+    projection.append(make_document(kvp("price", 1.5),
+                                    kvp("qty", 3),
+                                    kvp("item", make_document(kvp("name", "pen"))),
+                                    kvp("in_stock", true)));
+    projection.append(make_document(kvp("qty", std::int64_t{1} << 40),
+                                    kvp("price", 2),
+                                    kvp("item", make_document(kvp("name", 7)))));
+    projection.append(make_document(kvp("item", "not a document"),
+                                    kvp("in_stock", false),
+                                    kvp("item", make_document(kvp("name", "ink")))));
+
+    REQUIRE(projection.rows() == 3);
+
+    const auto& columns = projection.columns();
+    REQUIRE(columns.size() == 4);
+
+    const auto& price = columns[0];
+    REQUIRE(price.path() == "price");
+    REQUIRE(price.doubles() == std::vector<double>{1.5, 2.0, 0.0});
+    REQUIRE(price.is_valid(0));
+    REQUIRE(price.is_valid(1));
+    REQUIRE(!price.is_valid(2));
+    REQUIRE(price.null_count() == 1);
+    REQUIRE(price.validity() == std::vector<std::uint8_t>{0x03});
+
+    const auto& qty = columns[1];
+    REQUIRE(qty.int64s() == std::vector<std::int64_t>{3, std::int64_t{1} << 40, 0});
+
+    // A string column holds Arrow-style offsets. The int32 name and the non-document item are
+    // nulls, and the later, well-formed item is still found.
+    const auto& name = columns[2];
+    REQUIRE(name.string_offsets() == std::vector<std::int32_t>{0, 3, 3, 6});
+    REQUIRE(name.string_data() == "penink");
+    REQUIRE(name.string(0) == "pen");
+    REQUIRE(!name.is_valid(1));
+    REQUIRE(name.string(2) == "ink");
+
+    const auto& in_stock = columns[3];
+    REQUIRE(in_stock.bools() == std::vector<std::uint8_t>{1, 0, 0});
+    REQUIRE(in_stock.validity() == std::vector<std::uint8_t>{0x05});
+
+    SECTION("clear keeps the fields") {
+        projection.clear();
+        REQUIRE(projection.rows() == 0);
+        REQUIRE(projection.columns()[2].string_offsets() == std::vector<std::int32_t>{0});
+
+        projection.append(make_document(kvp("price", 4.0)));
+        REQUIRE(projection.columns()[0].doubles() == std::vector<double>{4.0});
+        REQUIRE(projection.columns()[1].null_count() == 1);
+    }
+
+    SECTION("a row that overflows a string column is not appended") {
+        // Lower the 2 GiB limit to the bytes already held.
+        struct restore_limit {
+            ~restore_limit() {
+                column_projection_string_limit() = limit;
+            }
+            std::size_t limit;
+        } restore{column_projection_string_limit()};
+        column_projection_string_limit() = 6;
+
+        // The price and qty fields are pushed before the name overflows.
+        auto overflowing = make_document(kvp("price", 9.0),
+                                         kvp("qty", 9),
+                                         kvp("item", make_document(kvp("name", "x"))),
+                                         kvp("in_stock", true));
+        REQUIRE_THROWS_AS(projection.append(overflowing.view()), logic_error);
+
+        REQUIRE(projection.rows() == 3);
+        REQUIRE(projection.columns()[0].doubles() == std::vector<double>{1.5, 2.0, 0.0});
+        REQUIRE(projection.columns()[0].null_count() == 1);
+        REQUIRE(projection.columns()[1].int64s().size() == 3);
+        REQUIRE(projection.columns()[2].string_offsets() ==
+                std::vector<std::int32_t>{0, 3, 3, 6});
+        REQUIRE(projection.columns()[2].string_data() == "penink");
+
+        // The validity bytes are whole again, and the next row lands where the failed one would
+        // have.
+        column_projection_string_limit() = restore.limit;
+        projection.append(make_document(kvp("price", 4.0)));
+        REQUIRE(projection.rows() == 4);
+        REQUIRE(projection.columns()[0].doubles() == std::vector<double>{1.5, 2.0, 0.0, 4.0});
+        REQUIRE(projection.columns()[0].validity() == std::vector<std::uint8_t>{0x0B});
+        REQUIRE(projection.columns()[3].validity() == std::vector<std::uint8_t>{0x05});
+        REQUIRE(projection.columns()[2].string_offsets() ==
+                std::vector<std::int32_t>{0, 3, 3, 6, 6});
+    }
+
+    SECTION("fields cannot be added once rows are held") {
+        REQUIRE_THROWS_AS(projection.add_field("other", bsoncxx::type::k_int32), logic_error);
+    }
+}
+
+TEST_CASE("column_projection rejects invalid fields", "[column_projection]") {
+    column_projection projection;
+    projection.add_field("a.b", bsoncxx::type::k_int32);
+
+    REQUIRE_THROWS_AS(projection.add_field("a.b", bsoncxx::type::k_int64), logic_error);
+    REQUIRE_THROWS_AS(projection.add_field("", bsoncxx::type::k_int64), logic_error);
+    REQUIRE_THROWS_AS(projection.add_field("c", bsoncxx::type::k_document), logic_error);
+
+    // A field and a field nested in it can both be columns.
+    REQUIRE_NOTHROW(projection.add_field("a", bsoncxx::type::k_int32));
+}
+
+}  // namespace
@@ -0,0 +1,126 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <bsoncxx/builder/basic/array.hpp>
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/private/libbson.hh>
+#include <bsoncxx/test_util/catch.hh>
+#include <bsoncxx/types.hpp>
+#include <mongocxx/client.hpp>
+#include <mongocxx/compiled_pipeline.hpp>
+#include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/instance.hpp>
+#include <mongocxx/private/libmongoc.hh>
+
+#include <third_party/catch/include/helpers.hpp>
+
+namespace {
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_array;
+using bsoncxx::builder::basic::make_document;
+using bsoncxx::types::bson_value::view;
+
+using namespace bsoncxx::types;
+using namespace mongocxx;
+
+bsoncxx::document::value wrap(bsoncxx::array::view stages) {
+    return make_document(kvp("pipeline", stages));
+}
+
+TEST_CASE("compiled pipelines are sent without being rebuilt", "[compiled_pipeline]") {
+    instance::current();
+
+    MOCK_CLIENT
+    MOCK_DATABASE
+    MOCK_COLLECTION
+    MOCK_CHANGE_STREAM
+    MOCK_CURSOR
+
+    client mongo_client{uri{}};
+    collection coll = mongo_client["compiled"]["pipeline"];
+
+    bsoncxx::stdx::optional<bsoncxx::document::value> sent;
+    collection_aggregate
+        ->interpose([&](mongoc_collection_t*,
+                        mongoc_query_flags_t,
+                        const bson_t* pipeline,
+                        const bson_t*,
+                        const mongoc_read_prefs_t*) -> mongoc_cursor_t* {
+            sent = bsoncxx::document::value{
+                bsoncxx::document::view{bson_get_data(pipeline), pipeline->len}};
+            return nullptr;
+        })
+        .forever();
+    collection_watch
+        ->interpose([&](const mongoc_collection_t*,
+                        const bson_t* pipeline,
+                        const bson_t*) -> mongoc_change_stream_t* {
+            sent = bsoncxx::document::value{
+                bsoncxx::document::view{bson_get_data(pipeline), pipeline->len}};
+            return nullptr;
+        })
+        .forever();
+    change_stream_destroy->interpose([](mongoc_change_stream_t*) {}).forever();
+
+    pipeline pipe;
+    pipe.match(make_document(kvp("status", "new")));
+    pipe.limit(10);
+
+    auto stages = make_array(make_document(kvp("$match", make_document(kvp("status", "new")))),
+                             make_document(kvp("$limit", 10)));
+
+    SECTION("a compiled pipeline holds the stages as they were compiled") {
+        compiled_pipeline compiled{pipe};
+        pipe.skip(5);
+
+        REQUIRE(compiled.view_array() == stages.view());
+
+        compiled_pipeline copy{compiled};
+        REQUIRE(copy.view_array().data() == compiled.view_array().data());
+
+        coll.aggregate(compiled);
+        REQUIRE(sent->view() == wrap(stages.view()).view());
+
+        sent = {};
+        coll.watch(compiled);
+        REQUIRE(sent->view() == wrap(stages.view()).view());
+    }
+
+    SECTION("a parameterized pipeline rebinds its values") {
+        parameterized_pipeline shared{pipe, {"0.$match.status", "1.$limit"}};
+
+        parameterized_pipeline request = shared;
+        request.bind(0, view{b_utf8{"archived"}}).bind(1, view{b_int32{20}});
+
+        auto rebound =
+            make_array(make_document(kvp("$match", make_document(kvp("status", "archived")))),
+                       make_document(kvp("$limit", 20)));
+
+        coll.aggregate(request);
+        REQUIRE(sent->view() == wrap(rebound.view()).view());
+
+        // Binding a value in one copy leaves the others untouched.
+        REQUIRE(shared.view_array() == stages.view());
+
+        compiled_pipeline snapshot = request;
+        request.bind(1, view{b_int32{30}});
+        REQUIRE(snapshot.view_array() == rebound.view());
+
+        REQUIRE_THROWS_AS(request.bind(1, view{b_utf8{"20"}}), logic_error);
+        REQUIRE_THROWS_AS(parameterized_pipeline(pipe, {"3.$limit"}), logic_error);
+    }
+}
+}  // namespace
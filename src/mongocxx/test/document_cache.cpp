@@ -0,0 +1,374 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/private/libbson.hh>
+#include <bsoncxx/test_util/catch.hh>
+#include <mongocxx/client.hpp>
+#include <mongocxx/document_cache.hpp>
+#include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/instance.hpp>
+#include <mongocxx/pool.hpp>
+#include <mongocxx/private/libbson.hh>
+#include <mongocxx/private/libmongoc.hh>
+
+#include <third_party/catch/include/helpers.hpp>
+
+namespace {
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_document;
+
+using namespace mongocxx;
+
+bsoncxx::document::value change(const char* operation,
+                                const char* id,
+                                bsoncxx::stdx::optional<std::int32_t> x = {}) {
+    bsoncxx::builder::basic::document event;
+    event.append(kvp("_id", make_document(kvp("_data", "token"))),
+                 kvp("operationType", operation),
+                 kvp("documentKey", make_document(kvp("_id", id))));
+    if (x) {
+        event.append(kvp("fullDocument", make_document(kvp("_id", id), kvp("x", *x))));
+    }
+    return event.extract();
+}
+
+// Waits up to five seconds for a condition that a cache's background thread brings about.
+template <typename Predicate>
+bool eventually(Predicate predicate) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{5};
+    while (!predicate()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    return true;
+}
+
+TEST_CASE("document_cache caches find_one results", "[document_cache]") {
+    instance::current();
+
+    MOCK_POOL
+    MOCK_CLIENT
+    MOCK_DATABASE
+    MOCK_COLLECTION
+    MOCK_CURSOR
+
+    client_destroy->interpose([](mongoc_client_t*) {}).forever();
+    get_database->interpose([](mongoc_client_t*, const char*) { return nullptr; }).forever();
+    collection_destroy->interpose([](mongoc_collection_t*) {}).forever();
+
+    // Every find returns `served` until it is cleared from `served_bsons`, and a change may be
+    // applied while the server answers.
+    auto served = make_document(kvp("_id", "a"), kvp("x", 1));
+    std::vector<bson_t> served_bsons(1);
+    bson_init_static(&served_bsons[0], served.view().data(), served.view().length());
+    int finds = 0;
+    std::function<void()> during_find;
+
+    MOCK_CURSOR_DOCUMENTS(served_bsons)
+    on_cursor_find = [&] {
+        ++finds;
+        if (during_find) {
+            during_find();
+        }
+    };
+
+    // A watched cache reads `stream_events` through the mocked change stream on its background
+    // thread. While `stream_fails` is set, reading the stream fails as a lost connection would,
+    // and while `hold_reopen` is set, reopening it blocks.
+    MOCK_CHANGE_STREAM
+
+    std::mutex stream_mutex;
+    std::condition_variable stream_cv;
+    std::deque<bsoncxx::document::value> stream_events;
+    bsoncxx::stdx::optional<bsoncxx::document::value> stream_current;
+    bson_t stream_current_bson;
+    std::atomic<bool> stream_fails{false};
+    std::atomic<int> stream_reads{0};
+    std::atomic<int> stream_errors{0};
+    std::atomic<int> watch_attempts{0};
+    bool hold_reopen = false;
+    libbson::scoped_bson_t error_reply{make_document(kvp("ok", 0))};
+
+    collection_watch
+        ->interpose([&](const mongoc_collection_t*,
+                        const bson_t*,
+                        const bson_t*) -> mongoc_change_stream_t* {
+            ++watch_attempts;
+            std::unique_lock<std::mutex> lock{stream_mutex};
+            stream_cv.wait_for(lock, std::chrono::seconds{5}, [&] { return !hold_reopen; });
+            return nullptr;
+        })
+        .forever();
+    change_stream_next
+        ->interpose([&](mongoc_change_stream_t*, const bson_t** bson) {
+            ++stream_reads;
+            std::unique_lock<std::mutex> lock{stream_mutex};
+            if (stream_events.empty() && !stream_fails) {
+                // Stands in for the time the server awaits new events.
+                stream_cv.wait_for(lock, std::chrono::milliseconds{5});
+            }
+            if (stream_fails || stream_events.empty()) {
+                return false;
+            }
+            stream_current = std::move(stream_events.front());
+            stream_events.pop_front();
+            auto current = stream_current->view();
+            bson_init_static(&stream_current_bson, current.data(), current.length());
+            *bson = &stream_current_bson;
+            return true;
+        })
+        .forever();
+    change_stream_error_document
+        ->interpose([&](const mongoc_change_stream_t*, bson_error_t* error, const bson_t** reply) {
+            if (!stream_fails) {
+                *reply = nullptr;
+                return false;
+            }
+            ++stream_errors;
+            bson_set_error(
+                error, MONGOC_ERROR_STREAM, MONGOC_ERROR_STREAM_SOCKET, "connection lost");
+            *reply = error_reply.bson();
+            return true;
+        })
+        .forever();
+    change_stream_destroy->interpose([](mongoc_change_stream_t*) {}).forever();
+
+    auto push_event = [&](bsoncxx::document::value event) {
+        {
+            std::lock_guard<std::mutex> lock{stream_mutex};
+            stream_events.push_back(std::move(event));
+        }
+        stream_cv.notify_all();
+    };
+
+    pool client_pool{uri{}};
+    auto unwatched = options::document_cache{}.watch(false);
+    auto watched = options::document_cache{}.max_await_time(std::chrono::milliseconds{10});
+
+    SECTION("a repeated find is answered from the cache") {
+        document_cache cache{client_pool, "db", "coll", unwatched};
+
+        auto first = cache.find_one(make_document(kvp("_id", "a")));
+        auto second = cache.find_one(make_document(kvp("_id", "a")));
+
+        REQUIRE(finds == 1);
+        REQUIRE(first);
+        REQUIRE(second);
+        REQUIRE(second->view() == served.view());
+        REQUIRE(cache.hits() == 1);
+        REQUIRE(cache.misses() == 1);
+        REQUIRE(cache.size() == 1);
+        REQUIRE(cache.size_bytes() > static_cast<std::int64_t>(served.view().length()));
+    }
+
+    SECTION("filters that differ only in field order share an entry") {
+        document_cache cache{client_pool, "db", "coll", unwatched};
+
+        cache.find_one(make_document(kvp("x", 1), kvp("y", 2)));
+        cache.find_one(make_document(kvp("y", 2), kvp("x", 1)));
+
+        REQUIRE(finds == 1);
+        REQUIRE(cache.size() == 1);
+    }
+
+    SECTION("that no document matches is cached") {
+        served_bsons.clear();
+        document_cache cache{client_pool, "db", "coll", unwatched};
+
+        REQUIRE(!cache.find_one(make_document(kvp("_id", "b"))));
+        REQUIRE(!cache.find_one(make_document(kvp("_id", "b"))));
+        REQUIRE(finds == 1);
+    }
+
+    SECTION("an _id filter is only invalidated by changes to its document") {
+        document_cache cache{client_pool, "db", "coll", unwatched};
+        auto filter = make_document(kvp("_id", "a"));
+
+        cache.find_one(filter.view());
+        cache.invalidate(change("insert", "b", 1));
+        cache.find_one(filter.view());
+        REQUIRE(finds == 1);
+
+        cache.invalidate(change("update", "a", 2));
+        cache.find_one(filter.view());
+        REQUIRE(finds == 2);
+        REQUIRE(cache.invalidations() == 1);
+    }
+
+    SECTION("other filters are invalidated by the documents they match") {
+        document_cache cache{client_pool, "db", "coll", unwatched};
+        auto below = make_document(kvp("x", make_document(kvp("$lt", 50))));
+
+        cache.find_one(below.view());
+        cache.invalidate(change("insert", "c", 100));
+        cache.find_one(below.view());
+        REQUIRE(finds == 1);
+
+        cache.invalidate(change("insert", "c", 10));
+        cache.find_one(below.view());
+        REQUIRE(finds == 2);
+
+        // Deleting the cached document invalidates the entry even though the event has no
+        // document to match.
+        cache.invalidate(change("delete", "a"));
+        cache.find_one(below.view());
+        REQUIRE(finds == 3);
+
+        // An update without the full document may have made any document match.
+        cache.invalidate(change("update", "d"));
+        cache.find_one(below.view());
+        REQUIRE(finds == 4);
+    }
+
+    SECTION("a drop empties the cache") {
+        document_cache cache{client_pool, "db", "coll", unwatched};
+
+        cache.find_one(make_document(kvp("_id", "a")));
+        cache.find_one(make_document(kvp("x", 1)));
+        REQUIRE(cache.size() == 2);
+
+        cache.invalidate(make_document(kvp("operationType", "drop")));
+        REQUIRE(cache.size() == 0);
+        REQUIRE(cache.size_bytes() == 0);
+        REQUIRE(cache.invalidations() == 2);
+    }
+
+    SECTION("a result read before a change is not cached") {
+        document_cache cache{client_pool, "db", "coll", unwatched};
+        during_find = [&] { cache.invalidate(change("update", "a", 1)); };
+
+        cache.find_one(make_document(kvp("_id", "a")));
+        REQUIRE(cache.size() == 0);
+
+        during_find = nullptr;
+        cache.find_one(make_document(kvp("_id", "a")));
+        REQUIRE(cache.size() == 1);
+    }
+
+    SECTION("a watched cache drops the entries that streamed changes affect") {
+        test_util::share_mocks_with_other_threads shared_mocks;
+        document_cache cache{client_pool, "db", "coll", watched};
+        auto filter = make_document(kvp("_id", "a"));
+
+        cache.find_one(filter.view());
+        cache.find_one(filter.view());
+        REQUIRE(finds == 1);
+        REQUIRE(watch_attempts == 1);
+
+        push_event(change("insert", "b", 1));
+        push_event(change("update", "a", 2));
+        REQUIRE(eventually([&] { return cache.invalidations() == 1; }));
+
+        cache.find_one(filter.view());
+        REQUIRE(finds == 2);
+        REQUIRE(cache.size() == 1);
+    }
+
+    SECTION("a watched cache is bypassed while its change stream is failing") {
+        test_util::share_mocks_with_other_threads shared_mocks;
+        document_cache cache{client_pool, "db", "coll", watched};
+        auto filter = make_document(kvp("_id", "a"));
+
+        cache.find_one(filter.view());
+        REQUIRE(cache.size() == 1);
+
+        {
+            std::lock_guard<std::mutex> lock{stream_mutex};
+            hold_reopen = true;
+        }
+        stream_fails = true;
+
+        // The cache is emptied and bypassed before the stream is reopened.
+        REQUIRE(eventually([&] { return watch_attempts == 2; }));
+        REQUIRE(stream_errors >= 1);
+        REQUIRE(cache.size() == 0);
+
+        cache.find_one(filter.view());
+        cache.find_one(filter.view());
+        REQUIRE(finds == 3);
+        REQUIRE(cache.size() == 0);
+        REQUIRE(cache.hits() == 0);
+
+        // Once the stream is open again, results are cached again.
+        stream_fails = false;
+        const int reads_before_reopen = stream_reads;
+        {
+            std::lock_guard<std::mutex> lock{stream_mutex};
+            hold_reopen = false;
+        }
+        stream_cv.notify_all();
+        REQUIRE(eventually([&] { return stream_reads > reads_before_reopen; }));
+
+        cache.find_one(filter.view());
+        cache.find_one(filter.view());
+        REQUIRE(finds == 4);
+        REQUIRE(cache.size() == 1);
+        REQUIRE(cache.hits() == 1);
+    }
+
+    SECTION("the least recently used entry is evicted") {
+        document_cache cache{client_pool, "db", "coll", unwatched};
+        cache.find_one(make_document(kvp("_id", "k0")));
+        const std::int64_t entry_bytes = cache.size_bytes();
+
+        document_cache small{client_pool,
+                             "db",
+                             "coll",
+                             options::document_cache{}.watch(false).shard_count(1).max_bytes(
+                                 2 * entry_bytes + entry_bytes / 2)};
+        finds = 0;
+
+        small.find_one(make_document(kvp("_id", "k0")));
+        small.find_one(make_document(kvp("_id", "k1")));
+        small.find_one(make_document(kvp("_id", "k0")));
+        small.find_one(make_document(kvp("_id", "k2")));
+        REQUIRE(finds == 3);
+        REQUIRE(small.evictions() == 1);
+
+        small.find_one(make_document(kvp("_id", "k0")));
+        REQUIRE(finds == 3);
+        small.find_one(make_document(kvp("_id", "k1")));
+        REQUIRE(finds == 4);
+    }
+
+    SECTION("invalid options are rejected") {
+        REQUIRE_THROWS_AS(document_cache(client_pool, "db", "coll", unwatched.max_bytes(0)),
+                          logic_error);
+        REQUIRE_THROWS_AS(
+            document_cache(client_pool, "db", "coll", options::document_cache{}.shard_count(0)),
+            logic_error);
+        REQUIRE_THROWS_AS(document_cache(client_pool,
+                                         "db",
+                                         "coll",
+                                         options::document_cache{}.max_await_time(
+                                             std::chrono::milliseconds{0})),
+                          logic_error);
+    }
+}
+
+}  // namespace
@@ -22,21 +22,31 @@
 #include <bsoncxx/types/bson_value/view.hpp>
 #include <chrono>
 #include <cstdint>
+#include <cstdio>
 #include <cstdlib>
 #include <fstream>
 #include <functional>
+#include <iterator>
+#include <memory>
 #include <mongocxx/client.hpp>
 #include <mongocxx/database.hpp>
+#include <mongocxx/exception/error_code.hpp>
+#include <mongocxx/exception/exception.hpp>
 #include <mongocxx/exception/gridfs_exception.hpp>
 #include <mongocxx/exception/logic_error.hpp>
 #include <mongocxx/gridfs/bucket.hpp>
+#include <mongocxx/gridfs/chunk_codec.hpp>
 #include <mongocxx/instance.hpp>
 #include <mongocxx/options/find.hpp>
+#include <mongocxx/options/gridfs/download.hpp>
 #include <mongocxx/options/gridfs/upload.hpp>
 #include <mongocxx/options/index.hpp>
+#include <mongocxx/pool.hpp>
 #include <mongocxx/uri.hpp>
 #include <numeric>
+#include <set>
 #include <sstream>
+#include <string>
 #include <vector>
 
 namespace {
@@ -45,6 +55,54 @@ using namespace mongocxx;
 using bsoncxx::builder::basic::kvp;
 using bsoncxx::builder::basic::make_document;
 
+// A run-length chunk codec: each run of up to 255 equal bytes is stored as its length and value.
+class run_length_codec : public gridfs::chunk_codec {
+   public:
+    explicit run_length_codec(std::string name = "rle") : _name{std::move(name)} {}
+
+    stdx::string_view name() const override {
+        return _name;
+    }
+
+    std::size_t max_compressed_size(std::size_t length) const override {
+        return 2 * length;
+    }
+
+    std::size_t compress(const std::uint8_t* data,
+                         std::size_t length,
+                         std::uint8_t* out) const override {
+        std::size_t out_len = 0;
+        for (std::size_t i = 0; i < length;) {
+            std::size_t run = 1;
+            while (i + run < length && run < 255 && data[i + run] == data[i]) {
+                ++run;
+            }
+            out[out_len++] = static_cast<std::uint8_t>(run);
+            out[out_len++] = data[i];
+            i += run;
+        }
+        return out_len;
+    }
+
+    std::size_t decompress(const std::uint8_t* data,
+                           std::size_t length,
+                           std::uint8_t* out,
+                           std::size_t capacity) const override {
+        std::size_t out_len = 0;
+        for (std::size_t i = 0; i + 1 < length; i += 2) {
+            if (out_len + data[i] > capacity) {
+                throw gridfs_exception{error_code::k_gridfs_file_corrupted};
+            }
+            std::fill_n(&out[out_len], data[i], data[i + 1]);
+            out_len += data[i];
+        }
+        return out_len;
+    }
+
+   private:
+    std::string _name;
+};
+
 // Downloads the file `id` from the gridfs collections in `db` specified by `bucket_name` and
 // verifies that it has file_name `expected_file_name`, contents `expected_contents`, and chunk size
 // `expected_chunk_size`.
@@ -338,6 +396,16 @@ TEST_CASE("uploading throws error when options are invalid", "[gridfs::bucket]")
         upload_options.chunk_size_bytes(-1);
         run_test();
     }
+
+    SECTION("zero concurrency") {
+        upload_options.concurrency(0);
+        run_test();
+    }
+
+    SECTION("concurrency without a pool") {
+        upload_options.concurrency(2);
+        run_test();
+    }
 }
 
 TEST_CASE("downloading throws error when files document is corrupt", "[gridfs::bucket]") {
@@ -738,6 +806,803 @@ TEST_CASE("gridfs upload/download round trip", "[gridfs::uploader] [gridfs::down
     REQUIRE(uploaded_bytes == downloaded_bytes);
 }
 
+TEST_CASE("gridfs upload reuses chunk buffers across batches", "[gridfs::uploader]") {
+    instance::current();
+
+    client client{uri{}};
+    database db = client["gridfs_upload_buffer_reuse"];
+    gridfs::bucket bucket = db.gridfs_bucket();
+
+    db["fs.files"].delete_many({});
+    db["fs.chunks"].delete_many({});
+
+    // Four chunks of this size fill one batch, so later batches are written into the buffers of
+    // earlier ones.
+    constexpr std::int32_t chunk_size = 4 * 1000 * 1000;
+    constexpr std::int32_t chunk_count = 10;
+
+    auto uploader =
+        bucket.open_upload_stream("file", options::gridfs::upload{}.chunk_size_bytes(chunk_size));
+
+    std::vector<std::uint8_t> bytes(chunk_size);
+    for (std::int32_t i = 0; i < chunk_count; ++i) {
+        // The last chunk is short, so stale bytes from a reused buffer would show.
+        std::size_t length = i == chunk_count - 1 ? 1000 : bytes.size();
+        std::fill(bytes.begin(), bytes.end(), static_cast<std::uint8_t>(i));
+        uploader.write(bytes.data(), length);
+    }
+    auto result = uploader.close();
+
+    std::set<bsoncxx::oid> ids;
+    options::find sorted;
+    sorted.sort(make_document(kvp("n", 1)));
+    std::int32_t n = 0;
+    for (auto&& chunk : db["fs.chunks"].find(make_document(kvp("files_id", result.id())), sorted)) {
+        ids.insert(chunk["_id"].get_oid().value);
+        REQUIRE(chunk["n"].get_int32().value == n);
+
+        auto data = chunk["data"].get_binary();
+        auto expected_size = static_cast<std::uint32_t>(n == chunk_count - 1 ? 1000 : chunk_size);
+        REQUIRE(data.size == expected_size);
+        REQUIRE(std::all_of(data.bytes, data.bytes + data.size, [n](std::uint8_t byte) {
+            return byte == static_cast<std::uint8_t>(n);
+        }));
+        ++n;
+    }
+
+    REQUIRE(n == chunk_count);
+    REQUIRE(ids.size() == static_cast<std::size_t>(chunk_count));
+}
+
+TEST_CASE("gridfs concurrent upload through a pool", "[gridfs::uploader]") {
+    instance::current();
+
+    client client{uri{}};
+    pool pool{uri{}};
+    database db = client["gridfs_concurrent_upload"];
+    gridfs::bucket bucket = db.gridfs_bucket();
+
+    db["fs.files"].delete_many({});
+    db["fs.chunks"].delete_many({});
+
+    // Four chunks of this size fill one batch, so the file below is sent as three batches.
+    constexpr std::int32_t chunk_size = 4 * 1000 * 1000;
+    std::vector<std::uint8_t> uploaded_bytes(10 * chunk_size + 100);
+    for (std::size_t i = 0; i < uploaded_bytes.size(); ++i) {
+        uploaded_bytes[i] = static_cast<std::uint8_t>(i % 251);
+    }
+
+    auto uploader = bucket.open_upload_stream(
+        "file", options::gridfs::upload{}.chunk_size_bytes(chunk_size).pool(&pool).concurrency(2));
+
+    // Write in pieces that do not line up with chunk boundaries.
+    for (std::size_t off = 0; off < uploaded_bytes.size(); off += 3 * 1000 * 1000) {
+        auto length = std::min<std::size_t>(3 * 1000 * 1000, uploaded_bytes.size() - off);
+        uploader.write(uploaded_bytes.data() + off, length);
+    }
+    auto result = uploader.close();
+
+    REQUIRE(db["fs.chunks"].count_documents({}) == 11);
+
+    std::vector<std::uint8_t> downloaded_bytes(uploaded_bytes.size());
+    auto downloader = bucket.open_download_stream(result.id());
+    REQUIRE(downloader.file_length() == static_cast<std::int64_t>(uploaded_bytes.size()));
+
+    std::size_t total = 0;
+    while (auto bytes_read =
+               downloader.read(downloaded_bytes.data() + total, downloaded_bytes.size() - total)) {
+        total += bytes_read;
+    }
+
+    REQUIRE(total == uploaded_bytes.size());
+    REQUIRE(uploaded_bytes == downloaded_bytes);
+}
+
+TEST_CASE("gridfs prefetching download through a pool", "[gridfs::downloader]") {
+    instance::current();
+
+    client client{uri{}};
+    pool pool{uri{}};
+    database db = client["gridfs_prefetching_download"];
+    gridfs::bucket bucket = db.gridfs_bucket();
+
+    db["fs.files"].delete_many({});
+    db["fs.chunks"].delete_many({});
+
+    constexpr std::int32_t chunk_size = 1000;
+    std::vector<std::uint8_t> uploaded_bytes(25 * chunk_size + 10);
+    for (std::size_t i = 0; i < uploaded_bytes.size(); ++i) {
+        uploaded_bytes[i] = static_cast<std::uint8_t>(i % 251);
+    }
+
+    auto uploader =
+        bucket.open_upload_stream("file", options::gridfs::upload{}.chunk_size_bytes(chunk_size));
+    uploader.write(uploaded_bytes.data(), uploaded_bytes.size());
+    auto result = uploader.close();
+
+    auto downloader = bucket.open_download_stream(
+        result.id(), options::gridfs::download{}.pool(&pool).prefetch_chunks(3));
+
+    std::vector<std::uint8_t> downloaded_bytes;
+
+    SECTION("with read()") {
+        std::uint8_t buffer[700];
+        while (auto bytes_read = downloader.read(buffer, sizeof(buffer))) {
+            downloaded_bytes.insert(downloaded_bytes.end(), buffer, buffer + bytes_read);
+        }
+    }
+
+    SECTION("with read_chunk()") {
+        // Start in the middle of the first chunk to mix both ways of reading.
+        std::uint8_t buffer[10];
+        REQUIRE(downloader.read(buffer, sizeof(buffer)) == sizeof(buffer));
+        downloaded_bytes.assign(buffer, buffer + sizeof(buffer));
+
+        bsoncxx::types::b_binary data;
+        while ((data = downloader.read_chunk()).size != 0) {
+            downloaded_bytes.insert(downloaded_bytes.end(), data.bytes, data.bytes + data.size);
+        }
+    }
+
+    REQUIRE(downloaded_bytes == uploaded_bytes);
+    downloader.close();
+}
+
+TEST_CASE("gridfs prefetching download is destroyed while the pool is exhausted",
+          "[gridfs::downloader]") {
+    instance::current();
+
+    client client{uri{}};
+    pool pool{uri{"mongodb://localhost:27017/?maxPoolSize=1"}};
+    database db = client["gridfs_prefetching_exhausted_pool"];
+    gridfs::bucket bucket = db.gridfs_bucket();
+
+    db["fs.files"].delete_many({});
+    db["fs.chunks"].delete_many({});
+
+    auto uploader = bucket.open_upload_stream("file");
+    std::uint8_t bytes[10] = {};
+    uploader.write(bytes, sizeof(bytes));
+    auto result = uploader.close();
+
+    // Hold the only client, so the prefetcher can never acquire one. Destroying the downloader
+    // must still return.
+    auto held = pool.acquire();
+    {
+        auto downloader = bucket.open_download_stream(
+            result.id(), options::gridfs::download{}.pool(&pool).prefetch_chunks(2));
+    }
+}
+
+TEST_CASE("gridfs range downloads and seeking", "[gridfs::downloader]") {
+    instance::current();
+
+    client client{uri{}};
+    pool pool{uri{}};
+    database db = client["gridfs_range_download"];
+    gridfs::bucket bucket = db.gridfs_bucket();
+
+    db["fs.files"].delete_many({});
+    db["fs.chunks"].delete_many({});
+
+    constexpr std::int32_t chunk_size = 100;
+    std::vector<std::uint8_t> uploaded_bytes(10 * chunk_size + 50);
+    for (std::size_t i = 0; i < uploaded_bytes.size(); ++i) {
+        uploaded_bytes[i] = static_cast<std::uint8_t>(i % 251);
+    }
+
+    auto uploader =
+        bucket.open_upload_stream("file", options::gridfs::upload{}.chunk_size_bytes(chunk_size));
+    uploader.write(uploaded_bytes.data(), uploaded_bytes.size());
+    auto result = uploader.close();
+
+    // Every case is run both without and with prefetching.
+    std::vector<options::gridfs::download> all_download_options{
+        options::gridfs::download{}, options::gridfs::download{}.pool(&pool).prefetch_chunks(2)};
+
+    auto read_all = [](gridfs::downloader& downloader) {
+        std::vector<std::uint8_t> bytes;
+        std::uint8_t buffer[64];
+        while (auto bytes_read = downloader.read(buffer, sizeof(buffer))) {
+            bytes.insert(bytes.end(), buffer, buffer + bytes_read);
+        }
+        return bytes;
+    };
+
+    auto slice = [&](std::size_t start, std::size_t end) {
+        return std::vector<std::uint8_t>(&uploaded_bytes[start], &uploaded_bytes[0] + end);
+    };
+
+    SECTION("a range within the file") {
+        for (auto&& download_options : all_download_options) {
+            auto downloader = bucket.open_download_stream(result.id(), 250, 720, download_options);
+            REQUIRE(read_all(downloader) == slice(250, 720));
+        }
+    }
+
+    SECTION("a range past the end of the file is truncated") {
+        for (auto&& download_options : all_download_options) {
+            auto downloader = bucket.open_download_stream(result.id(), 990, 5000, download_options);
+            REQUIRE(read_all(downloader) == slice(990, uploaded_bytes.size()));
+        }
+    }
+
+    SECTION("an empty range") {
+        for (auto&& download_options : all_download_options) {
+            auto downloader = bucket.open_download_stream(result.id(), 300, 300, download_options);
+            REQUIRE(read_all(downloader).empty());
+        }
+    }
+
+    SECTION("an invalid range") {
+        for (auto&& download_options : all_download_options) {
+            REQUIRE_THROWS_AS(bucket.open_download_stream(result.id(), 300, 200, download_options),
+                              logic_error);
+            REQUIRE_THROWS_AS(bucket.open_download_stream(result.id(), -1, 200, download_options),
+                              logic_error);
+        }
+    }
+
+    SECTION("seeking") {
+        for (auto&& download_options : all_download_options) {
+            auto downloader = bucket.open_download_stream(result.id(), download_options);
+
+            std::uint8_t byte;
+            downloader.seek(905);
+            REQUIRE(downloader.read(&byte, 1) == 1);
+            REQUIRE(byte == uploaded_bytes[905]);
+
+            // Within the current chunk.
+            downloader.seek(950);
+            REQUIRE(downloader.read(&byte, 1) == 1);
+            REQUIRE(byte == uploaded_bytes[950]);
+
+            // Backwards.
+            downloader.seek(5);
+            REQUIRE(read_all(downloader) == slice(5, uploaded_bytes.size()));
+
+            downloader.seek(static_cast<std::int64_t>(uploaded_bytes.size()));
+            REQUIRE(downloader.read(&byte, 1) == 0);
+
+            REQUIRE_THROWS_AS(downloader.seek(static_cast<std::int64_t>(uploaded_bytes.size()) + 1),
+                              logic_error);
+        }
+    }
+
+    SECTION("seeking is limited to the range") {
+        for (auto&& download_options : all_download_options) {
+            auto downloader = bucket.open_download_stream(result.id(), 100, 200, download_options);
+            downloader.seek(150);
+            REQUIRE(read_all(downloader) == slice(150, 200));
+            REQUIRE_THROWS_AS(downloader.seek(99), logic_error);
+        }
+    }
+}
+
+TEST_CASE("gridfs file upload and download", "[gridfs::bucket]") {
+    instance::current();
+
+    client client{uri{}};
+    pool pool{uri{}};
+    database db = client["gridfs_file_upload_download"];
+    gridfs::bucket bucket = db.gridfs_bucket();
+
+    db["fs.files"].delete_many({});
+    db["fs.chunks"].delete_many({});
+
+    const std::string source_path = "test_gridfs_upload_source.bin";
+    const std::string destination_path = "test_gridfs_download_destination.bin";
+
+    auto write_file = [](const std::string& path, const std::vector<std::uint8_t>& bytes) {
+        std::ofstream out{path, std::ios::binary};
+        out.write(reinterpret_cast<const char*>(bytes.data()),
+                  static_cast<std::streamsize>(bytes.size()));
+    };
+
+    auto read_file = [](const std::string& path) {
+        std::ifstream in{path, std::ios::binary};
+        return std::vector<std::uint8_t>{std::istreambuf_iterator<char>{in},
+                                         std::istreambuf_iterator<char>{}};
+    };
+
+    constexpr std::int32_t chunk_size = 100;
+    auto upload_options = options::gridfs::upload{}.chunk_size_bytes(chunk_size);
+
+    // Every download is run sequentially and split across a pool.
+    std::vector<options::gridfs::download> all_download_options{
+        options::gridfs::download{}, options::gridfs::download{}.pool(&pool).concurrency(3)};
+
+    SECTION("contents round trip") {
+        const std::vector<std::size_t> lengths{0, 50, 10 * chunk_size + 50};
+        for (std::size_t length : lengths) {
+            std::vector<std::uint8_t> bytes(length);
+            for (std::size_t i = 0; i < bytes.size(); ++i) {
+                bytes[i] = static_cast<std::uint8_t>(i % 251);
+            }
+            write_file(source_path, bytes);
+
+            auto result = bucket.upload_from_file("file", source_path, upload_options);
+
+            std::ostringstream os;
+            bucket.download_to_stream(result.id(), &os);
+            auto str = os.str();
+            REQUIRE(std::vector<std::uint8_t>(str.begin(), str.end()) == bytes);
+
+            for (auto&& download_options : all_download_options) {
+                bucket.download_to_file(result.id(), destination_path, download_options);
+                REQUIRE(read_file(destination_path) == bytes);
+            }
+        }
+    }
+
+    SECTION("a missing source file is reported before anything is uploaded") {
+        std::remove(source_path.c_str());
+        REQUIRE_THROWS_AS(bucket.upload_from_file("file", source_path), mongocxx::exception);
+        REQUIRE(!db["fs.files"].find_one({}));
+    }
+
+    SECTION("a missing GridFS file does not create the destination") {
+        std::remove(destination_path.c_str());
+        bsoncxx::types::bson_value::view id{bsoncxx::types::b_oid{bsoncxx::oid{}}};
+        for (auto&& download_options : all_download_options) {
+            REQUIRE_THROWS_AS(bucket.download_to_file(id, destination_path, download_options),
+                              gridfs_exception);
+            REQUIRE(!std::ifstream{destination_path});
+        }
+    }
+
+    std::remove(source_path.c_str());
+    std::remove(destination_path.c_str());
+}
+
+TEST_CASE("gridfs chunk compression", "[gridfs::uploader] [gridfs::downloader]") {
+    instance::current();
+
+    client client{uri{}};
+    pool pool{uri{}};
+    database db = client["gridfs_chunk_compression"];
+
+    db["fs.files"].delete_many({});
+    db["fs.chunks"].delete_many({});
+
+    auto codec = std::make_shared<run_length_codec>();
+    gridfs::bucket compressing_bucket =
+        db.gridfs_bucket(options::gridfs::bucket{}.chunk_codec(codec));
+    gridfs::bucket plain_bucket = db.gridfs_bucket();
+
+    // Runs of 50 equal bytes, which compress 25x.
+    constexpr std::int32_t chunk_size = 1000;
+    std::vector<std::uint8_t> bytes(10 * chunk_size + 300);
+    for (std::size_t i = 0; i < bytes.size(); ++i) {
+        bytes[i] = static_cast<std::uint8_t>(i / 50);
+    }
+
+    auto uploader = compressing_bucket.open_upload_stream(
+        "file", options::gridfs::upload{}.chunk_size_bytes(chunk_size));
+    uploader.write(bytes.data(), bytes.size());
+    auto result = uploader.close();
+
+    auto read_all = [](gridfs::downloader& downloader) {
+        std::vector<std::uint8_t> contents;
+        std::uint8_t buffer[256];
+        while (auto bytes_read = downloader.read(buffer, sizeof(buffer))) {
+            contents.insert(contents.end(), buffer, buffer + bytes_read);
+        }
+        return contents;
+    };
+
+    SECTION("the files document describes the uncompressed file") {
+        auto files_doc = db["fs.files"].find_one(make_document(kvp("_id", result.id())));
+        REQUIRE(files_doc->view()["chunkCodec"].get_string().value == stdx::string_view{"rle"});
+        REQUIRE(files_doc->view()["length"].get_int64().value ==
+                static_cast<std::int64_t>(bytes.size()));
+        REQUIRE(files_doc->view()["chunkSize"].get_int32().value == chunk_size);
+
+        for (auto&& chunk : db["fs.chunks"].find(make_document(kvp("files_id", result.id())))) {
+            REQUIRE(chunk["data"].get_binary().size < static_cast<std::uint32_t>(chunk_size) / 10);
+        }
+    }
+
+    SECTION("downloads decompress transparently") {
+        std::vector<options::gridfs::download> all_download_options{
+            options::gridfs::download{},
+            options::gridfs::download{}.pool(&pool).prefetch_chunks(2)};
+
+        for (auto&& download_options : all_download_options) {
+            auto downloader =
+                compressing_bucket.open_download_stream(result.id(), download_options);
+            REQUIRE(read_all(downloader) == bytes);
+
+            auto range = compressing_bucket.open_download_stream(
+                result.id(), 2500, 7777, download_options);
+            REQUIRE(read_all(range) ==
+                    std::vector<std::uint8_t>(bytes.begin() + 2500, bytes.begin() + 7777));
+        }
+    }
+
+    SECTION("uncompressed files are still readable through a compressing bucket") {
+        std::istringstream iss{"uncompressed"};
+        auto plain_id = plain_bucket.upload_from_stream("plain", &iss);
+
+        std::ostringstream os;
+        compressing_bucket.download_to_stream(plain_id.id(), &os);
+        REQUIRE(os.str() == "uncompressed");
+    }
+
+    SECTION("a compressed file cannot be read without its codec") {
+        REQUIRE_THROWS_AS(plain_bucket.open_download_stream(result.id()), gridfs_exception);
+
+        gridfs::bucket other_bucket = db.gridfs_bucket(
+            options::gridfs::bucket{}.chunk_codec(std::make_shared<run_length_codec>("other")));
+        REQUIRE_THROWS_AS(other_bucket.open_download_stream(result.id()), gridfs_exception);
+    }
+}
+
+TEST_CASE("gridfs checksums", "[gridfs::uploader] [gridfs::downloader]") {
+    instance::current();
+
+    client client{uri{}};
+    pool pool{uri{}};
+    database db = client["gridfs_checksums"];
+    gridfs::bucket bucket = db.gridfs_bucket();
+
+    db["fs.files"].delete_many({});
+    db["fs.chunks"].delete_many({});
+
+    // The CRC-32C check value.
+    const std::string contents = "123456789";
+    const std::int64_t expected_checksum = 0xE3069283;
+    constexpr std::int32_t chunk_size = 4;
+
+    auto upload = [&](bool compute_checksum) {
+        auto uploader = bucket.open_upload_stream(
+            "file",
+            options::gridfs::upload{}.chunk_size_bytes(chunk_size).compute_checksum(
+                compute_checksum));
+        for (char c : contents) {
+            auto byte = static_cast<std::uint8_t>(c);
+            uploader.write(&byte, 1);
+        }
+        return uploader.close();
+    };
+
+    auto read_all = [](gridfs::downloader& downloader) {
+        std::string read;
+        char buffer[3];
+        while (auto bytes_read =
+                   downloader.read(reinterpret_cast<std::uint8_t*>(buffer), sizeof(buffer))) {
+            read.append(buffer, bytes_read);
+        }
+        return read;
+    };
+
+    const std::string destination_path = "test_gridfs_checksum_destination.bin";
+    auto verifying = options::gridfs::download{}.verify_checksum(true);
+    std::vector<options::gridfs::download> all_file_download_options{
+        verifying, options::gridfs::download{verifying}.pool(&pool).concurrency(2)};
+
+    auto result = upload(true);
+
+    SECTION("the checksum is stored in the files document") {
+        auto files_doc = db["fs.files"].find_one(make_document(kvp("_id", result.id())));
+        REQUIRE(files_doc->view()["crc32c"].get_int64().value == expected_checksum);
+
+        auto unchecked = upload(false);
+        files_doc = db["fs.files"].find_one(make_document(kvp("_id", unchecked.id())));
+        REQUIRE(!files_doc->view()["crc32c"]);
+    }
+
+    SECTION("intact contents pass verification") {
+        auto downloader = bucket.open_download_stream(result.id(), verifying);
+        REQUIRE(read_all(downloader) == contents);
+        REQUIRE(!downloader.checksum_verified());
+        downloader.close();
+        REQUIRE(downloader.checksum_verified());
+
+        // Skipping the chunks with seek() leaves the contents unverified.
+        auto skipping = bucket.open_download_stream(result.id(), verifying);
+        skipping.seek(skipping.file_length());
+        skipping.close();
+        REQUIRE(!skipping.checksum_verified());
+
+        // Going back for the skipped chunks verifies them after all.
+        auto revisiting = bucket.open_download_stream(result.id(), verifying);
+        revisiting.seek(revisiting.file_length());
+        revisiting.seek(0);
+        REQUIRE(read_all(revisiting) == contents);
+        revisiting.close();
+        REQUIRE(revisiting.checksum_verified());
+
+        for (auto&& download_options : all_file_download_options) {
+            bucket.download_to_file(result.id(), destination_path, download_options);
+        }
+    }
+
+    SECTION("corrupted contents fail verification") {
+        db["fs.chunks"].update_one(
+            make_document(kvp("files_id", result.id()), kvp("n", 1)),
+            make_document(kvp(
+                "$set",
+                make_document(kvp("data",
+                                  bsoncxx::types::b_binary{bsoncxx::binary_sub_type::k_binary,
+                                                           4,
+                                                           reinterpret_cast<const std::uint8_t*>(
+                                                               "XXXX")})))));
+
+        auto downloader = bucket.open_download_stream(result.id(), verifying);
+        read_all(downloader);
+        REQUIRE_THROWS_AS(downloader.close(), gridfs_exception);
+
+        // A download closed before the end is not checked.
+        auto partial = bucket.open_download_stream(result.id(), verifying);
+        std::uint8_t byte;
+        partial.read(&byte, 1);
+        partial.close();
+        REQUIRE(!partial.checksum_verified());
+
+        for (auto&& download_options : all_file_download_options) {
+            REQUIRE_THROWS_AS(
+                bucket.download_to_file(result.id(), destination_path, download_options),
+                gridfs_exception);
+            REQUIRE(!std::ifstream{destination_path});
+        }
+
+        // A failed download leaves an existing destination as it was.
+        {
+            std::ofstream existing{destination_path, std::ios::binary};
+            existing << "existing contents";
+        }
+        for (auto&& download_options : all_file_download_options) {
+            REQUIRE_THROWS_AS(
+                bucket.download_to_file(result.id(), destination_path, download_options),
+                gridfs_exception);
+
+            std::ifstream existing{destination_path, std::ios::binary};
+            std::string contents{std::istreambuf_iterator<char>{existing},
+                                 std::istreambuf_iterator<char>{}};
+            REQUIRE(contents == "existing contents");
+        }
+    }
+
+    SECTION("verification requires a whole file with a checksum") {
+        REQUIRE_THROWS_AS(bucket.open_download_stream(result.id(), 1, 5, verifying), logic_error);
+
+        auto unchecked = upload(false);
+        REQUIRE_THROWS_AS(bucket.open_download_stream(unchecked.id(), verifying), logic_error);
+    }
+
+    std::remove(destination_path.c_str());
+}
+
+TEST_CASE("gridfs deduplication", "[gridfs::uploader] [gridfs::downloader]") {
+    instance::current();
+
+    client client{uri{}};
+    pool pool{uri{}};
+    database db = client["gridfs_deduplication"];
+
+    db["fs.files"].delete_many({});
+    db["fs.chunks"].delete_many({});
+    db["fs.blobs"].delete_many({});
+
+    // Pseudo-random contents, so that chunk boundaries are spread throughout the file.
+    std::vector<std::uint8_t> contents(256 * 1024);
+    std::uint32_t state = 1;
+    for (auto& byte : contents) {
+        state = state * 1103515245 + 12345;
+        byte = static_cast<std::uint8_t>(state >> 16);
+    }
+
+    constexpr std::int32_t chunk_size = 4 * 1024;
+    auto upload_options =
+        options::gridfs::upload{}.chunk_size_bytes(chunk_size).compute_checksum(true);
+
+    auto upload = [&](gridfs::bucket& bucket, const std::vector<std::uint8_t>& data) {
+        auto uploader = bucket.open_upload_stream("file", upload_options);
+        for (std::size_t offset = 0; offset < data.size(); offset += 1000) {
+            uploader.write(&data[offset], std::min<std::size_t>(1000, data.size() - offset));
+        }
+        return uploader.close();
+    };
+
+    auto read_all = [](gridfs::downloader& downloader) {
+        std::vector<std::uint8_t> read;
+        std::uint8_t buffer[777];
+        while (auto bytes_read = downloader.read(buffer, sizeof(buffer))) {
+            read.insert(read.end(), buffer, buffer + bytes_read);
+        }
+        downloader.close();
+        return read;
+    };
+
+    auto stored_blobs = [&] { return db["fs.blobs"].count_documents({}); };
+
+    std::vector<std::shared_ptr<gridfs::chunk_codec>> codecs{
+        nullptr, std::make_shared<run_length_codec>()};
+
+    SECTION("files are stored as a manifest of blobs and read back") {
+        const std::string destination_path = "test_gridfs_deduplication_destination.bin";
+
+        for (auto&& codec : codecs) {
+            gridfs::bucket bucket = db.gridfs_bucket(
+                options::gridfs::bucket{}.deduplicate(true).chunk_codec(codec));
+            auto result = upload(bucket, contents);
+
+            auto files_doc = db["fs.files"].find_one(make_document(kvp("_id", result.id())));
+            REQUIRE(files_doc->view()["length"].get_int64().value ==
+                    static_cast<std::int64_t>(contents.size()));
+            REQUIRE(files_doc->view()["manifest"].get_binary().size % 36 == 0);
+            REQUIRE(db["fs.chunks"].count_documents(make_document(kvp("files_id", result.id()))) ==
+                    0);
+
+            auto downloader = bucket.open_download_stream(
+                result.id(), options::gridfs::download{}.verify_checksum(true));
+            REQUIRE(read_all(downloader) == contents);
+
+            auto range = bucket.open_download_stream(result.id(), 5000, 100000);
+            REQUIRE(read_all(range) ==
+                    std::vector<std::uint8_t>(contents.begin() + 5000, contents.begin() + 100000));
+
+            auto seeking = bucket.open_download_stream(result.id());
+            seeking.seek(200000);
+            std::uint8_t byte;
+            REQUIRE(seeking.read(&byte, 1) == 1);
+            REQUIRE(byte == contents[200000]);
+            seeking.seek(10);
+            REQUIRE(seeking.read(&byte, 1) == 1);
+            REQUIRE(byte == contents[10]);
+
+            bucket.download_to_file(
+                result.id(),
+                destination_path,
+                options::gridfs::download{}.pool(&pool).concurrency(3).verify_checksum(true));
+            std::ifstream destination{destination_path, std::ios::binary};
+            std::vector<std::uint8_t> written{std::istreambuf_iterator<char>{destination},
+                                              std::istreambuf_iterator<char>{}};
+            REQUIRE(written == contents);
+        }
+
+        std::remove(destination_path.c_str());
+    }
+
+    SECTION("only the chunks around an edit are stored again") {
+        gridfs::bucket bucket = db.gridfs_bucket(options::gridfs::bucket{}.deduplicate(true));
+
+        upload(bucket, contents);
+        const auto original_blobs = stored_blobs();
+        REQUIRE(original_blobs > 16);
+
+        upload(bucket, contents);
+        REQUIRE(stored_blobs() == original_blobs);
+
+        auto edited = contents;
+        edited.insert(edited.begin() + 5000, 10, 0x42);
+        auto result = upload(bucket, edited);
+        REQUIRE(stored_blobs() - original_blobs <= 4);
+
+        auto downloader = bucket.open_download_stream(result.id());
+        REQUIRE(read_all(downloader) == edited);
+    }
+
+    SECTION("deleting a file keeps the chunks it shares") {
+        gridfs::bucket bucket = db.gridfs_bucket(options::gridfs::bucket{}.deduplicate(true));
+
+        auto first = upload(bucket, contents);
+        auto second = upload(bucket, contents);
+        bucket.delete_file(first.id());
+
+        auto downloader = bucket.open_download_stream(second.id());
+        REQUIRE(read_all(downloader) == contents);
+    }
+
+    SECTION("deleting and aborting release the chunks no other file refers to") {
+        gridfs::bucket bucket = db.gridfs_bucket(options::gridfs::bucket{}.deduplicate(true));
+
+        auto first = upload(bucket, contents);
+        const auto original_blobs = stored_blobs();
+
+        auto total_refs = [&] {
+            std::int64_t refs = 0;
+            for (auto&& blob : db["fs.blobs"].find({})) {
+                refs += blob["refs"].get_int64().value;
+            }
+            return refs;
+        };
+        auto manifest_entries = [&](bsoncxx::types::bson_value::view id) {
+            auto files_doc = db["fs.files"].find_one(make_document(kvp("_id", id)));
+            return static_cast<std::int64_t>(files_doc->view()["manifest"].get_binary().size / 36);
+        };
+
+        auto second = upload(bucket, contents);
+        auto edited = contents;
+        edited.insert(edited.begin() + 5000, 10, 0x42);
+        auto third = upload(bucket, edited);
+        REQUIRE(stored_blobs() > original_blobs);
+        REQUIRE(total_refs() == manifest_entries(first.id()) + manifest_entries(second.id()) +
+                                    manifest_entries(third.id()));
+
+        bucket.delete_file(third.id());
+        REQUIRE(stored_blobs() == original_blobs);
+
+        bucket.delete_file(second.id());
+        REQUIRE(stored_blobs() == original_blobs);
+        REQUIRE(total_refs() == manifest_entries(first.id()));
+
+        auto downloader = bucket.open_download_stream(first.id());
+        REQUIRE(read_all(downloader) == contents);
+
+        // Large enough for some of its chunks to be stored before the upload is aborted.
+        std::vector<std::uint8_t> large(9 * 1024 * 1024);
+        for (auto& byte : large) {
+            state = state * 1103515245 + 12345;
+            byte = static_cast<std::uint8_t>(state >> 16);
+        }
+
+        auto uploader = bucket.open_upload_stream("aborted", upload_options);
+        uploader.write(large.data(), large.size());
+        REQUIRE(stored_blobs() > original_blobs);
+        uploader.abort();
+        REQUIRE(stored_blobs() == original_blobs);
+
+        bucket.delete_file(first.id());
+        REQUIRE(stored_blobs() == 0);
+    }
+
+    SECTION("a corrupted manifest is reported") {
+        gridfs::bucket bucket = db.gridfs_bucket(options::gridfs::bucket{}.deduplicate(true));
+        auto result = upload(bucket, contents);
+
+        const bsoncxx::types::b_binary manifest{
+            bsoncxx::binary_sub_type::k_binary, 4, reinterpret_cast<const std::uint8_t*>("XXXX")};
+        db["fs.files"].update_one(
+            make_document(kvp("_id", result.id())),
+            make_document(kvp("$set", make_document(kvp("manifest", manifest)))));
+
+        REQUIRE_THROWS_AS(bucket.open_download_stream(result.id()), gridfs_exception);
+    }
+
+    SECTION("deduplicated uploads cannot use a pool") {
+        gridfs::bucket bucket = db.gridfs_bucket(options::gridfs::bucket{}.deduplicate(true));
+
+        REQUIRE_THROWS_AS(
+            bucket.open_upload_stream("file", options::gridfs::upload{}.pool(&pool)), logic_error);
+    }
+}
+
+TEST_CASE("downloading throws error when options are invalid", "[gridfs::bucket]") {
+    instance::current();
+
+    client client{uri{}};
+    database db = client["gridfs_download_error_invalid_options"];
+    gridfs::bucket bucket = db.gridfs_bucket();
+
+    std::istringstream iss{"foo"};
+    auto result = bucket.upload_from_stream("file", &iss);
+    auto id = result.id();
+    options::gridfs::download download_options;
+
+    SECTION("zero prefetch window") {
+        pool pool{uri{}};
+        download_options.pool(&pool).prefetch_chunks(0);
+        REQUIRE_THROWS_AS(bucket.open_download_stream(id, download_options), logic_error);
+    }
+
+    SECTION("prefetching without a pool") {
+        download_options.prefetch_chunks(2);
+        REQUIRE_THROWS_AS(bucket.open_download_stream(id, download_options), logic_error);
+    }
+
+    SECTION("zero download concurrency") {
+        download_options.concurrency(0);
+        REQUIRE_THROWS_AS(bucket.download_to_file(id, "unused.bin", download_options), logic_error);
+    }
+
+    SECTION("concurrent download without a pool") {
+        download_options.concurrency(2);
+        REQUIRE_THROWS_AS(bucket.download_to_file(id, "unused.bin", download_options), logic_error);
+    }
+}
+
 TEST_CASE("gridfs::bucket::open_upload_stream_with_id works", "[gridfs::bucket]") {
     instance::current();
 
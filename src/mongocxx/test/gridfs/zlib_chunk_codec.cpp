@@ -0,0 +1,81 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <vector>
+
+#include <bsoncxx/test_util/catch.hh>
+#include <mongocxx/exception/error_code.hpp>
+#include <mongocxx/exception/exception.hpp>
+#include <mongocxx/exception/gridfs_exception.hpp>
+#include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/gridfs/zlib_chunk_codec.hpp>
+
+#include <mongocxx/config/private/prelude.hh>
+
+namespace {
+using namespace mongocxx;
+
+TEST_CASE("zlib_chunk_codec rejects an invalid level", "[gridfs::zlib_chunk_codec]") {
+    REQUIRE_THROWS_AS(gridfs::zlib_chunk_codec{10}, logic_error);
+    REQUIRE_THROWS_AS(gridfs::zlib_chunk_codec{-2}, logic_error);
+}
+
+#if defined(MONGOCXX_ENABLE_ZLIB_CHUNK_CODEC)
+TEST_CASE("zlib_chunk_codec round-trips a chunk", "[gridfs::zlib_chunk_codec]") {
+    gridfs::zlib_chunk_codec codec;
+    REQUIRE(codec.name() == stdx::string_view{"zlib"});
+
+    std::vector<std::uint8_t> chunk(255 * 1024);
+    for (std::size_t i = 0; i < chunk.size(); ++i) {
+        chunk[i] = static_cast<std::uint8_t>(i % 7);
+    }
+
+    std::vector<std::uint8_t> compressed(codec.max_compressed_size(chunk.size()));
+    const std::size_t compressed_length =
+        codec.compress(chunk.data(), chunk.size(), compressed.data());
+    REQUIRE(compressed_length < chunk.size());
+
+    SECTION("a chunk decompresses to its original bytes") {
+        std::vector<std::uint8_t> out(chunk.size());
+        REQUIRE(codec.decompress(compressed.data(), compressed_length, out.data(), out.size()) ==
+                chunk.size());
+        REQUIRE(out == chunk);
+    }
+
+    SECTION("a chunk larger than the capacity is reported as corrupted") {
+        std::vector<std::uint8_t> out(chunk.size() - 1);
+        REQUIRE_THROWS_AS(
+            codec.decompress(compressed.data(), compressed_length, out.data(), out.size()),
+            gridfs_exception);
+    }
+
+    SECTION("bytes that are not a zlib stream are reported as corrupted") {
+        std::vector<std::uint8_t> out(chunk.size());
+        std::vector<std::uint8_t> garbage(64, 0xff);
+        REQUIRE_THROWS_AS(codec.decompress(garbage.data(), garbage.size(), out.data(), out.size()),
+                          gridfs_exception);
+    }
+}
+#else
+TEST_CASE("zlib_chunk_codec requires zlib support", "[gridfs::zlib_chunk_codec]") {
+    try {
+        gridfs::zlib_chunk_codec codec;
+        FAIL("expected an exception");
+    } catch (const exception& e) {
+        REQUIRE(e.code() == error_code::k_zlib_not_supported);
+    }
+}
+#endif
+
+}  // namespace
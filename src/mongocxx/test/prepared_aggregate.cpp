@@ -0,0 +1,96 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <bsoncxx/builder/basic/array.hpp>
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/private/libbson.hh>
+#include <bsoncxx/test_util/catch.hh>
+#include <bsoncxx/types.hpp>
+#include <mongocxx/client.hpp>
+#include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/instance.hpp>
+#include <mongocxx/pipeline.hpp>
+#include <mongocxx/prepared_aggregate.hpp>
+#include <mongocxx/private/libmongoc.hh>
+
+#include <third_party/catch/include/helpers.hpp>
+
+namespace {
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_array;
+using bsoncxx::builder::basic::make_document;
+using bsoncxx::types::bson_value::view;
+
+using namespace bsoncxx::types;
+using namespace mongocxx;
+
+TEST_CASE("prepared_aggregate patches bound values into its pipeline", "[prepared_aggregate]") {
+    instance::current();
+
+    MOCK_CLIENT
+    MOCK_DATABASE
+    MOCK_COLLECTION
+    MOCK_CURSOR
+
+    auto collection_copy = libmongoc::collection_copy.create_instance();
+    collection_copy->interpose([](mongoc_collection_t*) -> mongoc_collection_t* { return nullptr; })
+        .forever();
+    collection_destroy->interpose([](mongoc_collection_t*) {}).forever();
+
+    client mongo_client{uri{}};
+    collection coll = mongo_client["prepared"]["aggregate"];
+
+    bsoncxx::stdx::optional<bsoncxx::document::value> sent_pipeline;
+    bsoncxx::stdx::optional<bsoncxx::document::value> sent_options;
+    collection_aggregate
+        ->interpose([&](mongoc_collection_t*,
+                        mongoc_query_flags_t,
+                        const bson_t* pipeline,
+                        const bson_t* opts,
+                        const mongoc_read_prefs_t*) -> mongoc_cursor_t* {
+            sent_pipeline = bsoncxx::document::value{
+                bsoncxx::document::view{bson_get_data(pipeline), pipeline->len}};
+            sent_options =
+                bsoncxx::document::value{bsoncxx::document::view{bson_get_data(opts), opts->len}};
+            return nullptr;
+        })
+        .forever();
+
+    pipeline pipe;
+    pipe.match(make_document(kvp("status", "new"), kvp("tenant", 0)));
+    pipe.limit(10);
+
+    auto query = coll.prepare_aggregate(pipe,
+                                        {"0.$match.status", "0.$match.tenant", "1.$limit"},
+                                        options::aggregate{}.batch_size(50));
+
+    query.bind(0, view{b_utf8{"archived"}}).bind(1, view{b_int32{3}}).bind(2, view{b_int32{20}});
+    query.execute();
+
+    auto expected = make_array(
+        make_document(kvp("$match", make_document(kvp("status", "archived"), kvp("tenant", 3)))),
+        make_document(kvp("$limit", 20)));
+
+    REQUIRE(sent_pipeline);
+    REQUIRE(sent_pipeline->view() ==
+            bsoncxx::document::view{expected.view().data(), expected.view().length()});
+    REQUIRE(query.pipeline() == expected.view());
+    REQUIRE(sent_options->view()["batchSize"].get_int32() == 50);
+
+    REQUIRE_THROWS_AS(coll.prepare_aggregate(pipe, {"2.$limit"}), logic_error);
+    REQUIRE_THROWS_AS(query.bind(2, view{b_int64{20}}), logic_error);
+}
+}  // namespace
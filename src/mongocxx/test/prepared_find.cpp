@@ -0,0 +1,125 @@
+// Copyright 2020-present MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <chrono>
+
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/private/libbson.hh>
+#include <bsoncxx/test_util/catch.hh>
+#include <bsoncxx/types.hpp>
+#include <mongocxx/client.hpp>
+#include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/instance.hpp>
+#include <mongocxx/prepared_find.hpp>
+#include <mongocxx/private/libmongoc.hh>
+
+#include <third_party/catch/include/helpers.hpp>
+
+namespace {
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_document;
+using bsoncxx::types::bson_value::view;
+
+using namespace bsoncxx::types;
+using namespace mongocxx;
+
+TEST_CASE("prepared_find patches bound values into its filter", "[prepared_find]") {
+    instance::current();
+
+    MOCK_CLIENT
+    MOCK_DATABASE
+    MOCK_COLLECTION
+    MOCK_CURSOR
+
+    auto collection_copy = libmongoc::collection_copy.create_instance();
+    collection_copy->interpose([](mongoc_collection_t*) -> mongoc_collection_t* { return nullptr; })
+        .forever();
+    collection_destroy->interpose([](mongoc_collection_t*) {}).forever();
+
+    client mongo_client{uri{}};
+    collection coll = mongo_client["prepared"]["find"];
+
+    bsoncxx::stdx::optional<bsoncxx::document::value> sent_filter;
+    bsoncxx::stdx::optional<bsoncxx::document::value> sent_options;
+    collection_find_with_opts
+        ->interpose([&](mongoc_collection_t*,
+                        const bson_t* filter,
+                        const bson_t* opts,
+                        const mongoc_read_prefs_t*) -> mongoc_cursor_t* {
+            sent_filter = bsoncxx::document::value{
+                bsoncxx::document::view{bson_get_data(filter), filter->len}};
+            sent_options =
+                bsoncxx::document::value{bsoncxx::document::view{bson_get_data(opts), opts->len}};
+            return nullptr;
+        })
+        .forever();
+
+    SECTION("fixed-width values are sent with the prepared options") {
+        auto start = b_date{std::chrono::milliseconds{0}};
+        auto query = coll.prepare_find(
+            make_document(kvp("tenant", 0), kvp("ts", make_document(kvp("$gte", start)))),
+            {"tenant", "ts.$gte"},
+            options::find{}.limit(5).sort(make_document(kvp("ts", -1))));
+
+        auto later = b_date{std::chrono::milliseconds{123456}};
+        query.bind(0, view{b_int32{7}}).bind(1, view{later});
+        query.execute();
+
+        REQUIRE(sent_filter);
+        REQUIRE(sent_filter->view() ==
+                make_document(kvp("tenant", 7), kvp("ts", make_document(kvp("$gte", later)))));
+        REQUIRE(sent_options->view() == make_document(kvp("limit", std::int64_t{5}),
+                                                      kvp("sort", make_document(kvp("ts", -1)))));
+
+        query.bind(0, view{b_int32{8}});
+        query.execute();
+        REQUIRE(sent_filter->view()["tenant"].get_int32() == 8);
+    }
+
+    SECTION("values of a different length move the rest of the filter") {
+        auto query = coll.prepare_find(
+            make_document(kvp("a", make_document(kvp("name", "x"), kvp("n", 1))), kvp("b", "y")),
+            {"a.name", "a.n", "b"});
+
+        query.bind(0, view{b_utf8{"a longer name"}})
+            .bind(1, view{b_int32{2}})
+            .bind(2, view{b_utf8{""}});
+        REQUIRE(query.filter() ==
+                make_document(kvp("a", make_document(kvp("name", "a longer name"), kvp("n", 2))),
+                              kvp("b", "")));
+
+        query.bind(0, view{b_utf8{"z"}}).bind(2, view{b_utf8{"yy"}});
+        query.execute();
+        REQUIRE(sent_filter->view() ==
+                make_document(kvp("a", make_document(kvp("name", "z"), kvp("n", 2))),
+                              kvp("b", "yy")));
+    }
+
+    SECTION("invalid parameters are rejected") {
+        auto filter = make_document(kvp("a", make_document(kvp("n", 1))),
+                                    kvp("b", b_null{}));
+
+        REQUIRE_THROWS_AS(coll.prepare_find(filter.view(), {"a.missing"}), logic_error);
+        REQUIRE_THROWS_AS(coll.prepare_find(filter.view(), {"a.n.x"}), logic_error);
+        REQUIRE_THROWS_AS(coll.prepare_find(filter.view(), {"b"}), logic_error);
+        REQUIRE_THROWS_AS(coll.prepare_find(filter.view(), {"a", "a.n"}), logic_error);
+
+        auto query = coll.prepare_find(filter.view(), {"a.n"});
+        REQUIRE_THROWS_AS(query.bind(0, view{b_int64{1}}), logic_error);
+        REQUIRE_THROWS_AS(query.bind(1, view{b_int32{1}}), logic_error);
+    }
+}
+}  // namespace
@@ -15,7 +15,9 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <cassert>
+#include <cstdlib>
 #include <functional>
 #include <iostream>
 #include <memory>
@@ -32,6 +34,34 @@ namespace mongocxx {
 MONGOCXX_INLINE_NAMESPACE_BEGIN
 namespace test_util {
 
+// While an instance of this class exists, a thread that has no instance of a mock of its own uses
+// the instance of the one thread that has, so that code under test can call mocked functions from
+// the threads it starts. Declare it in the test or section that starts such threads.
+//
+// A borrowed instance is only safe to call while its rules never expire, since expiring a rule
+// pops it from the owning thread's stack. Rules that such threads may call must therefore be
+// interposed with forever() before the threads start and must not be changed while they run; a
+// thread that reaches a rule interposed otherwise through a borrowed instance aborts the test.
+class share_mocks_with_other_threads {
+   public:
+    share_mocks_with_other_threads() : _previous{enabled().exchange(true)} {}
+
+    ~share_mocks_with_other_threads() {
+        enabled() = _previous;
+    }
+
+    share_mocks_with_other_threads(const share_mocks_with_other_threads&) = delete;
+    share_mocks_with_other_threads& operator=(const share_mocks_with_other_threads&) = delete;
+
+    static std::atomic<bool>& enabled() {
+        static std::atomic<bool> shared{false};
+        return shared;
+    }
+
+   private:
+    const bool _previous;
+};
+
 template <typename T>
 class mock;
 
@@ -56,15 +86,18 @@ class mock<R (*)(Args...)> {
 
         void forever() {
             until([](Args...) { return true; });
+            _forever = true;
         }
 
         void until(conditional conditional) {
             _conditional = std::move(conditional);
+            _forever = false;
         }
 
        private:
         callback _callback;
         conditional _conditional;
+        bool _forever = false;
     };
 
     class instance {
@@ -134,8 +167,15 @@ class mock<R (*)(Args...)> {
     mock& operator=(const mock&) = delete;
 
     R operator()(Args... args) {
-        auto instance = active_instance();
+        bool borrowed = false;
+        auto instance = active_instance(&borrowed);
         if (instance) {
+            if (borrowed && !instance->_callbacks.empty() && !instance->_callbacks.top()._forever) {
+                std::cerr << "a mock shared with other threads was called through a rule that is "
+                             "not interposed with forever()"
+                          << std::endl;
+                std::abort();
+            }
             while (!instance->_callbacks.empty()) {
                 if (instance->_callbacks.top()._conditional(args...)) {
                     return instance->_callbacks.top()._callback(args...);
@@ -154,13 +194,17 @@ class mock<R (*)(Args...)> {
     }
 
    private:
-    instance* active_instance() {
+    instance* active_instance(bool* borrowed) {
         const auto id = std::this_thread::get_id();
         std::lock_guard<std::mutex> lock(_active_instances_lock);
         const auto iterator = _active_instances.find(id);
         if (iterator != _active_instances.end()) {
             return iterator->second;
         }
+        if (share_mocks_with_other_threads::enabled() && _active_instances.size() == 1) {
+            *borrowed = true;
+            return _active_instances.begin()->second;
+        }
         return nullptr;
     }
 
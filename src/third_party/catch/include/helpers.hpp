@@ -14,6 +14,10 @@
 
 #pragma once
 
+#include <cstddef>
+#include <functional>
+#include <vector>
+
 #include <bsoncxx/test_util/catch.hh>
 #include <mongocxx/exception/exception.hpp>
 #include <mongocxx/private/libmongoc.hh>
@@ -224,6 +228,42 @@ MONGOCXX_INLINE_NAMESPACE_END
     auto cursor_destroy = libmongoc::cursor_destroy.create_instance(); \
     cursor_destroy->interpose([&](mongoc_cursor_t*) {});
 
+// Serves `documents`, a std::vector<bson_t>, from the cursor of every find on the mocked
+// collection, starting over from the first document each time. A null cursor is treated as already
+// dead, so find returns a dummy handle that only the mocked cursor functions see. Use after
+// MOCK_COLLECTION and MOCK_CURSOR; if `on_cursor_find` is set, it runs whenever a find is issued.
+#define MOCK_CURSOR_DOCUMENTS(documents)                                                   \
+    static char dummy_cursor;                                                              \
+    std::size_t next_cursor_document = 0;                                                  \
+    std::function<void()> on_cursor_find;                                                  \
+    collection_find_with_opts                                                              \
+        ->interpose([&](mongoc_collection_t*,                                              \
+                        const bson_t*,                                                     \
+                        const bson_t*,                                                     \
+                        const mongoc_read_prefs_t*) {                                      \
+            next_cursor_document = 0;                                                      \
+            if (on_cursor_find) {                                                          \
+                on_cursor_find();                                                          \
+            }                                                                              \
+            return reinterpret_cast<mongoc_cursor_t*>(&dummy_cursor);                      \
+        })                                                                                 \
+        .forever();                                                                        \
+    auto cursor_next = libmongoc::cursor_next.create_instance();                           \
+    cursor_next                                                                            \
+        ->interpose([&](mongoc_cursor_t*, const bson_t** bson) {                           \
+            if (next_cursor_document == (documents).size()) {                              \
+                return false;                                                              \
+            }                                                                              \
+            *bson = &(documents)[next_cursor_document++];                                  \
+            return true;                                                                   \
+        })                                                                                 \
+        .forever();                                                                        \
+    auto cursor_error_document = libmongoc::cursor_error_document.create_instance();       \
+    cursor_error_document                                                                  \
+        ->interpose([](mongoc_cursor_t*, bson_error_t*, const bson_t**) { return false; }) \
+        .forever();                                                                        \
+    cursor_destroy->interpose([](mongoc_cursor_t*) {}).forever();
+
 #define MOCK_BULK                                                                      \
     auto bulk_operation_insert_with_opts =                                             \
         libmongoc::bulk_operation_insert_with_opts.create_instance();                  \